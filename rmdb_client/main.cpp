@@ -9,14 +9,27 @@
 #include <termios.h>
 #include <unistd.h>
 
+#include <arpa/inet.h>
+
 #include <cassert>
+#include <cstring>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #define MAX_MEM_BUFFER_SIZE 8192
 #define PORT_DEFAULT 8765
 
+// 二进制帧协议，格式见服务端的wire_protocol.h
+static const char PROTOCOL_MAGIC[4] = {'\xff', 'R', 'M', 'B'};
+static const uint8_t PROTOCOL_VERSION = 1;
+static const size_t COL_WIDTH = 16;
+
+enum ColType { TYPE_INT, TYPE_FLOAT, TYPE_STRING, TYPE_DATETIME };
+
 bool is_exit_command(std::string &cmd) { return cmd == "exit" || cmd == "exit;" || cmd == "bye" || cmd == "bye;"; }
 
 int init_unix_sock(const char *unix_sock_path) {
@@ -68,6 +81,166 @@ int init_tcp_sock(const char *server_host, int server_port) {
     return sockfd;
 }
 
+bool read_full(int sockfd, char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = recv(sockfd, buf, len, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        buf += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool send_frame(int sockfd, char type, const std::string &payload) {
+    std::string frame(4, '\0');
+    uint32_t len = htonl(payload.size() + 1);
+    memcpy(&frame[0], &len, sizeof(len));
+    frame.push_back(type);
+    frame.append(payload);
+    const char *data = frame.data();
+    size_t left = frame.size();
+    while (left > 0) {
+        ssize_t n = write(sockfd, data, left);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        left -= n;
+    }
+    return true;
+}
+
+bool recv_frame(int sockfd, char &type, std::string &payload) {
+    char header[5];
+    if (!read_full(sockfd, header, sizeof(header))) return false;
+    uint32_t len;
+    memcpy(&len, header, sizeof(len));
+    len = ntohl(len);
+    if (len == 0) return false;
+    type = header[4];
+    payload.resize(len - 1);
+    return read_full(sockfd, &payload[0], payload.size());
+}
+
+// 按网络字节序依次读取帧的内容
+struct FrameReader {
+    const std::string &data;
+    size_t pos = 0;
+
+    explicit FrameReader(const std::string &data_) : data(data_) {}
+
+    uint8_t u8() { return (uint8_t)data[pos++]; }
+    uint16_t u16() {
+        uint16_t val;
+        memcpy(&val, data.data() + pos, sizeof(val));
+        pos += sizeof(val);
+        return ntohs(val);
+    }
+    uint32_t u32() {
+        uint32_t val;
+        memcpy(&val, data.data() + pos, sizeof(val));
+        pos += sizeof(val);
+        return ntohl(val);
+    }
+    uint64_t u64() {
+        uint64_t high = u32();
+        return (high << 32) | u32();
+    }
+    std::string bytes(size_t len) {
+        std::string str = data.substr(pos, len);
+        pos += len;
+        return str;
+    }
+    std::string rest() { return data.substr(pos); }
+};
+
+// 与服务端文本协议的表格格式保持一致
+void print_separator(size_t num_cols) {
+    for (size_t i = 0; i < num_cols; ++i) std::cout << '+' << std::string(COL_WIDTH + 2, '-');
+    std::cout << "+\n";
+}
+
+void print_record(const std::vector<std::string> &rec_str) {
+    for (auto col : rec_str) {
+        if (col.size() > COL_WIDTH) col = col.substr(0, COL_WIDTH - 3) + "...";
+        std::cout << "| " << std::setw(COL_WIDTH) << col << ' ';
+    }
+    std::cout << "|\n";
+}
+
+/**
+ * 读取一条请求的全部结果帧并打印，直到收到FRAME_READY_FOR_QUERY
+ * 请求中的每条语句以FRAME_COMPLETE或FRAME_ERROR结束；查询结果按行到达，边接收边打印，不需要缓存整个结果集
+ */
+bool print_binary_result(int sockfd) {
+    std::vector<uint8_t> types;
+    char type;
+    std::string payload;
+    while (recv_frame(sockfd, type, payload)) {
+        FrameReader reader(payload);
+        switch (type) {
+            case 'T': {
+                types.resize(reader.u16());
+                std::vector<std::string> captions;
+                for (auto &col_type : types) {
+                    col_type = reader.u8();
+                    captions.emplace_back(reader.bytes(reader.u16()));
+                }
+                print_separator(types.size());
+                print_record(captions);
+                print_separator(types.size());
+                break;
+            }
+            case 'D': {
+                std::vector<std::string> columns;
+                for (auto col_type : types) {
+                    if (reader.u8()) {
+                        columns.emplace_back();
+                        continue;
+                    }
+                    if (col_type == TYPE_INT) {
+                        columns.emplace_back(std::to_string((int)reader.u32()));
+                    } else if (col_type == TYPE_FLOAT) {
+                        uint32_t bits = reader.u32();
+                        float val;
+                        memcpy(&val, &bits, sizeof(val));
+                        columns.emplace_back(std::to_string(val));
+                    } else {
+                        columns.emplace_back(reader.bytes(reader.u16()));
+                    }
+                }
+                print_record(columns);
+                break;
+            }
+            case 'C': {
+                uint64_t num_rec = reader.u64();
+                if (!types.empty()) {
+                    print_separator(types.size());
+                    std::cout << "Total record(s): " << num_rec << '\n';
+                }
+                std::cout << reader.rest() << std::flush;
+                types.clear();
+                break;
+            }
+            case 'E':
+                std::cout << payload << std::endl;
+                types.clear();
+                break;
+            case 'Z':
+                return true;
+            default:
+                fprintf(stderr, "Unknown frame type: %c\n", type);
+                return false;
+        }
+    }
+    fprintf(stderr, "Connection was broken\n");
+    return false;
+}
+
 int main(int argc, char *argv[]) {
     int ret = 0;  // set_terminal_noncanonical();
                   //    if (ret < 0) {
@@ -78,10 +251,15 @@ int main(int argc, char *argv[]) {
     const char *unix_socket_path = nullptr;
     const char *server_host = "127.0.0.1";  // 127.0.0.1 192.168.31.25
     int server_port = PORT_DEFAULT;
+    // -l 使用旧的文本协议
+    bool legacy = false;
     int opt;
 
-    while ((opt = getopt(argc, argv, "s:h:p:")) > 0) {
+    while ((opt = getopt(argc, argv, "s:h:p:l")) > 0) {
         switch (opt) {
+            case 'l':
+                legacy = true;
+                break;
             case 's':
                 unix_socket_path = optarg;
                 break;
@@ -111,6 +289,19 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    if (!legacy) {
+        char type;
+        std::string payload;
+        std::string handshake(PROTOCOL_MAGIC, sizeof(PROTOCOL_MAGIC));
+        handshake.push_back((char)PROTOCOL_VERSION);
+        if (write(sockfd, handshake.data(), handshake.size()) != (ssize_t)handshake.size() ||
+            !recv_frame(sockfd, type, payload) || type != 'R') {
+            fprintf(stderr, "Protocol handshake failed, try -l for the text protocol\n");
+            close(sockfd);
+            return 1;
+        }
+    }
+
     char recv_buf[MAX_MEM_BUFFER_SIZE];
 
     while (1) {
@@ -125,10 +316,16 @@ int main(int argc, char *argv[]) {
         if (!command.empty()) {
             add_history(command.c_str());
             if (is_exit_command(command)) {
+                if (!legacy) send_frame(sockfd, 'X', "");
                 printf("The client will be closed.\n");
                 break;
             }
 
+            if (!legacy) {
+                if (!send_frame(sockfd, 'Q', command) || !print_binary_result(sockfd)) break;
+                continue;
+            }
+
             if ((send_bytes = write(sockfd, command.c_str(), command.length() + 1)) == -1) {
                 // fprintf(stderr, "send error: %d:%s \n", errno, strerror(errno));
                 std::cerr << "send error: " << errno << ":" << strerror(errno) << " \n" << std::endl;
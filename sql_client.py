@@ -6,15 +6,25 @@ SQL客户端脚本
 
 import os
 import socket
+import struct
 import time
 from datetime import datetime
 from typing import Tuple, List
 
+# 二进制帧协议，格式见服务端的src/wire_protocol.h
+PROTOCOL_MAGIC = b'\xffRMB'
+PROTOCOL_VERSION = 1
+COL_WIDTH = 16
+TYPE_INT, TYPE_FLOAT = 0, 1
+
+
 class SQLClient:
-    def __init__(self, host: str = "127.0.0.1", port: int = 8765, run_id: str = None):
+    def __init__(self, host: str = "127.0.0.1", port: int = 8765, run_id: str = None, legacy: bool = False):
         self.server_host = host
         self.server_port = port
         self.buffer_size = 8192
+        # legacy为True时使用以'\0'结尾的文本协议
+        self.legacy = legacy
         
         # 添加缺失的属性初始化
         self.sock = None
@@ -67,6 +77,11 @@ class SQLClient:
             self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
             self.sock.settimeout(60)  # 增加超时时间
             self.sock.connect((self.server_host, self.server_port))
+            if not self.legacy:
+                self.sock.sendall(PROTOCOL_MAGIC + bytes([PROTOCOL_VERSION]))
+                frame_type, _ = self._recv_frame()
+                if frame_type != b'R':
+                    raise ConnectionError("协议握手失败")
             self.connected = True
             return True
         except Exception as e:
@@ -83,6 +98,79 @@ class SQLClient:
             self.sock = None
         self.connected = False
     
+    def _recv_exact(self, length: int) -> bytes:
+        data = b''
+        while len(data) < length:
+            chunk = self.sock.recv(length - len(data))
+            if not chunk:
+                raise ConnectionError("连接已关闭")
+            data += chunk
+        return data
+
+    def _recv_frame(self) -> Tuple[bytes, bytes]:
+        length, frame_type = struct.unpack('!Ic', self._recv_exact(5))
+        return frame_type, self._recv_exact(length - 1)
+
+    @staticmethod
+    def _format_row(columns: List[str]) -> str:
+        row = ''
+        for col in columns:
+            if len(col) > COL_WIDTH:
+                col = col[:COL_WIDTH - 3] + '...'
+            row += '| ' + col.rjust(COL_WIDTH) + ' '
+        return row + '|\n'
+
+    def _recv_result(self) -> str:
+        """读取一条请求的全部结果帧，直到FRAME_READY_FOR_QUERY，还原成与文本协议相同格式的响应"""
+        types = []
+        separator = ''
+        response = []
+        while True:
+            frame_type, payload = self._recv_frame()
+            if frame_type == b'T':
+                (num_cols,), pos = struct.unpack_from('!H', payload), 2
+                captions = []
+                for _ in range(num_cols):
+                    col_type, name_len = struct.unpack_from('!BH', payload, pos)
+                    pos += 3
+                    types.append(col_type)
+                    captions.append(payload[pos:pos + name_len].decode('utf-8', 'replace'))
+                    pos += name_len
+                separator = '+' + '+'.join(['-' * (COL_WIDTH + 2)] * num_cols) + '+\n'
+                response += [separator, self._format_row(captions), separator]
+            elif frame_type == b'D':
+                pos = 0
+                columns = []
+                for col_type in types:
+                    is_null = payload[pos]
+                    pos += 1
+                    if is_null:
+                        columns.append('')
+                    elif col_type == TYPE_INT:
+                        columns.append(str(struct.unpack_from('!i', payload, pos)[0]))
+                        pos += 4
+                    elif col_type == TYPE_FLOAT:
+                        columns.append('%f' % struct.unpack_from('!f', payload, pos)[0])
+                        pos += 4
+                    else:
+                        (str_len,) = struct.unpack_from('!H', payload, pos)
+                        columns.append(payload[pos + 2:pos + 2 + str_len].decode('utf-8', 'replace'))
+                        pos += 2 + str_len
+                response.append(self._format_row(columns))
+            elif frame_type == b'C':
+                (num_rec,) = struct.unpack_from('!Q', payload)
+                if types:
+                    response += [separator, f"Total record(s): {num_rec}\n"]
+                response.append(payload[8:].decode('utf-8', 'replace'))
+                types = []
+            elif frame_type == b'E':
+                response.append(payload.decode('utf-8', 'replace') + '\n')
+                types = []
+            elif frame_type == b'Z':
+                return ''.join(response)
+            else:
+                raise ConnectionError(f"未知的帧类型: {frame_type}")
+
     def send_sql(self, sql: str, timeout: int = 60) -> Tuple[bool, str]:
         """发送SQL命令（使用持久连接）"""
         if not self.connected:
@@ -90,9 +178,14 @@ class SQLClient:
                 return False, "连接失败"
         
         try:
-            self.sock.sendall((sql + '\0').encode('utf-8'))
-            data = self.sock.recv(self.buffer_size)
-            response = data.decode('utf-8').strip()
+            if self.legacy:
+                self.sock.sendall((sql + '\0').encode('utf-8'))
+                data = self.sock.recv(self.buffer_size)
+                response = data.decode('utf-8').strip()
+            else:
+                data = sql.encode('utf-8')
+                self.sock.sendall(struct.pack('!Ic', len(data) + 1, b'Q') + data)
+                response = self._recv_result().strip()
             self.log_interaction(sql, True, response)
             return True, response
         except Exception as e:
@@ -186,10 +279,11 @@ def main():
     parser.add_argument('--port', type=int, default=8765, help='服务器端口 (默认: 8765)')
     parser.add_argument('--file', help='要执行的SQL文件路径')
     parser.add_argument('--sql', help='要执行的SQL命令')
+    parser.add_argument('--legacy', action='store_true', help='使用旧的文本协议')
 
     args = parser.parse_args()
 
-    client = SQLClient(args.host, args.port)
+    client = SQLClient(args.host, args.port, legacy=args.legacy)
 
     if args.file:
         client.execute_sql_file(args.file)
@@ -347,15 +347,23 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse,
             // 设置新值并进行类型转换
             Value val = convert_sv_value(sv_set_clause->val);
 
-            // 如果类型不匹配，尝试进行类型转换
-            if (val.type != target_type)
+            if (val.param_idx >= 0)
             {
-                val = convert_value_type(val, target_type);
+                // 参数占位符，类型转换推迟到绑定参数时进行
+                init_param(val, target_type, col_meta->len);
             }
+            else
+            {
+                // 如果类型不匹配，尝试进行类型转换
+                if (val.type != target_type)
+                {
+                    val = convert_value_type(val, target_type);
+                }
 
-            // 初始化原始数据
-            val.raw = nullptr;
-            val.init_raw(col_meta->len);
+                // 初始化原始数据
+                val.raw = nullptr;
+                val.init_raw(col_meta->len);
+            }
             set_clause.rhs = std::move(val);
             set_clause.op = sv_set_clause->op;
 
@@ -411,6 +419,14 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse,
             // 转换值并进行类型检查
             Value val = convert_sv_value(x->vals[i]);
 
+            if (val.param_idx >= 0)
+            {
+                // 参数占位符，类型转换推迟到绑定参数时进行
+                init_param(val, target_type, col.len);
+                query->values.emplace_back(std::move(val));
+                continue;
+            }
+
             // 如果类型不匹配，尝试进行类型转换
             if (val.type != target_type)
             {
@@ -527,7 +543,8 @@ void Analyze::get_clause(const std::vector<std::shared_ptr<ast::BinaryExpr>> &sv
         if (expr->rhs != nullptr && (expr->rhs->Nodetype() == ast::TreeNodeType::IntLit ||
                                      expr->rhs->Nodetype() == ast::TreeNodeType::FloatLit ||
                                      expr->rhs->Nodetype() == ast::TreeNodeType::BoolLit ||
-                                     expr->rhs->Nodetype() == ast::TreeNodeType::StringLit))
+                                     expr->rhs->Nodetype() == ast::TreeNodeType::StringLit ||
+                                     expr->rhs->Nodetype() == ast::TreeNodeType::Param))
         {
             auto rhs_val = std::static_pointer_cast<ast::Value>(expr->rhs);
             cond.is_rhs_val = true;
@@ -684,7 +701,12 @@ void Analyze::check_clause(const std::vector<std::string> &tab_names,
             ColType lhs_type = lhs_col->type;
             ColType rhs_type;
 
-            if (cond.is_rhs_val /* && !cond.is_subquery*/)
+            if (cond.is_rhs_val && cond.rhs_val.param_idx >= 0)
+            {
+                // 参数占位符只记录左侧列的类型和长度，类型检查推迟到绑定参数时进行
+                init_param(cond.rhs_val, lhs_type, lhs_col->len);
+            }
+            else if (cond.is_rhs_val /* && !cond.is_subquery*/)
             {
                 rhs_type = cond.rhs_val.type;
                 // 检查类型是否兼容
@@ -785,12 +807,67 @@ Value Analyze::convert_sv_value(const std::shared_ptr<ast::Value> &sv_val)
         val.set_str(str_lit->val);
     }
     break;
+    case ast::TreeNodeType::Param:
+    {
+        auto param = std::static_pointer_cast<ast::Param>(sv_val);
+        val.set_int(0);
+        val.param_idx = param->idx;
+    }
+    break;
     default:
         throw InternalError("Unexpected sv value type 2");
     }
     return val;
 }
 
+/**
+ * @description: 初始化参数占位符，记录参数绑定时需要转换成的类型，raw只用来记录目标长度
+ * @param {Value&} val 参数占位符
+ * @param {ColType} type 目标类型
+ * @param {int} len 目标长度
+ */
+void Analyze::init_param(Value &val, ColType type, int len)
+{
+    val.type = type;
+    val.raw = std::make_shared<RmRecord>(len);
+}
+
+/**
+ * @description: 把常量绑定到参数占位符上，类型检查和转换规则与分析阶段处理常量时一致
+ * @return {Value} 绑定后的值
+ * @param {Value&} placeholder 计划中的参数占位符
+ * @param {Value&} value 参数的值
+ * @param {bool} is_cond 占位符是否位于条件表达式中，否则位于insert的values或update的set子句中
+ */
+Value Analyze::bind_param(const Value &placeholder, const Value &value, bool is_cond)
+{
+    Value val = value;
+    val.param_idx = placeholder.param_idx;
+    // HAVING COUNT(*)等没有对应列的条件，分析阶段也不做类型转换
+    if (placeholder.raw == nullptr)
+    {
+        return val;
+    }
+
+    ColType target_type = placeholder.type;
+    if (is_cond)
+    {
+        if (!can_cast_type(target_type, val.type))
+        {
+            throw IncompatibleTypeError(coltype2str(target_type), coltype2str(val.type));
+        }
+        if (val.type != target_type)
+            cast_value(val, target_type);
+    }
+    else if (val.type != target_type)
+    {
+        val = convert_value_type(val, target_type);
+    }
+    val.raw = nullptr;
+    val.init_raw(placeholder.raw->size);
+    return val;
+}
+
 CompOp Analyze::convert_sv_comp_op(ast::SvCompOp op)
 {
     static std::map<ast::SvCompOp, CompOp> m = {
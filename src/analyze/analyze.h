@@ -67,6 +67,9 @@ public:
 
     std::shared_ptr<Query> do_analyze(std::shared_ptr<ast::TreeNode> root, Context *context);
 
+    static Value convert_sv_value(const std::shared_ptr<ast::Value> &sv_val);
+    static Value bind_param(const Value &placeholder, const Value &value, bool is_cond);
+
 private:
     TabCol check_column(const std::vector<ColMeta> &all_cols, TabCol target, bool is_semijoin,
                        const std::unordered_map<std::string, std::string> &table_alias_map);
@@ -76,9 +79,9 @@ private:
     void check_clause(const std::vector<std::string> &tab_names,
                       std::vector<Condition> &conds, bool is_having, Context *context,
                       const std::unordered_map<std::string, std::string> &table_alias_map);
-    Value convert_sv_value(const std::shared_ptr<ast::Value> &sv_val);
     CompOp convert_sv_comp_op(ast::SvCompOp op);
-    Value convert_value_type(const Value &value, ColType target_type);
+    static Value convert_value_type(const Value &value, ColType target_type);
+    static void init_param(Value &val, ColType type, int len);
     static bool can_cast_type(ColType from, ColType to);
     static void cast_value(Value &val, ColType to);
 };
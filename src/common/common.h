@@ -118,6 +118,8 @@ struct Value
 
     std::shared_ptr<RmRecord> raw; // raw record buffer
 
+    int param_idx = -1; // 预编译语句中参数占位符的序号，-1表示普通常量
+
     void set_int(int int_val_)
     {
         type = TYPE_INT;
@@ -35,10 +35,39 @@ static constexpr int64_t TXN_DELETE_TAG = 1LL << 30;
 static constexpr int64_t TXN_ID_MASK = TXN_DELETE_TAG - 1;
 static constexpr int64_t INVALID_TS = -1; // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;  // the header page id
-static constexpr int PAGE_SIZE = 4096;    // size of a data page in byte  4KB
+// 页面大小在编译时通过cmake -DRMDB_PAGE_SIZE选择，默认4KB
+#ifndef RMDB_PAGE_SIZE
+#define RMDB_PAGE_SIZE 4096
+#endif
+static constexpr int PAGE_SIZE = RMDB_PAGE_SIZE; // size of a data page in byte
+static_assert(PAGE_SIZE == 4096 || PAGE_SIZE == 8192 || PAGE_SIZE == 16384, "PAGE_SIZE must be 4KB, 8KB or 16KB");
+// 缓冲池和日志缓冲区的默认大小，启动时可以通过配置文件或命令行参数修改，见common/runtime_config.h
 // static constexpr int BUFFER_POOL_SIZE = 65536;     // size of buffer pool 256MB
 static constexpr int BUFFER_POOL_SIZE = 262144;            // size of buffer pool 1GB
 static constexpr int LOG_BUFFER_SIZE = (1024 * PAGE_SIZE); // size of a log buffer in byte
+// 组提交：提交的事务最多等待GROUP_COMMIT_DELAY_US微秒与其他事务合并刷盘，等待的事务达到GROUP_COMMIT_SIZE个时立即刷盘
+// 等待刷盘的事务会占用工作线程，批大小实际不超过工作线程数（CPU核数），所有工作线程都在等待时立即刷盘
+// 可以通过RuntimeConfig的group_commit_delay_us、group_commit_size修改
+static constexpr int GROUP_COMMIT_DELAY_US = 200;
+static constexpr int GROUP_COMMIT_SIZE = 32;
+// 静态检查点遇到被页面latch占用的脏页时释放日志锁等待后重试，等待时间从CHECKPOINT_BACKOFF_MIN_US开始加倍，
+// 最多CHECKPOINT_BACKOFF_MAX_US；重试CHECKPOINT_FLUSH_RETRIES次仍然有页面被占用时检查点失败
+static constexpr int CHECKPOINT_FLUSH_RETRIES = 100;
+static constexpr int CHECKPOINT_BACKOFF_MIN_US = 50;
+static constexpr int CHECKPOINT_BACKOFF_MAX_US = 10000;
+// 异步IO：后端（auto优先使用io_uring，threads强制使用线程池），线程池后端的IO线程数，io_uring后端的队列深度
+// 可以通过RuntimeConfig的io_backend、io_threads修改
+static constexpr const char *DEFAULT_IO_BACKEND = "auto";
+static constexpr int IO_THREAD_NUM = 4;
+static constexpr unsigned IO_URING_DEPTH = 256;
+// 缓冲池的替换策略：CLOCK-SWEEP（默认）、LRU、CLOCK或LRU-K，可以通过RuntimeConfig的replacer、replacer_k修改
+static constexpr const char *DEFAULT_REPLACER = "CLOCK-SWEEP";
+static constexpr int LRU_K = 2;
+// 预读：顺序扫描每次提前异步读取PREFETCH_PAGES个页面
+static constexpr int PREFETCH_PAGES = 32;
+// 数据文件使用O_DIRECT打开，绕过操作系统的页缓存，由缓冲池负责全部缓存；可以通过RuntimeConfig的direct_io修改
+// 日志文件不受影响
+static constexpr bool DIRECT_IO = false;
 static constexpr int BUCKET_SIZE = 50;                     // size of extendible hash bucket
 
 using frame_id_t = int32_t; // frame id type, 帧页ID, 页在BufferPool中的存储单元称为帧,一帧对应一页
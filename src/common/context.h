@@ -22,8 +22,10 @@ See the Mulan PSL v2 for more details. */
 #include "transaction/transaction.h"
 #include "transaction/concurrency/lock_manager.h"
 #include "recovery/log_manager.h"
+#include "common/tuple_arena.h"
 
 // class TransactionManager;
+class FrameWriter;
 
 // used for data_send
 static int const_offset = -1;
@@ -109,5 +111,11 @@ public:
     char *data_send_;
     int *offset_;
     bool ellipsis_;
+    // 使用二进制协议的连接，查询结果通过它按行流式发送；文本协议下为nullptr
+    FrameWriter *frame_writer_ = nullptr;
+    // 使用文本协议的连接的发送缓冲区，结果可能超过data_send_大小的语句直接把文本追加到这里；二进制协议下为nullptr
+    FrameWriter *text_writer_ = nullptr;
     QueryFlags queryFlags_; // 新增的标志位结构体成员
+    // 执行器中间元组的内存池，同一个会话的语句依次使用，每条语句结束时回收
+    TupleArena arena_;
 };
\ No newline at end of file
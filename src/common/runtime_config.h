@@ -0,0 +1,299 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "common/config.h"
+#include "errors.h"
+
+/**
+ * @description: 启动时确定的配置，默认值来自config.h，可以被配置文件、环境变量和命令行参数覆盖
+ *
+ * 配置文件每行一项"key = value"，'#'之后为注释；命令行参数的形式为"--key=value"，后出现的覆盖先出现的。
+ * 环境变量的名称为"RMDB_"加上大写的配置项名称，如RMDB_REPLACER。优先级：命令行参数 > 环境变量 > 配置文件。
+ *   buffer_pool_size  缓冲池的大小，可以带K/M/G后缀，如256M
+ *   max_buffer_pool_size  运行时通过SET buffer_pool_size可以扩大到的最大值，默认为buffer_pool_size的2倍，
+ *                     启动时按这个大小预留地址空间和帧的元信息
+ *   log_buffer_size   每个日志缓冲区的大小，可以带K/M/G后缀
+ *   page_size         新建数据库的页面大小，只能等于编译时的PAGE_SIZE（cmake -DRMDB_PAGE_SIZE=8192/16384），
+ *                     页面大小记录在db.meta中，打开数据库时检查
+ *   replacer          缓冲池的替换策略：CLOCK-SWEEP、LRU、CLOCK或LRU-K
+ *   replacer_k        LRU-K的K
+ *   huge_pages        缓冲池是否使用预留的大页（MAP_HUGETLB），on/off，默认off；关闭时仍然申请透明大页
+ *   numa_policy       缓冲池内存的NUMA策略：local（默认）、interleave（在所有节点之间交错分配）或node:<n>（只在节点n上分配）
+ *   direct_io         数据文件是否使用O_DIRECT打开，on/off
+ *   io_backend        异步IO的后端：auto（默认，支持时使用io_uring）、io_uring或threads（线程池）
+ *   io_threads        线程池后端的IO线程数
+ *   group_commit_delay_us  提交的事务最多等待多少微秒与其他事务合并刷盘
+ *   group_commit_size 等待的事务达到多少个时立即刷盘
+ */
+struct RuntimeConfig
+{
+    size_t buffer_pool_size = (size_t)BUFFER_POOL_SIZE * PAGE_SIZE; // 字节
+    size_t max_buffer_pool_size = 0;                                // 字节，0表示buffer_pool_size的2倍
+    size_t log_buffer_size = LOG_BUFFER_SIZE;                      // 字节
+    size_t page_size = PAGE_SIZE;
+    std::string replacer = DEFAULT_REPLACER;
+    int replacer_k = LRU_K;
+    bool huge_pages = false;
+    std::string numa_policy = "local";
+    bool direct_io = DIRECT_IO;
+    std::string io_backend = DEFAULT_IO_BACKEND;
+    int io_threads = IO_THREAD_NUM;
+    int group_commit_delay_us = GROUP_COMMIT_DELAY_US;
+    int group_commit_size = GROUP_COMMIT_SIZE;
+
+    // 缓冲池中的帧数
+    size_t buffer_pool_frames() const { return buffer_pool_size / PAGE_SIZE; }
+
+    size_t max_buffer_pool_frames() const
+    {
+        return max_buffer_pool_size ? std::max(max_buffer_pool_size, buffer_pool_size) / PAGE_SIZE : 2 * buffer_pool_frames();
+    }
+
+    /**
+     * @description: 解析带K/M/G后缀的大小
+     * @param {string&} key 配置项名称，用于错误信息
+     * @param {string&} value 配置项的值
+     */
+    static size_t parse_size(const std::string &key, const std::string &value)
+    {
+        size_t pos = 0;
+        unsigned long long num = 0;
+        try
+        {
+            num = std::stoull(value, &pos);
+        }
+        catch (std::exception &)
+        {
+            throw ConfigError(key, value);
+        }
+        std::string suffix = value.substr(pos);
+        size_t unit = 1;
+        if (suffix == "K" || suffix == "k" || suffix == "KB" || suffix == "kB")
+            unit = 1024;
+        else if (suffix == "M" || suffix == "m" || suffix == "MB")
+            unit = 1024 * 1024;
+        else if (suffix == "G" || suffix == "g" || suffix == "GB")
+            unit = 1024 * 1024 * 1024;
+        else if (!suffix.empty())
+            throw ConfigError(key, value);
+        return num * unit;
+    }
+
+    // 解析不小于min的整数
+    static int parse_int(const std::string &key, const std::string &value, int min)
+    {
+        size_t pos = 0;
+        long num = 0;
+        try
+        {
+            num = std::stol(value, &pos);
+        }
+        catch (std::exception &)
+        {
+            throw ConfigError(key, value);
+        }
+        if (pos != value.size() || num > INT32_MAX)
+            throw ConfigError(key, value);
+        if (num < min)
+            throw ConfigError(key, value, "at least " + std::to_string(min));
+        return (int)num;
+    }
+
+    // 解析on/off、true/false或1/0
+    static bool parse_bool(const std::string &key, const std::string &value)
+    {
+        std::string v = value;
+        for (auto &c : v)
+            c = std::tolower((unsigned char)c);
+        if (v == "on" || v == "true" || v == "1")
+            return true;
+        if (v == "off" || v == "false" || v == "0")
+            return false;
+        throw ConfigError(key, value, "on or off");
+    }
+
+    // 设置一个配置项，名称或取值不合法时抛出ConfigError
+    void set(const std::string &key, const std::string &value)
+    {
+        if (key == "buffer_pool_size")
+        {
+            buffer_pool_size = parse_size(key, value);
+            if (buffer_pool_frames() < 16)
+                throw ConfigError(key, value, "at least 16 pages");
+        }
+        else if (key == "max_buffer_pool_size")
+        {
+            max_buffer_pool_size = parse_size(key, value);
+        }
+        else if (key == "log_buffer_size")
+        {
+            log_buffer_size = parse_size(key, value);
+            if (log_buffer_size < (size_t)PAGE_SIZE)
+                throw ConfigError(key, value, "at least one page");
+        }
+        else if (key == "page_size")
+        {
+            page_size = parse_size(key, value);
+            if (page_size != (size_t)PAGE_SIZE)
+                throw ConfigError(key, value, "this build uses " + std::to_string(PAGE_SIZE) +
+                                                  "-byte pages, rebuild with -DRMDB_PAGE_SIZE=" + std::to_string(page_size));
+        }
+        else if (key == "replacer")
+        {
+            std::string type = value;
+            for (auto &c : type)
+                c = std::toupper((unsigned char)c);
+            if (type != "CLOCK-SWEEP" && type != "LRU" && type != "CLOCK" && type != "LRU-K")
+                throw ConfigError(key, value, "CLOCK-SWEEP, LRU, CLOCK or LRU-K");
+            replacer = type;
+        }
+        else if (key == "replacer_k")
+        {
+            replacer_k = parse_int(key, value, 1);
+        }
+        else if (key == "huge_pages")
+        {
+            huge_pages = parse_bool(key, value);
+        }
+        else if (key == "numa_policy")
+        {
+            if (value != "local" && value != "interleave" &&
+                !(value.rfind("node:", 0) == 0 && value.size() > 5 &&
+                  value.find_first_not_of("0123456789", 5) == std::string::npos))
+                throw ConfigError(key, value, "local, interleave or node:<n>");
+            numa_policy = value;
+        }
+        else if (key == "direct_io")
+        {
+            direct_io = parse_bool(key, value);
+        }
+        else if (key == "io_backend")
+        {
+            std::string type = value;
+            for (auto &c : type)
+                c = std::tolower((unsigned char)c);
+            if (type != "auto" && type != "io_uring" && type != "threads")
+                throw ConfigError(key, value, "auto, io_uring or threads");
+            io_backend = type;
+        }
+        else if (key == "io_threads")
+        {
+            io_threads = parse_int(key, value, 1);
+        }
+        else if (key == "group_commit_delay_us")
+        {
+            group_commit_delay_us = parse_int(key, value, 0);
+        }
+        else if (key == "group_commit_size")
+        {
+            group_commit_size = parse_int(key, value, 1);
+        }
+        else
+        {
+            throw ConfigError(key, value, "unknown option");
+        }
+    }
+
+    // 读取配置文件
+    void load_file(const std::string &path)
+    {
+        std::ifstream ifs(path);
+        if (!ifs)
+            throw FileNotFoundError(path);
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            line = line.substr(0, line.find('#'));
+            size_t eq = line.find('=');
+            if (eq == std::string::npos)
+            {
+                if (!trim(line).empty())
+                    throw ConfigError(trim(line), "", "expected key = value");
+                continue;
+            }
+            set(trim(line.substr(0, eq)), trim(line.substr(eq + 1)));
+        }
+    }
+
+    // 读取环境变量中的配置项
+    void load_env()
+    {
+        static const char *const keys[] = {"replacer",   "replacer_k", "huge_pages", "numa_policy",
+                                           "direct_io",  "io_backend", "io_threads", "group_commit_delay_us",
+                                           "group_commit_size"};
+        for (const char *key : keys)
+        {
+            std::string name = "RMDB_";
+            for (const char *c = key; *c; c++)
+                name += std::toupper((unsigned char)*c);
+            if (const char *value = std::getenv(name.c_str()))
+                set(key, value);
+        }
+    }
+
+    /**
+     * @description: 解析命令行参数，--config=<file>指定的配置文件先于环境变量和其他参数生效
+     * @return {string} 数据库名称，没有指定时为空
+     */
+    std::string parse_args(int argc, char **argv)
+    {
+        std::string db_name;
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg.rfind("--config=", 0) == 0)
+                load_file(arg.substr(9));
+        }
+        load_env();
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) != 0)
+            {
+                if (!db_name.empty())
+                    throw ConfigError(arg, "", "more than one database given");
+                db_name = arg;
+                continue;
+            }
+            size_t eq = arg.find('=');
+            std::string key = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+            if (key == "config")
+                continue;
+            if (eq == std::string::npos)
+                throw ConfigError(key, "", "expected --key=value");
+            // 命令行中的名称可以用'-'代替'_'
+            for (auto &c : key)
+                if (c == '-')
+                    c = '_';
+            set(key, arg.substr(eq + 1));
+        }
+        return db_name;
+    }
+
+private:
+    static std::string trim(const std::string &s)
+    {
+        size_t begin = 0, end = s.size();
+        while (begin < end && std::isspace((unsigned char)s[begin]))
+            begin++;
+        while (end > begin && std::isspace((unsigned char)s[end - 1]))
+            end--;
+        return s.substr(begin, end - begin);
+    }
+};
@@ -0,0 +1,102 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @description: 执行器中间元组的内存池，每个会话的Context持有一个，只被执行当前语句的线程使用
+ *
+ * 元组大小按16字节分级，从64KB的块中顺序切分，释放的元组挂到同一级的空闲链表上，
+ * 之后分配同样大小的元组直接复用，语句执行期间占用的内存不超过同时存活的元组的峰值。
+ * 超过MAX_CLASS_SIZE的元组直接使用new[]。语句结束、所有元组都已经释放后由Portal::drop()调用reset()，
+ * 只保留第一个块给下一条语句使用。
+ */
+class TupleArena
+{
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+    static constexpr size_t ALIGN = 16;
+    static constexpr size_t MAX_CLASS_SIZE = 4096;
+
+    TupleArena() = default;
+    TupleArena(const TupleArena &) = delete;
+    TupleArena &operator=(const TupleArena &) = delete;
+
+    char *allocate(size_t size)
+    {
+        if (size > MAX_CLASS_SIZE)
+            return new char[size];
+        size_t cls = size_class(size);
+        if (FreeNode *node = free_[cls])
+        {
+            free_[cls] = node->next;
+            return reinterpret_cast<char *>(node);
+        }
+        size_t bytes = cls * ALIGN;
+        if (cur_ == nullptr || (size_t)(end_ - cur_) < bytes)
+            next_block();
+        char *p = cur_;
+        cur_ += bytes;
+        return p;
+    }
+
+    void deallocate(char *p, size_t size)
+    {
+        if (size > MAX_CLASS_SIZE)
+        {
+            delete[] p;
+            return;
+        }
+        size_t cls = size_class(size);
+        FreeNode *node = reinterpret_cast<FreeNode *>(p);
+        node->next = free_[cls];
+        free_[cls] = node;
+    }
+
+    // 释放语句中分配的全部内存，调用前所有从这里分配的元组都必须已经释放
+    void reset()
+    {
+        if (blocks_.size() > 1)
+            blocks_.resize(1);
+        used_blocks_ = 0;
+        cur_ = end_ = nullptr;
+        free_.fill(nullptr);
+    }
+
+    size_t reserved_bytes() const { return blocks_.size() * BLOCK_SIZE; }
+
+private:
+    struct FreeNode
+    {
+        FreeNode *next;
+    };
+
+    static size_t size_class(size_t size) { return size == 0 ? 1 : (size + ALIGN - 1) / ALIGN; }
+
+    void next_block()
+    {
+        // 块的剩余空间不足时直接丢弃，reset()之前不会再使用
+        if (used_blocks_ == blocks_.size())
+            blocks_.emplace_back(new char[BLOCK_SIZE]);
+        cur_ = blocks_[used_blocks_++].get();
+        end_ = cur_ + BLOCK_SIZE;
+    }
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t used_blocks_ = 0; // blocks_中已经开始切分的块数，reset()之后从保留的第一个块重新开始
+    char *cur_ = nullptr;
+    char *end_ = nullptr;
+    std::array<FreeNode *, MAX_CLASS_SIZE / ALIGN + 1> free_{};
+};
@@ -180,6 +180,25 @@ public:
         : RMDBError("Incompatible type error: lhs " + lhs + ", rhs " + rhs) {}
 };
 
+class PreparedStmtNotFoundError : public RMDBError
+{
+public:
+    PreparedStmtNotFoundError(const std::string &name) : RMDBError("Prepared statement not found: " + name) {}
+};
+
+class PreparedStmtExistsError : public RMDBError
+{
+public:
+    PreparedStmtExistsError(const std::string &name) : RMDBError("Prepared statement already exists: " + name) {}
+};
+
+class InvalidParamCountError : public RMDBError
+{
+public:
+    InvalidParamCountError(int expected, int given)
+        : RMDBError("Invalid parameter count: expected " + std::to_string(expected) + ", given " + std::to_string(given)) {}
+};
+
 class AmbiguousColumnError : public RMDBError
 {
 public:
@@ -207,4 +226,18 @@ class InvalidDatetimeFormatError : public RMDBError
 {
 public:
     InvalidDatetimeFormatError(const std::string &msg) : RMDBError(msg) {}
-};
\ No newline at end of file
+};
+class ConfigError : public RMDBError
+{
+public:
+    ConfigError(const std::string &key, const std::string &value, const std::string &reason = "")
+        : RMDBError("Invalid config " + key + (value.empty() ? "" : " = " + value) + (reason.empty() ? "" : ": " + reason)) {}
+};
+
+class PageSizeMismatchError : public RMDBError
+{
+public:
+    PageSizeMismatchError(size_t db_page_size, size_t page_size)
+        : RMDBError("Database uses " + std::to_string(db_page_size) + "-byte pages, but this build uses " +
+                    std::to_string(page_size) + "-byte pages") {}
+};
@@ -342,7 +342,7 @@ private:
         else
         {
             // 如果没有分组，添加默认结果
-            RmRecord record(TupleLen);
+            RmRecord record(TupleLen, tuple_arena());
             int offset = 0;
             std::vector<Value> agg_values;
             agg_values.resize(sel_cols_.size() + order_by_cols_.size());
@@ -775,7 +775,7 @@ void AggExecutor::generate_results_batch(size_t batch_size)
 
         if (check_having_conditions(having_lhs_agg_values, having_rhs_agg_values))
         {
-            RmRecord record(TupleLen);
+            RmRecord record(TupleLen, tuple_arena());
             int offset = 0;
 
             for (size_t i = 0; i < sel_cols_.size(); ++i)
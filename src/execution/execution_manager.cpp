@@ -20,6 +20,8 @@ See the Mulan PSL v2 for more details. */
 #include "executor_explain.h"
 #include "index/ix.h"
 #include "record_printer.h"
+#include "wire_protocol.h"
+#include "common/runtime_config.h"
 
 const char *help_info = "Supported SQL syntax:\n"
                         "  command ;\n"
@@ -76,7 +78,7 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context)
         {
         case T_CreateTable:
         {
-            sm_manager_->create_table(x->tab_name_, x->cols_, context);
+            sm_manager_->create_table(x->tab_name_, x->cols_, context, x->slotted_);
             break;
         }
         case T_DropTable:
@@ -129,6 +131,11 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Co
         sm_manager_->show_tables(context);
         break;
     }
+    case T_ShowStatus:
+    {
+        sm_manager_->show_status(context);
+        break;
+    }
     case T_DescTable:
     {
         auto x = std::static_pointer_cast<OtherPlan>(plan);
@@ -179,6 +186,21 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Co
             planner_->set_enable_sortmerge_join(x->bool_val_);
             break;
         }
+        case ast::SetKnobType::BufferPoolSize:
+        {
+            // 整数表示帧数，字符串表示带K/M/G后缀的字节数，如'256M'
+            const std::string &val = x->str_val_;
+            size_t frames = val.find_first_not_of("0123456789") == std::string::npos
+                                ? RuntimeConfig::parse_size("buffer_pool_size", val)
+                                : RuntimeConfig::parse_size("buffer_pool_size", val) / PAGE_SIZE;
+            BufferPoolManager_Final *bpm = sm_manager_->get_bpm();
+            if (frames < 16 || frames > bpm->get_max_pool_size())
+            {
+                throw ConfigError("buffer_pool_size", val, "between 16 and " + std::to_string(bpm->get_max_pool_size()) + " pages");
+            }
+            bpm->resize(frames);
+            break;
+        }
         default:
         {
             throw RMDBError("Not implemented!\n");
@@ -226,10 +248,15 @@ std::string makeAggFuncCaptions(const TabCol &sel_col)
 
 // 执行select语句，select语句的输出除了需要返回客户端外，还需要写入output.txt文件中
 // 执行select语句，select语句的输出除了需要返回客户端外，还需要写入output.txt文件中
-void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot, const std::vector<TabCol> &sel_cols,
-                            Context *context)
+/**
+ * @description: 开始执行查询，发送表头后产生结果
+ * @return {unique_ptr<SelectCursor>} 结果因为发送缓冲区积压而暂停时返回游标，由fetch_rows()继续；已经全部产生时返回nullptr
+ */
+std::unique_ptr<SelectCursor> QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
+                                                     const std::vector<TabCol> &sel_cols, Context *context)
 {
-    std::vector<std::string> captions;
+    auto cursor = std::make_unique<SelectCursor>();
+    std::vector<std::string> &captions = cursor->captions;
     captions.reserve(sel_cols.size());
     for (auto &sel_col : sel_cols)
     {
@@ -246,47 +273,78 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
         }
     }
 
+    // 二进制协议下按行流式发送结果，不再写入大小有限的发送缓冲区
+    FrameWriter *writer = context->frame_writer_;
     // Print header into buffer
-    RecordPrinter rec_printer(sel_cols.size());
-    rec_printer.print_separator(context);
-    rec_printer.print_record(captions, context);
-    rec_printer.print_separator(context);
-
-    // 文件I/O相关变量
-    int fd = -1;
-    std::string buffer;
+    if (writer != nullptr)
+    {
+        writer->send_row_desc(captions, executorTreeRoot->cols());
+    }
+    else
+    {
+        RecordPrinter rec_printer(sel_cols.size());
+        rec_printer.print_separator(context);
+        rec_printer.print_record(captions, context);
+        rec_printer.print_separator(context);
+    }
 
     // 只有在启用I/O时才打开文件并初始化缓冲区
     if (sm_manager_->io_enabled_)
     {
-        fd = ::open("output.txt", O_WRONLY | O_CREAT | O_APPEND, 0644);
-        if (fd == -1)
-            return;
+        cursor->fd = ::open("output.txt", O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (cursor->fd == -1)
+            return nullptr;
 
         // 64KB缓冲区
-        buffer.reserve(8096);
+        cursor->buffer.reserve(8096);
 
         // 写入表头到缓冲区
-        buffer.append("|");
+        cursor->buffer.append("|");
         for (size_t i = 0; i < captions.size(); ++i)
         {
-            buffer.append(" ").append(captions[i]).append(" |");
+            cursor->buffer.append(" ").append(captions[i]).append(" |");
         }
-        buffer.append("\n");
+        cursor->buffer.append("\n");
     }
 
-    // Print records
-    size_t num_rec = 0;
+    cursor->root = std::move(executorTreeRoot);
+    cursor->tuples = cursor->root->next_batch();
+    if (fetch_rows(*cursor, context))
+        return nullptr;
+    return cursor;
+}
+
+/**
+ * @description: 从游标的位置继续产生查询结果，二进制协议下发送缓冲区中积压的结果超过FRAME_HIGH_WATER时暂停
+ * @return {bool} 结果是否已经全部产生
+ */
+bool QlManager::fetch_rows(SelectCursor &cursor, Context *context)
+{
+    FrameWriter *writer = context->frame_writer_;
+    RecordPrinter rec_printer(cursor.captions.size());
+    const auto &cols = cursor.root->cols();
     [[maybe_unused]] ssize_t discard;
 
-    // 执行query_plan
-    auto Tuples = executorTreeRoot->next_batch();
-    while (Tuples.size())
+    // 执行query_plan，连接已经失败时不再继续产生结果
+    while (cursor.tuples.size() && (writer == nullptr || !writer->broken()))
     {
-        for (auto &Tuple : Tuples)
+        while (cursor.next < cursor.tuples.size())
         {
+            auto &Tuple = cursor.tuples[cursor.next++];
+            if (writer != nullptr)
+            {
+                writer->send_row(cols, Tuple->data);
+                // 没有开启文件输出时不需要把记录转换成文本
+                if (cursor.fd == -1)
+                {
+                    cursor.num_rec++;
+                    if (writer->pending() >= FRAME_HIGH_WATER)
+                        return false;
+                    continue;
+                }
+            }
             std::vector<std::string> columns;
-            for (auto &col : executorTreeRoot->cols())
+            for (auto &col : cols)
             {
                 std::string col_str;
                 char *rec_buf = Tuple->data + col.offset;
@@ -330,35 +388,46 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
                 columns.emplace_back(std::move(col_str));
             }
             // print record into buffer
-            rec_printer.print_record(columns, context);
+            if (writer == nullptr)
+                rec_printer.print_record(columns, context);
             // print record into file
-            buffer.append("|");
+            cursor.buffer.append("|");
             for (size_t i = 0; i < columns.size(); ++i)
             {
-                buffer.append(" ").append(columns[i]).append(" |");
+                cursor.buffer.append(" ").append(columns[i]).append(" |");
             }
-            buffer.append("\n");
-            num_rec++;
+            cursor.buffer.append("\n");
+            cursor.num_rec++;
             // 缓冲区满时写入
-            if (buffer.size() >= 8096)
+            if (cursor.buffer.size() >= 8096)
             {
-                discard = ::write(fd, buffer.data(), buffer.size());
-                buffer.clear();
+                discard = ::write(cursor.fd, cursor.buffer.data(), cursor.buffer.size());
+                cursor.buffer.clear();
             }
+            if (writer != nullptr && writer->pending() >= FRAME_HIGH_WATER)
+                return false;
         }
-        Tuples = executorTreeRoot->next_batch();
+        cursor.tuples = cursor.root->next_batch();
+        cursor.next = 0;
     }
 
     // 写入剩余数据
-    if (buffer.size())
+    if (cursor.fd != -1)
     {
-        discard = ::write(fd, buffer.data(), buffer.size());
+        if (cursor.buffer.size())
+        {
+            discard = ::write(cursor.fd, cursor.buffer.data(), cursor.buffer.size());
+        }
+        close(cursor.fd);
+        cursor.fd = -1;
     }
-    close(fd);
+    if (writer != nullptr)
+        return true;
     // Print footer into buffer
     rec_printer.print_separator(context);
     // Print record count into buffer
-    RecordPrinter::print_record_count(num_rec, context);
+    RecordPrinter::print_record_count(cursor.num_rec, context);
+    return true;
 }
 
 // 执行DML语句
@@ -31,6 +31,25 @@ See the Mulan PSL v2 for more details. */
 
 class Planner;
 
+// 查询结果的游标：二进制协议下发送缓冲区中积压的结果超过FRAME_HIGH_WATER时暂停产生结果，
+// 游标保存算子树和已经取出但还没有发送的记录，socket可写之后由QlManager::fetch_rows()继续
+struct SelectCursor
+{
+    std::unique_ptr<AbstractExecutor> root;
+    std::vector<std::string> captions;
+    int fd = -1;        // 开启文件输出时的output.txt
+    std::string buffer; // 还没有写入output.txt的内容
+    size_t num_rec = 0;
+    std::vector<std::unique_ptr<RmRecord>> tuples; // 当前批次的记录
+    size_t next = 0;                               // 当前批次中下一条要发送的记录
+
+    ~SelectCursor()
+    {
+        if (fd != -1)
+            close(fd);
+    }
+};
+
 class QlManager
 {
 private:
@@ -44,8 +63,9 @@ public:
 
     void run_mutli_query(std::shared_ptr<Plan> plan, Context *context);
     void run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Context *context);
-    void select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot, const std::vector<TabCol> &sel_cols,
-                     Context *context);
+    std::unique_ptr<SelectCursor> select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
+                                              const std::vector<TabCol> &sel_cols, Context *context);
+    bool fetch_rows(SelectCursor &cursor, Context *context);
 
     void run_dml(std::unique_ptr<AbstractExecutor> exec);
     static std::unordered_set<Value> sub_select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot, bool converse_to_float = false);
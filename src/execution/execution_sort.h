@@ -169,7 +169,7 @@ private:
 
     // 从文件流读取下一条记录
     std::unique_ptr<RmRecord> readNextRecord(std::ifstream &in) {
-        auto record = std::make_unique<RmRecord>(record_size);
+        auto record = make_record(record_size);
         in.read(record->data, record_size);
         if (in.gcount() != static_cast<std::streamsize>(record_size)) {
             if (in.eof()) return nullptr;
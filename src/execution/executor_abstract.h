@@ -18,11 +18,16 @@ See the Mulan PSL v2 for more details. */
 class AbstractExecutor
 {
 public:
-    Context *context_;
+    Context *context_ = nullptr;
     AbstractExecutor() = default;
     AbstractExecutor(Context *context) : context_(context) {}
     virtual ~AbstractExecutor() = default;
 
+    // 中间元组的数据从会话的TupleArena中分配，语句结束时由Portal::drop()整体回收
+    TupleArena *tuple_arena() const { return context_ ? &context_->arena_ : nullptr; }
+
+    std::unique_ptr<RmRecord> make_record(int size) { return std::make_unique<RmRecord>(size, tuple_arena()); }
+
     virtual size_t tupleLen() const { return 0; };
 
     virtual const std::vector<ColMeta> &cols() const
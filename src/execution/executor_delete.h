@@ -87,13 +87,13 @@ public:
                 throw TransactionAbortException(context_->txn_->get_transaction_id(),
                                                 AbortReason::UPGRADE_CONFLICT);
             }
-            // 删除记录
-            fh_->delete_record(rid, context_);
-
-            // 记录日志
+            // 先记录日志再删除记录，数据页写回时删除对应的日志已经在日志缓冲区中
             DeleteLogRecord log_record(context_->txn_->get_transaction_id(),
                                        rec, rid, tab_name_);
             context_->log_mgr_->add_log_to_buffer(&log_record);
+
+            // 删除记录
+            fh_->delete_record(rid, context_);
             if (context_->txn_->get_txn_manager()->get_concurrency_mode() !=
                 ConcurrencyMode::MVCC)
             {
@@ -380,7 +380,7 @@ public:
             return std::move(prev_record);
 
         // 创建新的投影记录
-        auto projected_record = std::make_unique<RmRecord>(len_);
+        auto projected_record = make_record(len_);
 
         // 获取原始记录的列信息
         const auto &prev_cols = tab_.cols;
@@ -77,7 +77,12 @@ public:
                                             AbortReason::UPGRADE_CONFLICT);
         }
         txn_mgr->set_record_txn_id(rec.data, context_->txn_, false);
-        rid_ = fh_->insert_record(rec.data, context_);
+        // 插入日志在数据页取消固定之前写入，保证数据页写回时日志已经可以持久化
+        rid_ = fh_->insert_record(rec.data, context_, [this, &rec](const Rid &rid)
+                                  {
+                                      InsertLogRecord log_record(context_->txn_->get_transaction_id(), rec, rid, tab_name_);
+                                      context_->log_mgr_->add_log_to_buffer(&log_record);
+                                  });
         context_->txn_->append_write_record(new WriteRecord(WType::INSERT_TUPLE,
                                                             tab_name_, rid_));
 
@@ -95,10 +100,6 @@ public:
             }
             ihs_[id]->insert_entry(key.get(), rid_, context_->txn_);
         }
-
-        // 记录日志
-        InsertLogRecord log_record(context_->txn_->get_transaction_id(), rec, rid_, tab_name_);
-        context_->log_mgr_->add_log_to_buffer(&log_record);
         return {};
     }
 
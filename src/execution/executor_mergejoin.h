@@ -58,7 +58,7 @@ private:
     std::unique_ptr<RmRecord> get_left_key(size_t idx) {
         auto cond = fed_conds_[0];
         auto left_col = left_->get_col(left_->cols(), cond.lhs_col);
-        auto key_rec = std::make_unique<RmRecord>(left_col->len);
+        auto key_rec = make_record(left_col->len);
         memcpy(key_rec->data, left_cache_[idx]->data + left_col->offset, left_col->len);
         return key_rec;
     }
@@ -67,7 +67,7 @@ private:
     std::unique_ptr<RmRecord> get_right_key(size_t idx) {
         auto cond = fed_conds_[0];
         auto right_col = right_->get_col(right_->cols(), cond.rhs_col);
-        auto key_rec = std::make_unique<RmRecord>(right_col->len);
+        auto key_rec = make_record(right_col->len);
         memcpy(key_rec->data, right_cache_[idx]->data + right_col->offset, right_col->len);
         return key_rec;
     }
@@ -109,7 +109,7 @@ public:
     MergeJoinExecutor(std::unique_ptr<AbstractExecutor> left, 
                      std::unique_ptr<AbstractExecutor> right,
                      const std::vector<Condition> &conds)
-        : left_(std::move(left)), right_(std::move(right)), 
+        : AbstractExecutor(left->context_), left_(std::move(left)), right_(std::move(right)),
           fed_conds_(conds) {
         len_ = left_->tupleLen() + right_->tupleLen();
         cols_ = left_->cols();
@@ -163,7 +163,7 @@ public:
                 // 生成笛卡尔积
                 for (size_t l = left_start; l < left_idx_ && batch.size() < batch_size; l++) {
                     for (size_t r = right_start; r < right_idx_ && batch.size() < batch_size; r++) {
-                        auto record = std::make_unique<RmRecord>(len_);
+                        auto record = make_record(len_);
                         std::memcpy(record->data, left_cache_[l]->data, left_->tupleLen());
                         std::memcpy(record->data + left_->tupleLen(), right_cache_[r]->data, right_->tupleLen());
                         batch.push_back(std::move(record));
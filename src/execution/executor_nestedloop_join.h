@@ -101,7 +101,7 @@ public:
     NestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor> left, 
                          std::unique_ptr<AbstractExecutor> right,
                          const std::vector<Condition> &conds)
-        : left_(std::move(left)), right_(std::move(right)),
+        : AbstractExecutor(left->context_), left_(std::move(left)), right_(std::move(right)),
           fed_conds_(std::move(conds)) {
         int left_tupleLen = left_->tupleLen();
         len_ = left_tupleLen + right_->tupleLen();
@@ -148,7 +148,7 @@ public:
             
             if (valid) {
                 // 创建连接后的记录
-                auto record = std::make_unique<RmRecord>(len_);
+                auto record = make_record(len_);
                 std::memcpy(record->data, left_rec->data, left_->tupleLen());
                 std::memcpy(record->data + left_->tupleLen(), right_rec->data, right_->tupleLen());
                 result.emplace_back(std::move(record));
@@ -32,7 +32,7 @@ private:
 
 public:
     ProjectionExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols)
-        : prev_(std::move(prev))
+        : AbstractExecutor(prev->context_), prev_(std::move(prev))
     {
         auto &prev_cols = prev_->cols();
         cols_.reserve(sel_cols.size());
@@ -71,7 +71,7 @@ public:
         const std::vector<ColMeta> &prev_cols)
     {        
         // 创建新的投影记录
-        auto projected_record = std::make_unique<RmRecord>(tuple_len_);
+        auto projected_record = make_record(tuple_len_);
 
         // 复制选定的列到新记录中
         for (size_t i = 0; i < cols_.size(); ++i)
@@ -120,7 +120,7 @@ private:
             
             // 如果匹配，加入结果集
             if (matched) {
-                RmRecord result_rec(len_);
+                RmRecord result_rec(len_, tuple_arena());
                 memcpy(result_rec.data, left_rec.data, len_);
                 result_batch_.push_back(std::move(result_rec));
             }
@@ -138,7 +138,7 @@ private:
 public:
     SemiJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
                     const std::vector<Condition> &conds)
-        : left_(std::move(left)), right_(std::move(right)),
+        : AbstractExecutor(left->context_), left_(std::move(left)), right_(std::move(right)),
         len_(left_->tupleLen()), cols_(left_->cols()),
         fed_conds_(std::move(conds)), 
         left_batch_pos_(0), right_batch_pos_(0), result_pos_(0),
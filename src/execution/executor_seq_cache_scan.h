@@ -88,23 +88,22 @@ public:
 
         // 对条件进行排序，以便后续处理
         std::sort(fed_conds_.begin(), fed_conds_.end());
-        scan_ = std::make_unique<RmScan_Final>(fh_, context_);
+        scan_ = std::make_unique<RmScan_Final>(fh_, context_, true);
     }
     void beginTuple() override
     {
         if (cache_index_ == INF)
         {
-            while (!scan_->is_end())
+            while (scan_->load_view())
             {
-                auto scan_batch = scan_->record_batch();
-                for (auto &rec : scan_batch)
+                for (auto &rec : scan_->view_records())
                 {
-                    if (satisfy_conditions(rec.get()))
+                    if (satisfy_conditions(&rec))
                     {
                         result_cache_.emplace_back(project(rec));
                     }
                 }
-                scan_->next_batch();
+                scan_->release_view();
             }
         }
         cache_index_ = 0;
@@ -157,13 +156,18 @@ public:
         }
     }
 
-    std::unique_ptr<RmRecord> project(std::unique_ptr<RmRecord> &prev_record)
+    // 扫描得到的记录是缓冲池帧的视图，输出的记录总是复制一份，只复制选中的列
+    std::unique_ptr<RmRecord> project(const RmRecord &prev_record)
     {
         if (cols_.empty())
-            return std::move(prev_record);
+        {
+            auto record = make_record(prev_record.size);
+            memcpy(record->data, prev_record.data, prev_record.size);
+            return record;
+        }
 
         // 创建新的投影记录
-        auto projected_record = std::make_unique<RmRecord>(len_);
+        auto projected_record = make_record(len_);
 
         // 获取原始记录的列信息
         const auto &prev_cols = tab_.cols;
@@ -176,7 +180,7 @@ public:
 
             // 从原记录复制数据到新记录
             memcpy(projected_record->data + dst_col.offset,
-                   prev_record->data + src_col.offset,
+                   prev_record.data + src_col.offset,
                    src_col.len);
         }
 
@@ -78,7 +78,7 @@ public:
         fh_ = sm_manager_->get_table_handle(tab_name_);
         len_ = tab_.cols.back().offset + tab_.cols.back().len;
         std::sort(fed_conds_.begin(), fed_conds_.end());
-        scan_ = std::make_unique<RmScan_Final>(fh_, context_);
+        scan_ = std::make_unique<RmScan_Final>(fh_, context_, true);
     }
 
     // 批量获取下一个batch_size个满足条件的元组，最少一页，最多batch_size且为页的整数倍
@@ -86,17 +86,17 @@ public:
     {
         std::vector<std::unique_ptr<RmRecord>> batch;
         batch.reserve(batch_size);
-        while (batch.size() < batch_size && !scan_->is_end())
+        // 直接在缓冲池帧上检查条件，只有满足条件的记录才复制出来
+        while (batch.size() < batch_size && scan_->load_view())
         {
-            auto scan_batch = scan_->record_batch();
-            for (auto &rec : scan_batch)
+            for (auto &rec : scan_->view_records())
             {
-                if (satisfy_conditions(rec.get()))
+                if (satisfy_conditions(&rec))
                 {
                     batch.emplace_back(project(rec));
                 }
             }
-            scan_->next_batch();
+            scan_->release_view();
         }
         return batch;
     }
@@ -106,19 +106,20 @@ public:
     {
         std::vector<Rid> batch;
         batch.reserve(batch_size);
-        while (batch.size() < batch_size && !scan_->is_end())
+        // 返回之前释放视图，调用者之后会修改这些记录
+        while (batch.size() < batch_size && scan_->load_view())
         {
-            auto scan_batch = scan_->record_batch();
+            auto &scan_batch = scan_->view_records();
             auto rids = scan_->rid_batch();
             assert(rids.size() == scan_batch.size());
             for (size_t id = 0; id < scan_batch.size(); id++)
             {
-                if (satisfy_conditions(scan_batch[id].get()))
+                if (satisfy_conditions(&scan_batch[id]))
                 {
                     batch.emplace_back(rids[id]);
                 }
             }
-            scan_->next_batch();
+            scan_->release_view();
         }
         return batch;
     }
@@ -145,13 +146,18 @@ public:
         }
     }
 
-    std::unique_ptr<RmRecord> project(std::unique_ptr<RmRecord> &prev_record)
+    // 扫描得到的记录是缓冲池帧的视图，输出的记录总是复制一份，只复制选中的列
+    std::unique_ptr<RmRecord> project(const RmRecord &prev_record)
     {
         if (cols_.empty())
-            return std::move(prev_record);
+        {
+            auto record = make_record(prev_record.size);
+            memcpy(record->data, prev_record.data, prev_record.size);
+            return record;
+        }
 
         // 创建新的投影记录
-        auto projected_record = std::make_unique<RmRecord>(len_);
+        auto projected_record = make_record(len_);
 
         // 获取原始记录的列信息
         const auto &prev_cols = tab_.cols;
@@ -164,7 +170,7 @@ public:
 
             // 从原记录复制数据到新记录
             memcpy(projected_record->data + dst_col.offset,
-                   prev_record->data + src_col.offset,
+                   prev_record.data + src_col.offset,
                    src_col.len);
         }
 
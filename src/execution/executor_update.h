@@ -83,6 +83,40 @@ private:
         }
     }
 
+    // 变长格式中更新后的记录在原来的页面中放不下，删除原记录后重新插入，所有索引指向新的位置
+    void relocate(RmRecord &old_rec, RmRecord &rec, Rid &rid)
+    {
+        TransactionManager *txn_mgr = context_->txn_->get_txn_manager();
+        DeleteLogRecord delete_log(context_->txn_->get_transaction_id(), old_rec, rid, tab_name_);
+        context_->log_mgr_->add_log_to_buffer(&delete_log);
+        fh_->delete_record(rid, context_);
+        if (txn_mgr->get_concurrency_mode() != ConcurrencyMode::MVCC)
+            context_->txn_->append_write_record(new WriteRecord(WType::DELETE_TUPLE, tab_name_, rid, old_rec));
+
+        txn_mgr->set_record_txn_id(rec.data, context_->txn_, false);
+        Rid new_rid = fh_->insert_record(rec.data, context_, [this, &rec](const Rid &new_rid)
+                                         {
+                                             InsertLogRecord insert_log(context_->txn_->get_transaction_id(), rec, new_rid, tab_name_);
+                                             context_->log_mgr_->add_log_to_buffer(&insert_log);
+                                         });
+        context_->txn_->append_write_record(new WriteRecord(WType::INSERT_TUPLE, tab_name_, new_rid));
+
+        // update_indexes()已经把修改过的索引换成新的键，这里只需要改变所有索引项的位置
+        for (auto &index : tab_.indexes)
+        {
+            auto ih = sm_manager_->get_index_handle(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols));
+            std::unique_ptr<char[]> key(new char[index.col_tot_len]);
+            int offset = 0;
+            for (int i = 0; i < index.col_num; ++i)
+            {
+                memcpy(key.get() + offset, rec.data + index.cols[i].offset, index.cols[i].len);
+                offset += index.cols[i].len;
+            }
+            ih->delete_entry(key.get(), rid, context_->txn_);
+            ih->insert_entry(key.get(), new_rid, context_->txn_);
+        }
+    }
+
 public:
     UpdateExecutor(SmManager *sm_manager, const std::string &tab_name, const std::vector<SetClause> &set_clauses,
                    const std::vector<Rid> &rids, Context *context)
@@ -240,11 +274,14 @@ public:
                 throw TransactionAbortException(context_->txn_->get_transaction_id(),
                                                 AbortReason::UPGRADE_CONFLICT);
             }
-            fh_->update_record(rid, rec.data, context_);
-
-            // 记录日志
+            // 更新日志在数据页取消固定之前写入，数据页写回时更新对应的日志已经在日志缓冲区中
             UpdateLogRecord log_record(context_->txn_->get_transaction_id(), rid, old_rec, rec, tab_name_);
-            context_->log_mgr_->add_log_to_buffer(&log_record);
+            if (!fh_->update_record(rid, rec.data, context_, [this, &log_record]()
+                                    { context_->log_mgr_->add_log_to_buffer(&log_record); }))
+            {
+                relocate(old_rec, rec, rid);
+                continue;
+            }
 
             if (txn_mgr->get_concurrency_mode() != ConcurrencyMode::MVCC)
             {
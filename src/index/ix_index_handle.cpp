@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #include "ix_index_handle.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "ix_scan.h"
 
 /**
@@ -84,8 +87,9 @@ bool IxNodeHandle::leaf_lookup(const char *key, Rid **value)
 {
     // 1. 在叶子节点中获取目标key所在位置
     auto key_id = lower_bound(key);
-    // 2. 判断目标key是否存在
-    if (key_id == page_hdr->num_key)
+    // 2. 判断目标key是否存在，lower_bound()返回的是第一个不小于key的位置
+    if (key_id == page_hdr->num_key ||
+        ix_compare(get_key(key_id), key, file_hdr->col_types_, file_hdr->col_lens_) != 0)
         return false;
     // 3. 如果存在，获取key对应的Rid，并赋值给传出参数value
     // 提示：可以调用lower_bound()和get_rid()函数。
@@ -257,6 +261,8 @@ IxIndexHandle::IxIndexHandle(IxManager *ix_manager, int fd)
  * @return [leaf node] and [root_is_latched] 返回目标叶子结点以及根结点是否加锁
  * @note need to Unlatch and unpin the leaf node outside!
  * 注意：用了FindLeafPage之后一定要unlatch叶结点，否则下次latch该结点会堵塞！
+ * find_first为true时先乐观查找，版本冲突过多时从根结点开始逐层加共享latch；
+ * 叶子结点对于修改操作不安全时，以find_first=false重新查找，从根结点开始加排他latch
  */
 IxNodeHandle IxIndexHandle::find_leaf_page(const char *key, Operation operation,
                                            Transaction *transaction, bool find_first)
@@ -264,9 +270,26 @@ IxNodeHandle IxIndexHandle::find_leaf_page(const char *key, Operation operation,
     if (operation != Operation::FIND)
         assert(transaction != nullptr);
     // 1. 获取根节点
-    if (!find_first)
+    if (find_first)
+    {
+        IxNodeHandle leaf;
+        switch (find_leaf_optimistic(key, operation, transaction, &leaf))
+        {
+        case OptimisticResult::FOUND:
+            return leaf;
+        case OptimisticResult::UNSAFE:
+            optimistic_unsafe_.fetch_add(1, std::memory_order_relaxed);
+            return find_leaf_page(key, operation, transaction, false);
+        case OptimisticResult::CONFLICT:
+            optimistic_conflicts_.fetch_add(1, std::memory_order_relaxed);
+            root_lacth_.lock_shared();
+            break;
+        }
+    }
+    else
     {
         root_lacth_.lock();
+        root_version_.fetch_add(1);
         transaction->append_index_latch_page_set(nullptr);
     }
 
@@ -326,6 +349,99 @@ IxNodeHandle IxIndexHandle::find_leaf_page(const char *key, Operation operation,
     }
 }
 
+/**
+ * @brief 乐观锁耦合：内部结点不加latch，读取结点前记下版本号，读到孩子结点编号后验证版本号没有变化；
+ * 进入孩子结点后再验证一次父结点，保证孩子结点没有在读取编号之后被删除或者分裂。
+ * 只有叶子结点加latch：查找加共享latch，插入和删除加排他latch并加入事务的index_latch_page_set
+ * @param[out] leaf 找到的叶子结点，已经加latch并固定
+ * @return 版本冲突超过OPTIMISTIC_RETRIES次时返回CONFLICT；叶子结点对于修改操作不安全时返回UNSAFE，
+ * 这两种情况下没有持有任何latch和固定的页面
+ */
+IxIndexHandle::OptimisticResult IxIndexHandle::find_leaf_optimistic(const char *key, Operation operation,
+                                                                    Transaction *transaction, IxNodeHandle *leaf)
+{
+    BufferPoolManager_Final *buffer_pool_manager_ = ix_manager_->buffer_pool_manager_;
+    for (int attempt = 0; attempt < OPTIMISTIC_RETRIES; attempt++)
+    {
+        if (attempt > 0)
+            std::this_thread::yield();
+        // 根结点编号可能正在被持有root_lacth_排他锁的线程修改
+        uint64_t root_version = root_version_.load(std::memory_order_acquire);
+        if (root_version & 1)
+            continue;
+        page_id_t page_no = file_hdr_->root_page_;
+
+        IxNodeHandle parent{};
+        parent.page = nullptr;
+        uint64_t parent_version = root_version;
+        while (true)
+        {
+            auto node = fetch_node(page_no);
+            uint64_t version = node.page->read_version();
+            bool valid = parent.page != nullptr ? parent.page->validate(parent_version)
+                                                : root_version_.load(std::memory_order_acquire) == root_version;
+            if (parent.page != nullptr)
+                buffer_pool_manager_->unpin_page(parent.get_page_id(), false);
+            if (!valid || (version & 1) || !node.is_consistent())
+            {
+                buffer_pool_manager_->unpin_page(node.get_page_id(), false);
+                break;
+            }
+
+            if (node.is_leaf_page())
+            {
+                // 加latch之前结点可能已经被修改：共享latch不改变版本号，排他latch使版本号加1
+                uint64_t expected = version;
+                if (operation == Operation::FIND)
+                    node.page->lock_shared();
+                else
+                {
+                    node.page->lock();
+                    expected++;
+                }
+                if (!node.page->validate(expected) || !node.is_leaf_page())
+                {
+                    if (operation == Operation::FIND)
+                        unlock_shared(node);
+                    else
+                    {
+                        node.page->unlock();
+                        buffer_pool_manager_->unpin_page(node.get_page_id(), false);
+                    }
+                    break;
+                }
+                if (operation != Operation::FIND)
+                {
+                    if (!node.is_safe(operation))
+                    {
+                        node.page->unlock();
+                        buffer_pool_manager_->unpin_page(node.get_page_id(), false);
+                        return OptimisticResult::UNSAFE;
+                    }
+                    transaction->append_index_latch_page_set(node.page);
+                }
+                *leaf = node;
+                return OptimisticResult::FOUND;
+            }
+
+            if (node.get_size() == 0)
+            {
+                buffer_pool_manager_->unpin_page(node.get_page_id(), false);
+                break;
+            }
+            page_no = node.internal_lookup(key);
+            if (!node.page->validate(version))
+            {
+                buffer_pool_manager_->unpin_page(node.get_page_id(), false);
+                break;
+            }
+            parent = node;
+            parent_version = version;
+        }
+    }
+    return OptimisticResult::CONFLICT;
+}
+
 /**
  * @brief 用于查找指定键在叶子结点中的对应的值result
  *
@@ -337,10 +453,12 @@ IxNodeHandle IxIndexHandle::find_leaf_page(const char *key, Operation operation,
 bool IxIndexHandle::get_value(const char *key, Rid *result, Transaction *transaction)
 {
     // 1. 获取目标key值所在的叶子结点
-    root_lacth_.lock_shared();
     auto leaf = find_leaf_page(key, Operation::FIND, transaction);
     // 2. 在叶子节点中查找目标key值的位置，并读取key对应的rid
-    bool exist = leaf.leaf_lookup(key, &result);
+    Rid *rid = nullptr;
+    bool exist = leaf.leaf_lookup(key, &rid);
+    if (exist)
+        *result = *rid;
     unlock_shared(leaf);
 
     // 3. 把rid存入result参数中
@@ -444,7 +562,6 @@ void IxIndexHandle::insert_into_parent(IxNodeHandle &old_node, const char *key,
 page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transaction *transaction, bool abort)
 {
     // 1. 查找key值应该插入到哪个叶子节点
-    root_lacth_.lock_shared();
     auto leaf_node = find_leaf_page(key, Operation::INSERT, transaction);
     // 2. 在该叶子节点中插入键值对
     try
@@ -483,7 +600,6 @@ page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transac
 bool IxIndexHandle::delete_entry(const char *key, const Rid &value, Transaction *transaction, bool abort)
 {
     // 1. 获取该键值对所在的叶子结点
-    root_lacth_.lock_shared();
     auto leaf_node = find_leaf_page(key, Operation::DELETE, transaction);
 
     int index = leaf_node.lower_bound(key);
@@ -525,7 +641,7 @@ bool IxIndexHandle::coalesce_or_redistribute_internal(IxNodeHandle &node, Transa
     //    1.2 如果不是根节点，并且不需要执行合并或重分配操作，则直接返回false，否则执行2
     if (node.page_hdr->num_key >= node.get_min_size())
     {
-        maintain_parent(node);
+        maintain_parent(node, transaction);
         return false;
     }
 
@@ -546,7 +662,7 @@ bool IxIndexHandle::coalesce_or_redistribute_internal(IxNodeHandle &node, Transa
     // NodeMinSize*2)，则只需要重新分配键值对（调用Redistribute函数）
     if (node.page_hdr->num_key + neighbor_node.page_hdr->num_key >= (node.get_min_size() << 1))
     {
-        redistribute(neighbor_node, node, parent_node, idx);
+        redistribute(neighbor_node, node, parent_node, idx, transaction);
         neighbor_node.page->unlock();
         buffer_pool_manager_->unpin_page(neighbor_node.get_page_id(), true);
         buffer_pool_manager_->unpin_page(parent_node.get_page_id(), false);
@@ -581,7 +697,7 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle &node, Transaction *tr
     //    1.2 如果不是根节点，并且不需要执行合并或重分配操作，则直接返回false，否则执行2
     if (node.page_hdr->num_key >= node.get_min_size())
     {
-        maintain_parent(node);
+        maintain_parent(node, transaction);
         return false;
     }
 
@@ -604,7 +720,7 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle &node, Transaction *tr
     // NodeMinSize*2)，则只需要重新分配键值对（调用Redistribute函数）
     if (node.page_hdr->num_key + neighbor_node.page_hdr->num_key >= (node.get_min_size() << 1))
     {
-        redistribute(neighbor_node, node, parent_node, idx);
+        redistribute(neighbor_node, node, parent_node, idx, transaction);
         if (idx == 0)
             neighbor_node.page->unlock();
         buffer_pool_manager_->unpin_page(neighbor_node.get_page_id(), true);
@@ -664,7 +780,8 @@ bool IxIndexHandle::adjust_root(IxNodeHandle &old_root_node)
  * 注意更新parent结点的相关kv对
  */
 
-void IxIndexHandle::redistribute(IxNodeHandle &neighbor_node, IxNodeHandle &node, IxNodeHandle &parent, int index)
+void IxIndexHandle::redistribute(IxNodeHandle &neighbor_node, IxNodeHandle &node, IxNodeHandle &parent, int index,
+                                 Transaction *transaction)
 {
 
     auto erase_pos_ = index ? neighbor_node.page_hdr->num_key - 1 : 0;
@@ -676,7 +793,7 @@ void IxIndexHandle::redistribute(IxNodeHandle &neighbor_node, IxNodeHandle &node
 
     maintain_child(node, insert_pos_);
 
-    maintain_parent(index ? node : neighbor_node);
+    maintain_parent(index ? node : neighbor_node, transaction);
     // 1. 通过index判断neighbor_node是否为node的前驱结点
     // 2. 从neighbor_node中移动一个键值对到node结点中
     // 3. 更新父节点中的相关信息，并且修改移动键值对对应孩字结点的父结点信息（maintain_child函数）
@@ -755,7 +872,6 @@ Rid IxIndexHandle::get_rid(const Iid &iid) const
  */
 std::pair<IxNodeHandle, int> IxIndexHandle::lower_bound(const char *key)
 {
-    root_lacth_.lock_shared();
     auto node = find_leaf_page(key, Operation::FIND, nullptr);
 
     int key_idx = node.lower_bound(key);
@@ -776,7 +892,6 @@ std::pair<IxNodeHandle, int> IxIndexHandle::lower_bound(const char *key)
  */
 std::pair<IxNodeHandle, int> IxIndexHandle::upper_bound(const char *key)
 {
-    root_lacth_.lock_shared();
     auto node = find_leaf_page(key, Operation::FIND, nullptr);
 
     int key_idx = node.upper_bound_adjust(key);
@@ -895,31 +1010,43 @@ IxNodeHandle IxIndexHandle::create_node()
 
 /**
  * @brief 从node开始更新其父节点的第一个key，一直向上更新直到根节点
+ * 修改父结点必须持有它的排他latch，乐观读取的线程才能通过版本号发现修改：事务已经持有的父结点直接修改，
+ * 否则尝试加latch。自底向上加latch可能与自顶向下加latch的写者死锁，所以加latch失败时放弃更新。
+ * 这种情况只出现在删除安全的叶子结点的第一个key之后，父结点中的key仍然不大于子树中的所有key，查找结果不变
  *
  * @param node
+ * @param transaction 持有的排他latch记录在它的index_latch_page_set中，可以为nullptr
  */
-void IxIndexHandle::maintain_parent(IxNodeHandle &node)
+void IxIndexHandle::maintain_parent(IxNodeHandle &node, Transaction *transaction)
 {
     IxNodeHandle curr = node;
     BufferPoolManager_Final *buffer_pool_manager_ = ix_manager_->buffer_pool_manager_;
+    auto latch_set = transaction != nullptr ? transaction->get_index_latch_page_set() : nullptr;
     while (curr.get_parent_page_no() != IX_NO_PAGE)
     {
         // Load its parent
         IxNodeHandle parent = fetch_node(curr.get_parent_page_no());
-        int rank = parent.find_child(curr);
-        char *parent_key = parent.get_key(rank);
-        char *child_first_key = curr.get_key(0);
-        if (memcmp(parent_key, child_first_key, file_hdr_->col_tot_len_) == 0)
+        bool held = latch_set != nullptr && std::find(latch_set->begin(), latch_set->end(), parent.page) != latch_set->end();
+        if (!held && !parent.page->try_lock())
         {
-            [[maybe_unused]] bool ret = buffer_pool_manager_->unpin_page(parent.get_page_id(), true);
+            [[maybe_unused]] bool ret = buffer_pool_manager_->unpin_page(parent.get_page_id(), false);
             assert(ret);
             break;
         }
-        memcpy(parent_key, child_first_key, file_hdr_->col_tot_len_); // 修改了parent node
+        int rank = parent.find_child(curr);
+        char *parent_key = parent.get_key(rank);
+        char *child_first_key = curr.get_key(0);
+        bool changed = memcmp(parent_key, child_first_key, file_hdr_->col_tot_len_) != 0;
+        if (changed)
+            memcpy(parent_key, child_first_key, file_hdr_->col_tot_len_); // 修改了parent node
+        if (!held)
+            parent.page->unlock();
         curr = parent;
 
-        [[maybe_unused]] bool ret = buffer_pool_manager_->unpin_page(parent.get_page_id(), true);
+        [[maybe_unused]] bool ret = buffer_pool_manager_->unpin_page(parent.get_page_id(), changed);
         assert(ret);
+        if (!changed)
+            break;
     }
 }
 void IxIndexHandle::maintain_child(IxNodeHandle &node, int child_idx)
@@ -942,6 +1069,7 @@ void IxIndexHandle::release_all_xlock(std::shared_ptr<std::deque<Page_Final *>>
         page_set->pop_front();
         if (node == nullptr)
         {
+            root_version_.fetch_add(1);
             root_lacth_.unlock();
         }
         else
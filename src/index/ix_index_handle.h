@@ -175,6 +175,12 @@ public:
     }
 
     bool is_safe(Operation operation);
+
+    // 不加latch读取结点时，结点可能正在被修改，使用其中的键数之前检查它是否在合法范围内
+    inline bool is_consistent() const
+    {
+        return page_hdr->num_key >= 0 && page_hdr->num_key <= file_hdr->btree_order_ + 1;
+    }
 };
 
 /* B+树 */
@@ -188,8 +194,22 @@ private:
     int fd_;                // 存储B+树的文件
     IxFileHdr *file_hdr_;   // 存了root_page，但其初始化为2（第0页存FILE_HDR_PAGE，第1页存LEAF_HEADER_PAGE）
     std::shared_mutex root_lacth_;
+    // 根结点编号的版本号，持有root_lacth_排他锁期间为奇数，乐观查找用它验证读到的根结点编号
+    std::atomic<uint64_t> root_version_{0};
     bool is_deleted = false;
 
+    // 乐观查找的结果：找到叶子结点；叶子结点对于修改操作不安全，需要从根结点开始加排他latch；版本冲突次数过多
+    enum class OptimisticResult
+    {
+        FOUND,
+        UNSAFE,
+        CONFLICT
+    };
+    static constexpr int OPTIMISTIC_RETRIES = 8; // 版本冲突时重试的次数，之后退回到逐层加latch
+    // 乐观查找因为版本冲突或者叶子结点不安全而退回到逐层加latch的次数
+    std::atomic<uint64_t> optimistic_conflicts_{0};
+    std::atomic<uint64_t> optimistic_unsafe_{0};
+
 public:
     IxIndexHandle(IxManager *ix_manager, int fd);
     ~IxIndexHandle()
@@ -209,6 +229,8 @@ public:
 
     inline int get_fd() { return fd_; }
     inline void mark_deleted() { is_deleted = true; }
+    inline uint64_t optimistic_conflicts() const { return optimistic_conflicts_.load(std::memory_order_relaxed); }
+    inline uint64_t optimistic_unsafe() const { return optimistic_unsafe_.load(std::memory_order_relaxed); }
 
     // for search
     // bool get_value(const char *key, std::vector<Rid> *result, Transaction *transaction);
@@ -231,7 +253,8 @@ public:
     bool coalesce_or_redistribute_internal(IxNodeHandle &node, Transaction *transaction);
     bool adjust_root(IxNodeHandle &old_root_node);
 
-    void redistribute(IxNodeHandle &neighbor_node, IxNodeHandle &node, IxNodeHandle &parent, int index);
+    void redistribute(IxNodeHandle &neighbor_node, IxNodeHandle &node, IxNodeHandle &parent, int index,
+                      Transaction *transaction);
 
     bool coalesce(IxNodeHandle neighbor_node, IxNodeHandle node, IxNodeHandle &parent, int index, Transaction *transaction);
 
@@ -258,7 +281,7 @@ private:
     IxNodeHandle create_node();
 
     // for maintain data structure
-    void maintain_parent(IxNodeHandle &node);
+    void maintain_parent(IxNodeHandle &node, Transaction *transaction);
 
     // void erase_leaf(IxNodeHandle &leaf);
 
@@ -266,6 +289,9 @@ private:
 
     void release_all_xlock(std::shared_ptr<std::deque<Page_Final *>> page_set, bool dirty);
 
+    OptimisticResult find_leaf_optimistic(const char *key, Operation operation, Transaction *transaction,
+                                          IxNodeHandle *leaf);
+
     // for index test
     Rid get_rid(const Iid &iid) const;
 };
\ No newline at end of file
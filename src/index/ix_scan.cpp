@@ -28,6 +28,10 @@ void IxScan::next_batch() {
     // 先获取新节点并加锁，再释放当前节点锁，避免锁空窗
     IxNodeHandle new_node = ih_->fetch_node(next_leaf);
     ih_->lock_shared(new_node);
+    // 预读再下一个叶子结点，读取它和处理当前结点重叠
+    page_id_t ahead = new_node.get_next_leaf();
+    if (ahead != IX_LEAF_HEADER_PAGE)
+        bpm_->prefetch(ih_->get_fd(), ahead, 1);
     ih_->unlock_shared(node_);
     node_ = std::move(new_node);
     pos_ = 0;
@@ -52,6 +52,8 @@ public:
             return std::make_shared<OtherPlan>(T_Help);
         case ast::TreeNodeType::ShowTables:
             return std::make_shared<OtherPlan>(T_ShowTable);
+        case ast::TreeNodeType::ShowStatus:
+            return std::make_shared<OtherPlan>(T_ShowStatus);
         case ast::TreeNodeType::DescTable:
         {
             auto x = std::static_pointer_cast<ast::DescTable>(query->parse);
@@ -70,7 +72,7 @@ public:
         case ast::TreeNodeType::SetStmt:
         {
             auto x = std::static_pointer_cast<ast::SetStmt>(query->parse);
-            return std::make_shared<SetKnobPlan>(x->set_knob_type_, x->bool_val_);
+            return std::make_shared<SetKnobPlan>(x->set_knob_type_, x->bool_val_, x->str_val_);
         }
         case ast::TreeNodeType::ExplainStmt:
         {
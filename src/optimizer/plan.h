@@ -24,6 +24,7 @@ typedef enum PlanTag
     T_Invalid = 1,
     T_Help,
     T_ShowTable,
+    T_ShowStatus,
     T_DescTable,
     T_CreateTable,
     T_DropTable,
@@ -190,6 +191,7 @@ public:
     std::string tab_name_;
     std::vector<std::string> tab_col_names_;
     std::vector<ColDef> cols_;
+    bool slotted_ = false; // 建表时使用变长格式
 };
 
 // help; show tables; desc tables; begin; abort; commit; rollback语句对应的plan
@@ -234,11 +236,12 @@ public:
 class SetKnobPlan : public Plan
 {
 public:
-    SetKnobPlan(ast::SetKnobType set_knob_type, bool bool_val)
-        : Plan(T_SetKnob), set_knob_type_(set_knob_type), bool_val_(bool_val) {}
+    SetKnobPlan(ast::SetKnobType set_knob_type, bool bool_val, std::string str_val = "")
+        : Plan(T_SetKnob), set_knob_type_(set_knob_type), bool_val_(bool_val), str_val_(std::move(str_val)) {}
     ~SetKnobPlan() {}
     ast::SetKnobType set_knob_type_;
     bool bool_val_;
+    std::string str_val_;
 };
 
 class AggPlan : public Plan
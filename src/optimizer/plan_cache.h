@@ -0,0 +1,391 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "errors.h"
+#include "analyze/analyze.h"
+#include "optimizer.h"
+#include "plan.h"
+#include "planner.h"
+
+// 缓存的执行计划：保存参数化语法树分析得到的Query和Plan，再次执行时只需要把常量绑定到参数占位符上
+struct CachedPlan
+{
+    // 计划中需要绑定参数的位置
+    struct BindSite
+    {
+        Value *val;   // 指向计划中的参数占位符
+        bool is_cond; // 是否位于条件表达式中
+    };
+
+    std::shared_ptr<ast::TreeNode> stmt; // 参数化后的语法树，失效后据此重新生成计划
+    std::shared_ptr<Query> query;
+    std::shared_ptr<Plan> plan;
+    std::vector<BindSite> bind_sites;
+    int param_count = 0;
+    uint64_t schema_version = 0; // 生成计划时SmManager的模式版本号
+    uint64_t knob_version = 0;   // 生成计划时Planner的规划参数版本号
+};
+
+// 会话私有的计划缓存，包括PREPARE创建的预编译语句和按规范化SQL自动缓存的计划
+// 执行时会直接修改计划中的参数，所以不能在会话之间共享
+class PlanCache
+{
+private:
+    static constexpr size_t MAX_CACHED_PLANS = 64;
+
+    SmManager *sm_manager_;
+    Analyze *analyze_;
+    Optimizer *optimizer_;
+    Planner *planner_;
+
+    // 规范化SQL -> 计划，按LRU淘汰
+    std::list<std::string> lru_list_;
+    std::unordered_map<std::string, std::pair<std::shared_ptr<CachedPlan>, std::list<std::string>::iterator>> plans_;
+    // PREPARE的名字 -> 计划
+    std::unordered_map<std::string, std::shared_ptr<CachedPlan>> prepared_;
+
+public:
+    PlanCache(SmManager *sm_manager, Analyze *analyze, Optimizer *optimizer, Planner *planner)
+        : sm_manager_(sm_manager), analyze_(analyze), optimizer_(optimizer), planner_(planner) {}
+
+    /**
+     * @description: 给语法树中的参数占位符按出现顺序编号，literals不为空时同时把常量替换成参数占位符
+     * @return {int} 参数个数
+     * @param {shared_ptr<ast::TreeNode>&} stmt 语法树
+     * @param {vector<shared_ptr<ast::Value>>} *literals 按出现顺序保存被替换掉的常量
+     */
+    static int parameterize(const std::shared_ptr<ast::TreeNode> &stmt, std::vector<std::shared_ptr<ast::Value>> *literals)
+    {
+        int count = 0;
+        auto visit = [&](std::shared_ptr<ast::Value> &val)
+        {
+            auto type = val->Nodetype();
+            if (type == ast::TreeNodeType::Param)
+            {
+                std::static_pointer_cast<ast::Param>(val)->idx = count++;
+            }
+            else if (literals != nullptr && (type == ast::TreeNodeType::IntLit || type == ast::TreeNodeType::FloatLit ||
+                                             type == ast::TreeNodeType::StringLit))
+            {
+                literals->emplace_back(std::move(val));
+                val = std::make_shared<ast::Param>(count++);
+            }
+        };
+        auto visit_conds = [&](std::vector<std::shared_ptr<ast::BinaryExpr>> &conds)
+        {
+            for (auto &cond : conds)
+            {
+                if (cond->rhs == nullptr || cond->rhs->Nodetype() == ast::TreeNodeType::Col)
+                    continue;
+                auto val = std::static_pointer_cast<ast::Value>(cond->rhs);
+                visit(val);
+                cond->rhs = val;
+            }
+        };
+
+        // 遍历顺序与常量在语句中出现的顺序一致
+        switch (stmt->Nodetype())
+        {
+        case ast::TreeNodeType::SelectStmt:
+        {
+            auto x = std::static_pointer_cast<ast::SelectStmt>(stmt);
+            for (auto &join : x->jointree)
+                visit_conds(join->conds);
+            visit_conds(x->conds);
+            visit_conds(x->having_conds);
+            break;
+        }
+        case ast::TreeNodeType::InsertStmt:
+        {
+            auto x = std::static_pointer_cast<ast::InsertStmt>(stmt);
+            for (auto &val : x->vals)
+                visit(val);
+            break;
+        }
+        case ast::TreeNodeType::UpdateStmt:
+        {
+            auto x = std::static_pointer_cast<ast::UpdateStmt>(stmt);
+            for (auto &set_clause : x->set_clauses)
+                visit(set_clause->val);
+            visit_conds(x->conds);
+            break;
+        }
+        case ast::TreeNodeType::DeleteStmt:
+            visit_conds(std::static_pointer_cast<ast::DeleteStmt>(stmt)->conds);
+            break;
+        case ast::TreeNodeType::ExplainStmt:
+            count += parameterize(std::static_pointer_cast<ast::ExplainStmt>(stmt)->query, literals);
+            break;
+        default:
+            break;
+        }
+        return count;
+    }
+
+    /**
+     * @description: 查找自动缓存的计划，计划已失效时重新生成
+     * @return {shared_ptr<CachedPlan>} 缓存的计划，未命中时返回nullptr
+     * @param {string&} key 规范化后的SQL
+     * @param {Context*} context
+     */
+    std::shared_ptr<CachedPlan> lookup(const std::string &key, Context *context)
+    {
+        auto iter = plans_.find(key);
+        if (iter == plans_.end())
+            return nullptr;
+        lru_list_.splice(lru_list_.begin(), lru_list_, iter->second.second);
+        auto entry = iter->second.first;
+        if (!is_valid(*entry) && !build(*entry, context))
+        {
+            lru_list_.erase(iter->second.second);
+            plans_.erase(iter);
+            return nullptr;
+        }
+        return entry;
+    }
+
+    /**
+     * @description: 把语句参数化后生成计划并加入自动缓存
+     * @return {shared_ptr<CachedPlan>} 新生成的计划，语句中的常量与词法分析得到的常量不一致时返回nullptr
+     * @param {string&} key 规范化后的SQL
+     * @param {shared_ptr<ast::TreeNode>} stmt 语法树，其中的常量会被替换成参数占位符
+     * @param {vector<shared_ptr<ast::Value>>&} literals 规范化时得到的常量
+     * @param {Context*} context
+     */
+    std::shared_ptr<CachedPlan> insert(const std::string &key, std::shared_ptr<ast::TreeNode> stmt,
+                                       const std::vector<std::shared_ptr<ast::Value>> &literals, Context *context)
+    {
+        std::vector<std::shared_ptr<ast::Value>> tree_literals;
+        int count = parameterize(stmt, &tree_literals);
+        if (count != (int)literals.size() || count != (int)tree_literals.size())
+            return nullptr;
+
+        auto entry = std::make_shared<CachedPlan>();
+        entry->stmt = std::move(stmt);
+        entry->param_count = count;
+        // 多表连接的连接顺序依赖表的基数估计，只自动缓存单表语句；EXPLAIN按被解释的语句判断
+        if (!build(*entry, context))
+            return nullptr;
+        auto query = entry->query;
+        while (query->sub_query != nullptr)
+            query = query->sub_query;
+        if (query->tables.size() > 1)
+            return nullptr;
+
+        // 键已经存在时（例如旧计划重新生成失败后又插入）原地替换并移到表头，不能在LRU链表中留下第二个节点
+        auto iter = plans_.find(key);
+        if (iter != plans_.end())
+        {
+            iter->second.first = entry;
+            lru_list_.splice(lru_list_.begin(), lru_list_, iter->second.second);
+            return entry;
+        }
+        if (plans_.size() >= MAX_CACHED_PLANS)
+        {
+            plans_.erase(lru_list_.back());
+            lru_list_.pop_back();
+        }
+        lru_list_.emplace_front(key);
+        plans_.emplace(key, std::make_pair(entry, lru_list_.begin()));
+        return entry;
+    }
+
+    /**
+     * @description: PREPARE，生成预编译语句的计划
+     * @param {string&} name 预编译语句的名字
+     * @param {shared_ptr<ast::TreeNode>} stmt 含有参数占位符的语法树
+     * @param {Context*} context
+     */
+    void prepare(const std::string &name, std::shared_ptr<ast::TreeNode> stmt, Context *context)
+    {
+        if (prepared_.count(name))
+            throw PreparedStmtExistsError(name);
+        auto entry = std::make_shared<CachedPlan>();
+        entry->param_count = parameterize(stmt, nullptr);
+        entry->stmt = std::move(stmt);
+        if (!build(*entry, context))
+            throw RMDBError("Statement cannot be prepared: " + name);
+        prepared_.emplace(name, std::move(entry));
+    }
+
+    /**
+     * @description: EXECUTE，查找预编译语句，计划已失效时重新生成
+     * @return {shared_ptr<CachedPlan>} 预编译语句的计划
+     * @param {string&} name 预编译语句的名字
+     * @param {Context*} context
+     */
+    std::shared_ptr<CachedPlan> get_prepared(const std::string &name, Context *context)
+    {
+        auto iter = prepared_.find(name);
+        if (iter == prepared_.end())
+            throw PreparedStmtNotFoundError(name);
+        if (!is_valid(*iter->second) && !build(*iter->second, context))
+            throw RMDBError("Statement cannot be prepared: " + name);
+        return iter->second;
+    }
+
+    // DEALLOCATE，删除预编译语句
+    void deallocate(const std::string &name)
+    {
+        if (prepared_.erase(name) == 0)
+            throw PreparedStmtNotFoundError(name);
+    }
+
+    /**
+     * @description: 把参数绑定到计划上
+     * @return {shared_ptr<Plan>} 绑定参数后的计划
+     * @param {CachedPlan&} entry 缓存的计划
+     * @param {vector<shared_ptr<ast::Value>>&} params 按顺序排列的参数
+     */
+    static std::shared_ptr<Plan> bind(CachedPlan &entry, const std::vector<std::shared_ptr<ast::Value>> &params)
+    {
+        if ((int)params.size() != entry.param_count)
+            throw InvalidParamCountError(entry.param_count, params.size());
+
+        std::vector<Value> values;
+        values.reserve(params.size());
+        for (auto &param : params)
+        {
+            values.emplace_back(Analyze::convert_sv_value(param));
+        }
+        for (auto &site : entry.bind_sites)
+        {
+            *site.val = Analyze::bind_param(*site.val, values[site.val->param_idx], site.is_cond);
+        }
+        return entry.plan;
+    }
+
+private:
+    bool is_valid(const CachedPlan &entry) const
+    {
+        return entry.schema_version == sm_manager_->schema_version() &&
+               entry.knob_version == planner_->knob_version();
+    }
+
+    /**
+     * @description: 对参数化的语法树做语义分析并生成计划，记录计划中所有参数占位符的位置
+     * @return {bool} 每个参数都能在计划中找到对应的位置时返回true
+     */
+    bool build(CachedPlan &entry, Context *context)
+    {
+        // 先读取版本号，生成计划期间发生的DDL会让下一次执行重新生成计划
+        uint64_t schema_version = sm_manager_->schema_version();
+        uint64_t knob_version = planner_->knob_version();
+        auto query = analyze_->do_analyze(entry.stmt, context);
+        auto plan = optimizer_->plan_query(query, context);
+        std::vector<CachedPlan::BindSite> bind_sites;
+        collect_bind_sites(plan, bind_sites);
+
+        std::vector<bool> bound(entry.param_count, false);
+        for (auto &site : bind_sites)
+        {
+            if (site.val->param_idx >= entry.param_count)
+                return false;
+            bound[site.val->param_idx] = true;
+        }
+        for (bool b : bound)
+        {
+            if (!b)
+                return false;
+        }
+        // 全部成功后才更新缓存项，失败时缓存项保持失效状态
+        entry.query = std::move(query);
+        entry.plan = std::move(plan);
+        entry.bind_sites = std::move(bind_sites);
+        entry.schema_version = schema_version;
+        entry.knob_version = knob_version;
+        return true;
+    }
+
+    static void collect_conds(std::vector<Condition> &conds, std::vector<CachedPlan::BindSite> &sites)
+    {
+        for (auto &cond : conds)
+        {
+            if (cond.is_rhs_val && cond.rhs_val.param_idx >= 0)
+                sites.push_back({&cond.rhs_val, true});
+        }
+    }
+
+    static void collect_bind_sites(const std::shared_ptr<Plan> &plan, std::vector<CachedPlan::BindSite> &sites)
+    {
+        if (plan == nullptr)
+            return;
+        switch (plan->tag)
+        {
+        case T_SeqScan:
+        case T_IndexScan:
+            collect_conds(std::static_pointer_cast<ScanPlan>(plan)->fed_conds_, sites);
+            break;
+        case T_NestLoop:
+        case T_SortMerge:
+        case T_SemiJoin:
+        {
+            auto x = std::static_pointer_cast<JoinPlan>(plan);
+            collect_conds(x->conds_, sites);
+            collect_bind_sites(x->left_, sites);
+            collect_bind_sites(x->right_, sites);
+            break;
+        }
+        case T_Projection:
+            collect_bind_sites(std::static_pointer_cast<ProjectionPlan>(plan)->subplan_, sites);
+            break;
+        case T_Explain:
+            collect_bind_sites(std::static_pointer_cast<ExplainPlan>(plan)->subplan_, sites);
+            break;
+        case T_Sort:
+            collect_bind_sites(std::static_pointer_cast<SortPlan>(plan)->subplan_, sites);
+            break;
+        case T_Agg:
+        {
+            auto x = std::static_pointer_cast<AggPlan>(plan);
+            collect_conds(x->having_conds_, sites);
+            collect_bind_sites(x->subplan_, sites);
+            break;
+        }
+        case T_Filter:
+        {
+            auto x = std::static_pointer_cast<FilterPlan>(plan);
+            collect_conds(x->conds_, sites);
+            collect_bind_sites(x->subplan_, sites);
+            break;
+        }
+        case T_Select:
+        case T_Insert:
+        case T_Update:
+        case T_Delete:
+        {
+            auto x = std::static_pointer_cast<DMLPlan>(plan);
+            for (auto &val : x->values_)
+            {
+                if (val.param_idx >= 0)
+                    sites.push_back({&val, false});
+            }
+            for (auto &set_clause : x->set_clauses_)
+            {
+                if (set_clause.rhs.param_idx >= 0)
+                    sites.push_back({&set_clause.rhs, false});
+            }
+            collect_conds(x->conds_, sites);
+            collect_bind_sites(x->subplan_, sites);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+};
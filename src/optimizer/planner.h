@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <memory>
@@ -108,6 +109,8 @@ private:
 
     bool enable_nestedloop_join = true;
     bool enable_sortmerge_join = false;
+    // 规划参数的版本号，参数改变后已缓存的执行计划需要重新生成
+    std::atomic<uint64_t> knob_version_{0};
     std::unordered_map<std::string, std::string> *tab_to_alias = &empty_map_;
     static std::unordered_map<std::string, std::string> empty_map_;
 
@@ -118,9 +121,19 @@ public:
 
     std::shared_ptr<Plan> do_planner(std::shared_ptr<Query> query, Context *context);
 
-    void set_enable_nestedloop_join(bool set_val) { enable_nestedloop_join = set_val; }
+    void set_enable_nestedloop_join(bool set_val)
+    {
+        enable_nestedloop_join = set_val;
+        knob_version_.fetch_add(1, std::memory_order_release);
+    }
+
+    void set_enable_sortmerge_join(bool set_val)
+    {
+        enable_sortmerge_join = set_val;
+        knob_version_.fetch_add(1, std::memory_order_release);
+    }
 
-    void set_enable_sortmerge_join(bool set_val) { enable_sortmerge_join = set_val; }
+    uint64_t knob_version() const { return knob_version_.load(std::memory_order_acquire); }
 
 private:
     // 查询优化相关函数
@@ -63,7 +63,8 @@ namespace ast
     enum SetKnobType
     {
         EnableNestLoop,
-        EnableSortMerge
+        EnableSortMerge,
+        BufferPoolSize
     };
 
     enum UpdateOp
@@ -80,6 +81,7 @@ namespace ast
     {
         Help,
         ShowTables,
+        ShowStatus,
         TxnBegin,
         TxnCommit,
         TxnAbort,
@@ -113,7 +115,11 @@ namespace ast
         CreateStaticCheckpoint,
         ExplainStmt,
         LoadStmt,
-        IoEnable
+        IoEnable,
+        Param,
+        PrepareStmt,
+        ExecuteStmt,
+        DeallocateStmt
     };
     // Base class for tree nodes
     struct TreeNode
@@ -138,6 +144,11 @@ namespace ast
         TreeNodeType Nodetype() const override { return TreeNodeType::ShowTables; }
     };
 
+    struct ShowStatus : public TreeNode
+    {
+        TreeNodeType Nodetype() const override { return TreeNodeType::ShowStatus; }
+    };
+
     struct TxnBegin : public TreeNode
     {
         TreeNodeType Nodetype() const override { return TreeNodeType::TxnBegin; }
@@ -185,8 +196,10 @@ namespace ast
     {
         std::string tab_name;
         std::vector<std::shared_ptr<Field>> fields;
+        bool slotted; // ROW_FORMAT = SLOTTED，字符串列变长存储
 
-        CreateTable(const std::string &tab_name_, const std::vector<std::shared_ptr<Field>> &fields_) : tab_name(std::move(tab_name_)), fields(std::move(fields_)) {}
+        CreateTable(const std::string &tab_name_, const std::vector<std::shared_ptr<Field>> &fields_, bool slotted_ = false)
+            : tab_name(std::move(tab_name_)), fields(std::move(fields_)), slotted(slotted_) {}
         TreeNodeType Nodetype() const override { return TreeNodeType::CreateTable; }
     };
 
@@ -276,6 +289,16 @@ namespace ast
         TreeNodeType Nodetype() const override { return TreeNodeType::BoolLit; }
     };
 
+    // 参数占位符'?'，idx为参数在语句中从0开始的序号，解析后统一编号
+    struct Param : public Value
+    {
+        int idx = -1;
+
+        Param() = default;
+        explicit Param(int idx_) : idx(idx_) {}
+        TreeNodeType Nodetype() const override { return TreeNodeType::Param; }
+    };
+
     struct Col : public Expr
     {
         std::string tab_name;
@@ -364,6 +387,32 @@ namespace ast
         DeleteStmt(const std::string &tab_name_, const std::vector<std::shared_ptr<BinaryExpr>> &conds_) : tab_name(std::move(tab_name_)), conds(std::move(conds_)) {}
         TreeNodeType Nodetype() const override { return TreeNodeType::DeleteStmt; }
     };
+    struct PrepareStmt : public TreeNode
+    {
+        std::string name;
+        std::shared_ptr<TreeNode> stmt;
+
+        PrepareStmt(std::string name_, std::shared_ptr<TreeNode> stmt_) : name(std::move(name_)), stmt(std::move(stmt_)) {}
+        TreeNodeType Nodetype() const override { return TreeNodeType::PrepareStmt; }
+    };
+
+    struct ExecuteStmt : public TreeNode
+    {
+        std::string name;
+        std::vector<std::shared_ptr<Value>> vals;
+
+        ExecuteStmt(std::string name_, std::vector<std::shared_ptr<Value>> vals_) : name(std::move(name_)), vals(std::move(vals_)) {}
+        TreeNodeType Nodetype() const override { return TreeNodeType::ExecuteStmt; }
+    };
+
+    struct DeallocateStmt : public TreeNode
+    {
+        std::string name;
+
+        explicit DeallocateStmt(std::string name_) : name(std::move(name_)) {}
+        TreeNodeType Nodetype() const override { return TreeNodeType::DeallocateStmt; }
+    };
+
     struct IoEnable : public TreeNode
     {
         bool set_io_enable;
@@ -539,7 +588,10 @@ namespace ast
         SetKnobType set_knob_type_;
         bool bool_val_;
 
+        std::string str_val_; // 非布尔类型的取值，如缓冲池大小
+
         SetStmt(SetKnobType &type, bool bool_value) : set_knob_type_(type), bool_val_(bool_value) {}
+        SetStmt(SetKnobType type, std::string str_value) : set_knob_type_(type), bool_val_(false), str_val_(std::move(str_value)) {}
         TreeNodeType Nodetype() const override { return TreeNodeType::SetStmt; }
     };
 
@@ -594,7 +646,5 @@ namespace ast
         virtual TreeNodeType Nodetype() const override { return TreeNodeType::CreateStaticCheckpoint; }
     };
 
-    extern std::shared_ptr<ast::TreeNode> parse_tree;
-
 }
 #define YYSTYPE ast::SemValue
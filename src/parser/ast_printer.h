@@ -95,6 +95,10 @@ namespace ast
             {
                 std::cout << "SHOW_TABLES\n";
             }
+            else if (auto x = std::dynamic_pointer_cast<ShowStatus>(node))
+            {
+                std::cout << "SHOW_STATUS\n";
+            }
             else if (auto x = std::dynamic_pointer_cast<CreateTable>(node))
             {
                 std::cout << "CREATE_TABLE\n";
@@ -160,6 +164,11 @@ namespace ast
                 std::cout << "STRING_LIT\n";
                 print_val(x->val, offset);
             }
+            else if (auto x = std::dynamic_pointer_cast<Param>(node))
+            {
+                std::cout << "PARAM\n";
+                print_val(x->idx, offset);
+            }
             else if (auto x = std::dynamic_pointer_cast<SetClause>(node))
             {
                 std::cout << "SET_CLAUSE\n";
@@ -219,6 +228,39 @@ namespace ast
             {
                 std::cout << "CREATE_STATIC_CHECKPOINT\n";
             }
+            else if (auto x = std::dynamic_pointer_cast<PrepareStmt>(node))
+            {
+                std::cout << "PREPARE\n";
+                print_val(x->name, offset);
+                print_node(x->stmt, offset);
+            }
+            else if (auto x = std::dynamic_pointer_cast<ExplainStmt>(node))
+            {
+                std::cout << "EXPLAIN\n";
+                print_node(x->query, offset);
+            }
+            else if (auto x = std::dynamic_pointer_cast<ExecuteStmt>(node))
+            {
+                std::cout << "EXECUTE\n";
+                print_val(x->name, offset);
+                print_node_list(x->vals, offset);
+            }
+            else if (auto x = std::dynamic_pointer_cast<DeallocateStmt>(node))
+            {
+                std::cout << "DEALLOCATE\n";
+                print_val(x->name, offset);
+            }
+            else if (auto x = std::dynamic_pointer_cast<SetStmt>(node))
+            {
+                static const std::map<SetKnobType, std::string> knob_names = {
+                    {EnableNestLoop, "enable_nestloop"},
+                    {EnableSortMerge, "enable_sortmerge"},
+                    {BufferPoolSize, "buffer_pool_size"},
+                };
+                std::cout << "SET\n";
+                print_val(knob_names.at(x->set_knob_type_), offset);
+                print_val(x->str_val_.empty() ? std::string(x->bool_val_ ? "true" : "false") : x->str_val_, offset);
+            }
             else
             {
                 assert(0);
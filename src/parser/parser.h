@@ -10,6 +10,133 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include "ast_printer.h"
 #include "ast.h"
 #include "parser_defs.h"
+
+// 可重入的SQL解析器，词法分析状态保存在各自的yyscan_t中，错误信息保存在解析器自己的error_msg_中，
+// 每个会话持有一个实例即可并发解析
+class SqlParser
+{
+public:
+    SqlParser() { yylex_init(&scanner_); }
+
+    ~SqlParser() { yylex_destroy(scanner_); }
+
+    SqlParser(const SqlParser &) = delete;
+    SqlParser &operator=(const SqlParser &) = delete;
+
+    /**
+     * @description: 解析一条SQL语句
+     * @return {int} yyparse的返回值，0表示解析成功
+     * @param {char} *sql 以'\0'结尾的SQL语句
+     * @param {shared_ptr<ast::TreeNode>} &parse_tree 解析得到的语法树，exit/EOF时为nullptr
+     */
+    int parse(const char *sql, std::shared_ptr<ast::TreeNode> &parse_tree)
+    {
+        parse_tree = nullptr;
+        error_msg_.clear();
+        YY_BUFFER_STATE buf = yy_scan_string(sql, scanner_);
+        int ret = yyparse(scanner_, parse_tree, error_msg_);
+        yy_delete_buffer(buf, scanner_);
+        return ret;
+    }
+
+    // 最近一次parse失败时的错误信息，解析成功时为空
+    const std::string &error_msg() const { return error_msg_; }
+
+    /**
+     * @description: 把SQL语句规范化为常量替换成'?'的文本，用作计划缓存的键，只做词法分析
+     * @return {bool} 语句能否使用计划缓存
+     * @param {char} *sql 以'\0'结尾的SQL语句
+     * @param {string&} key 规范化后的语句
+     * @param {vector<shared_ptr<ast::Value>>&} literals 语句中按出现顺序排列的常量
+     */
+    bool normalize(const char *sql, std::string &key, std::vector<std::shared_ptr<ast::Value>> &literals)
+    {
+        // 未闭合的块注释会让词法分析器停留在注释状态，这类语句直接走正常的解析流程
+        if (strstr(sql, "/*") != nullptr)
+            return false;
+        YY_BUFFER_STATE buf = yy_scan_string(sql, scanner_);
+        bool ret = yynormalize(scanner_, key, literals);
+        yy_delete_buffer(buf, scanner_);
+        return ret;
+    }
+
+    /**
+     * @description: 把一次请求中以';'分隔的多条语句拆开，字符串常量和注释中的';'不作为分隔符
+     * @return {vector<string>} 按顺序排列的语句，包含结尾的';'，开头的空白和注释、结尾的空白已经去掉，
+     * 这样前面带有注释的exit、crash等特殊命令也能被识别
+     * @param {char} *sql 以'\0'结尾的请求内容
+     */
+    static std::vector<std::string> split(const char *sql)
+    {
+        std::vector<std::string> stmts;
+        const char *begin = sql;
+        auto emit = [&](const char *end)
+        {
+            const char *last = end;
+            while (begin < last)
+            {
+                if (isspace((unsigned char)*begin))
+                {
+                    begin++;
+                }
+                else if (begin + 1 < last && begin[0] == '-' && begin[1] == '-')
+                {
+                    const char *eol = (const char *)memchr(begin, '\n', last - begin);
+                    begin = eol == nullptr ? last : eol + 1;
+                }
+                else if (begin + 1 < last && begin[0] == '/' && begin[1] == '*')
+                {
+                    const char *close = strstr(begin + 2, "*/");
+                    begin = close == nullptr || close + 2 > last ? last : close + 2;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            while (last > begin && isspace((unsigned char)last[-1]))
+                last--;
+            if (last > begin)
+                stmts.emplace_back(begin, last - begin);
+            begin = end;
+        };
+
+        const char *p = sql;
+        while (p != nullptr && *p != '\0')
+        {
+            if (*p == '\'')
+            {
+                p = strchr(p + 1, '\'');
+                p = p == nullptr ? nullptr : p + 1;
+            }
+            else if (p[0] == '-' && p[1] == '-')
+            {
+                p = strchr(p, '\n');
+            }
+            else if (p[0] == '/' && p[1] == '*')
+            {
+                p = strstr(p + 2, "*/");
+                p = p == nullptr ? nullptr : p + 2;
+            }
+            else if (*p++ == ';')
+            {
+                emit(p);
+            }
+        }
+        // 最后一条语句可以没有';'，例如exit、help
+        emit(sql + strlen(sql));
+        return stmts;
+    }
+
+private:
+    yyscan_t scanner_;
+    std::string error_msg_;
+};
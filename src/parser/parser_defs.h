@@ -10,12 +10,32 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "defs.h"
 
-int yyparse();
+namespace ast {
+struct TreeNode;
+struct Value;
+}
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+
+int yylex_init(yyscan_t *scanner);
+
+int yylex_destroy(yyscan_t scanner);
+
+int yyparse(yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg);
+
+bool yynormalize(yyscan_t scanner, std::string &key, std::vector<std::shared_ptr<ast::Value>> &literals);
 
 typedef struct yy_buffer_state *YY_BUFFER_STATE;
 
-YY_BUFFER_STATE yy_scan_string(const char *str);
+YY_BUFFER_STATE yy_scan_string(const char *str, yyscan_t scanner);
 
-void yy_delete_buffer(YY_BUFFER_STATE buffer);
+void yy_delete_buffer(YY_BUFFER_STATE buffer, yyscan_t scanner);
@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 #undef NDEBUG
 
 #include <cassert>
+#include <thread>
 
 #include "parser.h"
 
@@ -18,6 +19,7 @@ int main() {
         "show tables;",
         "desc tb;",
         "create table tb (a int, b float, c char(4));",
+        "create table tv (a int, b char(100)) row_format = slotted;",
         "drop table tb;",
         "create index tb(a);",
         "create index tb(a, b, c);",
@@ -26,26 +28,86 @@ int main() {
         "insert into tb values (1, 3.14, 'pi');",
         "delete from tb where a = 1;",
         "update tb set a = 1, b = 2.2, c = 'xyz' where x = 2 and y < 1.1 and z > 'abc';",
+        "update tv set b = 'a much longer string than before' where a = 1;",
         "select * from tb;",
         "select * from tb where x <> 2 and y >= 3. and z <= '123' and b < tb.a;",
         "select x.a, y.b from x, y where x.a = y.b and c = d;",
         "select x.a, y.b from x join y where x.a = y.b and c = d;",
+        "prepare q1 as select * from tb where a = ? and b < ?;",
+        "prepare q2 as insert into tb values (?, ?, ?);",
+        "prepare q3 as explain select * from tb where a = ?;",
+        "execute q1 (1, 2.5);",
+        "execute q2;",
+        "deallocate q1;",
+        "deallocate prepare q2;",
+        "set buffer_pool_size = 1024;",
+        "set buffer_pool_size = '256M';",
+        "show status;",
         "exit;",
         "help;",
         "",
     };
+    SqlParser parser;
+    std::shared_ptr<ast::TreeNode> parse_tree;
     for (auto &sql : sqls) {
         std::cout << sql << std::endl;
-        YY_BUFFER_STATE buf = yy_scan_string(sql.c_str());
-        assert(yyparse() == 0);
-        if (ast::parse_tree != nullptr) {
-            ast::TreePrinter::print(ast::parse_tree);
-            yy_delete_buffer(buf);
+        assert(parser.parse(sql.c_str(), parse_tree) == 0);
+        if (parse_tree != nullptr) {
+            ast::TreePrinter::print(parse_tree);
             std::cout << std::endl;
         } else {
             std::cout << "exit/EOF" << std::endl;
         }
     }
-    ast::parse_tree.reset();
+
+    // 各个解析器之间没有共享状态，可以在多个线程中同时解析
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&sqls]() {
+            SqlParser local_parser;
+            std::shared_ptr<ast::TreeNode> tree;
+            for (int round = 0; round < 100; round++) {
+                for (auto &sql : sqls) {
+                    assert(local_parser.parse(sql.c_str(), tree) == 0);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // 只有常量不同的语句规范化后得到相同的键
+    std::string key1, key2;
+    std::vector<std::shared_ptr<ast::Value>> literals1, literals2;
+    assert(parser.normalize("select * from tb where a = 1 and c = 'x' limit 3;", key1, literals1));
+    assert(parser.normalize("select * from tb where a = 20 and c = 'yz' limit 3;", key2, literals2));
+    assert(key1 == key2 && literals1.size() == 2 && literals2.size() == 2);
+    assert(parser.normalize("select * from tb where a = 1 and c = 'x' limit 4;", key2, literals2));
+    assert(key1 != key2);
+    assert(!parser.normalize("show tables;", key1, literals1));
+
+    // 错误信息保存在各自的解析器中
+    SqlParser other_parser;
+    assert(parser.parse("select from;", parse_tree) != 0);
+    assert(parser.error_msg().find("syntax error") != std::string::npos);
+    assert(other_parser.parse("show tables;", parse_tree) == 0);
+    assert(other_parser.error_msg().empty());
+    assert(parser.parse("show tables;", parse_tree) == 0);
+    assert(parser.error_msg().empty());
+
+    // 字符串常量和注释中的';'不分隔语句
+    auto stmts = SqlParser::split(" insert into tb values (1, 'a;b'); -- x;y\n select * from tb; /* ; */ exit");
+    assert(stmts.size() == 3);
+    assert(stmts[0] == "insert into tb values (1, 'a;b');");
+    assert(stmts[1] == "select * from tb;");
+    // 语句开头的注释被去掉，exit之类的特殊命令仍然能被识别
+    assert(stmts[2] == "exit");
+    stmts = SqlParser::split("/* a;'b */ select 1; -- c;d\n/* e */ crash");
+    assert(stmts.size() == 2);
+    assert(stmts[0] == "select 1;");
+    assert(stmts[1] == "crash");
+    assert(SqlParser::split("/* ; */ -- ;").empty());
+    assert(SqlParser::split("  ").empty());
     return 0;
 }
@@ -67,13 +67,14 @@
 
 
 /* First part of user prologue.  */
-#line 1 "/home/nero/diff/db2025/src/parser/yacc.y"
+#line 1 "/root/repo/src/parser/yacc.y"
 
 #include "ast.h"
 #include "yacc.tab.h"
 #include <iostream>
 #include <memory>
 #include <cstring>
+#include <strings.h>
 #include <cmath>
 #include <sstream>
 #include <iomanip>
@@ -82,24 +83,19 @@
 const int FLOAT_PRECISION = 6;
 const float FLOAT_PRECISION_MULTIPLIER = std::pow(10, FLOAT_PRECISION);
 
-int yylex(YYSTYPE *yylval, YYLTYPE *yylloc);
+int yylex(YYSTYPE *yylval, YYLTYPE *yylloc, yyscan_t scanner);
 
-void yyerror(YYLTYPE *locp, const char* s) {
+void yyerror(YYLTYPE *locp, yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg, const char* s) {
     //std::cerr << "Parser Error at line " << locp->first_line << " column " << locp->first_column << ": " << s << std::endl;
-        std::string error_msg = "Parser Error at line " + std::to_string(locp->first_line) +
-                           " column " + std::to_string(locp->first_column) + ": " + s + "\n";
+    // 错误信息保存在调用者传入的error_msg中，各个解析器之间不共享
+    error_msg = "Parser Error at line " + std::to_string(locp->first_line) +
+                " column " + std::to_string(locp->first_column) + ": " + s + "\n";
     std::cerr << error_msg;
-
-    // 将错误信息保存到全局变量中，以便后续传递给客户端
-    extern char *g_error_msg;
-    if (g_error_msg != nullptr) {
-        strcpy(g_error_msg, error_msg.c_str());
-    }
 }
 
 using namespace ast;
 
-#line 103 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 99 "/root/repo/src/parser/yacc.tab.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -181,69 +177,74 @@ enum yysymbol_kind_t
   YYSYMBOL_AVG = 51,                       /* AVG  */
   YYSYMBOL_AS = 52,                        /* AS  */
   YYSYMBOL_LOAD = 53,                      /* LOAD  */
-  YYSYMBOL_LEQ = 54,                       /* LEQ  */
-  YYSYMBOL_NEQ = 55,                       /* NEQ  */
-  YYSYMBOL_GEQ = 56,                       /* GEQ  */
-  YYSYMBOL_T_EOF = 57,                     /* T_EOF  */
-  YYSYMBOL_OUTPUT_FILE = 58,               /* OUTPUT_FILE  */
-  YYSYMBOL_OFF = 59,                       /* OFF  */
-  YYSYMBOL_IDENTIFIER = 60,                /* IDENTIFIER  */
-  YYSYMBOL_VALUE_STRING = 61,              /* VALUE_STRING  */
-  YYSYMBOL_VALUE_PATH = 62,                /* VALUE_PATH  */
-  YYSYMBOL_VALUE_INT = 63,                 /* VALUE_INT  */
-  YYSYMBOL_VALUE_FLOAT = 64,               /* VALUE_FLOAT  */
-  YYSYMBOL_VALUE_BOOL = 65,                /* VALUE_BOOL  */
-  YYSYMBOL_66_ = 66,                       /* ';'  */
-  YYSYMBOL_67_ = 67,                       /* '='  */
-  YYSYMBOL_68_ = 68,                       /* '('  */
-  YYSYMBOL_69_ = 69,                       /* ')'  */
-  YYSYMBOL_70_ = 70,                       /* ','  */
-  YYSYMBOL_71_ = 71,                       /* '.'  */
-  YYSYMBOL_72_ = 72,                       /* '*'  */
-  YYSYMBOL_73_ = 73,                       /* '<'  */
-  YYSYMBOL_74_ = 74,                       /* '>'  */
-  YYSYMBOL_75_ = 75,                       /* '+'  */
-  YYSYMBOL_76_ = 76,                       /* '-'  */
-  YYSYMBOL_YYACCEPT = 77,                  /* $accept  */
-  YYSYMBOL_start = 78,                     /* start  */
-  YYSYMBOL_stmt = 79,                      /* stmt  */
-  YYSYMBOL_txnStmt = 80,                   /* txnStmt  */
-  YYSYMBOL_dbStmt = 81,                    /* dbStmt  */
-  YYSYMBOL_setStmt = 82,                   /* setStmt  */
-  YYSYMBOL_io_stmt = 83,                   /* io_stmt  */
-  YYSYMBOL_ddl = 84,                       /* ddl  */
-  YYSYMBOL_dml = 85,                       /* dml  */
-  YYSYMBOL_fieldList = 86,                 /* fieldList  */
-  YYSYMBOL_colNameList = 87,               /* colNameList  */
-  YYSYMBOL_field = 88,                     /* field  */
-  YYSYMBOL_type = 89,                      /* type  */
-  YYSYMBOL_valueList = 90,                 /* valueList  */
-  YYSYMBOL_value = 91,                     /* value  */
-  YYSYMBOL_condition = 92,                 /* condition  */
-  YYSYMBOL_optWhereClause = 93,            /* optWhereClause  */
-  YYSYMBOL_optJoinClause = 94,             /* optJoinClause  */
-  YYSYMBOL_opt_having_clause = 95,         /* opt_having_clause  */
-  YYSYMBOL_whereClause = 96,               /* whereClause  */
-  YYSYMBOL_col = 97,                       /* col  */
-  YYSYMBOL_aggCol = 98,                    /* aggCol  */
-  YYSYMBOL_colList = 99,                   /* colList  */
-  YYSYMBOL_op = 100,                       /* op  */
-  YYSYMBOL_expr = 101,                     /* expr  */
-  YYSYMBOL_setClauses = 102,               /* setClauses  */
-  YYSYMBOL_setClause = 103,                /* setClause  */
-  YYSYMBOL_selector = 104,                 /* selector  */
-  YYSYMBOL_tableList = 105,                /* tableList  */
-  YYSYMBOL_opt_order_clause = 106,         /* opt_order_clause  */
-  YYSYMBOL_opt_limit_clause = 107,         /* opt_limit_clause  */
-  YYSYMBOL_opt_groupby_clause = 108,       /* opt_groupby_clause  */
-  YYSYMBOL_order_clause = 109,             /* order_clause  */
-  YYSYMBOL_order_item = 110,               /* order_item  */
-  YYSYMBOL_opt_asc_desc = 111,             /* opt_asc_desc  */
-  YYSYMBOL_set_knob_type = 112,            /* set_knob_type  */
-  YYSYMBOL_tbName = 113,                   /* tbName  */
-  YYSYMBOL_colName = 114,                  /* colName  */
-  YYSYMBOL_ALIAS = 115,                    /* ALIAS  */
-  YYSYMBOL_fileName = 116                  /* fileName  */
+  YYSYMBOL_PREPARE = 54,                   /* PREPARE  */
+  YYSYMBOL_EXECUTE = 55,                   /* EXECUTE  */
+  YYSYMBOL_DEALLOCATE = 56,                /* DEALLOCATE  */
+  YYSYMBOL_LEQ = 57,                       /* LEQ  */
+  YYSYMBOL_NEQ = 58,                       /* NEQ  */
+  YYSYMBOL_GEQ = 59,                       /* GEQ  */
+  YYSYMBOL_T_EOF = 60,                     /* T_EOF  */
+  YYSYMBOL_OUTPUT_FILE = 61,               /* OUTPUT_FILE  */
+  YYSYMBOL_OFF = 62,                       /* OFF  */
+  YYSYMBOL_IDENTIFIER = 63,                /* IDENTIFIER  */
+  YYSYMBOL_VALUE_STRING = 64,              /* VALUE_STRING  */
+  YYSYMBOL_VALUE_PATH = 65,                /* VALUE_PATH  */
+  YYSYMBOL_VALUE_INT = 66,                 /* VALUE_INT  */
+  YYSYMBOL_VALUE_FLOAT = 67,               /* VALUE_FLOAT  */
+  YYSYMBOL_VALUE_BOOL = 68,                /* VALUE_BOOL  */
+  YYSYMBOL_69_ = 69,                       /* ';'  */
+  YYSYMBOL_70_ = 70,                       /* '('  */
+  YYSYMBOL_71_ = 71,                       /* ')'  */
+  YYSYMBOL_72_ = 72,                       /* '='  */
+  YYSYMBOL_73_ = 73,                       /* ','  */
+  YYSYMBOL_74_ = 74,                       /* '?'  */
+  YYSYMBOL_75_ = 75,                       /* '.'  */
+  YYSYMBOL_76_ = 76,                       /* '*'  */
+  YYSYMBOL_77_ = 77,                       /* '<'  */
+  YYSYMBOL_78_ = 78,                       /* '>'  */
+  YYSYMBOL_79_ = 79,                       /* '+'  */
+  YYSYMBOL_80_ = 80,                       /* '-'  */
+  YYSYMBOL_YYACCEPT = 81,                  /* $accept  */
+  YYSYMBOL_start = 82,                     /* start  */
+  YYSYMBOL_stmt = 83,                      /* stmt  */
+  YYSYMBOL_prepareStmt = 84,               /* prepareStmt  */
+  YYSYMBOL_txnStmt = 85,                   /* txnStmt  */
+  YYSYMBOL_dbStmt = 86,                    /* dbStmt  */
+  YYSYMBOL_setStmt = 87,                   /* setStmt  */
+  YYSYMBOL_io_stmt = 88,                   /* io_stmt  */
+  YYSYMBOL_ddl = 89,                       /* ddl  */
+  YYSYMBOL_dml = 90,                       /* dml  */
+  YYSYMBOL_fieldList = 91,                 /* fieldList  */
+  YYSYMBOL_colNameList = 92,               /* colNameList  */
+  YYSYMBOL_field = 93,                     /* field  */
+  YYSYMBOL_type = 94,                      /* type  */
+  YYSYMBOL_valueList = 95,                 /* valueList  */
+  YYSYMBOL_value = 96,                     /* value  */
+  YYSYMBOL_condition = 97,                 /* condition  */
+  YYSYMBOL_optWhereClause = 98,            /* optWhereClause  */
+  YYSYMBOL_optJoinClause = 99,             /* optJoinClause  */
+  YYSYMBOL_opt_having_clause = 100,        /* opt_having_clause  */
+  YYSYMBOL_whereClause = 101,              /* whereClause  */
+  YYSYMBOL_col = 102,                      /* col  */
+  YYSYMBOL_aggCol = 103,                   /* aggCol  */
+  YYSYMBOL_colList = 104,                  /* colList  */
+  YYSYMBOL_op = 105,                       /* op  */
+  YYSYMBOL_expr = 106,                     /* expr  */
+  YYSYMBOL_setClauses = 107,               /* setClauses  */
+  YYSYMBOL_setClause = 108,                /* setClause  */
+  YYSYMBOL_selector = 109,                 /* selector  */
+  YYSYMBOL_tableList = 110,                /* tableList  */
+  YYSYMBOL_opt_order_clause = 111,         /* opt_order_clause  */
+  YYSYMBOL_opt_limit_clause = 112,         /* opt_limit_clause  */
+  YYSYMBOL_opt_groupby_clause = 113,       /* opt_groupby_clause  */
+  YYSYMBOL_order_clause = 114,             /* order_clause  */
+  YYSYMBOL_order_item = 115,               /* order_item  */
+  YYSYMBOL_opt_asc_desc = 116,             /* opt_asc_desc  */
+  YYSYMBOL_set_knob_type = 117,            /* set_knob_type  */
+  YYSYMBOL_tbName = 118,                   /* tbName  */
+  YYSYMBOL_colName = 119,                  /* colName  */
+  YYSYMBOL_ALIAS = 120,                    /* ALIAS  */
+  YYSYMBOL_fileName = 121                  /* fileName  */
 };
 typedef enum yysymbol_kind_t yysymbol_kind_t;
 
@@ -572,21 +573,21 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  59
+#define YYFINAL  69
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   224
+#define YYLAST   255
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  77
+#define YYNTOKENS  81
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  40
+#define YYNNTS  41
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  114
+#define YYNRULES  126
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  218
+#define YYNSTATES  243
 
 /* YYMAXUTOK -- Last valid token kind.  */
-#define YYMAXUTOK   320
+#define YYMAXUTOK   323
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
@@ -604,9 +605,9 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      68,    69,    72,    75,    70,    76,    71,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    66,
-      73,    67,    74,     2,     2,     2,     2,     2,     2,     2,
+      70,    71,    76,    79,    73,    80,    75,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    69,
+      77,    72,    78,    74,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -632,25 +633,26 @@ static const yytype_int8 yytranslate[] =
       35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
       55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-      65
+      65,    66,    67,    68
 };
 
 #if YYDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    81,    81,    86,    91,    96,   101,   109,   110,   111,
-     112,   113,   114,   121,   125,   129,   133,   140,   144,   151,
-     157,   161,   167,   171,   175,   179,   183,   187,   191,   198,
-     202,   206,   210,   228,   232,   239,   243,   250,   257,   261,
-     265,   269,   276,   280,   287,   291,   296,   300,   307,   315,
-     316,   323,   324,   331,   332,   339,   343,   351,   355,   359,
-     364,   372,   376,   381,   385,   389,   393,   400,   404,   411,
-     415,   419,   423,   427,   431,   435,   439,   446,   450,   457,
-     461,   468,   472,   476,   480,   484,   488,   495,   499,   503,
-     509,   515,   523,   531,   548,   565,   582,   602,   606,   610,
-     615,   621,   625,   629,   633,   641,   648,   649,   650,   654,
-     655,   658,   660,   662,   663
+       0,    88,    88,    93,    98,   103,   108,   116,   117,   118,
+     119,   120,   121,   122,   129,   133,   137,   141,   145,   149,
+     156,   160,   164,   168,   175,   179,   189,   196,   200,   210,
+     221,   225,   231,   235,   251,   255,   259,   263,   267,   271,
+     278,   282,   286,   290,   308,   312,   319,   323,   330,   337,
+     341,   345,   349,   356,   360,   367,   371,   376,   380,   384,
+     392,   400,   401,   408,   409,   416,   417,   424,   428,   436,
+     440,   444,   449,   457,   461,   466,   470,   474,   478,   485,
+     489,   496,   500,   504,   508,   512,   516,   520,   524,   531,
+     535,   542,   546,   553,   557,   561,   565,   569,   573,   580,
+     584,   588,   594,   600,   608,   616,   633,   650,   667,   687,
+     691,   695,   700,   706,   710,   714,   718,   726,   733,   734,
+     735,   739,   740,   743,   745,   747,   748
 };
 #endif
 
@@ -673,18 +675,18 @@ static const char *const yytname[] =
   "AND", "SEMI", "JOIN", "ON", "IN", "NOT", "EXIT", "HELP", "DIV",
   "EXPLAIN", "TXN_BEGIN", "TXN_COMMIT", "TXN_ABORT", "TXN_ROLLBACK",
   "ORDER_BY", "ENABLE_NESTLOOP", "ENABLE_SORTMERGE", "STATIC_CHECKPOINT",
-  "SUM", "COUNT", "MAX", "MIN", "AVG", "AS", "LOAD", "LEQ", "NEQ", "GEQ",
-  "T_EOF", "OUTPUT_FILE", "OFF", "IDENTIFIER", "VALUE_STRING",
-  "VALUE_PATH", "VALUE_INT", "VALUE_FLOAT", "VALUE_BOOL", "';'", "'='",
-  "'('", "')'", "','", "'.'", "'*'", "'<'", "'>'", "'+'", "'-'", "$accept",
-  "start", "stmt", "txnStmt", "dbStmt", "setStmt", "io_stmt", "ddl", "dml",
-  "fieldList", "colNameList", "field", "type", "valueList", "value",
-  "condition", "optWhereClause", "optJoinClause", "opt_having_clause",
-  "whereClause", "col", "aggCol", "colList", "op", "expr", "setClauses",
-  "setClause", "selector", "tableList", "opt_order_clause",
-  "opt_limit_clause", "opt_groupby_clause", "order_clause", "order_item",
-  "opt_asc_desc", "set_knob_type", "tbName", "colName", "ALIAS",
-  "fileName", YY_NULLPTR
+  "SUM", "COUNT", "MAX", "MIN", "AVG", "AS", "LOAD", "PREPARE", "EXECUTE",
+  "DEALLOCATE", "LEQ", "NEQ", "GEQ", "T_EOF", "OUTPUT_FILE", "OFF",
+  "IDENTIFIER", "VALUE_STRING", "VALUE_PATH", "VALUE_INT", "VALUE_FLOAT",
+  "VALUE_BOOL", "';'", "'('", "')'", "'='", "','", "'?'", "'.'", "'*'",
+  "'<'", "'>'", "'+'", "'-'", "$accept", "start", "stmt", "prepareStmt",
+  "txnStmt", "dbStmt", "setStmt", "io_stmt", "ddl", "dml", "fieldList",
+  "colNameList", "field", "type", "valueList", "value", "condition",
+  "optWhereClause", "optJoinClause", "opt_having_clause", "whereClause",
+  "col", "aggCol", "colList", "op", "expr", "setClauses", "setClause",
+  "selector", "tableList", "opt_order_clause", "opt_limit_clause",
+  "opt_groupby_clause", "order_clause", "order_item", "opt_asc_desc",
+  "set_knob_type", "tbName", "colName", "ALIAS", "fileName", YY_NULLPTR
 };
 
 static const char *
@@ -694,12 +696,12 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-158)
+#define YYPACT_NINF (-185)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-112)
+#define YYTABLE_NINF (-124)
 
 #define yytable_value_is_error(Yyn) \
   0
@@ -708,28 +710,31 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      94,    11,     4,     7,   -57,    -5,    32,   -57,    -1,   120,
-    -158,  -158,    39,  -158,  -158,  -158,  -158,   -13,  -158,    12,
-      16,  -158,  -158,  -158,  -158,  -158,  -158,  -158,    48,   -57,
-     -57,  -158,   -57,   -57,  -158,  -158,   -57,   -57,    56,  -158,
-    -158,   -21,    19,    30,    50,    51,    55,    57,    17,  -158,
-    -158,    72,    37,   115,    29,    79,  -158,  -158,   104,  -158,
-    -158,   -57,    69,    71,  -158,    76,   129,   125,    86,  -158,
-    -158,    83,    62,   134,    62,    62,    62,    90,    62,   -57,
-      86,    90,   -57,  -158,    86,    86,    86,    84,    62,  -158,
-    -158,   -11,  -158,    91,  -158,   103,   105,   106,   110,   122,
-     124,  -158,  -158,  -158,   -14,    90,  -158,  -158,  -158,   -48,
-    -158,    46,   -46,  -158,    22,    92,  -158,   166,    87,    86,
-    -158,    20,  -158,  -158,  -158,  -158,  -158,  -158,   132,   -57,
-     -57,   180,  -158,  -158,    86,  -158,   130,  -158,  -158,  -158,
-    -158,    86,  -158,  -158,  -158,  -158,  -158,    35,  -158,    62,
-    -158,   168,  -158,  -158,  -158,  -158,  -158,  -158,   139,  -158,
-    -158,   101,   -57,   -24,    90,   188,   190,  -158,   146,  -158,
-    -158,    92,  -158,  -158,  -158,  -158,  -158,    92,    92,    92,
-      92,  -158,   -24,    62,  -158,   178,  -158,    62,    62,   196,
-     143,  -158,  -158,  -158,  -158,  -158,  -158,   178,   166,  -158,
-      37,   166,   197,   194,  -158,  -158,    62,   152,  -158,    38,
-     147,  -158,  -158,  -158,  -158,  -158,    62,  -158
+     104,     2,     5,     9,   -53,     7,    11,   -53,    37,   118,
+    -185,  -185,   183,  -185,  -185,  -185,  -185,   -44,   -34,     3,
+     -13,  -185,    53,    10,  -185,  -185,  -185,  -185,  -185,  -185,
+    -185,  -185,    33,  -185,   -53,   -53,  -185,   -53,   -53,  -185,
+    -185,   -53,   -53,    38,  -185,  -185,   -20,    19,    23,    40,
+      48,    63,    64,    67,    66,  -185,  -185,    86,    35,   115,
+      78,   102,  -185,  -185,   145,   109,    92,    93,  -185,  -185,
+    -185,   -53,   100,   101,  -185,   103,   152,   159,   117,  -185,
+    -185,    -7,   116,   138,   127,   138,   138,   138,   120,   138,
+     -53,   117,   120,   -53,    76,   170,  -185,  -185,   117,   117,
+     117,   121,   138,  -185,  -185,   -12,  -185,   133,  -185,  -185,
+    -185,   122,   136,   137,   139,   140,   143,  -185,  -185,  -185,
+     -17,   120,  -185,  -185,  -185,   183,  -185,  -185,  -185,  -185,
+    -185,  -185,   -24,  -185,    -1,  -185,   123,    21,  -185,    46,
+     170,  -185,   180,   -14,   117,  -185,   161,  -185,  -185,  -185,
+    -185,  -185,  -185,   187,   -53,   -53,   203,  -185,  -185,  -185,
+     170,   157,   117,  -185,   151,  -185,  -185,  -185,  -185,   117,
+    -185,    58,   138,  -185,   193,  -185,  -185,  -185,  -185,  -185,
+    -185,   149,  -185,  -185,    56,   -53,   -23,   120,   213,   215,
+    -185,   167,  -185,   165,  -185,  -185,  -185,  -185,  -185,  -185,
+    -185,   170,   170,   170,   170,  -185,   -23,   138,  -185,   208,
+    -185,   138,   138,   226,   179,   172,  -185,  -185,  -185,  -185,
+    -185,   208,   180,  -185,    35,   180,   228,   227,  -185,  -185,
+    -185,   138,   181,  -185,     8,   175,  -185,  -185,  -185,  -185,
+    -185,   138,  -185
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -738,45 +743,50 @@ static const yytype_int16 yypact[] =
 static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       4,     3,     0,    13,    14,    15,    16,     0,     5,     0,
-       0,    10,     7,    11,     6,     8,     9,    17,     0,     0,
-       0,    28,     0,     0,   111,    24,     0,     0,     0,   109,
-     110,     0,     0,     0,     0,     0,     0,     0,   112,    87,
-      67,     0,    88,     0,     0,    58,    12,   114,     0,     1,
-       2,     0,     0,     0,    23,     0,     0,    49,     0,    20,
-      21,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,    27,     0,     0,     0,     0,     0,    30,
-     112,    49,    79,     0,    19,     0,     0,     0,     0,     0,
-       0,   113,    60,    68,    49,    89,    57,    59,    18,     0,
-      33,     0,     0,    35,     0,     0,    55,    50,     0,     0,
-      31,     0,    61,    66,    65,    63,    62,    64,     0,     0,
-       0,   102,    90,    22,     0,    38,     0,    40,    41,    37,
-      25,     0,    26,    46,    44,    45,    47,     0,    42,     0,
-      75,     0,    73,    72,    74,    69,    70,    71,     0,    80,
-      81,     0,     0,    51,    91,     0,    53,    34,     0,    36,
-      29,     0,    56,    76,    77,    78,    48,     0,     0,     0,
-       0,    82,    51,     0,    93,    51,    92,     0,     0,    98,
-       0,    43,    86,    85,    83,    84,    95,    51,    52,    94,
-     101,    54,     0,   100,    39,    96,     0,     0,    32,   108,
-      97,   103,    99,   107,   106,   105,     0,   104
+       4,     3,     0,    20,    21,    22,    23,     0,     0,     0,
+       0,     5,     0,     0,    12,    10,     7,    11,     6,     8,
+       9,    24,     0,    25,     0,     0,    39,     0,     0,   123,
+      35,     0,     0,     0,   121,   122,     0,     0,     0,     0,
+       0,     0,     0,     0,   124,    99,    79,     0,   100,     0,
+       0,    70,    13,   126,     0,     0,    16,     0,    18,     1,
+       2,     0,     0,     0,    34,     0,     0,    61,     0,    30,
+      31,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,    19,    38,     0,     0,
+       0,     0,     0,    41,   124,    61,    91,     0,    29,    28,
+      27,     0,     0,     0,     0,     0,     0,   125,    72,    80,
+      61,   101,    69,    71,    26,     0,    14,    57,    55,    56,
+      58,    59,     0,    53,     0,    44,     0,     0,    46,     0,
+       0,    67,    62,     0,     0,    42,     0,    73,    78,    77,
+      75,    74,    76,     0,     0,     0,   114,   102,    15,    17,
+       0,    32,     0,    49,     0,    51,    52,    48,    36,     0,
+      37,     0,     0,    87,     0,    85,    84,    86,    81,    82,
+      83,     0,    92,    93,     0,     0,    63,   103,     0,    65,
+      54,     0,    45,     0,    47,    40,    68,    88,    89,    90,
+      60,     0,     0,     0,     0,    94,    63,     0,   105,    63,
+     104,     0,     0,   110,     0,     0,    98,    97,    95,    96,
+     107,    63,    64,   106,   113,    66,     0,   112,    33,    50,
+     108,     0,     0,    43,   120,   109,   115,   111,   119,   118,
+     117,     0,   116
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -158,  -158,  -158,  -158,  -158,  -158,  -158,  -158,   204,  -158,
-     133,    88,  -158,  -158,   -84,    74,   -50,  -157,  -158,  -141,
-      -9,  -158,    31,  -158,  -158,  -158,   102,  -158,  -158,  -158,
-    -158,  -158,  -158,     8,  -158,  -158,    -3,   -66,   -74,  -158
+    -185,  -185,  -185,  -185,  -185,  -185,  -185,  -185,  -185,   -10,
+    -185,   150,    87,  -185,   111,   -98,    80,   -51,  -154,  -185,
+    -184,    -9,  -185,    42,  -185,  -185,  -185,   110,  -185,  -185,
+    -185,  -185,  -185,  -185,    14,  -185,  -185,    -3,   -73,   -85,
+    -185
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
-       0,    19,    20,    21,    22,    23,    24,    25,    26,   109,
-     112,   110,   139,   147,   148,   116,    89,   184,   189,   117,
-     118,    51,    52,   158,   176,    91,    92,    53,   104,   203,
-     208,   166,   210,   211,   215,    42,    54,    55,   102,    58
+       0,    22,    23,    24,    25,    26,    27,    28,    29,    30,
+     134,   137,   135,   167,   132,   133,   141,   103,   208,   213,
+     142,   143,    57,    58,   181,   200,   105,   106,    59,   120,
+     227,   233,   189,   235,   236,   240,    48,    60,    61,   118,
+      64
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -784,56 +794,62 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      50,    35,    93,    34,    38,    36,    88,   107,   183,    88,
-      29,    69,    59,    32,   106,    27,   128,   129,   111,   113,
-     113,   133,   134,   140,   141,   196,    62,    63,   199,    64,
-      65,   132,    30,    66,    67,    33,   101,   160,    70,    28,
-     205,   120,   198,    39,    40,    37,   213,   201,     5,    57,
-      31,     6,   214,    93,   131,   161,   130,    41,    83,   119,
-       7,    61,     9,    95,    97,    98,    99,   100,   111,   103,
-     135,   136,   137,   138,   174,   169,   105,   181,    68,   108,
-      90,   143,    60,   144,   145,   146,    71,   191,  -111,   185,
-     186,   142,   141,   192,   193,   194,   195,     1,    72,     2,
-      80,     3,     4,     5,   170,   171,     6,    78,   197,    43,
-      44,    45,    46,    47,    82,     7,     8,     9,    73,    74,
-     150,   151,    48,    75,    77,    76,   163,   164,    79,    10,
-      11,    81,    12,    13,    14,    15,    16,    84,   177,    85,
-      87,   152,   153,   154,    86,    88,    90,    17,    94,   175,
-     101,    18,   115,   143,   155,   144,   145,   146,   121,   182,
-     156,   157,   143,   162,   144,   145,   146,    43,    44,    45,
-      46,    47,   122,   178,   123,   124,   179,   180,    50,   125,
-      48,    43,    44,    45,    46,    47,    43,    44,    45,    46,
-      47,   126,    49,   127,    48,   149,   165,   209,   168,    48,
-     143,   173,   144,   145,   146,   187,    96,   209,   188,   190,
-     183,   202,   204,   207,   206,   212,    56,   216,   200,   114,
-       0,   159,   167,   172,   217
+      56,    40,    62,   102,    43,   107,    31,   123,   102,   207,
+      39,    34,    79,   153,   154,    37,   238,    41,   122,   173,
+     174,    63,   239,   222,    42,   136,   138,   138,   225,    65,
+      32,    72,    73,    35,    74,    75,   157,    38,    76,    77,
+     117,    67,    80,   175,   176,   177,    71,   159,   183,   160,
+      68,    36,   220,    69,   145,   223,   155,   108,   178,   109,
+      78,   144,   190,   179,   180,    33,    66,   230,    97,   156,
+     161,   107,   162,   184,   111,   113,   114,   115,   116,    70,
+     119,    44,    45,   198,   126,     5,   205,   121,     6,   136,
+     124,    81,   168,   201,   169,    82,   194,     7,    46,     9,
+      47,   209,   210,   216,   217,   218,   219,     1,    89,     2,
+      83,     3,     4,     5,   125,   158,     6,   170,    84,   169,
+     127,   221,   128,   129,   130,     7,     8,     9,    90,   195,
+     131,   160,   202,    85,    86,   203,   204,    87,    88,    10,
+      11,  -123,    12,    13,    14,    15,    16,   163,   164,   165,
+     166,   186,   187,    91,    92,    93,    96,    17,    18,    19,
+      20,    94,    95,   101,    21,    49,    50,    51,    52,    53,
+      98,    99,   199,   100,    49,    50,    51,    52,    53,   102,
+     104,    54,   206,   117,   110,    49,    50,    51,    52,    53,
+      54,   140,     5,   147,    55,     6,    49,    50,    51,    52,
+      53,    54,    56,   112,     7,   146,     9,   148,   149,   172,
+     150,   151,    54,   127,   152,   128,   129,   130,   185,   188,
+     191,   193,   234,   131,   104,   127,   197,   128,   129,   130,
+     211,   215,   234,   212,   127,   131,   128,   129,   130,   214,
+     207,   226,   228,   229,   131,   231,   232,   237,   241,   192,
+     139,   171,   196,   224,   182,   242
 };
 
-static const yytype_int16 yycheck[] =
+static const yytype_uint8 yycheck[] =
 {
-       9,     4,    68,    60,     7,    10,    20,    81,    32,    20,
-       6,    32,     0,     6,    80,     4,    30,    31,    84,    85,
-      86,    69,    70,    69,    70,   182,    29,    30,   185,    32,
-      33,   105,    28,    36,    37,    28,    60,   121,    59,    28,
-     197,    91,   183,    44,    45,    13,     8,   188,     9,    62,
-      46,    12,    14,   119,   104,   121,    70,    58,    61,    70,
-      21,    13,    23,    72,    73,    74,    75,    76,   134,    78,
-      24,    25,    26,    27,   158,   141,    79,   161,    22,    82,
-      60,    61,    66,    63,    64,    65,    67,   171,    71,   163,
-     164,    69,    70,   177,   178,   179,   180,     3,    68,     5,
-      71,     7,     8,     9,    69,    70,    12,    70,   182,    47,
-      48,    49,    50,    51,    10,    21,    22,    23,    68,    68,
-      33,    34,    60,    68,    52,    68,   129,   130,    13,    35,
-      36,    52,    38,    39,    40,    41,    42,    68,    37,    68,
-      11,    54,    55,    56,    68,    20,    60,    53,    65,   158,
-      60,    57,    68,    61,    67,    63,    64,    65,    67,   162,
-      73,    74,    61,    31,    63,    64,    65,    47,    48,    49,
-      50,    51,    69,    72,    69,    69,    75,    76,   187,    69,
-      60,    47,    48,    49,    50,    51,    47,    48,    49,    50,
-      51,    69,    72,    69,    60,    29,    16,   206,    68,    60,
-      61,    33,    63,    64,    65,    17,    72,   216,    18,    63,
-      32,    15,    69,    19,    17,    63,    12,    70,   187,    86,
-      -1,   119,   134,   149,   216
+       9,     4,    12,    20,     7,    78,     4,    92,    20,    32,
+      63,     6,    32,    30,    31,     6,     8,    10,    91,    33,
+      34,    65,    14,   207,    13,    98,    99,   100,   212,    63,
+      28,    34,    35,    28,    37,    38,   121,    28,    41,    42,
+      63,    54,    62,    57,    58,    59,    13,    71,   146,    73,
+      63,    46,   206,     0,   105,   209,    73,    64,    72,    66,
+      22,    73,   160,    77,    78,    63,    63,   221,    71,   120,
+      71,   144,    73,   146,    83,    84,    85,    86,    87,    69,
+      89,    44,    45,   181,    94,     9,   184,    90,    12,   162,
+      93,    72,    71,    37,    73,    72,   169,    21,    61,    23,
+      63,   186,   187,   201,   202,   203,   204,     3,    73,     5,
+      70,     7,     8,     9,    38,   125,    12,    71,    70,    73,
+      64,   206,    66,    67,    68,    21,    22,    23,    13,    71,
+      74,    73,    76,    70,    70,    79,    80,    70,    52,    35,
+      36,    75,    38,    39,    40,    41,    42,    24,    25,    26,
+      27,   154,   155,    75,    52,    10,    63,    53,    54,    55,
+      56,    52,    70,    11,    60,    47,    48,    49,    50,    51,
+      70,    70,   181,    70,    47,    48,    49,    50,    51,    20,
+      63,    63,   185,    63,    68,    47,    48,    49,    50,    51,
+      63,    70,     9,    71,    76,    12,    47,    48,    49,    50,
+      51,    63,   211,    76,    21,    72,    23,    71,    71,    29,
+      71,    71,    63,    64,    71,    66,    67,    68,    31,    16,
+      63,    70,   231,    74,    63,    64,    33,    66,    67,    68,
+      17,    66,   241,    18,    64,    74,    66,    67,    68,    72,
+      32,    15,    63,    71,    74,    17,    19,    66,    73,   162,
+     100,   140,   172,   211,   144,   241
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
@@ -841,61 +857,66 @@ static const yytype_int16 yycheck[] =
 static const yytype_int8 yystos[] =
 {
        0,     3,     5,     7,     8,     9,    12,    21,    22,    23,
-      35,    36,    38,    39,    40,    41,    42,    53,    57,    78,
-      79,    80,    81,    82,    83,    84,    85,     4,    28,     6,
-      28,    46,     6,    28,    60,   113,    10,    13,   113,    44,
-      45,    58,   112,    47,    48,    49,    50,    51,    60,    72,
-      97,    98,    99,   104,   113,   114,    85,    62,   116,     0,
-      66,    13,   113,   113,   113,   113,   113,   113,    22,    32,
-      59,    67,    68,    68,    68,    68,    68,    52,    70,    13,
-      71,    52,    10,   113,    68,    68,    68,    11,    20,    93,
-      60,   102,   103,   114,    65,    97,    72,    97,    97,    97,
-      97,    60,   115,    97,   105,   113,   114,   115,   113,    86,
-      88,   114,    87,   114,    87,    68,    92,    96,    97,    70,
-      93,    67,    69,    69,    69,    69,    69,    69,    30,    31,
-      70,    93,   115,    69,    70,    24,    25,    26,    27,    89,
-      69,    70,    69,    61,    63,    64,    65,    90,    91,    29,
-      33,    34,    54,    55,    56,    67,    73,    74,   100,   103,
-      91,   114,    31,   113,   113,    16,   108,    88,    68,   114,
-      69,    70,    92,    33,    91,    97,   101,    37,    72,    75,
-      76,    91,   113,    32,    94,   115,   115,    17,    18,    95,
-      63,    91,    91,    91,    91,    91,    94,   115,    96,    94,
-      99,    96,    15,   106,    69,    94,    17,    19,   107,    97,
-     109,   110,    63,     8,    14,   111,    70,   110
+      35,    36,    38,    39,    40,    41,    42,    53,    54,    55,
+      56,    60,    82,    83,    84,    85,    86,    87,    88,    89,
+      90,     4,    28,    63,     6,    28,    46,     6,    28,    63,
+     118,    10,    13,   118,    44,    45,    61,    63,   117,    47,
+      48,    49,    50,    51,    63,    76,   102,   103,   104,   109,
+     118,   119,    90,    65,   121,    63,    63,    54,    63,     0,
+      69,    13,   118,   118,   118,   118,   118,   118,    22,    32,
+      62,    72,    72,    70,    70,    70,    70,    70,    52,    73,
+      13,    75,    52,    10,    52,    70,    63,   118,    70,    70,
+      70,    11,    20,    98,    63,   107,   108,   119,    64,    66,
+      68,   102,    76,   102,   102,   102,   102,    63,   120,   102,
+     110,   118,   119,   120,   118,    38,    90,    64,    66,    67,
+      68,    74,    95,    96,    91,    93,   119,    92,   119,    92,
+      70,    97,   101,   102,    73,    98,    72,    71,    71,    71,
+      71,    71,    71,    30,    31,    73,    98,   120,    90,    71,
+      73,    71,    73,    24,    25,    26,    27,    94,    71,    73,
+      71,    95,    29,    33,    34,    57,    58,    59,    72,    77,
+      78,   105,   108,    96,   119,    31,   118,   118,    16,   113,
+      96,    63,    93,    70,   119,    71,    97,    33,    96,   102,
+     106,    37,    76,    79,    80,    96,   118,    32,    99,   120,
+     120,    17,    18,   100,    72,    66,    96,    96,    96,    96,
+      99,   120,   101,    99,   104,   101,    15,   111,    63,    71,
+      99,    17,    19,   112,   102,   114,   115,    66,     8,    14,
+     116,    73,   115
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    77,    78,    78,    78,    78,    78,    79,    79,    79,
-      79,    79,    79,    80,    80,    80,    80,    81,    81,    82,
-      83,    83,    84,    84,    84,    84,    84,    84,    84,    85,
-      85,    85,    85,    86,    86,    87,    87,    88,    89,    89,
-      89,    89,    90,    90,    91,    91,    91,    91,    92,    93,
-      93,    94,    94,    95,    95,    96,    96,    97,    97,    97,
-      97,    98,    98,    98,    98,    98,    98,    99,    99,   100,
-     100,   100,   100,   100,   100,   100,   100,   101,   101,   102,
-     102,   103,   103,   103,   103,   103,   103,   104,   104,   105,
-     105,   105,   105,   105,   105,   105,   105,   106,   106,   107,
-     107,   108,   108,   109,   109,   110,   111,   111,   111,   112,
-     112,   113,   114,   115,   116
+       0,    81,    82,    82,    82,    82,    82,    83,    83,    83,
+      83,    83,    83,    83,    84,    84,    84,    84,    84,    84,
+      85,    85,    85,    85,    86,    86,    86,    87,    87,    87,
+      88,    88,    89,    89,    89,    89,    89,    89,    89,    89,
+      90,    90,    90,    90,    91,    91,    92,    92,    93,    94,
+      94,    94,    94,    95,    95,    96,    96,    96,    96,    96,
+      97,    98,    98,    99,    99,   100,   100,   101,   101,   102,
+     102,   102,   102,   103,   103,   103,   103,   103,   103,   104,
+     104,   105,   105,   105,   105,   105,   105,   105,   105,   106,
+     106,   107,   107,   108,   108,   108,   108,   108,   108,   109,
+     109,   110,   110,   110,   110,   110,   110,   110,   110,   111,
+     111,   112,   112,   113,   113,   114,   114,   115,   116,   116,
+     116,   117,   117,   118,   119,   120,   121
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     2,     1,     1,     1,     1,     2,     4,     4,
-       3,     3,     6,     3,     2,     6,     6,     4,     2,     7,
-       4,     5,     9,     1,     3,     1,     3,     2,     1,     4,
-       1,     1,     1,     3,     1,     1,     1,     1,     3,     0,
-       2,     0,     2,     0,     2,     1,     3,     3,     1,     3,
-       3,     4,     4,     4,     4,     4,     4,     1,     3,     1,
-       1,     1,     1,     1,     1,     1,     2,     1,     1,     1,
-       3,     3,     4,     5,     5,     5,     5,     1,     1,     1,
-       2,     3,     4,     4,     5,     5,     6,     3,     0,     2,
-       0,     3,     0,     1,     3,     2,     1,     1,     0,     1,
-       1,     1,     1,     1,     1
+       1,     1,     1,     2,     4,     5,     2,     5,     2,     3,
+       1,     1,     1,     1,     2,     2,     4,     4,     4,     4,
+       3,     3,     6,     9,     3,     2,     6,     6,     4,     2,
+       7,     4,     5,     9,     1,     3,     1,     3,     2,     1,
+       4,     1,     1,     1,     3,     1,     1,     1,     1,     1,
+       3,     0,     2,     0,     2,     0,     2,     1,     3,     3,
+       1,     3,     3,     4,     4,     4,     4,     4,     4,     1,
+       3,     1,     1,     1,     1,     1,     1,     1,     2,     1,
+       1,     1,     3,     3,     4,     5,     5,     5,     5,     1,
+       1,     1,     2,     3,     4,     4,     5,     5,     6,     3,
+       0,     2,     0,     3,     0,     1,     3,     2,     1,     1,
+       0,     1,     1,     1,     1,     1,     1
 };
 
 
@@ -924,7 +945,7 @@ enum { YYENOMEM = -2 };
       }                                                           \
     else                                                          \
       {                                                           \
-        yyerror (&yylloc, YY_("syntax error: cannot back up")); \
+        yyerror (&yylloc, scanner, parse_tree, error_msg, YY_("syntax error: cannot back up")); \
         YYERROR;                                                  \
       }                                                           \
   while (0)
@@ -1040,7 +1061,7 @@ do {                                                                      \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Kind, Value, Location); \
+                  Kind, Value, Location, scanner, parse_tree, error_msg); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -1052,11 +1073,14 @@ do {                                                                      \
 
 static void
 yy_symbol_value_print (FILE *yyo,
-                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg)
 {
   FILE *yyoutput = yyo;
   YY_USE (yyoutput);
   YY_USE (yylocationp);
+  YY_USE (scanner);
+  YY_USE (parse_tree);
+  YY_USE (error_msg);
   if (!yyvaluep)
     return;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
@@ -1071,14 +1095,14 @@ yy_symbol_value_print (FILE *yyo,
 
 static void
 yy_symbol_print (FILE *yyo,
-                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp, yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg)
 {
   YYFPRINTF (yyo, "%s %s (",
              yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
   YYLOCATION_PRINT (yyo, yylocationp);
   YYFPRINTF (yyo, ": ");
-  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp, scanner, parse_tree, error_msg);
   YYFPRINTF (yyo, ")");
 }
 
@@ -1112,7 +1136,7 @@ do {                                                            \
 
 static void
 yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
-                 int yyrule)
+                 int yyrule, yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1126,7 +1150,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
       yy_symbol_print (stderr,
                        YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
                        &yyvsp[(yyi + 1) - (yynrhs)],
-                       &(yylsp[(yyi + 1) - (yynrhs)]));
+                       &(yylsp[(yyi + 1) - (yynrhs)]), scanner, parse_tree, error_msg);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1134,7 +1158,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
 # define YY_REDUCE_PRINT(Rule)          \
 do {                                    \
   if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, yylsp, Rule); \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule, scanner, parse_tree, error_msg); \
 } while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -1443,10 +1467,13 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
 
 static void
 yydestruct (const char *yymsg,
-            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp, yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg)
 {
   YY_USE (yyvaluep);
   YY_USE (yylocationp);
+  YY_USE (scanner);
+  YY_USE (parse_tree);
+  YY_USE (error_msg);
   if (!yymsg)
     yymsg = "Deleting";
   YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
@@ -1466,7 +1493,7 @@ yydestruct (const char *yymsg,
 `----------*/
 
 int
-yyparse (void)
+yyparse (yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg)
 {
 /* Lookahead token kind.  */
 int yychar;
@@ -1659,7 +1686,7 @@ yybackup:
   if (yychar == YYEMPTY)
     {
       YYDPRINTF ((stderr, "Reading a token\n"));
-      yychar = yylex (&yylval, &yylloc);
+      yychar = yylex (&yylval, &yylloc, scanner);
     }
 
   if (yychar <= YYEOF)
@@ -1751,212 +1778,321 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* start: stmt ';'  */
-#line 82 "/home/nero/diff/db2025/src/parser/yacc.y"
+#line 89 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = (yyvsp[-1].sv_node);
         YYACCEPT;
     }
-#line 1760 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1787 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
   case 3: /* start: HELP  */
-#line 87 "/home/nero/diff/db2025/src/parser/yacc.y"
+#line 94 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = std::make_shared<Help>();
         YYACCEPT;
     }
-#line 1769 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1796 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
   case 4: /* start: EXIT  */
-#line 92 "/home/nero/diff/db2025/src/parser/yacc.y"
+#line 99 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1778 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1805 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
   case 5: /* start: T_EOF  */
-#line 97 "/home/nero/diff/db2025/src/parser/yacc.y"
+#line 104 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1787 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1814 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
   case 6: /* start: io_stmt  */
-#line 102 "/home/nero/diff/db2025/src/parser/yacc.y"
+#line 109 "/root/repo/src/parser/yacc.y"
     {
         parse_tree = (yyvsp[0].sv_node);
         YYACCEPT;
     }
-#line 1796 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1823 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 12: /* stmt: EXPLAIN dml  */
-#line 115 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 13: /* stmt: EXPLAIN dml  */
+#line 123 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ExplainStmt>(std::move((yyvsp[0].sv_node)));
     }
-#line 1804 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1831 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 14: /* prepareStmt: PREPARE IDENTIFIER AS dml  */
+#line 130 "/root/repo/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<PrepareStmt>(std::move((yyvsp[-2].sv_str)), std::move((yyvsp[0].sv_node)));
+    }
+#line 1839 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 15: /* prepareStmt: PREPARE IDENTIFIER AS EXPLAIN dml  */
+#line 134 "/root/repo/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<PrepareStmt>(std::move((yyvsp[-3].sv_str)), std::make_shared<ExplainStmt>(std::move((yyvsp[0].sv_node))));
+    }
+#line 1847 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 16: /* prepareStmt: EXECUTE IDENTIFIER  */
+#line 138 "/root/repo/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<ExecuteStmt>(std::move((yyvsp[0].sv_str)), std::vector<std::shared_ptr<Value>>());
+    }
+#line 1855 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 17: /* prepareStmt: EXECUTE IDENTIFIER '(' valueList ')'  */
+#line 142 "/root/repo/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<ExecuteStmt>(std::move((yyvsp[-3].sv_str)), std::move((yyvsp[-1].sv_vals)));
+    }
+#line 1863 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 18: /* prepareStmt: DEALLOCATE IDENTIFIER  */
+#line 146 "/root/repo/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<DeallocateStmt>(std::move((yyvsp[0].sv_str)));
+    }
+#line 1871 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 19: /* prepareStmt: DEALLOCATE PREPARE IDENTIFIER  */
+#line 150 "/root/repo/src/parser/yacc.y"
+    {
+        (yyval.sv_node) = std::make_shared<DeallocateStmt>(std::move((yyvsp[0].sv_str)));
+    }
+#line 1879 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 13: /* txnStmt: TXN_BEGIN  */
-#line 122 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 20: /* txnStmt: TXN_BEGIN  */
+#line 157 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnBegin>();
     }
-#line 1812 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1887 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 14: /* txnStmt: TXN_COMMIT  */
-#line 126 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 21: /* txnStmt: TXN_COMMIT  */
+#line 161 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnCommit>();
     }
-#line 1820 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1895 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 15: /* txnStmt: TXN_ABORT  */
-#line 130 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 22: /* txnStmt: TXN_ABORT  */
+#line 165 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnAbort>();
     }
-#line 1828 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1903 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 16: /* txnStmt: TXN_ROLLBACK  */
-#line 134 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 23: /* txnStmt: TXN_ROLLBACK  */
+#line 169 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnRollback>();
     }
-#line 1836 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1911 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 17: /* dbStmt: SHOW TABLES  */
-#line 141 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 24: /* dbStmt: SHOW TABLES  */
+#line 176 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowTables>();
     }
-#line 1844 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1919 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 25: /* dbStmt: SHOW IDENTIFIER  */
+#line 180 "/root/repo/src/parser/yacc.y"
+    {
+        // STATUS不是关键字，在这里检查
+        if (strcasecmp((yyvsp[0].sv_str).c_str(), "status") != 0)
+        {
+            yyerror(&(yylsp[0]), scanner, parse_tree, error_msg, ("unknown SHOW target " + (yyvsp[0].sv_str)).c_str());
+            YYABORT;
+        }
+        (yyval.sv_node) = std::make_shared<ShowStatus>();
+    }
+#line 1933 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 18: /* dbStmt: LOAD fileName INTO tbName  */
-#line 145 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 26: /* dbStmt: LOAD fileName INTO tbName  */
+#line 190 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<LoadStmt>(std::move((yyvsp[-2].sv_str)), std::move((yyvsp[0].sv_str)));
     }
-#line 1852 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1941 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 19: /* setStmt: SET set_knob_type '=' VALUE_BOOL  */
-#line 152 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 27: /* setStmt: SET set_knob_type '=' VALUE_BOOL  */
+#line 197 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<SetStmt>((yyvsp[-2].sv_setKnobType), (yyvsp[0].sv_bool));  // 移除std::move
     }
-#line 1860 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1949 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 28: /* setStmt: SET IDENTIFIER '=' VALUE_INT  */
+#line 201 "/root/repo/src/parser/yacc.y"
+    {
+        // 数值类型的参数名不是关键字，在这里检查
+        if (strcasecmp((yyvsp[-2].sv_str).c_str(), "buffer_pool_size") != 0)
+        {
+            yyerror(&(yylsp[-2]), scanner, parse_tree, error_msg, ("unknown knob " + (yyvsp[-2].sv_str)).c_str());
+            YYABORT;
+        }
+        (yyval.sv_node) = std::make_shared<SetStmt>(SetKnobType::BufferPoolSize, std::to_string((yyvsp[0].sv_int)));
+    }
+#line 1963 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 20: /* io_stmt: SET OUTPUT_FILE ON  */
-#line 158 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 29: /* setStmt: SET IDENTIFIER '=' VALUE_STRING  */
+#line 211 "/root/repo/src/parser/yacc.y"
+    {
+        if (strcasecmp((yyvsp[-2].sv_str).c_str(), "buffer_pool_size") != 0)
+        {
+            yyerror(&(yylsp[-2]), scanner, parse_tree, error_msg, ("unknown knob " + (yyvsp[-2].sv_str)).c_str());
+            YYABORT;
+        }
+        (yyval.sv_node) = std::make_shared<SetStmt>(SetKnobType::BufferPoolSize, (yyvsp[0].sv_str));
+    }
+#line 1976 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 30: /* io_stmt: SET OUTPUT_FILE ON  */
+#line 222 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<IoEnable>(true);
     }
-#line 1868 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1984 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 21: /* io_stmt: SET OUTPUT_FILE OFF  */
-#line 162 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 31: /* io_stmt: SET OUTPUT_FILE OFF  */
+#line 226 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<IoEnable>(false);
     }
-#line 1876 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 1992 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 22: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
-#line 168 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 32: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
+#line 232 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateTable>(std::move((yyvsp[-3].sv_str)), std::move((yyvsp[-1].sv_fields)));
     }
-#line 1884 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2000 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 33: /* ddl: CREATE TABLE tbName '(' fieldList ')' IDENTIFIER '=' IDENTIFIER  */
+#line 236 "/root/repo/src/parser/yacc.y"
+    {
+        // ROW_FORMAT和它的取值不是关键字，在这里检查
+        if (strcasecmp((yyvsp[-2].sv_str).c_str(), "row_format") != 0)
+        {
+            yyerror(&(yylsp[-2]), scanner, parse_tree, error_msg, ("unknown table option " + (yyvsp[-2].sv_str)).c_str());
+            YYABORT;
+        }
+        bool slotted = strcasecmp((yyvsp[0].sv_str).c_str(), "slotted") == 0;
+        if (!slotted && strcasecmp((yyvsp[0].sv_str).c_str(), "fixed") != 0)
+        {
+            yyerror(&(yylsp[0]), scanner, parse_tree, error_msg, ("unknown row format " + (yyvsp[0].sv_str)).c_str());
+            YYABORT;
+        }
+        (yyval.sv_node) = std::make_shared<CreateTable>(std::move((yyvsp[-6].sv_str)), std::move((yyvsp[-4].sv_fields)), slotted);
+    }
+#line 2020 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 23: /* ddl: DROP TABLE tbName  */
-#line 172 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 34: /* ddl: DROP TABLE tbName  */
+#line 252 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropTable>(std::move((yyvsp[0].sv_str)));
     }
-#line 1892 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2028 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 24: /* ddl: DESC tbName  */
-#line 176 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 35: /* ddl: DESC tbName  */
+#line 256 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DescTable>(std::move((yyvsp[0].sv_str)));
     }
-#line 1900 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2036 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 25: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
-#line 180 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 36: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
+#line 260 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateIndex>(std::move((yyvsp[-3].sv_str)), std::move((yyvsp[-1].sv_strs)));
     }
-#line 1908 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2044 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 26: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
-#line 184 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 37: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
+#line 264 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropIndex>(std::move((yyvsp[-3].sv_str)), std::move((yyvsp[-1].sv_strs)));
     }
-#line 1916 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2052 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 27: /* ddl: SHOW INDEX FROM tbName  */
-#line 188 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 38: /* ddl: SHOW INDEX FROM tbName  */
+#line 268 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowIndex>(std::move((yyvsp[0].sv_str)));
     }
-#line 1924 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2060 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 28: /* ddl: CREATE STATIC_CHECKPOINT  */
-#line 192 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 39: /* ddl: CREATE STATIC_CHECKPOINT  */
+#line 272 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateStaticCheckpoint>();
     }
-#line 1932 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2068 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 29: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
-#line 199 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 40: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
+#line 279 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<InsertStmt>(std::move((yyvsp[-4].sv_str)), std::move((yyvsp[-1].sv_vals)));
     }
-#line 1940 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2076 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 30: /* dml: DELETE FROM tbName optWhereClause  */
-#line 203 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 41: /* dml: DELETE FROM tbName optWhereClause  */
+#line 283 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DeleteStmt>(std::move((yyvsp[-1].sv_str)), std::move((yyvsp[0].sv_conds)));
     }
-#line 1948 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2084 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 31: /* dml: UPDATE tbName SET setClauses optWhereClause  */
-#line 207 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 42: /* dml: UPDATE tbName SET setClauses optWhereClause  */
+#line 287 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<UpdateStmt>(std::move((yyvsp[-3].sv_str)), std::move((yyvsp[-1].sv_set_clauses)), std::move((yyvsp[0].sv_conds)));
     }
-#line 1956 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2092 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 32: /* dml: SELECT selector FROM tableList optWhereClause opt_groupby_clause opt_having_clause opt_order_clause opt_limit_clause  */
-#line 211 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 43: /* dml: SELECT selector FROM tableList optWhereClause opt_groupby_clause opt_having_clause opt_order_clause opt_limit_clause  */
+#line 291 "/root/repo/src/parser/yacc.y"
     {
         // 例如在 SelectStmt 创建时
         (yyval.sv_node) = std::make_shared<SelectStmt>(
@@ -1971,469 +2107,478 @@ yyreduce:
             std::move((yyvsp[-5].sv_table_list).aliases)      // 表别名
         );
     }
-#line 1975 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2111 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 33: /* fieldList: field  */
-#line 229 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 44: /* fieldList: field  */
+#line 309 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{std::move((yyvsp[0].sv_field))};
     }
-#line 1983 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2119 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 34: /* fieldList: fieldList ',' field  */
-#line 233 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 45: /* fieldList: fieldList ',' field  */
+#line 313 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_fields).emplace_back(std::move((yyvsp[0].sv_field)));
     }
-#line 1991 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2127 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 35: /* colNameList: colName  */
-#line 240 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 46: /* colNameList: colName  */
+#line 320 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{std::move((yyvsp[0].sv_str))}; // 使用 move
     }
-#line 1999 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2135 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 36: /* colNameList: colNameList ',' colName  */
-#line 244 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 47: /* colNameList: colNameList ',' colName  */
+#line 324 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_strs).emplace_back(std::move((yyvsp[0].sv_str))); // 使用 move
     }
-#line 2007 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2143 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 37: /* field: colName type  */
-#line 251 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 48: /* field: colName type  */
+#line 331 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_field) = std::make_shared<ColDef>(std::move((yyvsp[-1].sv_str)), std::move((yyvsp[0].sv_type_len)));
     }
-#line 2015 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2151 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 38: /* type: INT  */
-#line 258 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 49: /* type: INT  */
+#line 338 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_INT, sizeof(int));
     }
-#line 2023 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2159 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 39: /* type: CHAR '(' VALUE_INT ')'  */
-#line 262 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 50: /* type: CHAR '(' VALUE_INT ')'  */
+#line 342 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, (yyvsp[-1].sv_int));
     }
-#line 2031 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2167 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 40: /* type: FLOAT  */
-#line 266 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 51: /* type: FLOAT  */
+#line 346 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
     }
-#line 2039 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2175 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 41: /* type: DATETIME  */
-#line 270 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 52: /* type: DATETIME  */
+#line 350 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_DATETIME, 19);
     }
-#line 2047 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2183 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 42: /* valueList: value  */
-#line 277 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 53: /* valueList: value  */
+#line 357 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_vals) = std::vector<std::shared_ptr<Value>>{std::move((yyvsp[0].sv_val))}; // 使用 move
     }
-#line 2055 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2191 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 43: /* valueList: valueList ',' value  */
-#line 281 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 54: /* valueList: valueList ',' value  */
+#line 361 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_vals).emplace_back(std::move((yyvsp[0].sv_val))); // 使用 move
     }
-#line 2063 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2199 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 44: /* value: VALUE_INT  */
-#line 288 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 55: /* value: VALUE_INT  */
+#line 368 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<IntLit>((yyvsp[0].sv_int));
     }
-#line 2071 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2207 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 45: /* value: VALUE_FLOAT  */
-#line 292 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 56: /* value: VALUE_FLOAT  */
+#line 372 "/root/repo/src/parser/yacc.y"
     {
         // 浮点数在词法分析阶段已经进行了精度处理
         (yyval.sv_val) = std::make_shared<FloatLit>((yyvsp[0].sv_float));
     }
-#line 2080 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2216 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 46: /* value: VALUE_STRING  */
-#line 297 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 57: /* value: VALUE_STRING  */
+#line 377 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<StringLit>(std::move((yyvsp[0].sv_str)));
     }
-#line 2088 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2224 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 47: /* value: VALUE_BOOL  */
-#line 301 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 58: /* value: VALUE_BOOL  */
+#line 381 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<BoolLit>((yyvsp[0].sv_bool));
     }
-#line 2096 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2232 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 48: /* condition: col op expr  */
-#line 308 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 59: /* value: '?'  */
+#line 385 "/root/repo/src/parser/yacc.y"
+    {
+        // 参数编号在整条语句解析完成后统一分配
+        (yyval.sv_val) = std::make_shared<Param>();
+    }
+#line 2241 "/root/repo/src/parser/yacc.tab.cpp"
+    break;
+
+  case 60: /* condition: col op expr  */
+#line 393 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>(std::move((yyvsp[-2].sv_col)), (yyvsp[-1].sv_comp_op), std::move((yyvsp[0].sv_expr)));
     }
-#line 2104 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2249 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 49: /* optWhereClause: %empty  */
-#line 315 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 61: /* optWhereClause: %empty  */
+#line 400 "/root/repo/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 2110 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2255 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 50: /* optWhereClause: WHERE whereClause  */
-#line 317 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 62: /* optWhereClause: WHERE whereClause  */
+#line 402 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 2118 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2263 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 51: /* optJoinClause: %empty  */
-#line 323 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 63: /* optJoinClause: %empty  */
+#line 408 "/root/repo/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 2124 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2269 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 52: /* optJoinClause: ON whereClause  */
-#line 325 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 64: /* optJoinClause: ON whereClause  */
+#line 410 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 2132 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2277 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 53: /* opt_having_clause: %empty  */
-#line 331 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 65: /* opt_having_clause: %empty  */
+#line 416 "/root/repo/src/parser/yacc.y"
                   { /* ignore*/ }
-#line 2138 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2283 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 54: /* opt_having_clause: HAVING whereClause  */
-#line 333 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 66: /* opt_having_clause: HAVING whereClause  */
+#line 418 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 2146 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2291 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 55: /* whereClause: condition  */
-#line 340 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 67: /* whereClause: condition  */
+#line 425 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{std::move((yyvsp[0].sv_cond))}; // 使用 move
     }
-#line 2154 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2299 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 56: /* whereClause: whereClause AND condition  */
-#line 344 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 68: /* whereClause: whereClause AND condition  */
+#line 429 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_conds).emplace_back(std::move((yyvsp[0].sv_cond))); // 使用 move
     }
-#line 2162 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2307 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 57: /* col: tbName '.' colName  */
-#line 352 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 69: /* col: tbName '.' colName  */
+#line 437 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>(std::move((yyvsp[-2].sv_str)), std::move((yyvsp[0].sv_str)));
     }
-#line 2170 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2315 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 58: /* col: colName  */
-#line 356 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 70: /* col: colName  */
+#line 441 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", std::move((yyvsp[0].sv_str)));
     }
-#line 2178 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2323 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 59: /* col: colName AS ALIAS  */
-#line 360 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 71: /* col: colName AS ALIAS  */
+#line 445 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", std::move((yyvsp[-2].sv_str)));
         (yyval.sv_col)->alias = std::move((yyvsp[0].sv_str));
     }
-#line 2187 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2332 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 60: /* col: aggCol AS ALIAS  */
-#line 365 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 72: /* col: aggCol AS ALIAS  */
+#line 450 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::move((yyvsp[-2].sv_col));
         (yyval.sv_col)->alias = std::move((yyvsp[0].sv_str));
     }
-#line 2196 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2341 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 61: /* aggCol: SUM '(' col ')'  */
-#line 373 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 73: /* aggCol: SUM '(' col ')'  */
+#line 458 "/root/repo/src/parser/yacc.y"
 {
     (yyval.sv_col) = std::make_shared<Col>(std::move((yyvsp[-1].sv_col)->tab_name), std::move((yyvsp[-1].sv_col)->col_name), AggFuncType::SUM);
 }
-#line 2204 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2349 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 62: /* aggCol: MIN '(' col ')'  */
-#line 377 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 74: /* aggCol: MIN '(' col ')'  */
+#line 462 "/root/repo/src/parser/yacc.y"
     {
         // 优化后
         (yyval.sv_col) = std::make_shared<Col>(std::move((yyvsp[-1].sv_col)->tab_name), std::move((yyvsp[-1].sv_col)->col_name), AggFuncType::MIN);
     }
-#line 2213 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2358 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 63: /* aggCol: MAX '(' col ')'  */
-#line 382 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 75: /* aggCol: MAX '(' col ')'  */
+#line 467 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>(std::move((yyvsp[-1].sv_col)->tab_name), std::move((yyvsp[-1].sv_col)->col_name), AggFuncType::MAX);
     }
-#line 2221 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2366 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 64: /* aggCol: AVG '(' col ')'  */
-#line 386 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 76: /* aggCol: AVG '(' col ')'  */
+#line 471 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>(std::move((yyvsp[-1].sv_col)->tab_name), std::move((yyvsp[-1].sv_col)->col_name), AggFuncType::AVG);
     }
-#line 2229 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2374 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 65: /* aggCol: COUNT '(' col ')'  */
-#line 390 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 77: /* aggCol: COUNT '(' col ')'  */
+#line 475 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>(std::move((yyvsp[-1].sv_col)->tab_name), std::move((yyvsp[-1].sv_col)->col_name), AggFuncType::COUNT);
     }
-#line 2237 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2382 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 66: /* aggCol: COUNT '(' '*' ')'  */
-#line 394 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 78: /* aggCol: COUNT '(' '*' ')'  */
+#line 479 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", "*", AggFuncType::COUNT);
     }
-#line 2245 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2390 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 67: /* colList: col  */
-#line 401 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 79: /* colList: col  */
+#line 486 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{std::move((yyvsp[0].sv_col))}; // 使用 move
     }
-#line 2253 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2398 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 68: /* colList: colList ',' col  */
-#line 405 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 80: /* colList: colList ',' col  */
+#line 490 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cols).emplace_back(std::move((yyvsp[0].sv_col))); // 使用 move
     }
-#line 2261 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2406 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 69: /* op: '='  */
-#line 412 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 81: /* op: '='  */
+#line 497 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_EQ;
     }
-#line 2269 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2414 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 70: /* op: '<'  */
-#line 416 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 82: /* op: '<'  */
+#line 501 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LT;
     }
-#line 2277 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2422 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 71: /* op: '>'  */
-#line 420 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 83: /* op: '>'  */
+#line 505 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GT;
     }
-#line 2285 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2430 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 72: /* op: NEQ  */
-#line 424 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 84: /* op: NEQ  */
+#line 509 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_NE;
     }
-#line 2293 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2438 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 73: /* op: LEQ  */
-#line 428 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 85: /* op: LEQ  */
+#line 513 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LE;
     }
-#line 2301 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2446 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 74: /* op: GEQ  */
-#line 432 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 86: /* op: GEQ  */
+#line 517 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GE;
     }
-#line 2309 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2454 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 75: /* op: IN  */
-#line 436 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 87: /* op: IN  */
+#line 521 "/root/repo/src/parser/yacc.y"
     {
 	    (yyval.sv_comp_op) = SV_OP_IN;
     }
-#line 2317 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2462 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 76: /* op: NOT IN  */
-#line 440 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 88: /* op: NOT IN  */
+#line 525 "/root/repo/src/parser/yacc.y"
     {
     	(yyval.sv_comp_op) = SV_OP_NOT_IN;
     }
-#line 2325 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2470 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 77: /* expr: value  */
-#line 447 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 89: /* expr: value  */
+#line 532 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_val));
     }
-#line 2333 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2478 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 78: /* expr: col  */
-#line 451 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 90: /* expr: col  */
+#line 536 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_col));
     }
-#line 2341 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2486 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 79: /* setClauses: setClause  */
-#line 458 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 91: /* setClauses: setClause  */
+#line 543 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses) = std::vector<std::shared_ptr<SetClause>>{std::move((yyvsp[0].sv_set_clause))}; // 使用 move
     }
-#line 2349 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2494 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 80: /* setClauses: setClauses ',' setClause  */
-#line 462 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 92: /* setClauses: setClauses ',' setClause  */
+#line 547 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses).emplace_back(std::move((yyvsp[0].sv_set_clause))); // 使用 move
     }
-#line 2357 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2502 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 81: /* setClause: colName '=' value  */
-#line 469 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 93: /* setClause: colName '=' value  */
+#line 554 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>(std::move((yyvsp[-2].sv_str)), std::move((yyvsp[0].sv_val)), UpdateOp::ASSINGMENT);
     }
-#line 2365 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2510 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 82: /* setClause: colName '=' colName value  */
-#line 473 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 94: /* setClause: colName '=' colName value  */
+#line 558 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-3].sv_str), (yyvsp[0].sv_val), UpdateOp::SELF_ADD);
     }
-#line 2373 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2518 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 83: /* setClause: colName '=' colName '+' value  */
-#line 477 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 95: /* setClause: colName '=' colName '+' value  */
+#line 562 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>(std::move((yyvsp[-4].sv_str)), std::move((yyvsp[0].sv_val)), UpdateOp::SELF_ADD);
     }
-#line 2381 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2526 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 84: /* setClause: colName '=' colName '-' value  */
-#line 481 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 96: /* setClause: colName '=' colName '-' value  */
+#line 566 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>(std::move((yyvsp[-4].sv_str)), std::move((yyvsp[0].sv_val)), UpdateOp::SELF_SUB);
     }
-#line 2389 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2534 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 85: /* setClause: colName '=' colName '*' value  */
-#line 485 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 97: /* setClause: colName '=' colName '*' value  */
+#line 570 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>(std::move((yyvsp[-4].sv_str)), std::move((yyvsp[0].sv_val)), UpdateOp::SELF_MUT);
     }
-#line 2397 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2542 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 86: /* setClause: colName '=' colName DIV value  */
-#line 489 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 98: /* setClause: colName '=' colName DIV value  */
+#line 574 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>(std::move((yyvsp[-4].sv_str)), std::move((yyvsp[0].sv_val)), UpdateOp::SELF_DIV);
     }
-#line 2405 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2550 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 87: /* selector: '*'  */
-#line 496 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 99: /* selector: '*'  */
+#line 581 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cols) = {};
     }
-#line 2413 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2558 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 89: /* tableList: tbName  */
-#line 504 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 101: /* tableList: tbName  */
+#line 589 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_table_list).tables = {std::move((yyvsp[0].sv_str))}; // 使用 move
         (yyval.sv_table_list).aliases = {""};
         (yyval.sv_table_list).jointree = {};
     }
-#line 2423 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2568 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 90: /* tableList: tbName ALIAS  */
-#line 510 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 102: /* tableList: tbName ALIAS  */
+#line 595 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_table_list).tables = {std::move((yyvsp[-1].sv_str))}; // 使用 move
         (yyval.sv_table_list).aliases = {std::move((yyvsp[0].sv_str))}; // 使用 move
         (yyval.sv_table_list).jointree = {};
     }
-#line 2433 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2578 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 91: /* tableList: tableList ',' tbName  */
-#line 516 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 103: /* tableList: tableList ',' tbName  */
+#line 601 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_table_list).tables = std::move((yyvsp[-2].sv_table_list).tables); // 使用 move
         (yyval.sv_table_list).aliases = std::move((yyvsp[-2].sv_table_list).aliases); // 使用 move
@@ -2441,11 +2586,11 @@ yyreduce:
         (yyval.sv_table_list).aliases.emplace_back("");
         (yyval.sv_table_list).jointree = std::move((yyvsp[-2].sv_table_list).jointree); // 使用 move
     }
-#line 2445 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2590 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 92: /* tableList: tableList ',' tbName ALIAS  */
-#line 524 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 104: /* tableList: tableList ',' tbName ALIAS  */
+#line 609 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_table_list).tables = std::move((yyvsp[-3].sv_table_list).tables);     // 使用 move
         (yyval.sv_table_list).aliases = std::move((yyvsp[-3].sv_table_list).aliases);   // 使用 move
@@ -2453,11 +2598,11 @@ yyreduce:
         (yyval.sv_table_list).aliases.emplace_back(std::move((yyvsp[0].sv_str))); // 使用 move
         (yyval.sv_table_list).jointree = std::move((yyvsp[-3].sv_table_list).jointree);  // 使用 move
     }
-#line 2457 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2602 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 93: /* tableList: tableList JOIN tbName optJoinClause  */
-#line 532 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 105: /* tableList: tableList JOIN tbName optJoinClause  */
+#line 617 "/root/repo/src/parser/yacc.y"
     {
         auto join_expr = std::make_shared<JoinExpr>(
             std::move((yyvsp[-3].sv_table_list).tables.back()),  // left
@@ -2474,11 +2619,11 @@ yyreduce:
         (yyval.sv_table_list).jointree = std::move((yyvsp[-3].sv_table_list).jointree);
         (yyval.sv_table_list).jointree.emplace_back(std::move(join_expr));
     }
-#line 2478 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2623 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 94: /* tableList: tableList JOIN tbName ALIAS optJoinClause  */
-#line 549 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 106: /* tableList: tableList JOIN tbName ALIAS optJoinClause  */
+#line 634 "/root/repo/src/parser/yacc.y"
     {
         auto join_expr = std::make_shared<JoinExpr>(
             std::move((yyvsp[-4].sv_table_list).tables.back()),  // left
@@ -2495,11 +2640,11 @@ yyreduce:
         (yyval.sv_table_list).jointree = std::move((yyvsp[-4].sv_table_list).jointree);
         (yyval.sv_table_list).jointree.emplace_back(std::move(join_expr));
     }
-#line 2499 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2644 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 95: /* tableList: tableList SEMI JOIN tbName optJoinClause  */
-#line 566 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 107: /* tableList: tableList SEMI JOIN tbName optJoinClause  */
+#line 651 "/root/repo/src/parser/yacc.y"
     {
         auto join_expr = std::make_shared<JoinExpr>(
             std::move((yyvsp[-4].sv_table_list).tables.back()),  // left
@@ -2516,11 +2661,11 @@ yyreduce:
         (yyval.sv_table_list).jointree = std::move((yyvsp[-4].sv_table_list).jointree);
         (yyval.sv_table_list).jointree.emplace_back(std::move(join_expr));
     }
-#line 2520 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2665 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 96: /* tableList: tableList SEMI JOIN tbName ALIAS optJoinClause  */
-#line 583 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 108: /* tableList: tableList SEMI JOIN tbName ALIAS optJoinClause  */
+#line 668 "/root/repo/src/parser/yacc.y"
     {
         auto join_expr = std::make_shared<JoinExpr>(
             std::move((yyvsp[-5].sv_table_list).tables.back()),  // left
@@ -2537,110 +2682,110 @@ yyreduce:
         (yyval.sv_table_list).jointree = std::move((yyvsp[-5].sv_table_list).jointree);
         (yyval.sv_table_list).jointree.emplace_back(std::move(join_expr));
     }
-#line 2541 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2686 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 97: /* opt_order_clause: ORDER BY order_clause  */
-#line 603 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 109: /* opt_order_clause: ORDER BY order_clause  */
+#line 688 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_orderby) = (yyvsp[0].sv_orderby);
     }
-#line 2549 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2694 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 98: /* opt_order_clause: %empty  */
-#line 606 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 110: /* opt_order_clause: %empty  */
+#line 691 "/root/repo/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 2555 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2700 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 99: /* opt_limit_clause: LIMIT VALUE_INT  */
-#line 611 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 111: /* opt_limit_clause: LIMIT VALUE_INT  */
+#line 696 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_int) = (yyvsp[0].sv_int);
     }
-#line 2563 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2708 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 100: /* opt_limit_clause: %empty  */
-#line 615 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 112: /* opt_limit_clause: %empty  */
+#line 700 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_int) = -1;
     }
-#line 2571 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2716 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 101: /* opt_groupby_clause: GROUP BY colList  */
-#line 622 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 113: /* opt_groupby_clause: GROUP BY colList  */
+#line 707 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_cols) = (yyvsp[0].sv_cols);
     }
-#line 2579 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2724 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 102: /* opt_groupby_clause: %empty  */
-#line 625 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 114: /* opt_groupby_clause: %empty  */
+#line 710 "/root/repo/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 2585 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2730 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 103: /* order_clause: order_item  */
-#line 630 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 115: /* order_clause: order_item  */
+#line 715 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_orderby) = std::make_shared<OrderBy>(std::move((yyvsp[0].sv_order_item).first), (yyvsp[0].sv_order_item).second);
     }
-#line 2593 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2738 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 104: /* order_clause: order_clause ',' order_item  */
-#line 634 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 116: /* order_clause: order_clause ',' order_item  */
+#line 719 "/root/repo/src/parser/yacc.y"
     {
         (yyvsp[-2].sv_orderby)->addItem(std::move((yyvsp[0].sv_order_item).first), (yyvsp[0].sv_order_item).second);
         (yyval.sv_orderby) = std::move((yyvsp[-2].sv_orderby));  // 使用 move
     }
-#line 2602 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2747 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 105: /* order_item: col opt_asc_desc  */
-#line 642 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 117: /* order_item: col opt_asc_desc  */
+#line 727 "/root/repo/src/parser/yacc.y"
     {
         (yyval.sv_order_item) = std::make_pair(std::move((yyvsp[-1].sv_col)), (yyvsp[0].sv_orderby_dir));
     }
-#line 2610 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2755 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 106: /* opt_asc_desc: ASC  */
-#line 648 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 118: /* opt_asc_desc: ASC  */
+#line 733 "/root/repo/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_ASC;     }
-#line 2616 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2761 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 107: /* opt_asc_desc: DESC  */
-#line 649 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 119: /* opt_asc_desc: DESC  */
+#line 734 "/root/repo/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_DESC;    }
-#line 2622 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2767 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 108: /* opt_asc_desc: %empty  */
-#line 650 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 120: /* opt_asc_desc: %empty  */
+#line 735 "/root/repo/src/parser/yacc.y"
             { (yyval.sv_orderby_dir) = OrderBy_DEFAULT; }
-#line 2628 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2773 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 109: /* set_knob_type: ENABLE_NESTLOOP  */
-#line 654 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 121: /* set_knob_type: ENABLE_NESTLOOP  */
+#line 739 "/root/repo/src/parser/yacc.y"
                     { (yyval.sv_setKnobType) = ast::SetKnobType::EnableNestLoop; }
-#line 2634 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2779 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
-  case 110: /* set_knob_type: ENABLE_SORTMERGE  */
-#line 655 "/home/nero/diff/db2025/src/parser/yacc.y"
+  case 122: /* set_knob_type: ENABLE_SORTMERGE  */
+#line 740 "/root/repo/src/parser/yacc.y"
                          { (yyval.sv_setKnobType) = ast::SetKnobType::EnableSortMerge; }
-#line 2640 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2785 "/root/repo/src/parser/yacc.tab.cpp"
     break;
 
 
-#line 2644 "/home/nero/diff/db2025/src/parser/yacc.tab.cpp"
+#line 2789 "/root/repo/src/parser/yacc.tab.cpp"
 
       default: break;
     }
@@ -2715,7 +2860,7 @@ yyerrlab:
                 yysyntax_error_status = YYENOMEM;
               }
           }
-        yyerror (&yylloc, yymsgp);
+        yyerror (&yylloc, scanner, parse_tree, error_msg, yymsgp);
         if (yysyntax_error_status == YYENOMEM)
           YYNOMEM;
       }
@@ -2736,7 +2881,7 @@ yyerrlab:
       else
         {
           yydestruct ("Error: discarding",
-                      yytoken, &yylval, &yylloc);
+                      yytoken, &yylval, &yylloc, scanner, parse_tree, error_msg);
           yychar = YYEMPTY;
         }
     }
@@ -2792,7 +2937,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp, scanner, parse_tree, error_msg);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2833,7 +2978,7 @@ yyabortlab:
 | yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
 `-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (&yylloc, YY_("memory exhausted"));
+  yyerror (&yylloc, scanner, parse_tree, error_msg, YY_("memory exhausted"));
   yyresult = 2;
   goto yyreturnlab;
 
@@ -2848,7 +2993,7 @@ yyreturnlab:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, &yylloc);
+                  yytoken, &yylval, &yylloc, scanner, parse_tree, error_msg);
     }
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
@@ -2857,7 +3002,7 @@ yyreturnlab:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp, scanner, parse_tree, error_msg);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -2869,4 +3014,64 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 667 "/home/nero/diff/db2025/src/parser/yacc.y"
+#line 752 "/root/repo/src/parser/yacc.y"
+
+
+/**
+ * @description: 只做词法分析，把语句规范化为常量替换成'?'的形式，作为计划缓存的键
+ * @return {bool} 语句能否使用计划缓存，只缓存以';'结尾且不含'?'的SELECT/INSERT/UPDATE/DELETE
+ * @param {yyscan_t} scanner 已经设置好输入缓冲区的词法分析器
+ * @param {string&} key 规范化后的语句
+ * @param {vector<shared_ptr<Value>>&} literals 按出现顺序收集的常量
+ */
+bool yynormalize(yyscan_t scanner, std::string &key, std::vector<std::shared_ptr<ast::Value>> &literals)
+{
+    YYSTYPE lval;
+    YYLTYPE lloc = {1, 1, 1, 1};
+    key.clear();
+    literals.clear();
+
+    int tok = yylex(&lval, &lloc, scanner);
+    if (tok != SELECT && tok != INSERT && tok != UPDATE && tok != DELETE)
+        return false;
+    for (int prev = 0; tok != ';'; prev = tok, tok = yylex(&lval, &lloc, scanner))
+    {
+        switch (tok)
+        {
+        case 0:
+        case T_EOF:
+        case '?':
+            return false;
+        case VALUE_INT:
+            // LIMIT的值会影响排序计划，保留在键中
+            if (prev == LIMIT)
+            {
+                key += std::to_string(lval.sv_int);
+                break;
+            }
+            key += '?';
+            literals.emplace_back(std::make_shared<IntLit>(lval.sv_int));
+            break;
+        case VALUE_FLOAT:
+            key += '?';
+            literals.emplace_back(std::make_shared<FloatLit>(lval.sv_float));
+            break;
+        case VALUE_STRING:
+            key += '?';
+            literals.emplace_back(std::make_shared<StringLit>(std::move(lval.sv_str)));
+            break;
+        case VALUE_BOOL:
+            key += lval.sv_bool ? "true" : "false";
+            break;
+        case IDENTIFIER:
+        case VALUE_PATH:
+            key += lval.sv_str;
+            break;
+        default:
+            key += std::to_string(tok);
+            break;
+        }
+        key += ' ';
+    }
+    return true;
+}
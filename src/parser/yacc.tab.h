@@ -35,8 +35,8 @@
    especially those whose name start with YY_ or yy_.  They are
    private implementation details that can be changed or removed.  */
 
-#ifndef YY_YY_HOME_NERO_DIFF_DB2025_SRC_PARSER_YACC_TAB_H_INCLUDED
-# define YY_YY_HOME_NERO_DIFF_DB2025_SRC_PARSER_YACC_TAB_H_INCLUDED
+#ifndef YY_YY_ROOT_REPO_SRC_PARSER_YACC_TAB_H_INCLUDED
+# define YY_YY_ROOT_REPO_SRC_PARSER_YACC_TAB_H_INCLUDED
 /* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
@@ -44,6 +44,15 @@
 #if YYDEBUG
 extern int yydebug;
 #endif
+/* "%code requires" blocks.  */
+#line 29 "/root/repo/src/parser/yacc.y"
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+
+#line 56 "/root/repo/src/parser/yacc.tab.h"
 
 /* Token kinds.  */
 #ifndef YYTOKENTYPE
@@ -105,18 +114,21 @@ extern int yydebug;
     AVG = 306,                     /* AVG  */
     AS = 307,                      /* AS  */
     LOAD = 308,                    /* LOAD  */
-    LEQ = 309,                     /* LEQ  */
-    NEQ = 310,                     /* NEQ  */
-    GEQ = 311,                     /* GEQ  */
-    T_EOF = 312,                   /* T_EOF  */
-    OUTPUT_FILE = 313,             /* OUTPUT_FILE  */
-    OFF = 314,                     /* OFF  */
-    IDENTIFIER = 315,              /* IDENTIFIER  */
-    VALUE_STRING = 316,            /* VALUE_STRING  */
-    VALUE_PATH = 317,              /* VALUE_PATH  */
-    VALUE_INT = 318,               /* VALUE_INT  */
-    VALUE_FLOAT = 319,             /* VALUE_FLOAT  */
-    VALUE_BOOL = 320               /* VALUE_BOOL  */
+    PREPARE = 309,                 /* PREPARE  */
+    EXECUTE = 310,                 /* EXECUTE  */
+    DEALLOCATE = 311,              /* DEALLOCATE  */
+    LEQ = 312,                     /* LEQ  */
+    NEQ = 313,                     /* NEQ  */
+    GEQ = 314,                     /* GEQ  */
+    T_EOF = 315,                   /* T_EOF  */
+    OUTPUT_FILE = 316,             /* OUTPUT_FILE  */
+    OFF = 317,                     /* OFF  */
+    IDENTIFIER = 318,              /* IDENTIFIER  */
+    VALUE_STRING = 319,            /* VALUE_STRING  */
+    VALUE_PATH = 320,              /* VALUE_PATH  */
+    VALUE_INT = 321,               /* VALUE_INT  */
+    VALUE_FLOAT = 322,             /* VALUE_FLOAT  */
+    VALUE_BOOL = 323               /* VALUE_BOOL  */
   };
   typedef enum yytokentype yytoken_kind_t;
 #endif
@@ -140,7 +152,7 @@ struct YYLTYPE
 
 
 
-int yyparse (void);
+int yyparse (yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg);
 
 
-#endif /* !YY_YY_HOME_NERO_DIFF_DB2025_SRC_PARSER_YACC_TAB_H_INCLUDED  */
+#endif /* !YY_YY_ROOT_REPO_SRC_PARSER_YACC_TAB_H_INCLUDED  */
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <memory>
 #include <cstring>
+#include <strings.h>
 #include <cmath>
 #include <sstream>
 #include <iomanip>
@@ -12,26 +13,32 @@
 const int FLOAT_PRECISION = 6;
 const float FLOAT_PRECISION_MULTIPLIER = std::pow(10, FLOAT_PRECISION);
 
-int yylex(YYSTYPE *yylval, YYLTYPE *yylloc);
+int yylex(YYSTYPE *yylval, YYLTYPE *yylloc, yyscan_t scanner);
 
-void yyerror(YYLTYPE *locp, const char* s) {
+void yyerror(YYLTYPE *locp, yyscan_t scanner, std::shared_ptr<ast::TreeNode> &parse_tree, std::string &error_msg, const char* s) {
     //std::cerr << "Parser Error at line " << locp->first_line << " column " << locp->first_column << ": " << s << std::endl;
-        std::string error_msg = "Parser Error at line " + std::to_string(locp->first_line) +
-                           " column " + std::to_string(locp->first_column) + ": " + s + "\n";
+    // 错误信息保存在调用者传入的error_msg中，各个解析器之间不共享
+    error_msg = "Parser Error at line " + std::to_string(locp->first_line) +
+                " column " + std::to_string(locp->first_column) + ": " + s + "\n";
     std::cerr << error_msg;
-
-    // 将错误信息保存到全局变量中，以便后续传递给客户端
-    extern char *g_error_msg;
-    if (g_error_msg != nullptr) {
-        strcpy(g_error_msg, error_msg.c_str());
-    }
 }
 
 using namespace ast;
 %}
 
+%code requires {
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+}
+
 // request a pure (reentrant) parser
 %define api.pure full
+// the scanner state and the result tree belong to the caller, not to globals
+%param {yyscan_t scanner}
+%parse-param {std::shared_ptr<ast::TreeNode> &parse_tree}
+%parse-param {std::string &error_msg}
 // enable location in error handler
 %locations
 // enable verbose syntax error message
@@ -41,7 +48,7 @@ using namespace ast;
 %token SHOW TABLES CREATE TABLE DROP DESC INSERT INTO VALUES DELETE FROM ASC ORDER GROUP BY HAVING LIMIT
 WHERE UPDATE SET SELECT INT CHAR FLOAT DATETIME INDEX AND SEMI JOIN ON IN NOT EXIT HELP DIV EXPLAIN
 TXN_BEGIN TXN_COMMIT TXN_ABORT TXN_ROLLBACK ORDER_BY ENABLE_NESTLOOP ENABLE_SORTMERGE STATIC_CHECKPOINT
-SUM COUNT MAX MIN AVG AS LOAD
+SUM COUNT MAX MIN AVG AS LOAD PREPARE EXECUTE DEALLOCATE
 // non-keywords
 %token LEQ NEQ GEQ T_EOF
 %token OUTPUT_FILE OFF
@@ -54,7 +61,7 @@ SUM COUNT MAX MIN AVG AS LOAD
 %token <sv_bool> VALUE_BOOL
 
 // specify types for non-terminal symbol
-%type <sv_node> stmt dbStmt ddl dml txnStmt setStmt io_stmt
+%type <sv_node> stmt dbStmt ddl dml txnStmt setStmt io_stmt prepareStmt
 %type <sv_field> field
 %type <sv_fields> fieldList
 %type <sv_type_len> type
@@ -111,12 +118,40 @@ stmt:
     |   dml
     |   txnStmt
     |   setStmt
+    |   prepareStmt
     |   EXPLAIN dml
     {
         $$ = std::make_shared<ExplainStmt>(std::move($2));
     }
     ;
 
+prepareStmt:
+        PREPARE IDENTIFIER AS dml
+    {
+        $$ = std::make_shared<PrepareStmt>(std::move($2), std::move($4));
+    }
+    |   PREPARE IDENTIFIER AS EXPLAIN dml
+    {
+        $$ = std::make_shared<PrepareStmt>(std::move($2), std::make_shared<ExplainStmt>(std::move($5)));
+    }
+    |   EXECUTE IDENTIFIER
+    {
+        $$ = std::make_shared<ExecuteStmt>(std::move($2), std::vector<std::shared_ptr<Value>>());
+    }
+    |   EXECUTE IDENTIFIER '(' valueList ')'
+    {
+        $$ = std::make_shared<ExecuteStmt>(std::move($2), std::move($4));
+    }
+    |   DEALLOCATE IDENTIFIER
+    {
+        $$ = std::make_shared<DeallocateStmt>(std::move($2));
+    }
+    |   DEALLOCATE PREPARE IDENTIFIER
+    {
+        $$ = std::make_shared<DeallocateStmt>(std::move($3));
+    }
+    ;
+
 txnStmt:
         TXN_BEGIN
     {
@@ -141,6 +176,16 @@ dbStmt:
     {
         $$ = std::make_shared<ShowTables>();
     }
+    |   SHOW IDENTIFIER
+    {
+        // STATUS不是关键字，在这里检查
+        if (strcasecmp($2.c_str(), "status") != 0)
+        {
+            yyerror(&@2, scanner, parse_tree, error_msg, ("unknown SHOW target " + $2).c_str());
+            YYABORT;
+        }
+        $$ = std::make_shared<ShowStatus>();
+    }
     |   LOAD fileName INTO tbName
     {
         $$ = std::make_shared<LoadStmt>(std::move($2), std::move($4));
@@ -152,6 +197,25 @@ setStmt:
     {
         $$ = std::make_shared<SetStmt>($2, $4);  // 移除std::move
     }
+    |   SET IDENTIFIER '=' VALUE_INT
+    {
+        // 数值类型的参数名不是关键字，在这里检查
+        if (strcasecmp($2.c_str(), "buffer_pool_size") != 0)
+        {
+            yyerror(&@2, scanner, parse_tree, error_msg, ("unknown knob " + $2).c_str());
+            YYABORT;
+        }
+        $$ = std::make_shared<SetStmt>(SetKnobType::BufferPoolSize, std::to_string($4));
+    }
+    |   SET IDENTIFIER '=' VALUE_STRING
+    {
+        if (strcasecmp($2.c_str(), "buffer_pool_size") != 0)
+        {
+            yyerror(&@2, scanner, parse_tree, error_msg, ("unknown knob " + $2).c_str());
+            YYABORT;
+        }
+        $$ = std::make_shared<SetStmt>(SetKnobType::BufferPoolSize, $4);
+    }
     ;
 io_stmt:
         SET OUTPUT_FILE ON
@@ -168,6 +232,22 @@ ddl:
     {
         $$ = std::make_shared<CreateTable>(std::move($3), std::move($5));
     }
+    |   CREATE TABLE tbName '(' fieldList ')' IDENTIFIER '=' IDENTIFIER
+    {
+        // ROW_FORMAT和它的取值不是关键字，在这里检查
+        if (strcasecmp($7.c_str(), "row_format") != 0)
+        {
+            yyerror(&@7, scanner, parse_tree, error_msg, ("unknown table option " + $7).c_str());
+            YYABORT;
+        }
+        bool slotted = strcasecmp($9.c_str(), "slotted") == 0;
+        if (!slotted && strcasecmp($9.c_str(), "fixed") != 0)
+        {
+            yyerror(&@9, scanner, parse_tree, error_msg, ("unknown row format " + $9).c_str());
+            YYABORT;
+        }
+        $$ = std::make_shared<CreateTable>(std::move($3), std::move($5), slotted);
+    }
     |   DROP TABLE tbName
     {
         $$ = std::make_shared<DropTable>(std::move($3));
@@ -301,6 +381,11 @@ value:
     {
         $$ = std::make_shared<BoolLit>($1);
     }
+    |   '?'
+    {
+        // 参数编号在整条语句解析完成后统一分配
+        $$ = std::make_shared<Param>();
+    }
     ;
 
 condition:
@@ -664,4 +749,63 @@ fileName: VALUE_PATH;
 
 
 
-%%
\ No newline at end of file
+%%
+
+/**
+ * @description: 只做词法分析，把语句规范化为常量替换成'?'的形式，作为计划缓存的键
+ * @return {bool} 语句能否使用计划缓存，只缓存以';'结尾且不含'?'的SELECT/INSERT/UPDATE/DELETE
+ * @param {yyscan_t} scanner 已经设置好输入缓冲区的词法分析器
+ * @param {string&} key 规范化后的语句
+ * @param {vector<shared_ptr<Value>>&} literals 按出现顺序收集的常量
+ */
+bool yynormalize(yyscan_t scanner, std::string &key, std::vector<std::shared_ptr<ast::Value>> &literals)
+{
+    YYSTYPE lval;
+    YYLTYPE lloc = {1, 1, 1, 1};
+    key.clear();
+    literals.clear();
+
+    int tok = yylex(&lval, &lloc, scanner);
+    if (tok != SELECT && tok != INSERT && tok != UPDATE && tok != DELETE)
+        return false;
+    for (int prev = 0; tok != ';'; prev = tok, tok = yylex(&lval, &lloc, scanner))
+    {
+        switch (tok)
+        {
+        case 0:
+        case T_EOF:
+        case '?':
+            return false;
+        case VALUE_INT:
+            // LIMIT的值会影响排序计划，保留在键中
+            if (prev == LIMIT)
+            {
+                key += std::to_string(lval.sv_int);
+                break;
+            }
+            key += '?';
+            literals.emplace_back(std::make_shared<IntLit>(lval.sv_int));
+            break;
+        case VALUE_FLOAT:
+            key += '?';
+            literals.emplace_back(std::make_shared<FloatLit>(lval.sv_float));
+            break;
+        case VALUE_STRING:
+            key += '?';
+            literals.emplace_back(std::make_shared<StringLit>(std::move(lval.sv_str)));
+            break;
+        case VALUE_BOOL:
+            key += lval.sv_bool ? "true" : "false";
+            break;
+        case IDENTIFIER:
+        case VALUE_PATH:
+            key += lval.sv_str;
+            break;
+        default:
+            key += std::to_string(tok);
+            break;
+        }
+        key += ' ';
+    }
+    return true;
+}
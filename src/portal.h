@@ -46,6 +46,8 @@ struct PortalStmt
     std::vector<TabCol> sel_cols;
     std::unique_ptr<AbstractExecutor> root;
     std::shared_ptr<Plan> plan;
+    // 结果暂停发送的查询的游标，结果全部产生之后为nullptr
+    std::unique_ptr<SelectCursor> cursor;
 
     PortalStmt(portalTag tag_, std::vector<TabCol> sel_cols_, std::unique_ptr<AbstractExecutor> root_, std::shared_ptr<Plan> plan_) : tag(tag_), sel_cols(std::move(sel_cols_)), root(std::move(root_)), plan(std::move(plan_)) {}
     PortalStmt(portalTag tag_, std::unique_ptr<AbstractExecutor> root_, std::shared_ptr<Plan> plan_) : tag(tag_), root(std::move(root_)), plan(std::move(plan_)) {}
@@ -69,6 +71,7 @@ public:
         {
         case PlanTag::T_Help:
         case PlanTag::T_ShowTable:
+        case PlanTag::T_ShowStatus:
         case PlanTag::T_DescTable:
         case PlanTag::T_Transaction_begin:
         case PlanTag::T_Transaction_abort:
@@ -89,7 +92,7 @@ public:
             auto x = std::static_pointer_cast<DMLPlan>(plan);
             std::shared_ptr<ProjectionPlan> p = std::static_pointer_cast<ProjectionPlan>(x->subplan_);
             std::unique_ptr<AbstractExecutor> root = convert_plan_executor(p, context);
-            return std::make_shared<PortalStmt>(PORTAL_ONE_SELECT, std::move(p->sel_cols_), std::move(root), plan);
+            return std::make_shared<PortalStmt>(PORTAL_ONE_SELECT, p->sel_cols_, std::move(root), plan);
         }
         case T_Update:
         {
@@ -149,7 +152,7 @@ public:
         {
             case PORTAL_ONE_SELECT:
             {
-                ql->select_from(std::move(portal->root), std::move(portal->sel_cols), context);
+                portal->cursor = ql->select_from(std::move(portal->root), std::move(portal->sel_cols), context);
                 break;
             }
 
@@ -175,8 +178,29 @@ public:
         }
     }
 
-    // 清空资源
-    void drop() {}
+    // 清空资源：先销毁算子树，释放其中缓存的中间元组，再回收会话的元组内存池
+    /**
+     * @description: 继续产生run()中暂停的查询结果
+     * @return {bool} 结果是否已经全部产生，为false时查询再次暂停，socket可写之后再继续
+     */
+    bool resume(const std::shared_ptr<PortalStmt> &portal, QlManager *ql, Context *context)
+    {
+        if (!ql->fetch_rows(*portal->cursor, context))
+            return false;
+        portal->cursor.reset();
+        return true;
+    }
+
+    // start()失败时portal为nullptr，这时只回收元组内存池
+    void drop(const std::shared_ptr<PortalStmt> &portal, Context *context)
+    {
+        if (portal != nullptr)
+        {
+            portal->cursor.reset();
+            portal->root.reset();
+        }
+        context->arena_.reset();
+    }
 
     std::unique_ptr<AbstractExecutor> convert_plan_executor(std::shared_ptr<Plan> plan, Context *context)
     {
@@ -219,7 +243,7 @@ public:
             context->setJoinFlag(true); // 设置 join 标志位
             std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context);
             std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context);
-            return std::make_unique<NestedLoopJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_));
+            return std::make_unique<NestedLoopJoinExecutor>(std::move(left), std::move(right), x->conds_);
         }
         case PlanTag::T_SortMerge:
         {
@@ -227,7 +251,7 @@ public:
             context->setJoinFlag(true); // 设置 join 标志位
             std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context);
             std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context);
-            return std::make_unique<MergeJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_));
+            return std::make_unique<MergeJoinExecutor>(std::move(left), std::move(right), x->conds_);
         }
         case PlanTag::T_SemiJoin:
         {
@@ -235,7 +259,7 @@ public:
             context->setJoinFlag(true); // 设置 join 标志位
             std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context);
             std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context);
-            return std::make_unique<SemiJoinExecutor>(std::move(left), std::move(right), std::move(x->conds_));
+            return std::make_unique<SemiJoinExecutor>(std::move(left), std::move(right), x->conds_);
         }
         case PlanTag::T_Sort:
         {
@@ -290,4 +314,33 @@ public:
         }
         return nullptr;
     }
-};
\ No newline at end of file
+};
+
+// 离开作用域时调用Portal::drop()，语句执行失败抛出异常时也会释放算子树，并且在回滚事务之前完成
+// 查询结果暂停发送时用release()取出语句，留到之后继续执行
+class PortalGuard
+{
+public:
+    PortalGuard(Portal *portal, Context *context) : portal_(portal), context_(context) {}
+    ~PortalGuard()
+    {
+        if (active_)
+            portal_->drop(stmt, context_);
+    }
+
+    std::shared_ptr<PortalStmt> release()
+    {
+        active_ = false;
+        return std::move(stmt);
+    }
+
+    PortalGuard(const PortalGuard &) = delete;
+    PortalGuard &operator=(const PortalGuard &) = delete;
+
+    std::shared_ptr<PortalStmt> stmt;
+
+private:
+    Portal *portal_;
+    Context *context_;
+    bool active_ = true;
+};
@@ -32,7 +32,7 @@ public:
     inline static bool is_set(const char *bm, int pos) { return (bm[get_bucket(pos)] & get_bit(pos)) != 0; }
 
     /**
-     * @brief 找下一个为0 or 1的位
+     * @brief 找下一个为0 or 1的位，每次比较64位
      * @param bit false表示要找下一个为0的位，true表示要找下一个为1的位
      * @param bm 要找的起始地址为bm
      * @param max_n 要找的从起始地址开始的偏移为[curr+1,max_n)
@@ -41,25 +41,92 @@ public:
      */
     static int next_bit(bool bit, const char *bm, int max_n, int curr)
     {
-        for (int i = curr + 1; i < max_n; ++i)
+        int start = curr + 1;
+        if (start >= max_n)
+            return max_n;
+        int base = start & ~(WORD_BITS - 1);
+        // 第一个字去掉start之前的位
+        uint64_t word = load_word(bm, base, max_n) ^ (bit ? 0 : ~0ULL);
+        word &= ~0ULL >> (start - base);
+        while (true)
         {
-            if (is_set(bm, i) == bit)
+            if (word != 0)
             {
-                return i;
+                int pos = base + __builtin_clzll(word);
+                return pos < max_n ? pos : max_n;
             }
+            base += WORD_BITS;
+            if (base >= max_n)
+                return max_n;
+            word = load_word(bm, base, max_n) ^ (bit ? 0 : ~0ULL);
         }
-        return max_n;
     }
 
     // 找第一个为0 or 1的位
     inline static int first_bit(bool bit, const char *bm, int max_n) { return next_bit(bit, bm, max_n, -1); }
 
+    /**
+     * @brief 一次取出[0,max_n)中所有为1的位，按从小到大的顺序写入out
+     * @param out 至少能容纳max_n个元素
+     * @return 为1的位的个数
+     */
+    static int set_bits(const char *bm, int max_n, int *out)
+    {
+        int n = 0;
+        for (int base = 0; base < max_n; base += WORD_BITS)
+        {
+            uint64_t word = load_word(bm, base, max_n);
+            if (max_n - base < WORD_BITS)
+                word &= ~(~0ULL >> (max_n - base)); // 忽略max_n之后的位
+            while (word != 0)
+            {
+                int offset = __builtin_clzll(word);
+                out[n++] = base + offset;
+                word &= ~(HIGHEST_WORD_BIT >> offset);
+            }
+        }
+        return n;
+    }
+
+    // [0,max_n)中为1的位的个数
+    static int count(const char *bm, int max_n)
+    {
+        int n = 0;
+        for (int base = 0; base < max_n; base += WORD_BITS)
+        {
+            uint64_t word = load_word(bm, base, max_n);
+            if (max_n - base < WORD_BITS)
+                word &= ~(~0ULL >> (max_n - base));
+            n += __builtin_popcountll(word);
+        }
+        return n;
+    }
+
     // for example:
     // rid_.slot_no = Bitmap::next_bit(true, page_handle.bitmap, file_handle_->file_hdr_.num_records_per_page,
     // rid_.slot_no); int slot_no = Bitmap::first_bit(false, page_handle.bitmap, file_hdr_.num_records_per_page);
 
 private:
+    static constexpr int WORD_BITS = 64;
+    static constexpr uint64_t HIGHEST_WORD_BIT = 1ULL << 63;
+
     inline static int get_bucket(int pos) { return pos / BITMAP_WIDTH; }
 
+    /**
+     * 读取从第base位（64的倍数）开始的64位，第base位在返回值的最高位，与字节内从高位到低位的顺序一致。
+     * bitmap只有(max_n+7)/8个字节，最后不足8个字节时只读取剩下的字节，其余的位为0
+     */
+    inline static uint64_t load_word(const char *bm, int base, int max_n)
+    {
+        int byte = base / BITMAP_WIDTH;
+        int bytes = (max_n + BITMAP_WIDTH - 1) / BITMAP_WIDTH - byte;
+        uint64_t word = 0;
+        memcpy(&word, bm + byte, bytes < 8 ? bytes : 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        return word;
+    }
+
     inline static char get_bit(int pos) { return BITMAP_HIGHEST_BIT >> static_cast<char>(pos % BITMAP_WIDTH); }
 };
@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "common/tuple_arena.h"
 #include "defs.h"
 #include "storage/buffer_pool_manager_final.h"
 #include "storage/buffer_pool_manager.h"
@@ -38,10 +39,34 @@ struct RmFileHdr
     int record_size;          // 表中每条记录的大小，由于不包含变长字段，因此当前字段初始化后保持不变
     int num_pages;            // 文件中分配的页面个数（初始化为1）
     int num_records_per_page; // 每个页面最多能存储的元组个数
-    int first_free_page_no;   // 文件中当前第一个包含空闲空间的页面号（初始化为-1）
+    int first_free_page_no;   // 文件中当前第一个包含空闲空间的页面号（初始化为-1），RmFileHandle_Final改用空闲空间映射，保持为-1
     int bitmap_size;          // 每个页面bitmap大小
 };
 
+/* 表数据文件的记录格式 */
+enum RmRecordFormat : int
+{
+    RM_FORMAT_FIXED = 0, // 定长slot和bitmap，每条记录占record_size字节
+    RM_FORMAT_SLOTTED    // 页尾向前存放变长记录，页头之后是slot目录，字符串列去掉末尾的填充后存储
+};
+
+constexpr int RM_MAX_VAR_COLS = 64;
+
+/* 变长存储的字符串列在定长记录中的位置 */
+struct RmVarCol
+{
+    int offset;
+    int len;
+};
+
+/* 记录格式，紧跟在RmFileHdr之后写入第0号页面，这部分全为0时（包括格式出现之前的数据文件）是定长格式 */
+struct RmFormatHdr
+{
+    int format;                        // RmRecordFormat
+    int num_var_cols;                  // 变长存储的字符串列数，超过RM_MAX_VAR_COLS的列仍按定长存储
+    RmVarCol var_cols[RM_MAX_VAR_COLS]; // 按offset递增排列
+};
+
 /* 表数据文件中每个页面的页头，记录每个页面的元信息 */
 struct RmPageHdr
 {
@@ -52,9 +77,10 @@ struct RmPageHdr
 /* 表中的记录 */
 struct RmRecord
 {
-    char *data = nullptr;    // 记录的数据
-    int size = 0;            // 记录的大小
-    bool allocated_ = false; // 是否已经为数据分配空间
+    char *data = nullptr;          // 记录的数据
+    int size = 0;                  // 记录的大小
+    bool allocated_ = false;       // 是否已经为数据分配空间
+    TupleArena *arena_ = nullptr;  // 数据从arena_中分配时不为空，释放时归还给arena_
 
     RmRecord() = default;
 
@@ -79,11 +105,12 @@ struct RmRecord
         memcpy(this->data, data, size);
     }
 
-    RmRecord(const RmRecord &other) : size(other.size), allocated_(other.allocated_)
+    // 复制拥有数据的记录时，副本从同一个arena中分配
+    RmRecord(const RmRecord &other) : size(other.size), allocated_(other.allocated_), arena_(other.arena_)
     {
         if (allocated_)
         {
-            data = new char[size];
+            data = alloc(size);
             memcpy(data, other.data, size);
         }
         else
@@ -93,33 +120,35 @@ struct RmRecord
     };
 
     RmRecord(RmRecord &&other) noexcept : data(other.data), size(other.size),
-                                          allocated_(other.allocated_)
+                                          allocated_(other.allocated_), arena_(other.arena_)
     {
         other.data = nullptr;
         other.size = 0;
         other.allocated_ = false;
+        other.arena_ = nullptr;
     }
 
     RmRecord &operator=(const RmRecord &other)
     {
+        if (this == &other)
+            return *this;
         if (other.allocated_)
         {
-            if (size <= other.size)
+            // 大小和所属的arena都相同时复用已有的空间
+            if (!allocated_ || size != other.size || arena_ != other.arena_)
             {
-                size = other.size;
-                if (allocated_)
-                    delete[] data;
-                data = new char[size];
+                release();
+                arena_ = other.arena_;
+                data = alloc(other.size);
+                allocated_ = true;
             }
-
+            size = other.size;
             memcpy(data, other.data, size);
-            allocated_ = true;
         }
         else
         {
+            release();
             size = other.size;
-            if (allocated_)
-                delete[] data;
             data = other.data;
             allocated_ = false;
         }
@@ -127,30 +156,33 @@ struct RmRecord
     };
     RmRecord &operator=(RmRecord &&other)
     {
-        if (allocated_)
-            delete[] data;
+        if (this == &other)
+            return *this;
+        release();
         size = other.size;
         data = other.data;
+        allocated_ = other.allocated_;
+        arena_ = other.arena_;
         other.data = nullptr;
         other.size = 0;
-        allocated_ = other.allocated_;
         other.allocated_ = false;
+        other.arena_ = nullptr;
         return *this;
     };
 
     RmRecord(int size_) : data(new char[size_]), size(size_), allocated_(true) {}
 
+    // 在执行器的元组arena中分配数据，arena为nullptr时与RmRecord(size)相同
+    RmRecord(int size_, TupleArena *arena) : size(size_), allocated_(true), arena_(arena) { data = alloc(size_); }
+
     void Deserialize(const char *data_)
     {
         int newSize = *reinterpret_cast<const int *>(data_);
-        if (size != newSize)
+        if (size != newSize || !allocated_)
         {
-            if (allocated_ && data != nullptr)
-            {
-                delete[] data;
-            }
+            release();
             size = newSize;
-            data = new char[newSize];
+            data = alloc(newSize);
             allocated_ = true;
         }
         memcpy(data, data_ + sizeof(int), size);
@@ -158,9 +190,20 @@ struct RmRecord
 
     ~RmRecord()
     {
-        if (allocated_)
+        release();
+    }
+
+private:
+    char *alloc(int n) { return arena_ ? arena_->allocate(n) : new char[n]; }
+
+    void release()
+    {
+        if (allocated_ && data != nullptr)
         {
-            delete[] data;
+            if (arena_)
+                arena_->deallocate(data, size);
+            else
+                delete[] data;
         }
         allocated_ = false;
         data = nullptr;
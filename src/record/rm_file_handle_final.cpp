@@ -9,6 +9,12 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include "rm_file_handle_final.h"
+
+#include <limits.h>
+#include <unistd.h>
+
+#include <algorithm>
+
 #include "transaction/transaction_manager.h"
 
 /**
@@ -33,7 +39,7 @@ std::unique_ptr<RmRecord> RmFileHandle_Final::get_record(const Rid &rid, Context
     // 3. 初始化一个指向RmRecord的指针（赋值其内部的data和size）
     auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
     // 将slot中的数据复制到record中
-    memcpy(record->data, page_handle.get_slot(rid.slot_no), file_hdr_.record_size);
+    read_slot(page_handle, rid.slot_no, record->data);
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
 
     return record;
@@ -43,102 +49,107 @@ std::vector<std::pair<std::unique_ptr<RmRecord>, int>> RmFileHandle_Final::get_r
 {
     // 1. 获取指定记录所在的page handle
     RmPageHandle_FInal page_handle = fetch_page_handle(page_no);
-    std::shared_lock lock(page_handle.page->latch_);
     std::vector<std::pair<std::unique_ptr<RmRecord>, int>> records;
-    int slot_no = -1;
     records.reserve(file_hdr_.num_records_per_page); // 预分配空间，避免多次扩容
-    TransactionManager *txn_manager = context->txn_->get_txn_manager();
-
-    while (true)
     {
-        slot_no = Bitmap::next_bit(true, page_handle.bitmap, file_hdr_.num_records_per_page, slot_no);
+        std::shared_lock lock(page_handle.page->latch_);
+        scan_page(
+            page_handle, context,
+            [&](int slot_no, char *data)
+            {
+                // 记录可见且未删除，复制数据
+                auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
+                memcpy(record->data, data, file_hdr_.record_size);
+                records.emplace_back(std::make_pair(std::move(record), slot_no));
+            },
+            [&](int slot_no)
+            {
+                // 需要查找版本链，让上层处理
+                records.emplace_back(std::make_pair(nullptr, slot_no));
+            });
+    }
 
-        if (slot_no >= file_hdr_.num_records_per_page)
-        {
-            // 如果没有找到空闲位置，则退出循环
-            break;
-        }
+    // 全表扫描访问的页面以低优先级放回，避免大表扫描把热点页面挤出缓冲池
+    rm_manager_->buffer_pool_manager_->unpin_page({fd_, page_no}, false, true);
+    return records;
+}
 
-        char *data = page_handle.get_slot(slot_no);
+void RmFileHandle_Final::scan_page(const RmPageHandle_FInal &page_handle, Context *context,
+                                   const std::function<void(int, char *)> &visible, const std::function<void(int)> &in_chain)
+{
+    TransactionManager *txn_manager = context->txn_->get_txn_manager();
+    // 一次取出页面上所有被占用的slot。扫描逐页调用这里，缓冲区按线程复用，回调中不能再扫描其他页面
+    static thread_local std::vector<int> slots;
+    static thread_local std::vector<char> decoded; // 变长格式的记录解码到这里再交给visible
+    int num_slots = live_slots(page_handle, slots);
+    if (is_slotted())
+        decoded.resize(file_hdr_.record_size);
+    for (int i = 0; i < num_slots; i++)
+    {
+        int slot_no = slots[i];
+        char *data = slot_data(page_handle, slot_no);
         txn_id_t txn_id = txn_manager->get_record_txn_id(data);
         Transaction *record_txn = txn_manager->get_or_create_transaction(txn_id);
-
-        // 1. 检查是否需要查找版本链
         if (txn_manager->need_find_version_chain(record_txn, context->txn_))
+            in_chain(slot_no);
+        else if (!txn_manager->is_deleted(txn_id))
         {
-            // 需要查找版本链，让上层处理
-            records.emplace_back(std::make_pair(nullptr, slot_no));
-            continue;
-        }
-
-        // 2. 当前版本可见，检查是否是删除记录
-        bool is_deleted = txn_manager->is_deleted(txn_id);
-        if (is_deleted)
-        {
-            // 记录已被删除，跳过
-            continue;
+            if (is_slotted())
+            {
+                codec_.decode(data, decoded.data());
+                data = decoded.data();
+            }
+            visible(slot_no, data);
         }
-
-        // 3. 记录可见且未删除，复制数据
-        auto record = std::make_unique<RmRecord>(file_hdr_.record_size);
-        memcpy(record->data, data, file_hdr_.record_size);
-        records.emplace_back(std::make_pair(std::move(record), slot_no));
     }
+}
 
-    rm_manager_->buffer_pool_manager_->unpin_page({fd_, page_no}, false);
-    return records;
+void RmFileHandle_Final::prefetch_pages(int start_page_no, int num_pages)
+{
+    rm_manager_->buffer_pool_manager_->prefetch(fd_, start_page_no, num_pages);
 }
 
 /**
  * @description: 在当前表中插入一条记录，不指定插入位置
  * @param {char*} buf 要插入的记录的数据
  * @param {Context*} context
+ * @param {function} before_unpin 释放页面latch之后、取消固定页面之前调用，用于写入插入日志：
+ * 缓冲池只写回没有被固定的脏页，这样页面写回之前插入对应的日志已经在日志缓冲区中
  * @return {Rid} 插入的记录的记录号（位置）
  */
-Rid RmFileHandle_Final::insert_record(char *buf, Context *context)
+Rid RmFileHandle_Final::insert_record(char *buf, Context *context, const std::function<void(const Rid &)> &before_unpin)
 {
+    int min_bucket = required_bucket(buf);
     while (true)
     { // 循环尝试，直到插入成功
-        // 1. 获取一个可能有空闲空间的页面
-        RmPageHandle_FInal page_handle = create_page_handle();
+        // 1. 获取当前线程的目标页面，它在空闲空间映射中有足够的空闲空间
+        RmPageHandle_FInal page_handle = create_page_handle(min_bucket);
 
         // 2. 获取页面锁
-        std::lock_guard lock(page_handle.page->latch_);
+        std::unique_lock lock(page_handle.page->latch_);
 
-        // 3. 在page handle中尝试找到空闲slot位置
-        int slot_no = Bitmap::first_bit(false, page_handle.bitmap, file_hdr_.num_records_per_page);
+        // 3. 在page handle中找到空闲slot位置，写入记录并更新记录数
+        int slot_no = insert_slot(page_handle, buf);
 
-        // 如果这个页面已经没有空闲slot，释放这个页面并继续尝试
-        if (slot_no >= file_hdr_.num_records_per_page)
+        // 如果这个页面已经放不下，更新空闲空间映射，释放这个页面并继续尝试
+        if (slot_no < 0)
         {
+            update_free_space(page_handle);
+            lock.unlock();
             rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
             continue;
         }
 
-        // 4. 找到空闲位置，设置bitmap
-        Bitmap::set(page_handle.bitmap, slot_no); // 立即标记为已使用，防止其他进程选中同一个slot
-
-        // 5. 复制数据到slot
-        char *slot = page_handle.get_slot(slot_no);
-        memcpy(slot, buf, file_hdr_.record_size);
-
-        // 6. 更新记录数
-        page_handle.page_hdr->num_records++;
+        // 4. 更新空闲空间映射，页面满了之后下一次插入会选择其他页面
+        update_free_space(page_handle);
 
-        // 7. 如果页面已满，更新空闲页面链表
-        if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page)
-        {
-            std::lock_guard file_lock(lock_);
-            if (file_hdr_.first_free_page_no == page_handle.page->get_page_id().page_no)
-            {
-                file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
-            }
-        }
-
-        // 8. 创建返回的RID
+        // 5. 创建返回的RID
         Rid rid{page_handle.page->get_page_id().page_no, slot_no};
 
-        // 9. 解除页面固定
+        // 6. 解除页面固定，写日志时不能持有页面latch，检查点持有日志的锁等待页面latch
+        lock.unlock();
+        if (before_unpin)
+            before_unpin(rid);
         rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
 
         return rid;
@@ -164,18 +175,10 @@ void RmFileHandle_Final::insert_record(const Rid &rid, char *buf)
         throw RMDBError("Cannot insert record: slot is already occupied");
     }
 
-    // 3. 复制数据到指定slot
-    memcpy(page_handle.get_slot(rid.slot_no), buf, file_hdr_.record_size);
+    // 3. 复制数据到指定slot，更新bitmap和记录数
+    write_slot(page_handle, rid.slot_no, buf);
+    update_free_space(page_handle);
 
-    // 4. 更新bitmap和记录数
-    Bitmap::set(page_handle.bitmap, rid.slot_no);
-    ++page_handle.page_hdr->num_records;
-
-    // {
-    //     std::lock_guard lock(lock_);
-    //     if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page)
-    //         file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
-    // }
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
 }
 
@@ -185,24 +188,9 @@ void RmFileHandle_Final::recovery_insert_record(const Rid &rid, char *buf)
     RmPageHandle_FInal page_handle = fetch_page_handle(rid.page_no);
     std::lock_guard page_lock(page_handle.page->latch_);
 
-    bool is_occupied = is_record(page_handle, rid);
-    // 2. 复制数据到指定slot
-    memcpy(page_handle.get_slot(rid.slot_no), buf, file_hdr_.record_size);
-
-    if (!is_occupied)
-    {
-        // 3. 更新bitmap和记录数
-        Bitmap::set(page_handle.bitmap, rid.slot_no);
-        ++page_handle.page_hdr->num_records;
-
-        // if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page)
-        // {
-        //     std::lock_guard file_lock(lock_);
-        //     if (file_hdr_.first_free_page_no == page_handle.page->get_page_id().page_no) {
-        //         file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
-        //     }
-        // }
-    }
+    // 2. 复制数据到指定slot，slot空闲时更新bitmap和记录数
+    write_slot(page_handle, rid.slot_no, buf);
+    update_free_space(page_handle);
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
 }
 
@@ -229,7 +217,7 @@ void RmFileHandle_Final::delete_record(const Rid &rid, Context *context)
     // page_handle.page_hdr->num_records--;
 
     TransactionManager *txn_mgr = context->txn_->get_txn_manager();
-    char *data = page_handle.get_slot(rid.slot_no);
+    char *data = slot_data(page_handle, rid.slot_no);
     if (txn_mgr->get_concurrency_mode() == ConcurrencyMode::MVCC)
     {
         txn_id_t txn_id = txn_mgr->get_record_txn_id(data);
@@ -243,8 +231,9 @@ void RmFileHandle_Final::delete_record(const Rid &rid, Context *context)
 
         if (record_txn != context->txn_)
         {
-            UndoLog *undolog = new UndoLog(RmRecord(data, file_hdr_.record_size),
-                                           record_txn);
+            RmRecord old_record(file_hdr_.record_size);
+            read_slot(page_handle, rid.slot_no, old_record.data);
+            UndoLog *undolog = new UndoLog(old_record, record_txn);
             txn_mgr->UpdateUndoLink(fd_, rid, undolog);
             txn_mgr->set_record_txn_id(data, context->txn_, true);
 
@@ -259,11 +248,9 @@ void RmFileHandle_Final::delete_record(const Rid &rid, Context *context)
     }
     else
     {
-        Bitmap::reset(page_handle.bitmap, rid.slot_no);
-        page_handle.page_hdr->num_records--;
-        // 4. 如果页面从满状态变为未满状态，需要更新空闲页面链表
-        if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page - 1)
-            release_page_handle(page_handle);
+        remove_slot(page_handle, rid.slot_no);
+        // 4. 更新空闲空间映射
+        update_free_space(page_handle);
     }
 
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
@@ -278,28 +265,65 @@ void RmFileHandle_Final::recovery_delete_record(const Rid &rid)
     bool is_occupied = is_record(page_handle, rid);
     if (is_occupied)
     {
-        page_handle.page_hdr->num_records--;
         // 2. 更新bitmap和记录数
-        Bitmap::reset(page_handle.bitmap, rid.slot_no);
+        remove_slot(page_handle, rid.slot_no);
 
-        // 3. 如果页面从满状态变为未满状态，需要更新空闲页面链表
-        if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page - 1)
-            release_page_handle(page_handle);
+        // 3. 更新空闲空间映射
+        update_free_space(page_handle);
     }
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), is_occupied);
 }
 
+/**
+ * @description: 重做之前删除变长格式页面中日志涉及的记录，见RecoveryManager::analyze()
+ * @param {vector<Rid>&} rids 日志中出现的记录号，可以重复，会被排序
+ */
+void RmFileHandle_Final::recovery_remove_records(std::vector<Rid> &rids)
+{
+    std::sort(rids.begin(), rids.end(), [](const Rid &a, const Rid &b)
+              { return a.page_no != b.page_no ? a.page_no < b.page_no : a.slot_no < b.slot_no; });
+    size_t i = 0;
+    while (i < rids.size())
+    {
+        int page_no = rids[i].page_no;
+        size_t end = i;
+        while (end < rids.size() && rids[end].page_no == page_no)
+            end++;
+        // 还没有写入文件的页面由重做创建
+        if (page_no >= RM_FIRST_RECORD_PAGE && page_no < file_hdr_.num_pages)
+        {
+            RmPageHandle_FInal page_handle = fetch_page_handle(page_no);
+            std::lock_guard lock(page_handle.page->latch_);
+            bool removed = false;
+            for (; i < end; i++)
+            {
+                if (is_record(page_handle, rids[i]))
+                {
+                    remove_slot(page_handle, rids[i].slot_no);
+                    removed = true;
+                }
+            }
+            update_free_space(page_handle);
+            rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), removed);
+        }
+        i = end;
+    }
+}
+
 /**
  * @description: 更新记录文件中记录号为rid的记录
  * @param {Rid&} rid 要更新的记录的记录号（位置）
  * @param {char*} buf 新记录的数据
  * @param {Context*} context
+ * @param {function} before_unpin 与insert_record()相同，更新之后、取消固定页面之前调用，用于写入更新日志
+ * @return {bool} 变长格式中新记录在原来的页面中放不下时返回false，记录没有任何修改，
+ * 由调用者删除这条记录后重新插入；定长格式总是返回true
  */
-void RmFileHandle_Final::update_record(const Rid &rid, char *buf, Context *context)
+bool RmFileHandle_Final::update_record(const Rid &rid, char *buf, Context *context, const std::function<void()> &before_unpin)
 {
     // 1. 获取指定记录所在的page handle
     RmPageHandle_FInal page_handle = fetch_page_handle(rid.page_no);
-    std::lock_guard lock(page_handle.page->latch_);
+    std::unique_lock lock(page_handle.page->latch_);
 
     // 2. 检查记录是否存在
     if (!is_record(page_handle, rid))
@@ -308,8 +332,19 @@ void RmFileHandle_Final::update_record(const Rid &rid, char *buf, Context *conte
         throw RecordNotFoundError(rid.page_no, rid.slot_no);
     }
 
+    // 3. 变长格式先检查页面中能否放下，事务号不影响编码后的长度
+    if (is_slotted())
+    {
+        char encoded[RM_MAX_ENCODED_SIZE];
+        if (!RmSlottedPage(page_handle.page).can_update(rid.slot_no, codec_.encode(buf, encoded)))
+        {
+            rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+            return false;
+        }
+    }
+
     TransactionManager *txn_mgr = context->txn_->get_txn_manager();
-    char *data = page_handle.get_slot(rid.slot_no);
+    char *data = slot_data(page_handle, rid.slot_no);
     if (txn_mgr->get_concurrency_mode() == ConcurrencyMode::MVCC)
     {
         txn_id_t txn_id = txn_mgr->get_record_txn_id(data);
@@ -323,14 +358,14 @@ void RmFileHandle_Final::update_record(const Rid &rid, char *buf, Context *conte
         if (record_txn != context->txn_)
         {
             txn_mgr->set_record_txn_id(buf, context->txn_);
-            UndoLog *undolog = new UndoLog(RmRecord(data, file_hdr_.record_size),
-                                           record_txn);
+            RmRecord old_record(file_hdr_.record_size);
+            read_slot(page_handle, rid.slot_no, old_record.data);
+            UndoLog *undolog = new UndoLog(old_record, record_txn);
             txn_mgr->UpdateUndoLink(fd_, rid, undolog);
 
             auto write_record = new WriteRecord(WType::UPDATE_TUPLE, rm_manager_->disk_manager_->get_file_name(fd_),
                                                 rid, undolog);
             context->txn_->append_write_record(write_record);
-            memcpy(page_handle.get_slot(rid.slot_no), buf, file_hdr_.record_size);
         }
         else
         {
@@ -338,8 +373,14 @@ void RmFileHandle_Final::update_record(const Rid &rid, char *buf, Context *conte
         }
     }
 
-    memcpy(page_handle.get_slot(rid.slot_no), buf, file_hdr_.record_size);
+    write_slot(page_handle, rid.slot_no, buf);
+    update_free_space(page_handle);
+
+    lock.unlock();
+    if (before_unpin)
+        before_unpin();
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
+    return true;
 }
 
 /**
@@ -389,61 +430,213 @@ RmPageHandle_FInal RmFileHandle_Final::create_new_page_handle()
     // 2.更新page handle中的相关信息
     RmPageHandle_FInal page_handle(&file_hdr_, page);
 
-    // 初始化页头信息
-    page_handle.page_hdr->next_free_page_no = file_hdr_.first_free_page_no;
-    page_handle.page_hdr->num_records = 0; // 当前记录数为0
+    if (is_slotted())
+    {
+        // 变长格式：空的slot目录，整页都是空闲空间
+        RmSlottedPage(page).init();
+    }
+    else
+    {
+        // 初始化页头信息，空闲页面由空闲空间映射管理，不再使用页头中的链表
+        page_handle.page_hdr->next_free_page_no = RM_NO_PAGE;
+        page_handle.page_hdr->num_records = 0; // 当前记录数为0
 
-    // 初始化bitmap，将所有位都设置为0（表示所有slot都是空闲的）
-    memset(page_handle.bitmap, 0, file_hdr_.bitmap_size);
+        // 初始化bitmap，将所有位都设置为0（表示所有slot都是空闲的）
+        memset(page_handle.bitmap, 0, file_hdr_.bitmap_size);
+    }
 
-    // 3.更新file_hdr_
+    // 3.更新file_hdr_和空闲空间映射
     ++file_hdr_.num_pages;
-    file_hdr_.first_free_page_no = new_page_id.page_no;
+    update_free_space(page_handle);
     return page_handle;
 }
 
 /**
- * @brief 创建或获取一个空闲的page handle
+ * @brief 获取当前线程的目标页面，目标页面的空闲空间不够时从空闲空间映射中重新选择，没有可用的页面时创建新页面
  *
- * @return RmPageHandle_FInal 返回生成的空闲page handle
+ * @param min_bucket 页面在空闲空间映射中至少要达到的分级
+ * @return RmPageHandle_FInal 返回目标页面的page handle，其他线程可能已经把它插满，调用者需要在latch下检查
  * @note pin the page, remember to unpin it outside!
  */
-RmPageHandle_FInal RmFileHandle_Final::create_page_handle()
+RmPageHandle_FInal RmFileHandle_Final::create_page_handle(int min_bucket)
 {
-    std::lock_guard lock(lock_);
+    int slot = RmFreeSpaceMap::thread_slot();
 
-    // 1. 判断file_hdr_中是否还有空闲页
-    if (file_hdr_.first_free_page_no == RM_NO_PAGE)
+    // 1. 目标页面还有足够的空闲空间时继续使用，否则选择一个其他线程没有使用的页面
+    int page_no = free_space_map_->target(slot);
+    if (page_no == RM_NO_PAGE || free_space_map_->bucket(page_no) < min_bucket)
+        page_no = free_space_map_->claim(slot, min_bucket);
+
+    if (page_no == RM_NO_PAGE)
     {
-        // 1.1 没有空闲页：使用缓冲池来创建一个新page
-        RmPageHandle_FInal new_handle = create_new_page_handle();
-        // 将新页面设置为第一个空闲页
-        // file_hdr_.first_free_page_no = file_hdr_.num_pages - 1;
-        return new_handle;
+        std::lock_guard lock(lock_);
+        // 等待文件锁期间其他线程可能已经创建了新页面
+        page_no = free_space_map_->claim(slot, min_bucket);
+        if (page_no == RM_NO_PAGE)
+        {
+            // 2. 没有可用的页面：使用缓冲池来创建一个新page，作为当前线程的目标页面
+            RmPageHandle_FInal new_handle = create_new_page_handle();
+            free_space_map_->set_target(slot, new_handle.page->get_page_id().page_no);
+            return new_handle;
+        }
     }
-    // 1.2 有空闲页：直接获取第一个空闲页
-    // 使用缓冲池获取指定页面
-    Page_Final *page = rm_manager_->buffer_pool_manager_->fetch_page(PageId_Final{fd_, file_hdr_.first_free_page_no});
-    if (page == nullptr)
+
+    return fetch_page_handle(page_no);
+}
+
+/**
+ * @description: 页面的记录数变化后更新空闲空间映射，调用者持有页面的写latch
+ */
+void RmFileHandle_Final::update_free_space(const RmPageHandle_FInal &page_handle)
+{
+    // 定长格式按空闲slot数，变长格式按空闲字节数
+    int free_space = is_slotted() ? RmSlottedPage(page_handle.page).free_space()
+                                  : file_hdr_.num_records_per_page - page_handle.page_hdr->num_records;
+    free_space_map_->update(page_handle.page->get_page_id().page_no, free_space);
+}
+
+/**
+ * @description: 插入buf需要页面在空闲空间映射中达到的分级，达到这个分级的页面一定能放下这条记录
+ */
+int RmFileHandle_Final::required_bucket(const char *buf) const
+{
+    if (!is_slotted())
+        return 1;
+    char encoded[RM_MAX_ENCODED_SIZE];
+    int need = codec_.encode(buf, encoded) + (int)sizeof(RmSlot);
+    // 超过最高分级时只有新页面一定能放下，返回NUM_BUCKETS让create_page_handle直接创建新页面
+    return std::min(free_space_map_->bucket_of(need) + 1, (int)RmFreeSpaceMap::NUM_BUCKETS);
+}
+
+// 以下几个函数按记录格式访问页面中的slot，调用者持有页面的latch
+
+// 按slot顺序取出页面上所有记录的slot_no，返回记录数
+int RmFileHandle_Final::live_slots(const RmPageHandle_FInal &page_handle, std::vector<int> &slots) const
+{
+    if (is_slotted())
     {
-        throw PageNotExistError(std::string("Record File"), file_hdr_.first_free_page_no);
+        RmSlottedPage slotted_page(page_handle.page);
+        slots.resize(slotted_page.num_slots());
+        return slotted_page.live_slots(slots.data());
     }
+    slots.resize(file_hdr_.num_records_per_page);
+    return Bitmap::set_bits(page_handle.bitmap, file_hdr_.num_records_per_page, slots.data());
+}
 
-    // 生成并返回page handle
-    return RmPageHandle_FInal(&file_hdr_, page);
+// slot中记录的起始地址，变长格式是编码后的记录，开头的事务号与定长格式相同
+char *RmFileHandle_Final::slot_data(const RmPageHandle_FInal &page_handle, int slot_no) const
+{
+    if (is_slotted())
+        return RmSlottedPage(page_handle.page).tuple(slot_no);
+    return page_handle.get_slot(slot_no);
+}
+
+// 把slot中的记录复制到out中，out有record_size字节
+void RmFileHandle_Final::read_slot(const RmPageHandle_FInal &page_handle, int slot_no, char *out) const
+{
+    if (is_slotted())
+        codec_.decode(RmSlottedPage(page_handle.page).tuple(slot_no), out);
+    else
+        memcpy(out, page_handle.get_slot(slot_no), file_hdr_.record_size);
+}
+
+// 在任意空闲slot上写入记录，页面放不下时返回-1
+int RmFileHandle_Final::insert_slot(const RmPageHandle_FInal &page_handle, const char *buf)
+{
+    if (is_slotted())
+    {
+        char encoded[RM_MAX_ENCODED_SIZE];
+        int len = codec_.encode(buf, encoded);
+        return RmSlottedPage(page_handle.page).insert(encoded, len);
+    }
+    int slot_no = Bitmap::first_bit(false, page_handle.bitmap, file_hdr_.num_records_per_page);
+    if (slot_no >= file_hdr_.num_records_per_page)
+        return -1;
+    Bitmap::set(page_handle.bitmap, slot_no);
+    memcpy(page_handle.get_slot(slot_no), buf, file_hdr_.record_size);
+    page_handle.page_hdr->num_records++;
+    return slot_no;
 }
 
 /**
- * @description: 当一个页面从没有空闲空间的状态变为有空闲空间状态时，更新文件头和页头中空闲页面相关的元数据
+ * @description: 在指定的slot上写入记录，slot上已有记录时覆盖
+ * 变长格式中更新之前已经检查过空间，回滚时记录的空间只增不减，旧的记录一定能放回原处；
+ * 重做日志时清理线程已经回收的多余空间不会重做，放不下时先回收所有记录多余的空间，仍然放不下时抛出InternalError
  */
-void RmFileHandle_Final::release_page_handle(RmPageHandle_FInal &page_handle)
+void RmFileHandle_Final::write_slot(const RmPageHandle_FInal &page_handle, int slot_no, const char *buf)
+{
+    if (is_slotted())
+    {
+        char encoded[RM_MAX_ENCODED_SIZE];
+        int len = codec_.encode(buf, encoded);
+        RmSlottedPage slotted_page(page_handle.page);
+        if (slotted_page.insert_at(slot_no, encoded, len))
+            return;
+        slotted_page.shrink_all();
+        if (!slotted_page.insert_at(slot_no, encoded, len))
+            throw InternalError("no space for record (" + std::to_string(page_handle.page->get_page_id().page_no) +
+                                ", " + std::to_string(slot_no) + ") in slotted page");
+        return;
+    }
+    if (!Bitmap::is_set(page_handle.bitmap, slot_no))
+    {
+        Bitmap::set(page_handle.bitmap, slot_no);
+        ++page_handle.page_hdr->num_records;
+    }
+    memcpy(page_handle.get_slot(slot_no), buf, file_hdr_.record_size);
+}
+
+// 删除slot上的记录
+void RmFileHandle_Final::remove_slot(const RmPageHandle_FInal &page_handle, int slot_no)
 {
-    // 当page从已满变成未满，考虑如何更新：
-    // 1. 将这个新的空闲页面插入到空闲页面链表的头部
-    // 2. 让这个页面指向原来的第一个空闲页面
-    std::lock_guard lock(lock_);
-    page_handle.page_hdr->next_free_page_no = file_hdr_.first_free_page_no;
-    file_hdr_.first_free_page_no = page_handle.page->get_page_id().page_no;
+    if (is_slotted())
+    {
+        RmSlottedPage(page_handle.page).remove(slot_no);
+        return;
+    }
+    Bitmap::reset(page_handle.bitmap, slot_no);
+    page_handle.page_hdr->num_records--;
+}
+
+/**
+ * @description: 打开文件时初始化空闲空间映射，优先读入正常关闭时保存的映射，否则读取所有页头重建
+ */
+void RmFileHandle_Final::init_free_space_map()
+{
+    DiskManager_Final *disk_manager = rm_manager_->disk_manager_;
+    free_space_map_ = std::make_unique<RmFreeSpaceMap>(is_slotted() ? RmSlottedPage::capacity() : file_hdr_.num_records_per_page);
+
+    // 读入后删除保存的文件，之后如果没有正常关闭，下次打开时从页头重建
+    std::string path = disk_manager->get_file_name(fd_) + ".fsm";
+    if (path[0] != '/')
+    {
+        char cwd[PATH_MAX];
+        if (getcwd(cwd, sizeof(cwd)) == nullptr)
+            throw UnixError();
+        path = std::string(cwd) + "/" + path;
+    }
+    free_space_map_path_ = path;
+    bool loaded = false;
+    if (disk_manager->is_file(path))
+    {
+        loaded = free_space_map_->load(path, file_hdr_.num_pages);
+        disk_manager->destroy_file(path);
+    }
+    if (loaded)
+        return;
+
+    static constexpr int REBUILD_PREFETCH_PAGES = 64;
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_hdr_.num_pages; page_no++)
+    {
+        if ((page_no - RM_FIRST_RECORD_PAGE) % REBUILD_PREFETCH_PAGES == 0)
+            prefetch_pages(page_no, std::min(REBUILD_PREFETCH_PAGES, file_hdr_.num_pages - page_no));
+        RmPageHandle_FInal page_handle = fetch_page_handle(page_no);
+        {
+            std::lock_guard lock(page_handle.page->latch_);
+            update_free_space(page_handle);
+        }
+        rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false, true);
+    }
 }
 
 void RmFileHandle_Final::abort_insert_record(const Rid &rid)
@@ -465,12 +658,10 @@ void RmFileHandle_Final::abort_insert_record(const Rid &rid)
         return; // 如果没有记录，直接返回
     }
     // 3. 更新bitmap，标记slot为空闲
-    Bitmap::reset(page_handle.bitmap, rid.slot_no);
-    page_handle.page_hdr->num_records--;
+    remove_slot(page_handle, rid.slot_no);
 
-    // 4. 如果页面从满状态变为未满状态，需要更新空闲页面链表
-    if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page - 1)
-        release_page_handle(page_handle);
+    // 4. 更新空闲空间映射
+    update_free_space(page_handle);
 
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
 }
@@ -481,18 +672,9 @@ void RmFileHandle_Final::abort_delete_record(const Rid &rid, char *buf)
     RmPageHandle_FInal page_handle = fetch_page_handle(rid.page_no);
     std::lock_guard lock(page_handle.page->latch_);
 
-    // 复制数据到指定slot
-    memcpy(page_handle.get_slot(rid.slot_no), buf, file_hdr_.record_size);
-
-    // 更新bitmap和记录数
-    if (!is_record(page_handle, rid))
-    {
-        ++page_handle.page_hdr->num_records;
-        Bitmap::set(page_handle.bitmap, rid.slot_no);
-        // std::lock_guard lock(lock_);
-        // if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page)
-        //     file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
-    }
+    // 复制数据到指定slot，slot空闲时更新bitmap和记录数
+    write_slot(page_handle, rid.slot_no, buf);
+    update_free_space(page_handle);
 
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
 }
@@ -508,15 +690,8 @@ void RmFileHandle_Final::abort_update_record(const Rid &rid, char *buf)
     //     throw RecordNotFoundError(rid.page_no, rid.slot_no);
     // }
 
-    if (!is_record(page_handle, rid))
-    {
-        ++page_handle.page_hdr->num_records;
-        Bitmap::set(page_handle.bitmap, rid.slot_no);
-        // std::lock_guard lock(lock_);
-        // if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page)
-        //     file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
-    }
-    memcpy(page_handle.get_slot(rid.slot_no), buf, file_hdr_.record_size);
+    write_slot(page_handle, rid.slot_no, buf);
+    update_free_space(page_handle);
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
 }
 
@@ -525,6 +700,7 @@ void RmFileHandle_Final::clean_page(int page_no, TransactionManager *txn_mgr, ti
     // 清理当前页面
     RmPageHandle_FInal page_handle = fetch_page_handle(page_no);
     std::vector<std::pair<Transaction *, int>> to_delete;
+    std::vector<int> to_shrink; // 变长格式中不会再回滚的记录，释放多余的空间
     to_delete.reserve(file_hdr_.num_records_per_page);
     PageId_Final pageid{.fd = fd_, .page_no = page_no};
 
@@ -538,7 +714,7 @@ void RmFileHandle_Final::clean_page(int page_no, TransactionManager *txn_mgr, ti
 
     // 扫描页面中的所有槽位
     Rid rid{.page_no = page_no};
-    int slot_no = -1;
+    std::vector<int> slots;
     {
         std::shared_lock read_lock(page_handle.page->latch_);
         if (page_handle.page_hdr->num_records == 0)
@@ -548,16 +724,11 @@ void RmFileHandle_Final::clean_page(int page_no, TransactionManager *txn_mgr, ti
             return;
         }
 
-        while (true)
+        int num_slots = live_slots(page_handle, slots);
+        for (int i = 0; i < num_slots; i++)
         {
-            slot_no = Bitmap::next_bit(true, page_handle.bitmap, file_hdr_.num_records_per_page, slot_no);
-
-            if (slot_no >= file_hdr_.num_records_per_page)
-            {
-                break;
-            }
-
-            char *data = page_handle.get_slot(slot_no);
+            int slot_no = slots[i];
+            char *data = slot_data(page_handle, slot_no);
             txn_id_t txn_id = txn_mgr->get_record_txn_id(data);
             Transaction *record_txn = txn_mgr->get_or_create_transaction(txn_id);
             rid.slot_no = slot_no;
@@ -569,6 +740,10 @@ void RmFileHandle_Final::clean_page(int page_no, TransactionManager *txn_mgr, ti
                 {
                     to_delete.emplace_back(std::make_pair(record_txn, slot_no));
                 }
+                else if (is_slotted())
+                {
+                    to_shrink.push_back(slot_no);
+                }
             }
             else
             {
@@ -579,22 +754,26 @@ void RmFileHandle_Final::clean_page(int page_no, TransactionManager *txn_mgr, ti
 
     // 处理需要删除的记录
     bool change = false;
-    if (to_delete.size())
+    if (to_delete.size() || to_shrink.size())
     {
         change = true;
-        bool was_full = (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page);
         std::lock_guard write_lock(page_handle.page->latch_);
         for (auto &[txn, slot_no] : to_delete)
         {
-            Bitmap::reset(page_handle.bitmap, slot_no);
+            remove_slot(page_handle, slot_no);
             txn->release();
         }
-        page_handle.page_hdr->num_records -= to_delete.size();
-        // 如果页面从满状态变为未满状态，需要更新空闲页面链表
-        if (was_full)
+        // 释放共享latch之后记录可能又被其他事务更新，重新检查，正在进行的更新回滚时需要原来的空间
+        RmSlottedPage slotted_page(page_handle.page);
+        for (int slot_no : to_shrink)
         {
-            release_page_handle(page_handle);
+            if (!slotted_page.is_live(slot_no))
+                continue;
+            txn_id_t txn_id = txn_mgr->get_record_txn_id(slotted_page.tuple(slot_no));
+            if (txn_mgr->need_clean(txn_mgr->get_or_create_transaction(txn_id), watermark))
+                slotted_page.shrink(slot_no);
         }
+        update_free_space(page_handle);
     }
 
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), change);
@@ -653,45 +832,31 @@ std::vector<Rid> RmFileHandle_Final::batch_insert_records(const std::vector<std:
         return rids;
     }
 
-    RmPageHandle_FInal page_handle = create_page_handle();
-    std::lock_guard lock(page_handle.page->latch_);
+    RmPageHandle_FInal page_handle = create_page_handle(required_bucket(records.front().get()));
+    std::unique_lock lock(page_handle.page->latch_);
 
     for (const auto &record : records)
     {
-        // 检查当前页面是否还有空间
-        if (page_handle.page_hdr->num_records >= file_hdr_.num_records_per_page)
+        // 找到空闲slot，设置bitmap和复制数据
+        int slot_no = insert_slot(page_handle, record.get());
+
+        // 当前页面已满，换到空闲空间映射选出的下一个页面，新页面也可能已经被其他线程插满
+        while (slot_no < 0)
         {
-            // 当前页面已满，释放并创建新页面
+            update_free_space(page_handle);
+            lock.unlock();
             rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
-            page_handle = create_page_handle();
-            // 注意：这里需要重新获取锁，但由于是新的page_handle，会自动获取新的锁
+            page_handle = create_page_handle(required_bucket(record.get()));
+            lock = std::unique_lock(page_handle.page->latch_);
+            slot_no = insert_slot(page_handle, record.get());
         }
+        update_free_space(page_handle);
 
-        // 找到空闲slot
-        int slot_no = Bitmap::first_bit(false, page_handle.bitmap, file_hdr_.num_records_per_page);
-
-        if (slot_no < file_hdr_.num_records_per_page)
-        {
-            // 设置bitmap和复制数据
-            Bitmap::set(page_handle.bitmap, slot_no);
-            memcpy(page_handle.get_slot(slot_no), record.get(), file_hdr_.record_size);
-            page_handle.page_hdr->num_records++;
-
-            // 记录RID
-            rids.emplace_back(Rid{page_handle.page->get_page_id().page_no, slot_no});
-
-            // 如果页面已满，更新空闲页面链表
-            if (page_handle.page_hdr->num_records == file_hdr_.num_records_per_page)
-            {
-                std::lock_guard file_lock(lock_);
-                if (file_hdr_.first_free_page_no == page_handle.page->get_page_id().page_no)
-                {
-                    file_hdr_.first_free_page_no = page_handle.page_hdr->next_free_page_no;
-                }
-            }
-        }
+        // 记录RID
+        rids.emplace_back(Rid{page_handle.page->get_page_id().page_no, slot_no});
     }
 
+    lock.unlock();
     rm_manager_->buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), true);
     return rids;
 }
@@ -11,13 +11,17 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <assert.h>
+#include <string.h>
 
+#include <functional>
 #include <memory>
 
 #include "bitmap.h"
 #include "common/context.h"
 #include "rm_defs.h"
+#include "rm_free_space_map.h"
 #include "rm_manager_final.h"
+#include "rm_slotted_page.h"
 
 class RmManager_Final;
 
@@ -55,8 +59,12 @@ private:
     RmManager_Final *rm_manager_; // 记录管理器，用于管理表的数据文件
     int fd_;                      // 打开文件后产生的文件句柄
     RmFileHdr file_hdr_;          // 文件头，维护当前表文件的元数据
+    RmFormatHdr format_hdr_;      // 记录格式，创建文件之后不再改变
+    RmTupleCodec codec_;          // 变长格式中记录的编码
     std::shared_mutex lock_;      // 锁，用于保护文件头的读写操作
     bool is_deleted_ = false;     // 标记文件是否被删除
+    std::unique_ptr<RmFreeSpaceMap> free_space_map_; // 每个页面的空闲程度，插入时用来选择页面
+    std::string free_space_map_path_;                // 空闲空间映射在正常关闭时保存到这个文件，句柄可能在离开数据库目录之后才析构，使用绝对路径
 
     struct CleaningProgress
     {
@@ -74,9 +82,16 @@ public:
         // 注意：这里从磁盘中读出文件描述符为fd的文件的file_hdr，读到内存中
         // 这里实际就是初始化file_hdr，只不过是从磁盘中读出进行初始化
         // init file_hdr_
-        disk_manager_->read_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr_, sizeof(file_hdr_));
+        // 按整个页面读到对齐的缓冲区中，O_DIRECT模式下不需要经过DiskManager的中转缓冲区
+        alignas(PAGE_SIZE) char buf[PAGE_SIZE] = {};
+        disk_manager_->read_page(fd, RM_FILE_HDR_PAGE, buf, PAGE_SIZE);
+        memcpy(&file_hdr_, buf, sizeof(file_hdr_));
+        memcpy(&format_hdr_, buf + sizeof(file_hdr_), sizeof(format_hdr_));
+        if (is_slotted())
+            codec_ = RmTupleCodec(format_hdr_, file_hdr_.record_size);
         // disk_manager管理的fd对应的文件中，设置从file_hdr_.num_pages开始分配page_no
         disk_manager_->set_fd2pageno(fd, file_hdr_.num_pages);
+        init_free_space_map();
     }
 
     ~RmFileHandle_Final()
@@ -96,6 +111,7 @@ public:
     int get_approximate_num() { return file_hdr_.num_pages * file_hdr_.num_records_per_page; }
 
     RmFileHdr get_file_hdr() const { return file_hdr_; }
+    inline bool is_slotted() const { return format_hdr_.format == RM_FORMAT_SLOTTED; }
     int GetFd() { return fd_; }
     inline void mark_deleted() { is_deleted_ = true; } // 标记文件为已删除
     inline int get_page_num()
@@ -103,21 +119,36 @@ public:
         std::shared_lock lock(lock_);
         return file_hdr_.num_pages;
     }
+    inline const RmFreeSpaceMap &get_free_space_map() const { return *free_space_map_; }
     inline BufferPoolManager_Final *get_buffer_pool_manager() const
     {
         return rm_manager_->buffer_pool_manager_;
     }
 
-    /* 判断指定位置上是否已经存在一条记录，通过Bitmap来判断 */
+    /* 判断指定位置上是否已经存在一条记录，定长格式通过Bitmap来判断，变长格式通过slot目录判断 */
     inline bool is_record(const RmPageHandle_FInal &page_handle, const Rid &rid)
     {
+        if (is_slotted())
+            return RmSlottedPage(page_handle.page).is_live(rid.slot_no);
         return Bitmap::is_set(page_handle.bitmap, rid.slot_no); // page的slot_no位置上是否有record
     }
 
     std::unique_ptr<RmRecord> get_record(const Rid &rid, Context *context);
     std::vector<std::pair<std::unique_ptr<RmRecord>, int>> get_records(int page_no, Context *context);
 
-    Rid insert_record(char *buf, Context *context);
+    /**
+     * @description: 按slot顺序遍历页面上的记录，调用者需要持有页面的latch
+     * 当前版本可见且没有被删除的记录调用visible(slot_no, data)，data指向页面中的记录；
+     * 当前版本不可见、需要在版本链上查找的记录调用in_chain(slot_no)。
+     * 变长格式的data指向按线程复用的解码缓冲区，只在回调期间有效，回调中不能再调用scan_page
+     */
+    void scan_page(const RmPageHandle_FInal &page_handle, Context *context,
+                   const std::function<void(int, char *)> &visible, const std::function<void(int)> &in_chain);
+
+    // 异步预读从start_page_no开始的num_pages个页面
+    void prefetch_pages(int start_page_no, int num_pages);
+
+    Rid insert_record(char *buf, Context *context, const std::function<void(const Rid &)> &before_unpin = nullptr);
 
     void insert_record(const Rid &rid, char *buf);
     void recovery_insert_record(const Rid &rid, char *buf);
@@ -127,8 +158,9 @@ public:
 
     void delete_record(const Rid &rid, Context *context);
     void recovery_delete_record(const Rid &rid);
+    void recovery_remove_records(std::vector<Rid> &rids);
 
-    void update_record(const Rid &rid, char *buf, Context *context);
+    bool update_record(const Rid &rid, char *buf, Context *context, const std::function<void()> &before_unpin = nullptr);
     // void recovery_update_record(const Rid &rid);
 
     void abort_insert_record(const Rid &rid);
@@ -151,7 +183,17 @@ public:
     bool clean_pages(TransactionManager *txn_mgr, timestamp_t watermark);
 
 private:
-    RmPageHandle_FInal create_page_handle();
+    RmPageHandle_FInal create_page_handle(int min_bucket = 1);
+
+    void update_free_space(const RmPageHandle_FInal &page_handle);
+    int required_bucket(const char *buf) const;
+
+    int live_slots(const RmPageHandle_FInal &page_handle, std::vector<int> &slots) const;
+    char *slot_data(const RmPageHandle_FInal &page_handle, int slot_no) const;
+    void read_slot(const RmPageHandle_FInal &page_handle, int slot_no, char *out) const;
+    int insert_slot(const RmPageHandle_FInal &page_handle, const char *buf);
+    void write_slot(const RmPageHandle_FInal &page_handle, int slot_no, const char *buf);
+    void remove_slot(const RmPageHandle_FInal &page_handle, int slot_no);
 
-    void release_page_handle(RmPageHandle_FInal &page_handle);
+    void init_free_space_map();
 };
\ No newline at end of file
@@ -0,0 +1,183 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "rm_free_space_map.h"
+
+#include <fstream>
+#include <vector>
+
+#include "rm_defs.h"
+
+static constexpr uint32_t FSM_MAGIC = 0x4d534632; // "2FSM"，分级数改变时修改
+static constexpr int WORDS_PER_CHUNK = RmFreeSpaceMap::CHUNK_PAGES / 64;
+
+static std::atomic<int> next_thread_slot{0};
+
+RmFreeSpaceMap::RmFreeSpaceMap(int capacity)
+    : capacity_(capacity), dir_(new std::atomic<Chunk *>[MAX_CHUNKS])
+{
+    for (int i = 0; i < MAX_CHUNKS; i++)
+        dir_[i].store(nullptr, std::memory_order_relaxed);
+    for (auto &target : targets_)
+        target.store(RM_NO_PAGE, std::memory_order_relaxed);
+}
+
+RmFreeSpaceMap::~RmFreeSpaceMap()
+{
+    int num_chunks = num_chunks_.load();
+    for (int i = 0; i < num_chunks; i++)
+        delete dir_[i].load();
+}
+
+RmFreeSpaceMap::Chunk *RmFreeSpaceMap::get_or_create_chunk(int chunk_no)
+{
+    Chunk *chunk = get_chunk(chunk_no);
+    if (chunk != nullptr)
+        return chunk;
+    Chunk *created = new Chunk();
+    if (!dir_[chunk_no].compare_exchange_strong(chunk, created, std::memory_order_acq_rel))
+    {
+        delete created;
+        return chunk;
+    }
+    int num_chunks = num_chunks_.load();
+    while (num_chunks <= chunk_no && !num_chunks_.compare_exchange_weak(num_chunks, chunk_no + 1))
+        ;
+    return created;
+}
+
+void RmFreeSpaceMap::update(int page_no, int free_space)
+{
+    if (page_no < 0 || page_no / CHUNK_PAGES >= MAX_CHUNKS)
+        return;
+    Chunk *chunk = get_or_create_chunk(page_no / CHUNK_PAGES);
+    int offset = page_no % CHUNK_PAGES;
+    uint8_t bucket = bucket_of(free_space);
+    // 分级没有变化时不写，避免相邻页面的插入线程在同一个缓存行上互相干扰
+    uint8_t old_bucket = chunk->buckets[offset].load(std::memory_order_relaxed);
+    if (old_bucket == bucket)
+        return;
+    chunk->buckets[offset].store(bucket, std::memory_order_relaxed);
+    if ((old_bucket > 0) != (bucket > 0))
+    {
+        uint64_t mask = 1ULL << (offset % 64);
+        if (bucket > 0)
+            chunk->has_space[offset / 64].fetch_or(mask, std::memory_order_relaxed);
+        else
+            chunk->has_space[offset / 64].fetch_and(~mask, std::memory_order_relaxed);
+    }
+}
+
+int RmFreeSpaceMap::bucket(int page_no) const
+{
+    if (page_no < 0 || page_no / CHUNK_PAGES >= MAX_CHUNKS)
+        return 0;
+    Chunk *chunk = get_chunk(page_no / CHUNK_PAGES);
+    return chunk == nullptr ? 0 : chunk->buckets[page_no % CHUNK_PAGES].load(std::memory_order_relaxed);
+}
+
+int RmFreeSpaceMap::thread_slot()
+{
+    static thread_local int slot = next_thread_slot.fetch_add(1) % TARGET_SLOTS;
+    return slot;
+}
+
+bool RmFreeSpaceMap::targeted_by_other(int page_no, int slot) const
+{
+    for (int i = 0; i < TARGET_SLOTS; i++)
+        if (i != slot && targets_[i].load(std::memory_order_relaxed) == page_no)
+            return true;
+    return false;
+}
+
+int RmFreeSpaceMap::claim(int slot, int min_bucket)
+{
+    int num_words = num_chunks_.load(std::memory_order_acquire) * WORDS_PER_CHUNK;
+    if (num_words == 0)
+        return RM_NO_PAGE;
+    int start = target(slot);
+    int start_word = (start < 0 || start / 64 >= num_words) ? 0 : start / 64;
+    for (int i = 0; i < num_words; i++)
+    {
+        int word = (start_word + i) % num_words;
+        Chunk *chunk = get_chunk(word / WORDS_PER_CHUNK);
+        if (chunk == nullptr)
+            continue;
+        uint64_t bits = chunk->has_space[word % WORDS_PER_CHUNK].load(std::memory_order_relaxed);
+        while (bits != 0)
+        {
+            int page_no = word * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (chunk->buckets[page_no % CHUNK_PAGES].load(std::memory_order_relaxed) < min_bucket)
+                continue;
+            // 两个槽位同时选中同一个页面也没有关系，只是这两个线程会共用这个页面
+            if (!targeted_by_other(page_no, slot))
+            {
+                set_target(slot, page_no);
+                return page_no;
+            }
+        }
+    }
+    return RM_NO_PAGE;
+}
+
+int RmFreeSpaceMap::free_pages() const
+{
+    int num_chunks = num_chunks_.load(std::memory_order_acquire);
+    int count = 0;
+    for (int i = 0; i < num_chunks; i++)
+    {
+        Chunk *chunk = get_chunk(i);
+        if (chunk == nullptr)
+            continue;
+        for (auto &word : chunk->has_space)
+            count += __builtin_popcountll(word.load(std::memory_order_relaxed));
+    }
+    return count;
+}
+
+void RmFreeSpaceMap::save(const std::string &path, int num_pages) const
+{
+    std::vector<uint8_t> buckets(num_pages);
+    for (int page_no = 0; page_no < num_pages; page_no++)
+        buckets[page_no] = bucket(page_no);
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs.write(reinterpret_cast<const char *>(&FSM_MAGIC), sizeof(FSM_MAGIC));
+    ofs.write(reinterpret_cast<const char *>(&capacity_), sizeof(capacity_));
+    ofs.write(reinterpret_cast<const char *>(&num_pages), sizeof(num_pages));
+    ofs.write(reinterpret_cast<const char *>(buckets.data()), buckets.size());
+}
+
+bool RmFreeSpaceMap::load(const std::string &path, int num_pages)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs)
+        return false;
+    uint32_t magic = 0;
+    int capacity = 0, saved_pages = 0;
+    ifs.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    ifs.read(reinterpret_cast<char *>(&capacity), sizeof(capacity));
+    ifs.read(reinterpret_cast<char *>(&saved_pages), sizeof(saved_pages));
+    if (!ifs || magic != FSM_MAGIC || capacity != capacity_ || saved_pages != num_pages)
+        return false;
+    std::vector<uint8_t> buckets(num_pages);
+    ifs.read(reinterpret_cast<char *>(buckets.data()), buckets.size());
+    if (!ifs)
+        return false;
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < num_pages; page_no++)
+    {
+        if (buckets[page_no] >= NUM_BUCKETS)
+            return false;
+        // 保存的是分级，取该分级中最少的空闲空间，保证读入后分级不变
+        int free_space = buckets[page_no] == 0 ? 0 : ((buckets[page_no] - 1) * capacity_ + NUM_BUCKETS - 2) / (NUM_BUCKETS - 1) + 1;
+        update(page_no, free_space);
+    }
+    return true;
+}
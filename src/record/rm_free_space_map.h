@@ -0,0 +1,102 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @description: 表数据文件的空闲空间映射，每个页面记录一个空闲程度的分级，代替文件头中单一的空闲页面链表
+ *
+ * 分级0表示页面已满，1~NUM_BUCKETS-1按空闲空间的比例递增，分级高于bucket_of(n)的页面一定有n的空闲空间。每64个页面另有一个位图字，
+ * 标记其中还有空闲slot的页面，查找时按字跳过已满的页面。页面按CHUNK_PAGES个一组按需分配，
+ * 读取和更新都不需要加锁；更新同一个页面的调用者必须持有该页面的写latch。
+ *
+ * 插入线程按到达顺序分到TARGET_SLOTS个槽位中的一个，每个槽位记住自己的目标页面，
+ * 目标页面满了之后才重新查找，查找时跳过其他槽位正在使用的页面，
+ * 这样并发插入的线程分散在不同的页面上，不会争用同一个页面的latch。
+ *
+ * 空闲空间映射由页头推导，页头的修改都有日志。正常关闭时保存到"<表名>.fsm"，
+ * 打开时读入并删除这个文件；系统崩溃后文件不存在，打开表时从页头重建，重做和回滚日志时随页面一起更新。
+ */
+class RmFreeSpaceMap
+{
+public:
+    static constexpr int NUM_BUCKETS = 32;
+    static constexpr int TARGET_SLOTS = 16;
+    static constexpr int CHUNK_PAGES = 8192;
+    static constexpr int MAX_CHUNKS = 8192; // 最多管理CHUNK_PAGES * MAX_CHUNKS个页面，更大的页面号视为已满
+
+    // capacity为空页面的空闲空间，定长格式为每页的slot数，变长格式为每页可用的字节数
+    explicit RmFreeSpaceMap(int capacity);
+    ~RmFreeSpaceMap();
+
+    RmFreeSpaceMap(const RmFreeSpaceMap &) = delete;
+    RmFreeSpaceMap &operator=(const RmFreeSpaceMap &) = delete;
+
+    // 空闲空间对应的分级
+    inline int bucket_of(int free_space) const
+    {
+        if (free_space <= 0)
+            return 0;
+        return std::min(1 + (free_space - 1) * (NUM_BUCKETS - 1) / capacity_, NUM_BUCKETS - 1);
+    }
+
+    // 页面的空闲空间变化后调用，调用者持有页面的写latch
+    void update(int page_no, int free_space);
+
+    int bucket(int page_no) const;
+    inline bool has_space(int page_no) const { return bucket(page_no) > 0; }
+
+    // 当前线程所在的槽位
+    static int thread_slot();
+
+    inline int target(int slot) const { return targets_[slot].load(std::memory_order_relaxed); }
+
+    /**
+     * @description: 为槽位查找一个分级不低于min_bucket、且没有被其他槽位使用的页面，作为它新的目标页面
+     * 从槽位原来的目标页面开始向后查找，到文件末尾后回到文件开头
+     * @return {int} 页面号，没有这样的页面时返回RM_NO_PAGE
+     */
+    int claim(int slot, int min_bucket = 1);
+
+    inline void set_target(int slot, int page_no) { targets_[slot].store(page_no, std::memory_order_relaxed); }
+
+    // 有空闲空间的页面数
+    int free_pages() const;
+
+    // 按num_pages个页面保存到文件中
+    void save(const std::string &path, int num_pages) const;
+
+    /**
+     * @description: 读入save()保存的文件，页面数与num_pages不一致或者文件损坏时返回false
+     */
+    bool load(const std::string &path, int num_pages);
+
+private:
+    struct Chunk
+    {
+        std::atomic<uint8_t> buckets[CHUNK_PAGES]{};
+        std::atomic<uint64_t> has_space[CHUNK_PAGES / 64]{};
+    };
+
+    Chunk *get_chunk(int chunk_no) const { return dir_[chunk_no].load(std::memory_order_acquire); }
+    Chunk *get_or_create_chunk(int chunk_no);
+    bool targeted_by_other(int page_no, int slot) const;
+
+    const int capacity_;
+    std::unique_ptr<std::atomic<Chunk *>[]> dir_;
+    std::atomic<int> num_chunks_{0}; // 已经分配的最大块号+1，查找时只扫描这些块
+    std::atomic<int> targets_[TARGET_SLOTS];
+};
@@ -14,8 +14,11 @@ std::shared_ptr<RmFileHandle_Final> RmManager_Final::open_file(const std::string
 void RmManager_Final::close_file(const RmFileHandle_Final *file_handle, bool flush)
 {
     if (flush)
+    {
         disk_manager_->write_page(file_handle->fd_, RM_FILE_HDR_PAGE, (char *)&file_handle->file_hdr_,
                                   sizeof(file_handle->file_hdr_));
+        file_handle->free_space_map_->save(file_handle->free_space_map_path_, file_handle->file_hdr_.num_pages);
+    }
     // 缓冲区的所有页刷到磁盘，注意这句话必须写在close_file前面
     buffer_pool_manager_->remove_all_pages(file_handle->fd_, flush);
     disk_manager_->close_file(file_handle->fd_);
@@ -11,10 +11,14 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include <assert.h>
+#include <string.h>
+
+#include <algorithm>
 #include <memory>
 
 #include "bitmap.h"
 #include "rm_defs.h"
+#include "rm_slotted_page.h"
 
 class RmFileHandle_Final;
 
@@ -35,13 +39,17 @@ public:
      * @description: 创建表的数据文件并初始化相关信息
      * @param {string&} filename 要创建的文件名称
      * @param {int} record_size 表中记录的大小
+     * @param {RmFormatHdr*} format 记录格式，为空时使用定长格式
      */
-    void create_file(const std::string &filename, int record_size)
+    void create_file(const std::string &filename, int record_size, const RmFormatHdr *format = nullptr)
     {
         if (record_size < 1 || record_size > RM_MAX_RECORD_SIZE)
         {
             throw InvalidRecordSizeError(record_size);
         }
+        RmFormatHdr format_hdr{};
+        if (format != nullptr)
+            format_hdr = *format;
         disk_manager_->create_file(filename);
         int fd = disk_manager_->open_file(filename);
 
@@ -50,14 +58,29 @@ public:
         file_hdr.record_size = record_size;
         file_hdr.num_pages = 1;
         file_hdr.first_free_page_no = RM_NO_PAGE;
-        // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
-        file_hdr.num_records_per_page =
-            (BITMAP_WIDTH * (PAGE_SIZE - 1 - (int)sizeof(RmFileHdr)) + 1) / (1 + record_size * BITMAP_WIDTH);
-        file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        if (format_hdr.format == RM_FORMAT_SLOTTED)
+        {
+            // 变长格式没有bitmap，num_records_per_page按所有字符串为空时估计，只用于预分配
+            int min_encoded = record_size;
+            for (int i = 0; i < format_hdr.num_var_cols; i++)
+                min_encoded -= format_hdr.var_cols[i].len - (int)sizeof(uint16_t);
+            file_hdr.num_records_per_page = RmSlottedPage::capacity() / (std::max(min_encoded, 1) + (int)sizeof(RmSlot));
+            file_hdr.bitmap_size = 0;
+        }
+        else
+        {
+            // We have: sizeof(hdr) + (n + 7) / 8 + n * record_size <= PAGE_SIZE
+            file_hdr.num_records_per_page =
+                (BITMAP_WIDTH * (PAGE_SIZE - 1 - (int)sizeof(RmFileHdr)) + 1) / (1 + record_size * BITMAP_WIDTH);
+            file_hdr.bitmap_size = (file_hdr.num_records_per_page + BITMAP_WIDTH - 1) / BITMAP_WIDTH;
+        }
 
-        // 将file header写入磁盘文件（名为file name，文件描述符为fd）中的第0页
+        // 将file header和记录格式写入磁盘文件（名为file name，文件描述符为fd）中的第0页
         // head page直接写入磁盘，没有经过缓冲区的NewPage，那么也就不需要FlushPage
-        disk_manager_->write_page(fd, RM_FILE_HDR_PAGE, (char *)&file_hdr, sizeof(file_hdr));
+        char buf[sizeof(RmFileHdr) + sizeof(RmFormatHdr)];
+        memcpy(buf, &file_hdr, sizeof(file_hdr));
+        memcpy(buf + sizeof(file_hdr), &format_hdr, sizeof(format_hdr));
+        disk_manager_->write_page(fd, RM_FILE_HDR_PAGE, buf, sizeof(buf));
         disk_manager_->close_file(fd);
     }
 
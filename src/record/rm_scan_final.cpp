@@ -13,12 +13,22 @@ See the Mulan PSL v2 for more details. */
 #include "storage/buffer_pool_manager_final.h"
 #include "transaction/transaction_manager.h"
 
-RmScan_Final::RmScan_Final(std::shared_ptr<RmFileHandle_Final> file_handle, Context *context) : file_handle_(file_handle),
-                                                                                                context_(context),
-                                                                                                rid_{RM_FILE_HDR_PAGE, -1}, // 初始化为第0页,slot_no为-1表示即将开始扫描
-                                                                                                current_record_idx_(0)
+RmScan_Final::RmScan_Final(std::shared_ptr<RmFileHandle_Final> file_handle, Context *context, bool zero_copy)
+    : file_handle_(file_handle),
+      context_(context),
+      rid_{RM_FILE_HDR_PAGE, -1}, // 初始化为第0页,slot_no为-1表示即将开始扫描
+      prefetched_until_(RM_FIRST_RECORD_PAGE),
+      current_record_idx_(0),
+      zero_copy_(zero_copy)
 {
     page_num = file_handle->get_page_num();
+    if (zero_copy_)
+    {
+        // 零拷贝模式由load_view()逐页加载
+        views_.reserve(file_handle_->file_hdr_.num_records_per_page);
+        view_slots_.reserve(file_handle_->file_hdr_.num_records_per_page);
+        return;
+    }
     // 预分配空间，避免后续resize
     current_records_.reserve(file_handle_->file_hdr_.num_records_per_page);
     load_next_page(); // 加载第一页数据
@@ -64,6 +74,8 @@ void RmScan_Final::load_next_page()
         return;
     }
 
+    prefetch_ahead();
+
     // 获取当前页的所有记录
     std::vector<std::pair<std::unique_ptr<RmRecord>, int>> raw_records =
         file_handle_->get_records(rid_.page_no, context_);
@@ -105,8 +117,96 @@ void RmScan_Final::load_next_page()
     }
 }
 
+void RmScan_Final::prefetch_ahead()
+{
+    // 已经预读的页面剩下不到一半时，继续预读后面的页面
+    if (prefetched_until_ < page_num && prefetched_until_ - rid_.page_no < PREFETCH_PAGES / 2)
+    {
+        int start = std::max(prefetched_until_, rid_.page_no + 1);
+        int num = std::min(PREFETCH_PAGES, page_num - start);
+        file_handle_->prefetch_pages(start, num);
+        prefetched_until_ = start + num;
+    }
+}
+
+RmScan_Final::~RmScan_Final()
+{
+    release_view();
+}
+
+/**
+ * @description: 释放当前视图，固定下一个有可见记录的页面并在持有共享latch的情况下建立视图
+ * @return {bool} 是否还有记录，返回false时已经扫描到文件末尾
+ */
+bool RmScan_Final::load_view()
+{
+    assert(zero_copy_);
+    release_view();
+    TransactionManager *txn_manager = context_->txn_->get_txn_manager();
+    int record_size = file_handle_->file_hdr_.record_size;
+    bool slotted = file_handle_->is_slotted();
+    while (++rid_.page_no < page_num)
+    {
+        prefetch_ahead();
+        RmPageHandle_FInal page_handle = file_handle_->fetch_page_handle(rid_.page_no);
+        view_page_ = page_handle.page;
+        view_page_->latch_.lock_shared();
+
+        // 写入者先持有页面的latch再修改版本链，这里持有页面latch查找版本链的顺序与之相同
+        std::shared_ptr<PageVersionInfo> version_info;
+        bool version_info_loaded = false;
+        file_handle_->scan_page(
+            page_handle, context_,
+            [&](int slot_no, char *data)
+            {
+                // 变长格式的data是解码用的临时缓冲区，需要复制
+                views_.emplace_back(data, record_size, slotted);
+                view_slots_.push_back(slot_no);
+            },
+            [&](int slot_no)
+            {
+                if (!version_info_loaded)
+                {
+                    version_info = txn_manager->GetPageVersionInfo(PageId_Final{file_handle_->GetFd(), rid_.page_no});
+                    version_info_loaded = true;
+                }
+                if (!version_info)
+                    return;
+                // 版本链上的旧版本同样不复制，由清理线程的水位线保证扫描期间不会被回收
+                auto visible_version = txn_manager->GetVisibleRecord(version_info, Rid{rid_.page_no, slot_no}, context_->txn_);
+                if (visible_version)
+                {
+                    views_.emplace_back(std::move(*visible_version));
+                    view_slots_.push_back(slot_no);
+                }
+            });
+        if (!views_.empty())
+        {
+            rid_.slot_no = view_slots_.front();
+            return true;
+        }
+        release_view();
+    }
+    return false;
+}
+
+void RmScan_Final::release_view()
+{
+    if (view_page_ == nullptr)
+        return;
+    PageId_Final page_id = view_page_->get_page_id();
+    view_page_->latch_.unlock_shared();
+    view_page_ = nullptr;
+    views_.clear();
+    view_slots_.clear();
+    // 与get_records()相同，全表扫描访问的页面以低优先级放回
+    file_handle_->get_buffer_pool_manager()->unpin_page(page_id, false, true);
+}
+
 bool RmScan_Final::is_end() const
 {
+    if (zero_copy_)
+        return view_page_ == nullptr && rid_.page_no + 1 >= page_num;
     return rid_.page_no >= page_num ||
            current_records_.empty();
 }
@@ -119,6 +219,13 @@ Rid RmScan_Final::rid() const
 std::vector<Rid> RmScan_Final::rid_batch() const
 {
     std::vector<Rid> rids;
+    if (zero_copy_)
+    {
+        rids.reserve(view_slots_.size());
+        for (int slot_no : view_slots_)
+            rids.emplace_back(Rid{rid_.page_no, slot_no});
+        return rids;
+    }
     rids.reserve(current_records_.size());
 
     // current_records_中的记录都已经是可见的了
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 
 class RmFileHandle_Final;
+class Page_Final;
 
 class RmScan_Final : public RecScan
 {
@@ -24,13 +25,21 @@ private:
     Context *context_; // 事务上下文
     Rid rid_;          // 当前扫描位置
     int page_num;
+    int prefetched_until_; // 已经提交预读的页面的下一个页号
 
     // 批量扫描相关
     std::vector<std::pair<std::unique_ptr<RmRecord>, int>> current_records_; // 当前页面的记录批次
     size_t current_record_idx_;                                              // 当前批次中的位置
 
+    // 零拷贝扫描相关
+    bool zero_copy_;
+    Page_Final *view_page_ = nullptr; // 当前视图固定并持有共享latch的页面
+    std::vector<RmRecord> views_;     // 当前页面可见记录的视图，不拥有数据
+    std::vector<int> view_slots_;     // 每个视图对应的slot_no
+
 public:
-    RmScan_Final(std::shared_ptr<RmFileHandle_Final> file_handle, Context *context);
+    RmScan_Final(std::shared_ptr<RmFileHandle_Final> file_handle, Context *context, bool zero_copy = false);
+    ~RmScan_Final();
 
     void next() override;         // 移动到下一条记录
     void next_batch();            // 移动到下一批次记录(下一页)
@@ -52,6 +61,18 @@ public:
     std::vector<Rid> rid_batch() const override;                    // 获取当前页所有记录的RID
     std::vector<std::unique_ptr<RmRecord>> record_batch() override; // 获取当前页所有记录
 
+    /**
+     * 零拷贝访问，构造时zero_copy为true才能使用，不能与上面按记录复制的接口混用：
+     *   while (scan.load_view()) { for (auto &rec : scan.view_records()) ...; scan.release_view(); }
+     * load_view()固定下一个有可见记录的页面并持有它的共享latch，view_records()中的记录直接指向缓冲池帧
+     * （或版本链上的旧版本），在release_view()之前有效。持有视图期间不能修改这个页面，
+     * 需要修改扫描到的记录时先通过rid_batch()记下RID，释放视图之后再修改
+     */
+    bool load_view();
+    void release_view();
+    const std::vector<RmRecord> &view_records() const { return views_; }
+
 private:
     void load_next_page(); // 加载下一页数据
+    void prefetch_ahead(); // 已经预读的页面剩下不到一半时继续预读
 };
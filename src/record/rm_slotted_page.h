@@ -0,0 +1,279 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <string.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "rm_defs.h"
+
+// 编码后记录的最大长度
+constexpr int RM_MAX_ENCODED_SIZE = RM_MAX_RECORD_SIZE + RM_MAX_VAR_COLS * (int)sizeof(uint16_t);
+
+/* 变长格式页面中，RmPageHdr之后的页头 */
+struct RmSlottedPageHdr
+{
+    int num_slots;     // slot目录的项数，包括空闲的slot
+    int data_begin;    // 记录区的起始位置，记录从页尾向前分配
+    int garbage_bytes; // 记录区中已经释放、整理页面之后才能重新使用的字节数
+};
+
+/* slot目录项，len为0表示空闲的slot */
+struct RmSlot
+{
+    uint16_t offset; // 记录的位置
+    uint16_t len;    // 记录当前的长度
+    uint16_t cap;    // 为记录分配的空间，记录变短时不缩小，保证回滚时旧的记录一定能放回原处
+};
+
+/**
+ * @description: 变长格式的页面，页头之后是slot目录，记录从页尾向前存放，中间是空闲空间
+ *
+ * 记录号中的slot_no是slot目录的下标，整理页面只移动记录，不改变slot_no。
+ * 删除记录和记录移到更大的空间时，原来的空间计入garbage_bytes，空闲空间不够连续时整理页面。
+ * 所有位置都相对于页头（page->get_data() + OFFSET_PAGE_HDR），调用者持有页面的latch。
+ */
+class RmSlottedPage
+{
+public:
+    static constexpr int PAGE_BYTES = PAGE_SIZE - (int)Page_Final::OFFSET_PAGE_HDR;
+    static constexpr int HDR_SIZE = (int)(sizeof(RmPageHdr) + sizeof(RmSlottedPageHdr));
+
+    explicit RmSlottedPage(Page_Final *page) : base_(page->get_data() + Page_Final::OFFSET_PAGE_HDR) {}
+
+    // 空页面上可以用于slot目录和记录的字节数
+    static constexpr int capacity() { return PAGE_BYTES - HDR_SIZE; }
+
+    void init()
+    {
+        page_hdr()->next_free_page_no = RM_NO_PAGE;
+        page_hdr()->num_records = 0;
+        hdr()->num_slots = 0;
+        hdr()->data_begin = PAGE_BYTES;
+        hdr()->garbage_bytes = 0;
+    }
+
+    inline int num_slots() const { return hdr()->num_slots; }
+    inline bool is_live(int slot_no) const { return slot_no >= 0 && slot_no < num_slots() && slots()[slot_no].len > 0; }
+    inline char *tuple(int slot_no) const { return base_ + slots()[slot_no].offset; }
+    inline int tuple_len(int slot_no) const { return slots()[slot_no].len; }
+
+    // 整理页面之后的空闲字节数
+    inline int free_space() const { return contiguous_space() + hdr()->garbage_bytes; }
+
+    // 按slot顺序写出所有记录的slot_no，返回记录数
+    int live_slots(int *out) const
+    {
+        int n = 0;
+        const RmSlot *dir = slots();
+        for (int i = 0; i < num_slots(); i++)
+            if (dir[i].len > 0)
+                out[n++] = i;
+        return n;
+    }
+
+    /**
+     * @description: 插入一条记录，优先使用空闲的slot
+     * @return {int} slot_no，空间不够时返回-1，页面没有变化
+     */
+    int insert(const char *data, int len)
+    {
+        int slot_no = 0;
+        const RmSlot *dir = slots();
+        while (slot_no < num_slots() && dir[slot_no].len > 0)
+            slot_no++;
+        return insert_at(slot_no, data, len) ? slot_no : -1;
+    }
+
+    /**
+     * @description: 在指定的slot上写入记录，用于恢复和回滚；slot上已有记录时替换它，slot超出目录时扩展目录
+     * @return {bool} 空间不够时返回false，页面没有变化
+     */
+    bool insert_at(int slot_no, const char *data, int len)
+    {
+        if (is_live(slot_no))
+            return update(slot_no, data, len);
+        int new_slots = std::max(0, slot_no + 1 - num_slots());
+        int need = len + new_slots * (int)sizeof(RmSlot);
+        if (free_space() < need)
+            return false;
+        if (contiguous_space() < need)
+            compact();
+        for (int i = num_slots(); i <= slot_no; i++)
+            slots()[i] = RmSlot{0, 0, 0};
+        hdr()->num_slots += new_slots;
+        place(slot_no, data, len);
+        page_hdr()->num_records++;
+        return true;
+    }
+
+    // 更新记录是否能在这个页面中完成
+    bool can_update(int slot_no, int len) const
+    {
+        const RmSlot &slot = slots()[slot_no];
+        return len <= slot.cap || len <= free_space() + slot.cap;
+    }
+
+    /**
+     * @description: 更新记录，新记录不超过原来分配的空间时原地写入，否则在页面中重新分配
+     * @return {bool} 空间不够时返回false，页面没有变化
+     */
+    bool update(int slot_no, const char *data, int len)
+    {
+        RmSlot &slot = slots()[slot_no];
+        if (len <= slot.cap)
+        {
+            memcpy(base_ + slot.offset, data, len);
+            slot.len = len;
+            return true;
+        }
+        if (!can_update(slot_no, len))
+            return false;
+        // 原来的空间先释放，整理页面时不再保留
+        hdr()->garbage_bytes += slot.cap;
+        slot.cap = 0;
+        slot.len = 0;
+        if (contiguous_space() < len)
+            compact();
+        place(slot_no, data, len);
+        return true;
+    }
+
+    void remove(int slot_no)
+    {
+        RmSlot *dir = slots();
+        hdr()->garbage_bytes += dir[slot_no].cap;
+        dir[slot_no] = RmSlot{0, 0, 0};
+        page_hdr()->num_records--;
+        // 末尾空闲的slot从目录中去掉
+        while (num_slots() > 0 && dir[num_slots() - 1].len == 0)
+            hdr()->num_slots--;
+    }
+
+    // 不会再回滚的记录释放超出当前长度的空间
+    void shrink(int slot_no)
+    {
+        RmSlot &slot = slots()[slot_no];
+        hdr()->garbage_bytes += slot.cap - slot.len;
+        slot.cap = slot.len;
+    }
+
+    // 所有记录都释放超出当前长度的空间
+    void shrink_all()
+    {
+        for (int i = 0; i < num_slots(); i++)
+            if (slots()[i].len > 0)
+                shrink(i);
+    }
+
+    // 把所有记录移到页尾，回收garbage_bytes
+    void compact()
+    {
+        RmSlot *dir = slots();
+        std::vector<int> order;
+        order.reserve(num_slots());
+        for (int i = 0; i < num_slots(); i++)
+            if (dir[i].cap > 0)
+                order.push_back(i);
+        // 按位置从后向前移动，每条记录只会向页尾移动，不会覆盖还没有移动的记录
+        std::sort(order.begin(), order.end(), [dir](int a, int b)
+                  { return dir[a].offset > dir[b].offset; });
+        int end = PAGE_BYTES;
+        for (int i : order)
+        {
+            end -= dir[i].cap;
+            memmove(base_ + end, base_ + dir[i].offset, dir[i].len);
+            dir[i].offset = end;
+        }
+        hdr()->data_begin = end;
+        hdr()->garbage_bytes = 0;
+    }
+
+private:
+    inline RmPageHdr *page_hdr() const { return reinterpret_cast<RmPageHdr *>(base_); }
+    inline RmSlottedPageHdr *hdr() const { return reinterpret_cast<RmSlottedPageHdr *>(base_ + sizeof(RmPageHdr)); }
+    inline RmSlot *slots() const { return reinterpret_cast<RmSlot *>(base_ + HDR_SIZE); }
+    inline int contiguous_space() const { return hdr()->data_begin - HDR_SIZE - num_slots() * (int)sizeof(RmSlot); }
+
+    // 在连续空闲空间中分配并写入，调用者保证空间足够
+    void place(int slot_no, const char *data, int len)
+    {
+        hdr()->data_begin -= len;
+        RmSlot &slot = slots()[slot_no];
+        slot.offset = hdr()->data_begin;
+        slot.len = len;
+        slot.cap = len;
+        memcpy(base_ + slot.offset, data, len);
+    }
+
+    char *base_;
+};
+
+/**
+ * @description: 变长格式中记录的编码，字符串列写成2字节的长度加去掉末尾'\0'之后的内容，其他列原样保留
+ * 第一个字符串列之前的部分与定长记录相同，MVCC的事务号可以直接在页面中读写
+ */
+class RmTupleCodec
+{
+public:
+    RmTupleCodec() = default;
+    RmTupleCodec(const RmFormatHdr &format, int record_size)
+        : record_size_(record_size), var_cols_(format.var_cols, format.var_cols + format.num_var_cols) {}
+
+    // 编码后的最大长度
+    int max_size() const { return record_size_ + (int)(var_cols_.size() * sizeof(uint16_t)); }
+
+    // 编码一条定长记录，返回编码后的长度，out至少有max_size()字节
+    int encode(const char *record, char *out) const
+    {
+        int pos = 0, len = 0;
+        for (auto &col : var_cols_)
+        {
+            memcpy(out + len, record + pos, col.offset - pos);
+            len += col.offset - pos;
+            uint16_t n = col.len;
+            while (n > 0 && record[col.offset + n - 1] == '\0')
+                n--;
+            memcpy(out + len, &n, sizeof(n));
+            memcpy(out + len + sizeof(n), record + col.offset, n);
+            len += sizeof(n) + n;
+            pos = col.offset + col.len;
+        }
+        memcpy(out + len, record + pos, record_size_ - pos);
+        return len + record_size_ - pos;
+    }
+
+    // 解码为record_size字节的定长记录
+    void decode(const char *data, char *out) const
+    {
+        int pos = 0;
+        const char *in = data;
+        for (auto &col : var_cols_)
+        {
+            memcpy(out + pos, in, col.offset - pos);
+            in += col.offset - pos;
+            uint16_t n;
+            memcpy(&n, in, sizeof(n));
+            memcpy(out + col.offset, in + sizeof(n), n);
+            memset(out + col.offset + n, 0, col.len - n);
+            in += sizeof(n) + n;
+            pos = col.offset + col.len;
+        }
+        memcpy(out + pos, in, record_size_ - pos);
+    }
+
+private:
+    int record_size_ = 0;
+    std::vector<RmVarCol> var_cols_;
+};
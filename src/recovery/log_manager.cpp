@@ -44,22 +44,21 @@ lsn_t LogManager::add_log_to_buffer_without_lock(LogRecord *log_record)
 }
 
 /**
- * @description: 交换双缓冲区
+ * @description: 交换双缓冲区，调用时需要持有latch_
  */
 void LogManager::swap_buffers() {
-    // 获取当前非活跃缓冲区的索引
-    int flush_buffer_index = 1 - active_buffer_index_;
-    LogBuffer* flush_buffer = &log_buffers_[flush_buffer_index];
+    // 等待刷盘线程写完非活跃缓冲区
+    flush_done_cv_.wait(latch_, [this] { return !flushing_; });
+    LogBuffer* flush_buffer = &log_buffers_[1 - active_buffer_index_];
     
-    // 如果非活跃缓冲区有数据，先刷盘
+    // 如果刷盘线程还没来得及处理非活跃缓冲区，直接刷盘
     if (flush_buffer->size() > 0) {
         disk_manager_->write_log(flush_buffer->buffer_, flush_buffer->size());
-        persist_lsn_ = global_lsn_ - 1;
         flush_buffer->reset();
     }
     
     // 交换活跃缓冲区
-    active_buffer_index_ = flush_buffer_index;
+    active_buffer_index_ = 1 - active_buffer_index_;
     
     // 通知刷盘线程有新数据需要处理
     flush_cv_.notify_one();
@@ -76,81 +75,147 @@ void LogManager::flush_log_to_disk()
 
 void LogManager::flush_log_to_disk_without_lock()
 {
-    if(is_dirty_) {
+    flush_done_cv_.wait(latch_, [this] { return !flushing_; });
+    LogBuffer* inactive_buffer = &log_buffers_[1 - active_buffer_index_];
+    if(is_dirty_ || inactive_buffer->size() > 0) {
+        // 先刷新非活跃缓冲区，其中的日志更早
+        if (inactive_buffer->size() > 0) {
+            disk_manager_->write_log(inactive_buffer->buffer_, inactive_buffer->size());
+            inactive_buffer->reset();
+        }
+        
         // 刷新当前活跃缓冲区
         LogBuffer* active_buffer = &log_buffers_[active_buffer_index_];
         if (active_buffer->size() > 0) {
             disk_manager_->write_log(active_buffer->buffer_, active_buffer->size());
             active_buffer->reset();
         }
-        
-        // 刷新非活跃缓冲区
-        LogBuffer* inactive_buffer = &log_buffers_[1 - active_buffer_index_];
-        if (inactive_buffer->size() > 0) {
-            disk_manager_->write_log(inactive_buffer->buffer_, inactive_buffer->size());
-            inactive_buffer->reset();
-        }
+        disk_manager_->sync_log();
         
         persist_lsn_ = global_lsn_ - 1;
+        pending_commits_ = 0;
+        is_dirty_ = false;
+        persist_cv_.notify_all();
+    }
+}
+
+/**
+ * @description: 等待日志号不超过lsn的日志都持久化到磁盘中，用于事务提交
+ * @param {lsn_t} lsn 需要持久化的日志号
+ */
+void LogManager::wait_for_flush(lsn_t lsn)
+{
+    std::unique_lock lock(latch_);
+    if (persist_lsn_ >= lsn) {
+        return;
+    }
+    // 已经在正在写入的这一批中的日志不需要再触发一次刷盘
+    if (!flushing_ || lsn > flushing_lsn_) {
+        pending_commits_++;
+        flush_cv_.notify_one();
+    }
+    persist_cv_.wait(lock, [this, lsn] { return persist_lsn_ >= lsn || shutdown_; });
+}
+
+/**
+ * @description: 把两个缓冲区中的日志写入磁盘并持久化，写磁盘时不持有latch_，其他事务可以继续向活跃缓冲区写日志
+ * @param {unique_lock<mutex>&} lock 持有latch_的锁
+ */
+void LogManager::group_flush(std::unique_lock<std::mutex> &lock)
+{
+    flushing_ = true;
+    pending_commits_ = 0;
+    flushing_lsn_ = global_lsn_ - 1;
+    bool written = false;
+
+    // 非活跃缓冲区中的日志更早，先写入
+    LogBuffer* flush_buffer = &log_buffers_[1 - active_buffer_index_];
+    if (flush_buffer->size() > 0) {
+        lock.unlock();
+        disk_manager_->write_log(flush_buffer->buffer_, flush_buffer->size());
+        lock.lock();
+        flush_buffer->reset();
+        written = true;
+    }
+
+    // 交换缓冲区，原来的活跃缓冲区变为非活跃缓冲区后写入磁盘
+    // 写入和fdatasync作为一组有序的请求一起提交，一次持久化这一批所有事务的日志
+    if (log_buffers_[active_buffer_index_].size() > 0) {
+        flushing_lsn_ = global_lsn_ - 1;
+        active_buffer_index_ = 1 - active_buffer_index_;
         is_dirty_ = false;
+        flush_buffer = &log_buffers_[1 - active_buffer_index_];
+        lock.unlock();
+        disk_manager_->async_write_log(flush_buffer->buffer_, flush_buffer->size(), true).get();
+        lock.lock();
+        flush_buffer->reset();
+    } else if (written) {
+        lock.unlock();
+        disk_manager_->sync_log();
+        lock.lock();
     }
+    if (flushing_lsn_ > persist_lsn_) {
+        persist_lsn_ = flushing_lsn_;
+    }
+    flushing_ = false;
+    flush_done_cv_.notify_all();
+    persist_cv_.notify_all();
 }
 
 /**
- * @description: 周期性的把日志缓冲区的内容刷到磁盘中
+ * @description: 刷盘线程：有事务等待提交时进行组提交，否则周期性的把日志缓冲区的内容刷到磁盘中
  */
 void LogManager::flush_log_to_disk_periodically() {
+    std::unique_lock lock(latch_);
     while (!shutdown_) {
-        std::unique_lock<std::mutex> lock(flush_mutex_);
-        
         // 等待一定时间或被唤醒
         flush_cv_.wait_for(lock, std::chrono::milliseconds(10), [this] {
-            return shutdown_.load() || is_dirty_;
+            return shutdown_.load() || pending_commits_ > 0 || log_buffers_[1 - active_buffer_index_].size() > 0;
         });
         
         if (shutdown_) {
             break;
         }
         
-        // 立即交换缓冲区并刷盘
-        {
-            std::lock_guard<std::mutex> log_lock(latch_);
-            if (is_dirty_) {
-                // 获取非活跃缓冲区进行刷盘
-                int flush_buffer_index = 1 - active_buffer_index_;
-                LogBuffer* flush_buffer = &log_buffers_[flush_buffer_index];
-                
-                if (flush_buffer->size() > 0) {
-                    disk_manager_->write_log(flush_buffer->buffer_, flush_buffer->size());
-                    persist_lsn_ = global_lsn_ - 1;
-                    flush_buffer->reset();
-                }
-                
-                // 如果当前活跃缓冲区也有数据，交换后刷盘
-                LogBuffer* active_buffer = &log_buffers_[active_buffer_index_];
-                if (active_buffer->size() > 0) {
-                    // 交换缓冲区
-                    active_buffer_index_ = flush_buffer_index;
-                    
-                    // 刷新原来的活跃缓冲区（现在变成非活跃）
-                    disk_manager_->write_log(active_buffer->buffer_, active_buffer->size());
-                    persist_lsn_ = global_lsn_ - 1;
-                    active_buffer->reset();
-                }
-                
-                is_dirty_ = false;
-            }
+        // 组提交：等待更多的事务加入这一批，直到达到批大小或者超过最大等待时间
+        if (pending_commits_ > 0 && pending_commits_ < group_commit_size_ && group_commit_delay_us_ > 0) {
+            flush_cv_.wait_for(lock, std::chrono::microseconds(group_commit_delay_us_), [this] {
+                return shutdown_.load() || pending_commits_ >= group_commit_size_;
+            });
+        }
+        
+        if (is_dirty_ || pending_commits_ > 0 || log_buffers_[1 - active_buffer_index_].size() > 0) {
+            group_flush(lock);
         }
     }
 }
 
 void LogManager::create_static_check_point(TransactionManager *txn_mgr)
 {
-    std::lock_guard lock(latch_);
-    flush_log_to_disk_without_lock();
+    // 持有页面latch的线程可能正在等待latch_写日志或者等待日志持久化，持有latch_时不能阻塞地等待页面latch。
+    // 先不持有latch_写回大部分脏页；持有latch_后只尝试加页面latch，有页面被占用时暂时释放latch_让对方继续，
+    // 退避一段时间后重试，超过重试次数时放弃检查点，日志保持不变
+    flush_log_to_disk();
+    buffer_pool_manager_->force_flush_all_pages();
+    std::unique_lock lock(latch_);
+    int backoff_us = CHECKPOINT_BACKOFF_MIN_US;
+    for (int retry = 0;; retry++)
+    {
+        flush_log_to_disk_without_lock();
+        if (buffer_pool_manager_->force_flush_all_pages(false))
+            break;
+        if (retry >= CHECKPOINT_FLUSH_RETRIES)
+        {
+            throw InternalError("LogManager::create_static_check_point dirty pages still latched after " +
+                                std::to_string(retry) + " retries");
+        }
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+        backoff_us = std::min(backoff_us * 2, CHECKPOINT_BACKOFF_MAX_US);
+        lock.lock();
+    }
 
     int offset = 0;
-    buffer_pool_manager_->force_flush_all_pages();
 
     std::unordered_set<int> finish_txns_;
     LogRecord *log_record = nullptr;
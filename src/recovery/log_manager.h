@@ -10,6 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
 #include <mutex>
 #include <vector>
 #include <iostream>
@@ -17,6 +20,7 @@ See the Mulan PSL v2 for more details. */
 #include "log_defs.h"
 #include "common/config.h"
 #include "record/rm_defs.h"
+#include "storage/buffer_pool_manager_final.h"
 
 class TransactionManager;
 
@@ -195,7 +199,7 @@ public:
         prev_lsn_ = INVALID_LSN;
         table_name_ = nullptr;
     }
-    InsertLogRecord(txn_id_t txn_id, RmRecord &insert_value, Rid &rid, std::string &table_name)
+    InsertLogRecord(txn_id_t txn_id, RmRecord &insert_value, const Rid &rid, std::string &table_name)
         : InsertLogRecord()
     {
         log_tid_ = txn_id;
@@ -486,9 +490,23 @@ class LogBuffer
 public:
     LogBuffer() : offset_(0) {}
 
+    ~LogBuffer() { delete[] buffer_; }
+
+    LogBuffer(const LogBuffer &) = delete;
+    LogBuffer &operator=(const LogBuffer &) = delete;
+
+    // 分配大小为capacity的缓冲区，由LogManager在构造时调用
+    void init(int capacity)
+    {
+        delete[] buffer_;
+        buffer_ = new char[capacity + 1];
+        capacity_ = capacity;
+        offset_ = 0;
+    }
+
     inline bool is_full(int append_size)
     {
-        return (offset_ + append_size > LOG_BUFFER_SIZE);
+        return (offset_ + append_size > capacity_);
     }
 
     inline void append(LogRecord *log_record)
@@ -507,24 +525,37 @@ public:
         return offset_;
     }
 
-    char buffer_[LOG_BUFFER_SIZE + 1];
+    char *buffer_ = nullptr;
+    int capacity_ = 0;
     int offset_; // 写入log的offset
 };
 
-/* 日志管理器，负责把日志写入日志缓冲区，以及把日志缓冲区中的内容写入磁盘中 */
-class LogManager
+/* 日志管理器，负责把日志写入日志缓冲区，以及把日志缓冲区中的内容写入磁盘中
+ * 同时作为缓冲池的WalFlusher，缓冲池写回脏页之前通过它持久化页面修改对应的日志 */
+class LogManager : public WalFlusher
 {
 public:
-    LogManager(DiskManager_Final *disk_manager, BufferPoolManager_Final *buffer_pool_manager)
+    LogManager(DiskManager_Final *disk_manager, BufferPoolManager_Final *buffer_pool_manager,
+               size_t log_buffer_size = LOG_BUFFER_SIZE)
         : disk_manager_(disk_manager), buffer_pool_manager_(buffer_pool_manager)
     {
+        for (auto &log_buffer : log_buffers_)
+            log_buffer.init(log_buffer_size);
         flush_thread_ = std::thread(&LogManager::flush_log_to_disk_periodically, this);
+        if (buffer_pool_manager_ != nullptr)
+            buffer_pool_manager_->set_wal_flusher(this);
     }
 
     ~LogManager()
     {
-        shutdown_.store(true);
+        if (buffer_pool_manager_ != nullptr)
+            buffer_pool_manager_->set_wal_flusher(nullptr);
+        {
+            std::lock_guard lock(latch_);
+            shutdown_.store(true);
+        }
         flush_cv_.notify_all();  // 唤醒刷盘线程
+        persist_cv_.notify_all();
         if (flush_thread_.joinable())
         {
             flush_thread_.join();
@@ -534,6 +565,33 @@ public:
 
     lsn_t add_log_to_buffer(LogRecord *log_record);
     void flush_log_to_disk();
+    void wait_for_flush(lsn_t lsn);
+
+    lsn_t get_persist_lsn() const { return persist_lsn_.load(); }
+
+    // WalFlusher
+    lsn_t last_lsn() const override { return global_lsn_.load() - 1; }
+    lsn_t persist_lsn() const override { return persist_lsn_.load(); }
+    void flush_until(lsn_t lsn) override { wait_for_flush(lsn); }
+
+    // 设置组提交的最大等待时间和批大小
+    void set_group_commit(int delay_us, int size)
+    {
+        std::lock_guard lock(latch_);
+        group_commit_delay_us_ = std::max(0, delay_us);
+        group_commit_size_ = std::max(1, size);
+    }
+
+    /**
+     * @description: 限制组提交的批大小。等待刷盘的事务会占用执行它的工作线程，同时等待的事务不会超过工作线程数，
+     * 批大小超过工作线程数时这一批永远凑不满，每次提交都要等满group_commit_delay_us_
+     * @param {int} max_waiters 最多同时等待刷盘的事务个数，即工作线程数
+     */
+    void limit_group_commit_size(int max_waiters)
+    {
+        std::lock_guard lock(latch_);
+        group_commit_size_ = std::max(1, std::min(group_commit_size_, max_waiters));
+    }
 
     LogBuffer *get_log_buffer() { return &log_buffers_[active_buffer_index_]; }
 
@@ -545,18 +603,25 @@ private:
     void flush_log_to_disk_without_lock();
     lsn_t add_log_to_buffer_without_lock(LogRecord *log_record);
     void swap_buffers();  // 新增：交换缓冲区
+    void group_flush(std::unique_lock<std::mutex> &lock);
 
 private:
     std::atomic<lsn_t> global_lsn_{0}; // 全局lsn，递增，用于为每条记录分发lsn
-    std::mutex latch_;                 // 用于对log_buffer_的互斥访问
+    std::mutex latch_;                 // 用于对log_buffer_的互斥访问，下面的条件变量都在latch_上等待
     
     // 双缓冲区实现
     LogBuffer log_buffers_[2];         // 双缓冲区
     std::atomic<int> active_buffer_index_{0};  // 当前活跃缓冲区索引
-    std::mutex flush_mutex_;           // 刷盘操作的互斥锁
-    std::condition_variable flush_cv_; // 用于唤醒刷盘线程
+    std::condition_variable_any flush_cv_;      // 用于唤醒刷盘线程
+    std::condition_variable_any persist_cv_;    // 日志持久化后唤醒等待提交的事务
+    std::condition_variable_any flush_done_cv_; // 刷盘线程写完一批日志后唤醒等待缓冲区的线程
+    bool flushing_ = false;            // 刷盘线程正在不持有latch_的情况下写非活跃缓冲区
+    lsn_t flushing_lsn_ = INVALID_LSN; // 正在写入的这一批日志的最后一个日志号
+    int pending_commits_ = 0;          // 等待下一批刷盘的提交事务个数
+    int group_commit_delay_us_ = GROUP_COMMIT_DELAY_US;
+    int group_commit_size_ = GROUP_COMMIT_SIZE;
     
-    lsn_t persist_lsn_;                // 记录已经持久化到磁盘中的最后一条日志的日志号
+    std::atomic<lsn_t> persist_lsn_{INVALID_LSN}; // 记录已经持久化到磁盘中的最后一条日志的日志号
     DiskManager_Final *disk_manager_;
     BufferPoolManager_Final *buffer_pool_manager_;
     std::thread flush_thread_;          // 异步刷盘线程
@@ -13,9 +13,55 @@ See the Mulan PSL v2 for more details. */
 
 /**
  * @description: analyze阶段，需要获得脏页表（DPT）和未完成的事务列表（ATT）
+ *
+ * 重做不检查页面的LSN，页面可能已经写回了日志之后的状态。定长格式的slot原地覆盖，重做的结果与页面状态无关；
+ * 变长格式的页面按日志顺序重新写入时可能放不下，这里先删除日志涉及的所有记录，
+ * 这些记录由重做从它们的第一条日志开始重新构造，页面中剩下的记录在日志期间没有变化
  */
 void RecoveryManager::analyze()
 {
+    std::unordered_map<std::string, std::vector<Rid>> slotted_rids;
+    auto collect = [&](const char *table_name, size_t table_name_size, const Rid &rid)
+    {
+        std::string name(table_name, table_name_size);
+        auto fh = sm_manager_->get_table_handle(name);
+        if (fh != nullptr && fh->is_slotted())
+            slotted_rids[name].push_back(rid);
+    };
+
+    long long offset = 0;
+    LogRecord *log_record = nullptr;
+    while ((log_record = read_log(offset)) != nullptr)
+    {
+        offset += log_record->log_tot_len_;
+        switch (log_record->log_type_)
+        {
+        case UPDATE:
+        {
+            auto *update_log_record = static_cast<UpdateLogRecord *>(log_record);
+            collect(update_log_record->table_name_, update_log_record->table_name_size_, update_log_record->rid_);
+            break;
+        }
+        case INSERT:
+        {
+            auto *insert_log_record = static_cast<InsertLogRecord *>(log_record);
+            collect(insert_log_record->table_name_, insert_log_record->table_name_size_, insert_log_record->rid_);
+            break;
+        }
+        case DELETE:
+        {
+            auto *delete_log_record = static_cast<DeleteLogRecord *>(log_record);
+            collect(delete_log_record->table_name_, delete_log_record->table_name_size_, delete_log_record->rid_);
+            break;
+        }
+        default:
+            break;
+        }
+        delete log_record;
+    }
+
+    for (auto &[table_name, rids] : slotted_rids)
+        sm_manager_->get_table_handle(table_name)->recovery_remove_records(rids);
 }
 
 /**
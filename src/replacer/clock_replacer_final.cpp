@@ -37,7 +37,8 @@ bool ClockReplacer_Final::victim(frame_id_t *frame_id)
                     else
                     {
                         // 找到可替换页面
-                        *frame_id = idx + (&shard - &shards_[0]) * shard.entries.size();
+                        // 与get_shard()和pin()中的映射一致：帧编号 = 分片内下标 * SHARD_COUNT + 分片编号
+                        *frame_id = idx * SHARD_COUNT + (&shard - &shards_[0]);
                         shard.entries[idx].in_replacer = false;
                         shard.num_entries--;
 
@@ -81,6 +82,19 @@ void ClockReplacer_Final::unpin(frame_id_t frame_id)
     }
 }
 
+void ClockReplacer_Final::unpin_low_priority(frame_id_t frame_id)
+{
+    auto &shard = get_shard(frame_id);
+    std::lock_guard guard(shard.mtx);
+    size_t idx = frame_id / SHARD_COUNT % shard.entries.size();
+    if (!shard.entries[idx].in_replacer)
+    {
+        shard.entries[idx].in_replacer = true;
+        shard.entries[idx].ref = false; // 不设置引用位，时钟指针第一次经过时就可以淘汰
+        shard.num_entries++;
+    }
+}
+
 size_t ClockReplacer_Final::Size()
 {
     size_t total = 0;
@@ -15,6 +15,7 @@ public:
     bool victim(frame_id_t *frame_id) override;
     void pin(frame_id_t frame_id) override;
     void unpin(frame_id_t frame_id) override;
+    void unpin_low_priority(frame_id_t frame_id) override;
     size_t Size() override;
 
 private:
@@ -0,0 +1,116 @@
+#include "lru_k_replacer_final.h"
+#include <algorithm>
+
+LRUKReplacer_Final::LRUKReplacer_Final(size_t num_pages, size_t k)
+    : k_(std::clamp<size_t>(k, 1, MAX_K)), shards_(SHARD_COUNT), frames_(num_pages) {}
+
+bool LRUKReplacer_Final::victim(frame_id_t *frame_id)
+{
+    // 访问不足K次的页面优先于访问过K次的页面，同一类中比较所有分片最先淘汰的候选
+    while (true)
+    {
+        Shard *best = nullptr;
+        bool best_history = false;
+        std::pair<uint64_t, frame_id_t> best_key;
+        for (auto &shard : shards_)
+        {
+            std::lock_guard guard(shard.mtx);
+            bool history = !shard.history_set.empty();
+            if (!history && shard.cache_set.empty())
+                continue;
+            auto key = history ? *shard.history_set.begin() : *shard.cache_set.begin();
+            if (best == nullptr || (history && !best_history) || (history == best_history && key < best_key))
+            {
+                best = &shard;
+                best_history = history;
+                best_key = key;
+            }
+        }
+        if (best == nullptr)
+            return false;
+
+        std::lock_guard guard(best->mtx);
+        // 比较期间分片可能已经变化，候选不再是这个分片中最先淘汰的页面时重新比较
+        auto &set = best_history ? best->history_set : best->cache_set;
+        if (set.empty() || *set.begin() != best_key || (!best_history && !best->history_set.empty()))
+            continue;
+        *frame_id = best_key.second;
+        remove(*best, frames_[*frame_id]);
+        frames_[*frame_id].count = 0; // 帧将存放新的页面，清空访问历史
+        return true;
+    }
+}
+
+void LRUKReplacer_Final::pin(frame_id_t frame_id)
+{
+    auto &shard = get_shard(frame_id);
+    std::lock_guard guard(shard.mtx);
+    FrameInfo &info = frames_[frame_id];
+    if (info.evictable)
+        remove(shard, info);
+}
+
+void LRUKReplacer_Final::unpin(frame_id_t frame_id)
+{
+    auto &shard = get_shard(frame_id);
+    std::lock_guard guard(shard.mtx);
+    FrameInfo &info = frames_[frame_id];
+    if (info.evictable)
+        remove(shard, info);
+
+    // 记录一次访问
+    uint64_t ts = current_ts_.fetch_add(1) + 1;
+    if (info.count == 0)
+        info.first_access = ts;
+    info.history[info.head % k_] = ts;
+    info.head = (info.head + 1) % k_;
+    if (info.count < k_)
+        info.count++;
+    insert(shard, info, frame_id, false);
+}
+
+void LRUKReplacer_Final::unpin_low_priority(frame_id_t frame_id)
+{
+    auto &shard = get_shard(frame_id);
+    std::lock_guard guard(shard.mtx);
+    FrameInfo &info = frames_[frame_id];
+    if (info.evictable)
+        return;
+    // 不记录访问：热点页面保持原来的位置，其他页面放在最先淘汰的位置
+    insert(shard, info, frame_id, true);
+}
+
+size_t LRUKReplacer_Final::Size()
+{
+    size_t size = 0;
+    for (auto &shard : shards_)
+    {
+        std::lock_guard guard(shard.mtx);
+        size += shard.history_set.size() + shard.cache_set.size();
+    }
+    return size;
+}
+
+void LRUKReplacer_Final::remove(Shard &shard, FrameInfo &info)
+{
+    if (info.count < k_)
+        shard.history_set.erase(info.set_it);
+    else
+        shard.cache_set.erase(info.set_it);
+    info.evictable = false;
+}
+
+void LRUKReplacer_Final::insert(Shard &shard, FrameInfo &info, frame_id_t frame_id, bool low_priority)
+{
+    if (info.count < k_)
+    {
+        // 访问时间戳从1开始，低优先级的页面使用0，排在所有页面之前
+        uint64_t key = low_priority ? 0 : info.first_access;
+        info.set_it = shard.history_set.emplace(key, frame_id).first;
+    }
+    else
+    {
+        info.set_it = shard.cache_set.emplace(kth_access(info), frame_id).first;
+    }
+    info.evictable = true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "common/config.h"
+#include "replacer/replacer.h"
+
+/**
+ * @description: LRU-K替换策略，淘汰倒数第K次访问距今最久的页面
+ * 访问次数不足K次的页面（如全表扫描只读一次的页面）总是先于访问过K次的页面被淘汰，
+ * 它们之间按第一次访问的先后淘汰，因此大表扫描不会把频繁访问的热点页面挤出缓冲池
+ * 帧按编号分布在多个分片中以减少锁竞争，淘汰时比较所有分片中最先淘汰的候选，淘汰顺序与不分片时一致
+ */
+class LRUKReplacer_Final : public Replacer
+{
+public:
+        explicit LRUKReplacer_Final(size_t num_pages, size_t k = LRU_K);
+        ~LRUKReplacer_Final() = default;
+
+        bool victim(frame_id_t *frame_id) override;
+        void pin(frame_id_t frame_id) override;
+        void unpin(frame_id_t frame_id) override;
+        void unpin_low_priority(frame_id_t frame_id) override;
+        size_t Size() override;
+
+        static constexpr size_t MAX_K = 4;
+
+private:
+        struct FrameInfo
+        {
+                std::array<uint64_t, MAX_K> history{}; // 最近K次访问的时间戳，循环使用
+                size_t count{0};                       // 访问次数，最多记录K次
+                size_t head{0};                        // 下一次访问写入history的位置
+                uint64_t first_access{0};              // 帧存放当前页面以来第一次访问的时间戳
+                bool evictable{false};
+                std::set<std::pair<uint64_t, frame_id_t>>::iterator set_it; // 在history_set或cache_set中的位置
+        };
+
+        struct Shard
+        {
+                std::mutex mtx;
+                std::set<std::pair<uint64_t, frame_id_t>> history_set; // 访问不足K次的页面，按第一次访问的时间排序
+                std::set<std::pair<uint64_t, frame_id_t>> cache_set;   // 访问过K次的页面，按倒数第K次访问的时间排序
+        };
+
+        static constexpr int SHARD_COUNT = 16;
+        static constexpr int SHARD_MASK = SHARD_COUNT - 1;
+        size_t k_;
+        std::vector<Shard> shards_;
+        std::vector<FrameInfo> frames_; // 帧的访问历史，由帧所在分片的锁保护
+        std::atomic<uint64_t> current_ts_{0};
+
+        inline Shard &get_shard(frame_id_t frame_id)
+        {
+                return shards_[frame_id & SHARD_MASK];
+        }
+
+        // 倒数第K次访问的时间戳
+        inline uint64_t kth_access(const FrameInfo &info) const
+        {
+                return info.history[info.head % k_];
+        }
+
+        void remove(Shard &shard, FrameInfo &info);
+        void insert(Shard &shard, FrameInfo &info, frame_id_t frame_id, bool low_priority);
+};
@@ -47,6 +47,17 @@ void LRUReplacer_Final::unpin(frame_id_t frame_id)
     shard.lru_map[frame_id] = shard.lru_list.begin();
 }
 
+void LRUReplacer_Final::unpin_low_priority(frame_id_t frame_id)
+{
+    auto &shard = get_shard(frame_id);
+    std::lock_guard guard(shard.mtx);
+    if (shard.lru_map.find(frame_id) != shard.lru_map.end())
+        return;
+    // 放在尾部，最先被淘汰
+    shard.lru_list.push_back(frame_id);
+    shard.lru_map[frame_id] = std::prev(shard.lru_list.end());
+}
+
 size_t LRUReplacer_Final::Size()
 {
     size_t size = 0;
@@ -39,6 +39,13 @@ class Replacer {
      */
     virtual void unpin(frame_id_t frame_id) = 0;
 
+    /**
+     * Unpins a frame that was only touched by a large scan. The access should not make the frame
+     * look hot, so policies place it where it is evicted before frames used by other queries.
+     * @param frame_id the id of the frame to unpin
+     */
+    virtual void unpin_low_priority(frame_id_t frame_id) { unpin(frame_id); }
+
     /** @return the number of elements in the replacer that can be victimized */
     virtual size_t Size() = 0;
 };
@@ -9,51 +9,127 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <readline/history.h>
 #include <readline/readline.h>
-#include <setjmp.h>
 #include <signal.h>
+#include <sys/epoll.h>
 #include <unistd.h>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 #include "errors.h"
+#include "common/runtime_config.h"
 #include "optimizer/optimizer.h"
+#include "optimizer/plan_cache.h"
 #include "recovery/log_recovery.h"
 #include "optimizer/plan.h"
 #include "optimizer/planner.h"
 #include "portal.h"
 #include "analyze/analyze.h"
+#include "wire_protocol.h"
 
 #define SOCK_PORT 8765
-#define MAX_CONN_LIMIT 256
+#define MAX_CONN_LIMIT SOMAXCONN
+#define MAX_EPOLL_EVENTS 1024
 
 static bool should_exit = false;
 
-// 构建全局所需的管理器对象
-auto disk_manager = std::make_unique<DiskManager_Final>();
-auto buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(BUFFER_POOL_SIZE, disk_manager.get());
-auto rm_manager = std::make_unique<RmManager_Final>(disk_manager.get(), buffer_pool_manager.get());
-auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
-auto sm_manager = std::make_unique<SmManager>(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
-auto lock_manager = std::make_unique<LockManager>();
-auto txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), sm_manager.get());
-auto planner = std::make_unique<Planner>(sm_manager.get());
-auto optimizer = std::make_unique<Optimizer>(sm_manager.get(), planner.get());
-auto ql_manager = std::make_unique<QlManager>(sm_manager.get(), txn_manager.get(), planner.get());
-auto log_manager = std::make_unique<LogManager>(disk_manager.get(), buffer_pool_manager.get());
-auto recovery = std::make_unique<RecoveryManager>(disk_manager.get(), buffer_pool_manager.get(), sm_manager.get(), txn_manager.get());
-auto portal = std::make_unique<Portal>(sm_manager.get());
-auto analyze = std::make_unique<Analyze>(sm_manager.get());
-pthread_mutex_t *buffer_mutex;
-pthread_mutex_t *sockfd_mutex;
-
-static jmp_buf jmpbuf;
+// 全局所需的管理器对象，在main()中读取配置之后构建
+std::unique_ptr<DiskManager_Final> disk_manager;
+std::unique_ptr<BufferPoolManager_Final> buffer_pool_manager;
+std::unique_ptr<RmManager_Final> rm_manager;
+std::unique_ptr<IxManager> ix_manager;
+std::unique_ptr<SmManager> sm_manager;
+std::unique_ptr<LockManager> lock_manager;
+std::unique_ptr<TransactionManager> txn_manager;
+std::unique_ptr<Planner> planner;
+std::unique_ptr<Optimizer> optimizer;
+std::unique_ptr<QlManager> ql_manager;
+std::unique_ptr<LogManager> log_manager;
+std::unique_ptr<RecoveryManager> recovery;
+std::unique_ptr<Portal> portal;
+std::unique_ptr<Analyze> analyze;
+
+// 按启动配置构建管理器对象
+static void init_managers(const RuntimeConfig &config)
+{
+    disk_manager = std::make_unique<DiskManager_Final>(config.direct_io, config.io_backend, config.io_threads);
+    buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(config.buffer_pool_frames(), disk_manager.get(),
+                                                                    config.max_buffer_pool_frames(), config.replacer,
+                                                                    config.replacer_k, config.huge_pages, config.numa_policy);
+    rm_manager = std::make_unique<RmManager_Final>(disk_manager.get(), buffer_pool_manager.get());
+    ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    sm_manager = std::make_unique<SmManager>(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
+    lock_manager = std::make_unique<LockManager>();
+    txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), sm_manager.get());
+    planner = std::make_unique<Planner>(sm_manager.get());
+    optimizer = std::make_unique<Optimizer>(sm_manager.get(), planner.get());
+    ql_manager = std::make_unique<QlManager>(sm_manager.get(), txn_manager.get(), planner.get());
+    log_manager = std::make_unique<LogManager>(disk_manager.get(), buffer_pool_manager.get(), config.log_buffer_size);
+    // 批大小在启动服务端时还会被限制在工作线程数以内
+    log_manager->set_group_commit(config.group_commit_delay_us, config.group_commit_size);
+    recovery = std::make_unique<RecoveryManager>(disk_manager.get(), buffer_pool_manager.get(), sm_manager.get(), txn_manager.get());
+    portal = std::make_unique<Portal>(sm_manager.get());
+    analyze = std::make_unique<Analyze>(sm_manager.get());
+}
+// 客户端会话：保存一个连接在多次请求之间需要保留的状态（上下文、当前事务、未处理完的请求数据）
+// 会话以EPOLLONESHOT方式注册到epoll中，同一时刻最多只有一个工作线程在处理某个会话
+struct Session
+{
+    int fd;
+    // 记录客户端当前正在执行的事务ID
+    txn_id_t txn_id = INVALID_TXN_ID;
+    // 需要返回给客户端的结果的长度
+    int offset = 0;
+    // 系统所需的上下文信息，data_send_在每次被工作线程处理时指向该线程的发送缓冲区
+    std::unique_ptr<Context> context;
+    // 已经接收但还没有处理的请求数据，每条请求以'\0'结尾
+    std::string recv_buf;
+    // 会话私有的可重入解析器，不同会话的解析与语义分析可以并行执行
+    SqlParser parser;
+    // 会话私有的计划缓存，执行时直接把常量绑定到缓存的计划上
+    PlanCache plan_cache;
+    // 是否已经根据第一个字节确定了连接使用的协议，以及是否为二进制帧协议
+    bool protocol_checked = false;
+    bool binary_protocol = false;
+    FrameWriter frame_writer;
+    // 结果暂停发送的查询：发送缓冲区积压过多时暂停产生结果，socket可写之后继续
+    std::shared_ptr<PortalStmt> suspended;
+    // 当前请求中还没有执行的语句，排在暂停的查询后面
+    std::deque<std::string> pending_stmts;
+    // 客户端已经退出或者关闭了连接，不再接收新的请求，结果全部写出后关闭会话
+    bool closing = false;
+
+    explicit Session(int fd_)
+        : fd(fd_), plan_cache(sm_manager.get(), analyze.get(), optimizer.get(), planner.get()), frame_writer(fd_)
+    {
+        context = std::make_unique<Context>(lock_manager.get(), log_manager.get(), nullptr, nullptr, &offset);
+    }
+};
+
+static int epoll_fd = -1;
+
+// 工作线程池：reactor线程把可读的会话放入就绪队列，由固定数量的工作线程取出处理
+static std::mutex ready_mutex;
+static std::condition_variable ready_cv;
+static std::deque<Session *> ready_sessions;
+static bool workers_stop = false;
+
+// 所有存活的会话，服务器退出时回滚它们未结束的事务并关闭连接
+static std::mutex sessions_mutex;
+static std::unordered_set<Session *> live_sessions;
+
 void sigint_handler(int signo)
 {
     should_exit = true;
     log_manager->flush_log_to_disk();
     std::cout << "The Server receive Crtl+C, will been closed\n";
-    longjmp(jmpbuf, 1);
 }
 
 // 判断当前正在执行的是显式事务还是单条SQL语句的事务，并更新事务ID
@@ -69,207 +145,585 @@ void SetTransaction(txn_id_t *txn_id, Context *context)
     }
 }
 
-void *client_handler(void *sock_fd)
+/**
+ * @description: 为一条语句生成计划，处理PREPARE/EXECUTE/DEALLOCATE，并把可以缓存的语句加入会话的计划缓存
+ * @return {shared_ptr<Plan>} 需要执行的计划，PREPARE和DEALLOCATE不需要执行，返回nullptr
+ * @param {Session} *session 请求所属的会话
+ * @param {char} *sql 请求内容
+ * @param {shared_ptr<ast::TreeNode>} parse_tree 语法树
+ * @param {string} *cache_key 规范化后的SQL，语句不能自动缓存时为nullptr
+ * @param {vector<shared_ptr<ast::Value>>&} literals 规范化时得到的常量
+ */
+std::shared_ptr<Plan> plan_statement(Session *session, const char *sql, std::shared_ptr<ast::TreeNode> parse_tree,
+                                     const std::string *cache_key, const std::vector<std::shared_ptr<ast::Value>> &literals)
 {
-    int fd = *((int *)sock_fd);
-    pthread_mutex_unlock(sockfd_mutex);
+    Context *context = session->context.get();
+    switch (parse_tree->Nodetype())
+    {
+    case ast::TreeNodeType::PrepareStmt:
+    {
+        auto x = std::static_pointer_cast<ast::PrepareStmt>(parse_tree);
+        session->plan_cache.prepare(x->name, x->stmt, context);
+        return nullptr;
+    }
+    case ast::TreeNodeType::ExecuteStmt:
+    {
+        auto x = std::static_pointer_cast<ast::ExecuteStmt>(parse_tree);
+        for (auto &val : x->vals)
+        {
+            if (val->Nodetype() == ast::TreeNodeType::Param)
+                throw RMDBError("Parameter placeholder is only allowed in PREPARE");
+        }
+        return PlanCache::bind(*session->plan_cache.get_prepared(x->name, context), x->vals);
+    }
+    case ast::TreeNodeType::DeallocateStmt:
+        session->plan_cache.deallocate(std::static_pointer_cast<ast::DeallocateStmt>(parse_tree)->name);
+        return nullptr;
+    default:
+        break;
+    }
 
-    int i_recvBytes;
-    // 接收客户端发送的请求
-    char data_recv[BUFFER_LENGTH];
-    // 需要返回给客户端的结果
-    char *data_send = new char[BUFFER_LENGTH];
-    // 需要返回给客户端的结果的长度
-    int offset = 0;
-    // 记录客户端当前正在执行的事务ID
-    txn_id_t txn_id = INVALID_TXN_ID;
+    if (PlanCache::parameterize(parse_tree, nullptr) > 0)
+        throw RMDBError("Parameter placeholder is only allowed in PREPARE");
+    if (cache_key != nullptr)
+    {
+        // 与常量无关的错误（表或列不存在、内部错误等）和不使用缓存时一样，直接抛出；
+        // 类型检查和字符串长度检查依赖常量的值，参数化之后报错的位置可能不同，重新按普通方式生成计划
+        try
+        {
+            auto entry = session->plan_cache.insert(*cache_key, parse_tree, literals, context);
+            if (entry != nullptr)
+                return PlanCache::bind(*entry, literals);
+        }
+        catch (IncompatibleTypeError &)
+        {
+        }
+        catch (StringOverflowError &)
+        {
+        }
+        // 语法树中的常量已经被替换成参数，重新解析后按普通方式执行，保证报错与不使用缓存时一致
+        parse_tree = nullptr;
+        session->parser.parse(sql, parse_tree);
+    }
 
-    // std::string output = "establish client connection, sockfd: " + std::to_string(fd) + "\n";
-    // std::cout << output;
-    // 开启事务，初始化系统所需的上下文信息（包括事务对象指针、锁管理器指针、日志管理器指针、存放结果的buffer、记录结果长度的变量）
-    auto context = std::make_unique<Context>(lock_manager.get(), log_manager.get(), nullptr, data_send, &offset);
+    // analyze and rewrite
+    std::shared_ptr<Query> query = analyze->do_analyze(parse_tree, context);
+    // context->clearFlags(); // 清除标志位
+    // 优化器
+    return optimizer->plan_query(query, context);
+}
 
-    while (true)
+/**
+ * @description: 执行语句或者继续执行暂停的查询，出错时把错误信息写入发送缓冲区、写入output.txt并回滚事务
+ * @return {bool} 是否出错
+ * @param {Session} *session 语句所属的会话
+ * @param {function} body 执行语句的过程
+ */
+static bool run_guarded(Session *session, const std::function<void()> &body)
+{
+    Context *context = session->context.get();
+    char *data_send = context->data_send_;
+    int &offset = session->offset;
+    try
+    {
+        body();
+    }
+    catch (TransactionAbortException &e)
     {
-        // std::cout << "Waiting for request..." << std::endl;
+        // 事务需要回滚，需要把abort信息返回给客户端并写入output.txt文件中
+        std::string str = "abort\n";
+        memcpy(data_send, str.c_str(), str.length());
+        data_send[str.length()] = '\0';
+        offset = str.length();
+
+        // 回滚事务
+        txn_manager->abort(context, log_manager.get());
+        std::cout << e.GetInfo() << std::endl;
+
+        // 只有当io_enabled_为true时才写入文件
+        if (sm_manager->io_enabled_)
+        {
+            std::fstream outfile;
+            outfile.open("output.txt", std::ios::out | std::ios::app);
+            if (outfile.is_open())
+            {
+                outfile << str;
+                outfile.close();
+            }
+        }
+        return true;
+    }
+    catch (RMDBError &e)
+    {
+        // 遇到异常，需要打印failure到output.txt文件中，并发异常信息返回给客户端
+        std::cerr << e.what() << std::endl;
 
-        i_recvBytes = read(fd, data_recv, BUFFER_LENGTH);
+        memcpy(data_send, e.what(), e.get_msg_len());
+        data_send[e.get_msg_len()] = '\n';
+        data_send[e.get_msg_len() + 1] = '\0';
+        offset = e.get_msg_len() + 1;
 
-        if (i_recvBytes == 0)
+        // 只有当io_enabled_为true时才写入文件
+        if (sm_manager->io_enabled_)
         {
-            // std::cout << "Maybe the client has closed" << std::endl;
-            break;
+            std::fstream outfile;
+            outfile.open("output.txt", std::ios::out | std::ios::app);
+            if (outfile.is_open())
+            {
+                outfile << "failure\n";
+                outfile.close();
+            }
         }
-        if (i_recvBytes == -1)
+
+        // 回滚事务
+        txn_manager->abort(context, log_manager.get());
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @description: 语句执行完之后把结果写入会话的发送缓冲区，单条语句的事务自动提交
+ * @return {bool} 是否继续保持连接，写回失败时返回false
+ * @param {Session} *session 语句所属的会话
+ * @param {bool} failed 语句是否出错
+ * @param {bool} end_of_request 是否为请求中的最后一条语句，文本协议只在最后一条语句的结果后面加'\0'
+ */
+static bool finish_statement(Session *session, bool failed, bool end_of_request)
+{
+    Context *context = session->context.get();
+    char *data_send = context->data_send_;
+    int &offset = session->offset;
+    txn_id_t &txn_id = session->txn_id;
+
+    // future TODO: 格式化 sql_handler.result, 传给客户端
+    // send result with fixed format, use protobuf in the future
+    bool keep_alive;
+    if (session->binary_protocol)
+    {
+        if (failed)
         {
-            std::cout << "Client read error!" << std::endl;
-            break;
+            // 去掉文本协议中错误信息末尾的换行
+            size_t len = offset;
+            if (len > 0 && data_send[len - 1] == '\n')
+                len--;
+            session->frame_writer.send_error(data_send, len);
         }
-        data_recv[i_recvBytes] = '\0';
-        // printf("i_recvBytes: %d \n ", i_recvBytes);
+        else
+        {
+            session->frame_writer.send_complete(data_send, offset);
+        }
+    }
+    else
+    {
+        data_send[offset] = '\0';
+        session->frame_writer.put_bytes(data_send, end_of_request ? offset + 1 : offset);
+    }
+    // 结果先缓存在会话的发送缓冲区中，由handle_session不阻塞地写回
+    keep_alive = !session->frame_writer.broken();
 
-        if (strcmp(data_recv, "exit") == 0)
+    // 如果是单条语句，需要按照一个完整的事务来执行，所以执行完当前语句后，自动提交事务
+    if (context->txn_->get_state() == TransactionState::ABORTED ||
+        context->txn_->get_state() == TransactionState::COMMITTED)
+    {
+        // 事务已经结束，释放事务对象
+        context->txn_->release();
+        context->txn_ = nullptr;
+        txn_id = INVALID_TXN_ID;
+    }
+    else if (!context->txn_->get_txn_mode())
+    {
+        txn_manager->commit(context, context->log_mgr_);
+        context->txn_->release();
+        context->txn_ = nullptr;
+        txn_id = INVALID_TXN_ID;
+    }
+    return keep_alive;
+}
+
+/**
+ * @description: 执行一条语句，并把结果写回客户端；查询结果积压过多时语句暂停，保存在session->suspended中
+ * @return {bool} 是否继续保持连接，客户端退出或写回失败时返回false
+ * @param {Session} *session 请求所属的会话
+ * @param {char} *data_recv 以'\0'结尾的语句
+ * @param {bool} end_of_request 是否为请求中的最后一条语句，文本协议只在最后一条语句的结果后面加'\0'
+ */
+bool handle_statement(Session *session, const char *data_recv, bool end_of_request)
+{
+    Context *context = session->context.get();
+    char *data_send = context->data_send_;
+    int &offset = session->offset;
+    txn_id_t &txn_id = session->txn_id;
+
+    if (strcmp(data_recv, "exit") == 0)
+    {
+        std::cout << "Client exit." << std::endl;
+        return false;
+    }
+    if (strcmp(data_recv, "crash") == 0)
+    {
+        txn_manager->StopPurgeCleaner();
+        log_manager->flush_log_to_disk();
+        std::cout << "Server crash" << std::endl;
+        exit(1);
+    }
+    // std::cout << "Read from client " << fd << ": " << data_recv << std::endl;
+    offset = 0;
+    SetTransaction(&txn_id, context);
+
+    // 规范化后的SQL已经有缓存的计划时，直接绑定常量，跳过语法分析、语义分析和查询优化
+    std::string cache_key;
+    std::vector<std::shared_ptr<ast::Value>> literals;
+    bool cacheable = session->parser.normalize(data_recv, cache_key, literals);
+    std::shared_ptr<Plan> plan;
+    if (cacheable)
+    {
+        try
         {
-            std::cout << "Client exit." << std::endl;
-            break;
+            auto entry = session->plan_cache.lookup(cache_key, context);
+            if (entry != nullptr)
+                plan = PlanCache::bind(*entry, literals);
         }
-        if (strcmp(data_recv, "crash") == 0)
+        catch (RMDBError &)
         {
-            txn_manager->StopPurgeCleaner();
-            log_manager->flush_log_to_disk();
-            std::cout << "Server crash" << std::endl;
-            exit(1);
+            // 按普通方式重新执行，由分析阶段报告错误
+            plan = nullptr;
         }
-        // std::cout << "Read from client " << fd << ": " << data_recv << std::endl;
-        offset = 0;
-        SetTransaction(&txn_id, context.get());
-
-        // 用于判断是否已经调用了yy_delete_buffer来删除buf
-        bool finish_analyze = false;
-        pthread_mutex_lock(buffer_mutex);
-        YY_BUFFER_STATE buf = yy_scan_string(data_recv);
-        if (yyparse() == 0)
+    }
+
+    bool failed = false;
+    std::shared_ptr<ast::TreeNode> parse_tree;
+    if (plan != nullptr || session->parser.parse(data_recv, parse_tree) == 0)
+    {
+        if (plan != nullptr || parse_tree != nullptr)
         {
-            if (ast::parse_tree != nullptr)
-            {
-                try
+            failed = run_guarded(session, [&]
+                                 {
+                if (plan == nullptr)
+                    plan = plan_statement(session, data_recv, parse_tree, cacheable ? &cache_key : nullptr, literals);
+                if (plan != nullptr)
                 {
-                    // analyze and rewrite
-                    std::shared_ptr<Query> query = analyze->do_analyze(ast::parse_tree, context.get());
-                    yy_delete_buffer(buf);
-                    finish_analyze = true;
-                    pthread_mutex_unlock(buffer_mutex);
-                    // context->clearFlags(); // 清除标志位
-                    // 优化器
-                    std::shared_ptr<Plan> plan = optimizer->plan_query(query, context.get());
-                    std::shared_ptr<PortalStmt> portalStmt = portal->start(plan, context.get());
+                    PortalGuard guard(portal.get(), context);
+                    guard.stmt = portal->start(plan, context);
                     // portal
-                    portal->run(portalStmt, ql_manager.get(), &txn_id, context.get());
-                    portal->drop();
-                }
-                catch (TransactionAbortException &e)
-                {
-                    // 事务需要回滚，需要把abort信息返回给客户端并写入output.txt文件中
-                    std::string str = "abort\n";
-                    memcpy(data_send, str.c_str(), str.length());
-                    data_send[str.length()] = '\0';
-                    offset = str.length();
-
-                    // 回滚事务
-                    txn_manager->abort(context.get(), log_manager.get());
-                    std::cout << e.GetInfo() << std::endl;
-
-                    // 只有当io_enabled_为true时才写入文件
-                    if (sm_manager->io_enabled_)
-                    {
-                        std::fstream outfile;
-                        outfile.open("output.txt", std::ios::out | std::ios::app);
-                        if (outfile.is_open())
-                        {
-                            outfile << str;
-                            outfile.close();
-                        }
-                    }
-                }
-                catch (RMDBError &e)
-                {
-                    // 遇到异常，需要打印failure到output.txt文件中，并发异常信息返回给客户端
-                    std::cerr << e.what() << std::endl;
+                    portal->run(guard.stmt, ql_manager.get(), &txn_id, context);
+                    // 结果还没有发送完，语句留到socket可写之后继续执行
+                    if (guard.stmt->cursor != nullptr)
+                        session->suspended = guard.release();
+                } });
+        }
+    }
+    else
+    {
+        failed = true;
+        std::string ParseError = "parse error";
+        std::memcpy(data_send, ParseError.c_str(), ParseError.length());
+        data_send[ParseError.length()] = '\n';
+        data_send[ParseError.length() + 1] = '\0';
+        offset = ParseError.length() + 1;
+
+        // 只有当io_enabled_为true时才写入文件
+        if (sm_manager->io_enabled_)
+        {
+            std::fstream outfile;
+            outfile.open("output.txt", std::ios::out | std::ios::app);
+            if (outfile.is_open())
+            {
+                outfile << "failure\n";
+                outfile.close();
+            }
+        }
+    }
+    if (session->suspended != nullptr)
+        return true;
+    return finish_statement(session, failed, end_of_request);
+}
 
-                    memcpy(data_send, e.what(), e.get_msg_len());
-                    data_send[e.get_msg_len()] = '\n';
-                    data_send[e.get_msg_len() + 1] = '\0';
-                    offset = e.get_msg_len() + 1;
+/**
+ * @description: 继续执行暂停的查询，结果全部产生之后完成这条语句
+ * @return {bool} 是否继续保持连接
+ * @param {Session} *session 有暂停的查询的会话
+ */
+static bool resume_statement(Session *session)
+{
+    Context *context = session->context.get();
+    bool failed = run_guarded(session, [&]
+                              {
+        PortalGuard guard(portal.get(), context);
+        guard.stmt = std::move(session->suspended);
+        if (!portal->resume(guard.stmt, ql_manager.get(), context))
+            session->suspended = guard.release(); });
+    if (session->suspended != nullptr)
+        return true;
+    return finish_statement(session, failed, session->pending_stmts.empty());
+}
 
-                    // 只有当io_enabled_为true时才写入文件
-                    if (sm_manager->io_enabled_)
-                    {
-                        std::fstream outfile;
-                        outfile.open("output.txt", std::ios::out | std::ios::app);
-                        if (outfile.is_open())
-                        {
-                            outfile << "failure\n";
-                            outfile.close();
-                        }
-                    }
+// 关闭会话，连接断开时回滚尚未结束的显式事务
+void close_session(Session *session)
+{
+    Context *context = session->context.get();
+    // 先释放暂停的查询持有的算子树，再回滚事务
+    if (session->suspended != nullptr)
+    {
+        portal->drop(session->suspended, context);
+        session->suspended = nullptr;
+    }
+    if (context->txn_ != nullptr)
+    {
+        context->txn_->set_thread_id(std::this_thread::get_id());
+        txn_manager->abort(context, log_manager.get());
+        context->txn_->release();
+        context->txn_ = nullptr;
+    }
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, session->fd, nullptr);
+    close(session->fd); // close a file descriptor.
+    {
+        std::lock_guard lock(sessions_mutex);
+        live_sessions.erase(session);
+    }
+    delete session;
+}
 
-                    // 回滚事务
-                    txn_manager->abort(context.get(), log_manager.get());
-                }
-            }
+/**
+ * @description: 依次执行当前请求中剩下的语句，遇到结果暂停发送的查询时返回，socket可写之后再继续
+ * @return {bool} 是否继续保持连接
+ * @param {Session} *session 请求所属的会话
+ */
+static bool run_request(Session *session)
+{
+    if (session->suspended != nullptr && !resume_statement(session))
+        return false;
+    while (session->suspended == nullptr && !session->pending_stmts.empty())
+    {
+        std::string stmt = std::move(session->pending_stmts.front());
+        session->pending_stmts.pop_front();
+        if (!handle_statement(session, stmt.c_str(), session->pending_stmts.empty()))
+            return false;
+    }
+    if (session->suspended == nullptr && session->binary_protocol)
+        session->frame_writer.send_ready_for_query();
+    return true;
+}
+
+/**
+ * @description: 执行客户端发送的一条请求，请求中可以包含多条以';'分隔的语句，按顺序执行并依次返回结果
+ * 每条语句单独返回结果，前面的语句出错不影响后面语句的执行
+ * @return {bool} 是否继续保持连接
+ * @param {Session} *session 请求所属的会话
+ * @param {char} *data_recv 以'\0'结尾的请求内容
+ */
+bool handle_request(Session *session, const char *data_recv)
+{
+    auto stmts = SqlParser::split(data_recv);
+    // 空请求也需要返回一个空的结果
+    if (stmts.empty())
+        stmts.emplace_back();
+    session->pending_stmts.assign(std::make_move_iterator(stmts.begin()), std::make_move_iterator(stmts.end()));
+    return run_request(session);
+}
+
+/**
+ * @description: 处理二进制协议下已经完整接收的帧
+ * 发送缓冲区中未写出的结果超过FRAME_FLUSH_SIZE或者有暂停的查询时停止处理，等结果写出后再继续
+ * @return {bool} 是否继续保持连接，客户端要求关闭、帧不合法或写回失败时返回false
+ * @param {Session} *session 请求所属的会话
+ * @param {size_t} &begin 第一个未处理的帧在接收缓冲区中的位置，返回时指向剩余的半个帧
+ */
+bool handle_frames(Session *session, size_t &begin)
+{
+    std::string &buf = session->recv_buf;
+    while (session->suspended == nullptr && session->frame_writer.pending() < FRAME_FLUSH_SIZE &&
+           buf.size() - begin >= FRAME_HEADER_LENGTH)
+    {
+        uint32_t len = read_frame_u32(buf.data() + begin);
+        if (len == 0 || len > MAX_FRAME_LENGTH)
+        {
+            std::cout << "Invalid frame length: " << len << std::endl;
+            return false;
         }
-        else
+        if (buf.size() - begin < len + 4)
+            break;
+        char type = buf[begin + 4];
+        std::string sql = buf.substr(begin + FRAME_HEADER_LENGTH, len - 1);
+        begin += len + 4;
+        // FRAME_TERMINATE或者不认识的帧，关闭连接
+        if (type != FRAME_QUERY)
+            return false;
+        if (!handle_request(session, sql.c_str()))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @description: 工作线程处理一个就绪的会话：读出socket中的全部数据，依次执行其中完整的请求
+ * 结果写入发送缓冲区后不阻塞地写回，socket写不下的部分留到会话下一次可写时再写；
+ * 查询结果积压过多时查询暂停，会话下一次可写时继续执行
+ * @return {bool} 会话是否仍然存活，返回false时会话已经被关闭
+ * @param {Session} *session 就绪的会话
+ * @param {char} *data_send 当前工作线程的发送缓冲区
+ */
+bool handle_session(Session *session, char *data_send)
+{
+    Context *context = session->context.get();
+    context->data_send_ = data_send;
+    // 显式事务可能在不同的工作线程上执行多条语句
+    if (context->txn_ != nullptr)
+        context->txn_->set_thread_id(std::this_thread::get_id());
+
+    bool peer_closed = false;
+    char data_recv[BUFFER_LENGTH];
+    while (true)
+    {
+        ssize_t i_recvBytes = read(session->fd, data_recv, BUFFER_LENGTH);
+        if (i_recvBytes > 0)
+        {
+            // 客户端已经退出时丢弃之后收到的数据
+            if (!session->closing)
+                session->recv_buf.append(data_recv, i_recvBytes);
+            continue;
+        }
+        if (i_recvBytes == -1 && errno == EINTR)
+            continue;
+        if (i_recvBytes == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (i_recvBytes == -1)
+            std::cout << "Client read error!" << std::endl;
+        // Maybe the client has closed
+        peer_closed = true;
+        break;
+    }
+
+    // 根据第一个字节确定连接使用的协议，二进制协议需要先收到完整的握手
+    size_t begin = 0;
+    if (!session->protocol_checked && !session->recv_buf.empty())
+    {
+        if (session->recv_buf[0] != PROTOCOL_MAGIC[0])
         {
-            std::string ParseError = "parse error";
-            std::memcpy(data_send, ParseError.c_str(), ParseError.length());
-            data_send[ParseError.length()] = '\n';
-            data_send[ParseError.length() + 1] = '\0';
-            offset = ParseError.length() + 1;
-
-            // 只有当io_enabled_为true时才写入文件
-            if (sm_manager->io_enabled_)
+            session->protocol_checked = true;
+            context->text_writer_ = &session->frame_writer;
+        }
+        else if (session->recv_buf.size() >= PROTOCOL_HANDSHAKE_LENGTH)
+        {
+            if (memcmp(session->recv_buf.data(), PROTOCOL_MAGIC, sizeof(PROTOCOL_MAGIC)) != 0 ||
+                (uint8_t)session->recv_buf[sizeof(PROTOCOL_MAGIC)] != PROTOCOL_VERSION)
             {
-                std::fstream outfile;
-                outfile.open("output.txt", std::ios::out | std::ios::app);
-                if (outfile.is_open())
-                {
-                    outfile << "failure\n";
-                    outfile.close();
-                }
+                std::cout << "Unsupported client protocol!" << std::endl;
+                close_session(session);
+                return false;
             }
+            session->protocol_checked = true;
+            session->binary_protocol = true;
+            context->frame_writer_ = &session->frame_writer;
+            begin = PROTOCOL_HANDSHAKE_LENGTH;
+            session->frame_writer.send_ready();
         }
-        if (!finish_analyze)
+    }
+
+    // 先继续暂停的查询和同一个请求中剩下的语句，再依次处理已经完整接收的请求，剩余的半条请求留到下次可读时再处理；
+    // 发送缓冲区积压过多时暂停处理，等客户端读走结果、socket可写时再继续
+    bool keep_alive = true;
+    while (true)
+    {
+        keep_alive = session->frame_writer.try_flush();
+        if (!keep_alive || session->frame_writer.pending() >= FRAME_FLUSH_SIZE)
+            break;
+        if (session->suspended != nullptr)
         {
-            yy_delete_buffer(buf);
-            pthread_mutex_unlock(buffer_mutex);
+            // 查询再次暂停时发送缓冲区已经超过FRAME_HIGH_WATER，下一轮写不完就会退出循环
+            keep_alive = run_request(session);
+            if (!keep_alive)
+                break;
+            continue;
         }
-        // future TODO: 格式化 sql_handler.result, 传给客户端
-        // send result with fixed format, use protobuf in the future
-        data_send[offset] = '\0';
-        if (::write(fd, data_send, offset + 1) == -1)
+        size_t processed = begin;
+        if (session->protocol_checked && session->binary_protocol)
         {
-            break;
+            keep_alive = handle_frames(session, begin);
         }
-        // 如果是单条语句，需要按照一个完整的事务来执行，所以执行完当前语句后，自动提交事务
-        if (context->txn_->get_state() == TransactionState::ABORTED ||
-            context->txn_->get_state() == TransactionState::COMMITTED)
+        else if (session->protocol_checked)
         {
-            // 事务已经结束，释放事务对象
-            context->txn_->release();
-            context->txn_ = nullptr;
-            txn_id = INVALID_TXN_ID;
+            size_t end;
+            while (session->suspended == nullptr && session->frame_writer.pending() < FRAME_FLUSH_SIZE &&
+                   (end = session->recv_buf.find('\0', begin)) != std::string::npos)
+            {
+                if (!handle_request(session, session->recv_buf.c_str() + begin))
+                {
+                    keep_alive = false;
+                    break;
+                }
+                begin = end + 1;
+            }
         }
-        else if (!context->txn_->get_txn_mode())
+        // 没有新的完整请求时，剩余的结果等下一次可写时再写
+        if (!keep_alive || begin == processed)
+            break;
+    }
+    if (!keep_alive)
+    {
+        if (session->frame_writer.broken())
         {
-            txn_manager->commit(context.get(), context->log_mgr_);
-            context->txn_->release();
-            context->txn_ = nullptr;
-            txn_id = INVALID_TXN_ID;
+            close_session(session);
+            return false;
         }
+        // 客户端exit或者请求不合法，不再处理之后的请求，前面语句的结果写完再关闭
+        session->closing = true;
+        session->pending_stmts.clear();
+        begin = session->recv_buf.size();
     }
+    session->recv_buf.erase(0, begin);
 
-    // Clear
-    // std::cout << "Terminating current client_connection..." << std::endl;
+    // 对端关闭连接后仍然写完已经产生的结果，写不进去时try_flush()会标记连接失败
+    if (peer_closed)
+        session->closing = true;
+    if (session->closing && session->suspended == nullptr && session->frame_writer.pending() == 0)
+    {
+        close_session(session);
+        return false;
+    }
+    return true;
+}
 
+void *worker_thread(void *)
+{
+    char *data_send = new char[BUFFER_LENGTH];
+    while (true)
+    {
+        Session *session;
+        {
+            std::unique_lock lock(ready_mutex);
+            ready_cv.wait(lock, []
+                          { return workers_stop || !ready_sessions.empty(); });
+            if (ready_sessions.empty())
+                break;
+            session = ready_sessions.front();
+            ready_sessions.pop_front();
+        }
+        if (handle_session(session, data_send))
+        {
+            // 会话处理完毕，重新注册到epoll中：结果还没有写完时等待可写，否则等待下一次可读；
+            // 正在关闭的会话只等待可写，对端关闭写端后EPOLLIN和EPOLLRDHUP会一直就绪
+            struct epoll_event ev{};
+            if (session->closing)
+                ev.events = EPOLLOUT | EPOLLONESHOT;
+            else
+                ev.events = (session->frame_writer.pending() > 0 ? EPOLLOUT : EPOLLIN) | EPOLLRDHUP | EPOLLONESHOT;
+            ev.data.ptr = session;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, session->fd, &ev);
+        }
+    }
     delete[] data_send;
-    close(fd);          // close a file descriptor.
-    pthread_exit(NULL); // terminate calling thread!
+    return nullptr;
 }
 
 void start_server()
 {
-    // init mutex
-    buffer_mutex = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t));
-    sockfd_mutex = (pthread_mutex_t *)malloc(sizeof(pthread_mutex_t));
-    pthread_mutex_init(buffer_mutex, nullptr);
-    pthread_mutex_init(sockfd_mutex, nullptr);
-
     int sockfd_server;
     int fd_temp;
     struct sockaddr_in s_addr_in{};
 
     // 初始化连接
-    sockfd_server = socket(AF_INET, SOCK_STREAM, 0); // ipv4,TCP
+    sockfd_server = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0); // ipv4,TCP
     assert(sockfd_server != -1);
     int val = 1;
     setsockopt(sockfd_server, SOL_SOCKET, SO_REUSEADDR, &val, sizeof(val));
@@ -293,43 +747,110 @@ void start_server()
         exit(1);
     }
 
-    while (!should_exit)
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    assert(epoll_fd != -1);
+    struct epoll_event listen_ev{};
+    listen_ev.events = EPOLLIN;
+    listen_ev.data.ptr = nullptr;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sockfd_server, &listen_ev);
+
+    // 工作线程数与CPU核数一致，工作线程屏蔽SIGINT，保证信号只会打断reactor线程的epoll_wait
+    size_t worker_num = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<pthread_t> workers(worker_num);
+    // 提交时等待日志刷盘会占用工作线程，同时等待的事务不会超过工作线程数
+    log_manager->limit_group_commit_size(worker_num);
+    sigset_t sigint_set, old_set;
+    sigemptyset(&sigint_set);
+    sigaddset(&sigint_set, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &sigint_set, &old_set);
+    for (auto &worker : workers)
     {
-        // std::cout << "Waiting for new connection..." << std::endl;
-        pthread_t thread_id;
-        struct sockaddr_in s_addr_client{};
-        int client_length = sizeof(s_addr_client);
-
-        if (setjmp(jmpbuf))
+        if (pthread_create(&worker, nullptr, &worker_thread, nullptr) != 0)
         {
-            std::cout << "Break from Server Listen Loop\n";
-            break;
+            std::cout << "Create thread fail!" << std::endl;
+            exit(1);
         }
+    }
+    pthread_sigmask(SIG_SETMASK, &old_set, nullptr);
 
-        // Block here. Until server accepts a new connection.
-        pthread_mutex_lock(sockfd_mutex);
-        int sockfd = accept(sockfd_server, (struct sockaddr *)(&s_addr_client), (socklen_t *)(&client_length));
-        if (sockfd == -1)
+    std::vector<struct epoll_event> events(MAX_EPOLL_EVENTS);
+    while (!should_exit)
+    {
+        int n = epoll_wait(epoll_fd, events.data(), MAX_EPOLL_EVENTS, -1);
+        if (n == -1)
         {
-            std::cout << "Accept error!" << std::endl;
-            continue; // ignore current socket ,continue while loop.
+            if (errno == EINTR)
+                continue;
+            std::cout << "Epoll wait error!" << std::endl;
+            break;
         }
-
-        // 和客户端建立连接，并开启一个线程负责处理客户端请求
-        if (pthread_create(&thread_id, nullptr, &client_handler, (void *)(&sockfd)) != 0)
+        for (int i = 0; i < n; ++i)
         {
-            std::cout << "Create thread fail!" << std::endl;
-            break; // break while loop
+            if (events[i].data.ptr == nullptr)
+            {
+                // 接受所有等待中的新连接，每个连接只占用一个会话对象，不占用线程
+                while (true)
+                {
+                    int sockfd = accept4(sockfd_server, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (sockfd == -1)
+                    {
+                        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                            std::cout << "Accept error!" << std::endl;
+                        break;
+                    }
+                    int nodelay = 1;
+                    setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+                    auto *session = new Session(sockfd);
+                    {
+                        std::lock_guard lock(sessions_mutex);
+                        live_sessions.insert(session);
+                    }
+                    struct epoll_event ev{};
+                    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+                    ev.data.ptr = session;
+                    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sockfd, &ev);
+                }
+                continue;
+            }
+            // 会话可读或可写，交给工作线程处理
+            {
+                std::lock_guard lock(ready_mutex);
+                ready_sessions.push_back(static_cast<Session *>(events[i].data.ptr));
+            }
+            ready_cv.notify_one();
         }
     }
+    std::cout << "Break from Server Listen Loop\n";
 
     // Clear
     std::cout << " Try to close all client-connection.\n";
+    {
+        std::lock_guard lock(ready_mutex);
+        workers_stop = true;
+    }
+    ready_cv.notify_all();
+    for (auto &worker : workers)
+    {
+        pthread_join(worker, nullptr);
+    }
     int ret = shutdown(sockfd_server, SHUT_WR); // shut down the all or part of a full-duplex connection.
     if (ret == -1)
     {
         printf("%s\n", strerror(errno));
     }
+    close(sockfd_server);
+
+    // 工作线程已经全部退出，剩下的会话不会再被处理，回滚未结束的事务后关闭连接
+    std::vector<Session *> sessions;
+    {
+        std::lock_guard lock(sessions_mutex);
+        sessions.assign(live_sessions.begin(), live_sessions.end());
+    }
+    for (auto *session : sessions)
+    {
+        close_session(session);
+    }
+    close(epoll_fd);
 
     txn_manager->StopPurgeCleaner();
     //    assert(ret != -1);
@@ -340,10 +861,26 @@ void start_server()
 
 int main(int argc, char **argv)
 {
-    if (argc != 2)
+    RuntimeConfig config;
+    std::string db_name;
+    try
+    {
+        db_name = config.parse_args(argc, argv);
+    }
+    catch (RMDBError &e)
+    {
+        std::cerr << e.what() << std::endl;
+        db_name.clear();
+    }
+    if (db_name.empty())
     {
         // 需要指定数据库名称
-        std::cerr << "Usage: " << argv[0] << " <database>" << std::endl;
+        std::cerr << "Usage: " << argv[0]
+                  << " [--config=<file>] [--buffer_pool_size=<size>] [--max_buffer_pool_size=<size>] [--log_buffer_size=<size>]"
+                     " [--page_size=<size>] [--replacer=CLOCK-SWEEP|LRU|CLOCK|LRU-K] [--replacer_k=<k>]"
+                     " [--huge_pages=on|off] [--numa_policy=local|interleave|node:<n>] [--direct_io=on|off]"
+                     " [--io_backend=auto|io_uring|threads] [--io_threads=<n>] [--group_commit_delay_us=<us>] [--group_commit_size=<n>] <database>"
+                  << std::endl;
         exit(1);
     }
 
@@ -361,8 +898,7 @@ int main(int argc, char **argv)
                      "Welcome to RMDB!\n"
                      "Type 'help;' for help.\n"
                      "\n";
-        // Database name is passed by args
-        std::string db_name = argv[1];
+        init_managers(config);
         if (!sm_manager->is_dir(db_name))
         {
             // Database not found, create a new one
@@ -0,0 +1,343 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/async_io.h"
+
+#include <limits.h> // for IOV_MAX
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef RMDB_HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "common/config.h"
+#include "errors.h"
+
+/**
+ * @description: 同步执行一个请求，iov超过IOV_MAX时分多次系统调用
+ * @param {IoRequest&} req 要执行的请求
+ */
+void AsyncIO::execute(const IoRequest &req)
+{
+    if (req.op == IoOp::FSYNC)
+    {
+        if (::fdatasync(req.fd) == -1)
+            throw InternalError("AsyncIO fdatasync Error");
+        return;
+    }
+
+    off_t pos = req.offset;
+    for (size_t i = 0; i < req.iov.size(); i += IOV_MAX)
+    {
+        int cnt = std::min(req.iov.size() - i, (size_t)IOV_MAX);
+        ssize_t expect = 0;
+        for (int j = 0; j < cnt; j++)
+            expect += req.iov[i + j].iov_len;
+
+        if (req.op == IoOp::READ)
+        {
+            ssize_t n = ::preadv(req.fd, req.iov.data() + i, cnt, pos);
+            if (n < 0)
+                throw InternalError("AsyncIO read Error");
+            if (n < expect) // 读到文件末尾
+            {
+                zero_fill_short_read(req.iov.data() + i, req.iov.size() - i, n);
+                return;
+            }
+        }
+        else
+        {
+            ssize_t n = pos == -1 ? ::writev(req.fd, req.iov.data() + i, cnt)
+                                  : ::pwritev(req.fd, req.iov.data() + i, cnt, pos);
+            if (n != expect)
+                throw InternalError("AsyncIO write Error");
+        }
+        if (pos != -1)
+            pos += expect;
+    }
+}
+
+/**
+ * @description: 创建异步IO后端
+ * @param {string&} backend auto或io_uring时优先使用io_uring，threads时使用线程池
+ * @param {size_t} thread_num 线程池后端的IO线程数
+ */
+std::unique_ptr<AsyncIO> AsyncIO::create(const std::string &backend, size_t thread_num)
+{
+    thread_num = std::max<size_t>(1, thread_num);
+#ifdef RMDB_HAVE_LIBURING
+    if (backend != "threads")
+    {
+        auto uring = std::make_unique<IoUringIO>(IO_URING_DEPTH);
+        if (uring->ok())
+            return uring;
+    }
+#else
+    (void)backend;
+#endif
+    return std::make_unique<ThreadPoolIO>(thread_num);
+}
+
+ThreadPoolIO::ThreadPoolIO(size_t thread_num)
+{
+    for (size_t i = 0; i < thread_num; i++)
+        threads_.emplace_back(&ThreadPoolIO::worker, this);
+}
+
+ThreadPoolIO::~ThreadPoolIO()
+{
+    {
+        std::lock_guard lock(mutex_);
+        terminate_ = true;
+    }
+    cv_.notify_all();
+    for (auto &thread : threads_)
+        thread.join();
+}
+
+IoFuture ThreadPoolIO::submit(std::vector<IoRequest> reqs, bool ordered)
+{
+    if (reqs.empty())
+    {
+        std::promise<void> done;
+        done.set_value();
+        return done.get_future();
+    }
+
+    // 有序的请求作为一个任务依次执行，否则每个请求一个任务
+    auto shared_reqs = std::make_shared<std::vector<IoRequest>>(std::move(reqs));
+    size_t task_num = ordered ? 1 : shared_reqs->size();
+    auto batch = std::make_shared<IoBatch>(task_num);
+    IoFuture future = batch->promise.get_future();
+    {
+        std::lock_guard lock(mutex_);
+        for (size_t i = 0; i < task_num; i++)
+        {
+            tasks_.emplace_back([batch, shared_reqs, i, ordered]
+                                {
+                try
+                {
+                    if (ordered)
+                    {
+                        for (auto &req : *shared_reqs)
+                            execute(req);
+                    }
+                    else
+                        execute((*shared_reqs)[i]);
+                }
+                catch (...)
+                {
+                    batch->fail(std::current_exception());
+                }
+                batch->complete(); });
+        }
+    }
+    if (task_num == 1)
+        cv_.notify_one();
+    else
+        cv_.notify_all();
+    return future;
+}
+
+void ThreadPoolIO::worker()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this]
+                     { return terminate_ || !tasks_.empty(); });
+            // 退出前执行完已经提交的请求
+            if (tasks_.empty())
+                return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+#ifdef RMDB_HAVE_LIBURING
+IoUringIO::IoUringIO(unsigned depth) : ring_(std::make_unique<struct io_uring>()), depth_(depth)
+{
+    if (io_uring_queue_init(depth, ring_.get(), 0) < 0)
+    {
+        // 内核不支持io_uring或者被禁用（如容器的seccomp策略）
+        ring_.reset();
+        return;
+    }
+    reaper_ = std::thread(&IoUringIO::reap, this);
+}
+
+IoUringIO::~IoUringIO()
+{
+    if (!ring_)
+        return;
+    // 提交一个空操作唤醒完成线程，完成线程处理完正在执行的请求后退出
+    terminate_ = true;
+    {
+        std::lock_guard lock(submit_mutex_);
+        struct io_uring_sqe *sqe = get_sqe();
+        if (sqe == nullptr)
+        {
+            // 无法唤醒完成线程，不能释放它还在等待的ring
+            reaper_.detach();
+            ring_.release();
+            return;
+        }
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, nullptr);
+        io_uring_submit(ring_.get());
+    }
+    reaper_.join();
+    io_uring_queue_exit(ring_.get());
+}
+
+/**
+ * @description: 从提交队列中取一个空闲的sqe，队列已满时先把其中的请求提交给内核，调用者需要持有submit_mutex_
+ * @return {io_uring_sqe*} 空闲的sqe，提交失败时返回nullptr
+ */
+struct io_uring_sqe *IoUringIO::get_sqe()
+{
+    struct io_uring_sqe *sqe;
+    while ((sqe = io_uring_get_sqe(ring_.get())) == nullptr)
+    {
+        int ret = io_uring_submit(ring_.get());
+        if (ret < 0 && ret != -EINTR && ret != -EAGAIN)
+            return nullptr;
+    }
+    return sqe;
+}
+
+IoFuture IoUringIO::submit(std::vector<IoRequest> reqs, bool ordered)
+{
+    auto batch = std::make_shared<IoBatch>(reqs.size());
+    IoFuture future = batch->promise.get_future();
+    if (reqs.empty())
+    {
+        batch->promise.set_value();
+        return future;
+    }
+
+    // 有序的请求用IOSQE_IO_LINK串成一条链，必须在同一次提交中放入提交队列
+    size_t chunk = ordered ? reqs.size() : std::min<size_t>(reqs.size(), depth_);
+    if (chunk > depth_)
+        throw InternalError("IoUringIO::submit too many ordered requests");
+
+    for (size_t start = 0; start < reqs.size(); start += chunk)
+    {
+        size_t cnt = std::min(chunk, reqs.size() - start);
+        // 限制正在执行的请求数，保证完成队列不会溢出
+        {
+            std::unique_lock lock(slot_mutex_);
+            slot_cv_.wait(lock, [&]
+                          { return inflight_ + cnt <= depth_; });
+            inflight_ += cnt;
+        }
+
+        std::lock_guard lock(submit_mutex_);
+        for (size_t i = start; i < start + cnt; i++)
+        {
+            auto *slot = new Slot{batch, std::move(reqs[i])};
+            IoRequest &req = slot->req;
+            struct io_uring_sqe *sqe = get_sqe();
+            if (sqe == nullptr)
+            {
+                // 剩下的请求都不再提交，直接以失败完成，已经放入提交队列的请求仍然正常提交
+                delete slot;
+                size_t rest = reqs.size() - i;
+                batch->fail(std::make_exception_ptr(InternalError("IoUringIO::submit Error")));
+                for (size_t j = 0; j < rest; j++)
+                    batch->complete();
+                {
+                    std::lock_guard slot_lock(slot_mutex_);
+                    inflight_ -= start + cnt - i;
+                }
+                slot_cv_.notify_all();
+                io_uring_submit(ring_.get());
+                return future;
+            }
+            switch (req.op)
+            {
+            case IoOp::READ:
+                io_uring_prep_readv(sqe, req.fd, req.iov.data(), req.iov.size(), req.offset);
+                break;
+            case IoOp::WRITE:
+                io_uring_prep_writev(sqe, req.fd, req.iov.data(), req.iov.size(), req.offset);
+                break;
+            case IoOp::FSYNC:
+                io_uring_prep_fsync(sqe, req.fd, IORING_FSYNC_DATASYNC);
+                break;
+            }
+            if (ordered && i + 1 < start + cnt)
+                sqe->flags |= IOSQE_IO_LINK;
+            io_uring_sqe_set_data(sqe, slot);
+        }
+        int ret;
+        do
+        {
+            ret = io_uring_submit(ring_.get());
+        } while (ret == -EINTR || ret == -EAGAIN);
+    }
+    return future;
+}
+
+void IoUringIO::reap()
+{
+    while (true)
+    {
+        struct io_uring_cqe *cqe;
+        int ret = io_uring_wait_cqe(ring_.get(), &cqe);
+        if (ret == -EINTR)
+            continue;
+        if (ret < 0)
+            break;
+        auto *slot = static_cast<Slot *>(io_uring_cqe_get_data(cqe));
+        int res = cqe->res;
+        io_uring_cqe_seen(ring_.get(), cqe);
+
+        if (slot == nullptr) // 析构时提交的空操作
+        {
+            std::unique_lock lock(slot_mutex_);
+            if (terminate_ && inflight_ == 0)
+                break;
+            continue;
+        }
+
+        size_t expect = 0;
+        for (auto &iov : slot->req.iov)
+            expect += iov.iov_len;
+        if (res < 0)
+            slot->batch->fail(std::make_exception_ptr(InternalError(std::string("IoUringIO Error: ") + strerror(-res))));
+        else if (slot->req.op == IoOp::WRITE && (size_t)res != expect)
+            slot->batch->fail(std::make_exception_ptr(InternalError("IoUringIO short write")));
+        else if (slot->req.op == IoOp::READ && (size_t)res < expect) // 读到文件末尾
+            zero_fill_short_read(slot->req.iov.data(), slot->req.iov.size(), res);
+        slot->batch->complete();
+        delete slot;
+
+        bool done;
+        {
+            std::lock_guard lock(slot_mutex_);
+            inflight_--;
+            done = terminate_ && inflight_ == 0;
+        }
+        slot_cv_.notify_all();
+        if (done)
+            break;
+    }
+}
+#endif
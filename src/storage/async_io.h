@@ -0,0 +1,185 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+
+enum class IoOp
+{
+    READ,  // 读到iov中，读到文件末尾时可以少于请求的字节数
+    WRITE, // 写入iov中的全部数据，offset为-1时追加到文件末尾
+    FSYNC  // fdatasync
+};
+
+struct IoRequest
+{
+    IoOp op;
+    int fd;
+    off_t offset;
+    std::vector<struct iovec> iov;
+};
+
+/**
+ * @description: 读到文件末尾时只读到了前n个字节，把iov中剩下的部分清零，读出的页面不会残留缓冲区中原来的内容
+ * @param {iovec} *iov 读请求的iov
+ * @param {size_t} cnt iov的个数
+ * @param {size_t} n 实际读到的字节数
+ */
+inline void zero_fill_short_read(const struct iovec *iov, size_t cnt, size_t n)
+{
+    for (size_t i = 0; i < cnt; i++)
+    {
+        if (n >= iov[i].iov_len)
+        {
+            n -= iov[i].iov_len;
+            continue;
+        }
+        memset((char *)iov[i].iov_base + n, 0, iov[i].iov_len - n);
+        n = 0;
+    }
+}
+
+// 一组异步请求的完成状态，全部完成后future就绪，有请求失败时future抛出异常
+using IoFuture = std::future<void>;
+
+/**
+ * @description: 异步磁盘IO的后端，DiskManager_Final通过它提交页面和日志的读写
+ *
+ * 编译时找到liburing并且运行时内核支持io_uring时使用io_uring，否则使用线程池执行pread/pwrite。
+ * 可以通过RuntimeConfig的io_backend=threads强制使用线程池，io_threads设置线程池大小。
+ */
+class AsyncIO
+{
+public:
+    virtual ~AsyncIO() = default;
+
+    /**
+     * @description: 提交一组请求
+     * @param {vector<IoRequest>} reqs 请求，iov指向的内存在future就绪之前必须保持有效
+     * @param {bool} ordered 为true时请求按顺序依次执行（如先写日志再fdatasync），否则可以并发执行
+     * @return {IoFuture} 全部请求完成后就绪
+     */
+    virtual IoFuture submit(std::vector<IoRequest> reqs, bool ordered = false) = 0;
+
+    virtual const char *name() const = 0;
+
+    // 按配置创建后端，io_uring初始化失败时回退到线程池
+    static std::unique_ptr<AsyncIO> create(const std::string &backend = DEFAULT_IO_BACKEND, size_t thread_num = IO_THREAD_NUM);
+
+protected:
+    // 一次submit()中所有请求共享的完成状态
+    struct IoBatch
+    {
+        std::atomic<size_t> remaining;
+        std::promise<void> promise;
+        std::mutex err_mutex;
+        std::exception_ptr err;
+
+        explicit IoBatch(size_t n) : remaining(n) {}
+
+        void fail(std::exception_ptr e)
+        {
+            std::lock_guard lock(err_mutex);
+            if (!err)
+                err = e;
+        }
+
+        // 完成一个请求，最后一个请求完成时设置future
+        void complete()
+        {
+            if (remaining.fetch_sub(1) == 1)
+            {
+                if (err)
+                    promise.set_exception(err);
+                else
+                    promise.set_value();
+            }
+        }
+    };
+
+    // 同步执行一个请求，失败时抛出异常
+    static void execute(const IoRequest &req);
+};
+
+// 线程池后端：每个请求由一个IO线程用preadv/pwritev同步执行
+class ThreadPoolIO : public AsyncIO
+{
+public:
+    explicit ThreadPoolIO(size_t thread_num);
+    ~ThreadPoolIO() override;
+
+    IoFuture submit(std::vector<IoRequest> reqs, bool ordered = false) override;
+
+    const char *name() const override { return "threads"; }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> threads_;
+    bool terminate_ = false;
+
+    void worker();
+};
+
+#ifdef RMDB_HAVE_LIBURING
+struct io_uring;
+
+// io_uring后端：提交线程直接把请求放入提交队列，由一个完成线程收割完成事件
+class IoUringIO : public AsyncIO
+{
+public:
+    explicit IoUringIO(unsigned depth);
+    ~IoUringIO() override;
+
+    IoFuture submit(std::vector<IoRequest> reqs, bool ordered = false) override;
+
+    const char *name() const override { return "io_uring"; }
+
+    bool ok() const { return ring_ != nullptr; }
+
+private:
+    // 一个提交到io_uring的请求
+    struct Slot
+    {
+        std::shared_ptr<IoBatch> batch;
+        IoRequest req;
+    };
+
+    std::unique_ptr<struct io_uring> ring_;
+    std::mutex submit_mutex_;
+    std::mutex slot_mutex_;
+    std::condition_variable slot_cv_;
+    unsigned depth_;
+    unsigned inflight_ = 0; // 已经提交还没有完成的请求数，不超过depth_
+    std::thread reaper_;
+    std::atomic<bool> terminate_{false};
+
+    void reap();
+    struct io_uring_sqe *get_sqe();
+};
+#endif
@@ -2,38 +2,68 @@
 #include <chrono>
 #include <algorithm>
 
-// replacer
-static std::string REPLACER_TYPE;
 static constexpr size_t FLUSH_BATCH_SIZE = 32;                  // 批量刷盘大小
-static constexpr auto FLUSH_INTERVAL = std::chrono::seconds(1); // 定期刷盘间隔
-static constexpr size_t DIRTY_THRESHOLD = 1024;                 // 脏页阈值
-
-BufferPoolManager_Final::BufferPoolManager_Final(size_t pool_size, DiskManager_Final *disk_manager)
-    : pages_(pool_size), disk_manager_(disk_manager),
-      dirty_page_count_(0)
-{
-    // REPLACER_TYPE = "CLOCK";
-    // 可以被Replacer改变
-    if (REPLACER_TYPE.compare("LRU") == 0)
-        replacer_ = new LRUReplacer_Final(pool_size);
-    else if (REPLACER_TYPE.compare("CLOCK") == 0)
-        replacer_ = new ClockReplacer_Final(pool_size);
+static constexpr auto FLUSH_INTERVAL = std::chrono::seconds(1); // 有脏页时至少每隔这么久写回一批，减少检查点和恢复的工作量
+static constexpr size_t DIRTY_THRESHOLD = 1024;                 // 脏页阈值，超过时每轮至少写回一批
+static constexpr auto BGWRITER_DELAY = std::chrono::milliseconds(100); // 后台写线程每轮的间隔
+static constexpr size_t BGWRITER_MAX_PAGES = 1024;                     // 每轮最多写回的页面数
+static constexpr double BGWRITER_LOOKAHEAD_MIN = 2.0;                  // 干净帧目标与平滑后每轮分配帧数之比
+static constexpr double BGWRITER_LOOKAHEAD_MAX = 16.0;
+
+BufferPoolManager_Final::BufferPoolManager_Final(size_t pool_size, DiskManager_Final *disk_manager, size_t max_pool_size,
+                                                 const std::string &replacer_type, int replacer_k, bool huge_pages,
+                                                 const std::string &numa_policy)
+    : arena_(pool_size, max_pool_size, PAGE_SIZE, huge_pages, numa_policy), pages_(std::max(pool_size, max_pool_size)),
+      pool_size_(pool_size), retired_(pages_.size(), false), disk_manager_(disk_manager), dirty_page_count_(0)
+{
+    // replacer按最大帧数创建，扩大缓冲池时不需要重建
+    max_pool_size = pages_.size();
+    if (replacer_type.compare("CLOCK-SWEEP") == 0)
+        replacer_ = nullptr;
+    else if (replacer_type.compare("LRU") == 0)
+        replacer_ = new LRUReplacer_Final(max_pool_size);
+    else if (replacer_type.compare("CLOCK") == 0)
+        replacer_ = new ClockReplacer_Final(max_pool_size);
+    else if (replacer_type.compare("LRU-K") == 0)
+        replacer_ = new LRUKReplacer_Final(max_pool_size, replacer_k);
     else
+        throw InternalError("BufferPoolManager_Final: unknown replacer " + replacer_type);
+    for (size_t i = 0; i < max_pool_size; ++i)
     {
-        replacer_ = new LRUReplacer_Final(pool_size);
+        pages_[i].data_ = arena_.frame(i);
+        if (i < pool_size)
+        {
+            free_list_.emplace_back(i);
+        }
+        else
+        {
+            // 超出初始大小的帧处于退役状态，扩大缓冲池时才会使用
+            pages_[i].pin_state_ = 1;
+            retired_[i] = true;
+        }
     }
-    for (size_t i = 0; i < pool_size; ++i)
+    for (auto &shard : page_table_)
     {
-        free_list_.emplace_back(i);
+        shard.table.reserve(pool_size / PAGE_TABLE_SHARDS + 1);
     }
-    page_table_.reserve(pool_size);
+    seq_trackers_ = std::make_unique<SeqTracker[]>(DiskManager_Final::MAX_FD);
     flush_thread_ = std::thread(&BufferPoolManager_Final::background_flush, this);
+    prefetch_thread_ = std::thread(&BufferPoolManager_Final::background_prefetch, this);
 }
 
 BufferPoolManager_Final::~BufferPoolManager_Final()
 {
     terminate_ = true;
     flush_cond_.notify_all();
+    {
+        std::lock_guard lock(prefetch_mutex_);
+        prefetch_queue_.clear();
+    }
+    prefetch_cond_.notify_all();
+    if (prefetch_thread_.joinable())
+    {
+        prefetch_thread_.join();
+    }
     if (flush_thread_.joinable())
     {
         flush_thread_.join();
@@ -50,97 +80,111 @@ BufferPoolManager_Final::~BufferPoolManager_Final()
 
 Page_Final *BufferPoolManager_Final::fetch_page(const PageId_Final &page_id)
 {
+    PageTableShard &shard = get_shard(page_id);
+    IoStats &stats = disk_manager_->io_stats();
+    stats.add(page_id.fd, STAT_FETCHES);
     frame_id_t frame_id;
-
-    // 先用读锁检查页面是否存在
+    while (true)
     {
-        std::shared_lock read_lock(table_latch_);
-        auto it = page_table_.find(page_id);
-        if (it != page_table_.end())
+        // 先用分区的读锁检查页面是否存在
+        bool found = false;
         {
-            frame_id = it->second;
-            Page_Final &page = pages_[frame_id];
-            int prev = page.pin_count_.fetch_add(1);
-            if (prev == 0)
+            std::shared_lock read_lock(shard.latch);
+            auto it = shard.table.find(page_id);
+            if (it != shard.table.end())
             {
-                replacer_->pin(frame_id);
+                frame_id = it->second;
+                pin_frame(frame_id);
+                found = true;
             }
-            return &page;
         }
-    }
-
-    // 页面不存在，获取写锁进行页面替换
-    std::unique_lock write_lock(table_latch_);
 
-    // 再次检查页面是否存在（双重检查，避免竞态）
-    auto it = page_table_.find(page_id);
-    if (it != page_table_.end())
-    {
-        frame_id = it->second;
-        Page_Final &page = pages_[frame_id];
-        int prev = page.pin_count_.fetch_add(1);
-        if (prev == 0)
+        if (!found)
         {
-            replacer_->pin(frame_id);
-        }
-        return &page;
-    }
+            // 页面不存在，获取分区的写锁分配一个帧
+            std::unique_lock write_lock(shard.latch);
 
-    // 获取可替换的帧
-    if (!find_victim_page(&frame_id))
-    {
-        return nullptr;
-    }
+            // 再次检查页面是否存在（双重检查，避免竞态）
+            auto it = shard.table.find(page_id);
+            if (it != shard.table.end())
+            {
+                frame_id = it->second;
+                pin_frame(frame_id);
+            }
+            else
+            {
+                if (!find_victim_page(&frame_id))
+                {
+                    return nullptr;
+                }
+                shard.table[page_id] = frame_id;
+                write_lock.unlock();
 
-    Page_Final &old_page = pages_[frame_id];
-    PageId_Final old_page_id = old_page.id_;
+                // 在分区锁外写回被淘汰的页面并读取新页面，其他线程访问这个帧时等待加载完成
+                load_frame(frame_id, page_id, true);
+                note_miss(page_id);
+                stats.add(page_id.fd, STAT_MISSES);
+                return &pages_[frame_id];
+            }
+        }
 
-    // 从page table中移除旧页面
-    if (old_page_id.fd != -1)
-    {
-        page_table_.erase(old_page_id);
+        // 页面可能正在被其他线程加载
+        wait_loaded(frame_id);
+        if (pages_[frame_id].id_ == page_id)
+        {
+            stats.add(page_id.fd, STAT_HITS);
+            return &pages_[frame_id];
+        }
+        // 找到的是正在写回的被淘汰页面（或者加载失败的页面），帧已经分配给了其他页面，重新查找
+        release_pin(frame_id);
     }
-
-    // 先获取页面锁，然后释放表锁
-    std::lock_guard page_lock(old_page.latch_);
-
-    // 更新page table并释放表锁
-    page_table_[page_id] = frame_id;
-    // replacer_->pin(frame_id);
-    old_page.pin_count_.store(1);
-    write_lock.unlock();
-
-    // 在表锁外进行IO操作，只持有页面锁
-    update_page(&old_page, page_id, frame_id);
-
-    // 读取新页面数据
-    disk_manager_->read_page(page_id.fd, page_id.page_no, old_page.data_, PAGE_SIZE);
-    return &old_page;
 }
 
-bool BufferPoolManager_Final::unpin_page(const PageId_Final &page_id, bool is_dirty)
+/**
+ * @description: 取消固定页面
+ * @param {PageId_Final&} page_id 页面
+ * @param {bool} is_dirty 页面是否被修改
+ * @param {bool} low_priority 页面只被全表扫描访问，不应该被当作热点页面
+ */
+bool BufferPoolManager_Final::unpin_page(const PageId_Final &page_id, bool is_dirty, bool low_priority)
 {
-    std::shared_lock lock(table_latch_);
-    auto it = page_table_.find(page_id);
-    if (it == page_table_.end())
+    PageTableShard &shard = get_shard(page_id);
+    std::shared_lock lock(shard.latch);
+    auto it = shard.table.find(page_id);
+    if (it == shard.table.end())
         return false;
 
     frame_id_t frame_id = it->second;
     Page_Final &page = pages_[frame_id];
 
-    int prev = page.pin_count_.fetch_sub(1);
-    if (prev == 1)
-    {
-        replacer_->unpin(frame_id);
-    }
-    else if (prev <= 0)
+    if (unpin_frame(frame_id, low_priority) == 0)
     {
         assert(false && "Pin count should not be negative");
-        page.pin_count_.fetch_add(1);
         return false;
     }
 
-    if (is_dirty && !page.is_dirty_.exchange(true))
+    if (is_dirty)
+    {
+        mark_dirty(page);
+    }
+    return true;
+}
+
+/**
+ * @description: 标记脏页，并把页面写回前需要持久化的日志号更新为最后一条日志的日志号
+ * 执行器在取消固定页面之前写入修改对应的日志，因此没有被固定的脏页的修改都已经有日志
+ */
+void BufferPoolManager_Final::mark_dirty(Page_Final &page)
+{
+    if (WalFlusher *wal = wal_.load())
+    {
+        lsn_t lsn = wal->last_lsn();
+        lsn_t cur = page.flush_lsn_.load();
+        while (cur < lsn && !page.flush_lsn_.compare_exchange_weak(cur, lsn))
+        {
+        }
+    }
+    if (!page.is_dirty_.exchange(true))
     {
         dirty_page_count_.fetch_add(1);
         if (dirty_page_count_.load() > DIRTY_THRESHOLD)
@@ -148,23 +192,45 @@ bool BufferPoolManager_Final::unpin_page(const PageId_Final &page_id, bool is_di
             flush_cond_.notify_one();
         }
     }
-    return true;
+}
+
+/**
+ * @description: 写回脏页之前等待日志号不超过lsn的日志持久化
+ * 调用时不能持有页面的latch：检查点持有日志管理器的锁写回所有脏页，会等待页面的latch
+ */
+void BufferPoolManager_Final::wal_before_write(lsn_t lsn)
+{
+    WalFlusher *wal = wal_.load();
+    if (wal == nullptr || lsn == INVALID_LSN || wal->persist_lsn() >= lsn)
+        return;
+    wal_flush_waits_.fetch_add(1);
+    wal->flush_until(lsn);
 }
 
 bool BufferPoolManager_Final::flush_page(const PageId_Final &page_id)
 {
-    std::shared_lock read_lock(table_latch_);
-    auto it = page_table_.find(page_id);
-    if (it == page_table_.end())
+    PageTableShard &shard = get_shard(page_id);
+    std::shared_lock read_lock(shard.latch);
+    auto it = shard.table.find(page_id);
+    if (it == shard.table.end())
         return false;
 
     frame_id_t frame_id = it->second;
     read_lock.unlock(); // 释放读锁，避免持有锁过长时间
     Page_Final &page = pages_[frame_id];
+    // 页面可能还被固定着，正在进行的修改对应的日志可能还没有写入，这里持久化当前所有的日志
+    if (page.is_dirty_.load())
+    {
+        WalFlusher *wal = wal_.load();
+        wal_before_write(wal ? wal->last_lsn() : INVALID_LSN);
+    }
     std::lock_guard lock(page.latch_); // 确保页面解锁
-    if (page.is_dirty_.exchange(false))
+    // 释放分区锁之后帧可能已经被换成其他页面，这时页面已经写回
+    if (page.id_ == page_id && page.is_dirty_.exchange(false))
     {
         disk_manager_->write_page(page_id.fd, page_id.page_no, page.data_, PAGE_SIZE);
+        dirty_page_count_.fetch_sub(1);
+        written_flush_.fetch_add(1);
     }
     return true;
 }
@@ -175,48 +241,45 @@ Page_Final *BufferPoolManager_Final::new_page(PageId_Final *page_id)
     if (!find_victim_page(&frame_id))
         return nullptr;
 
-    // 分配新页面ID
+    // 分配新页面ID，新页面还不在page table中，不需要双重检查
     page_id->page_no = disk_manager_->allocate_page(page_id->fd);
-
-    Page_Final &page = pages_[frame_id];
-    PageId_Final old_page_id = page.id_;
-    std::unique_lock lock(table_latch_);
-
-    // 处理页面替换
-    if (old_page_id.fd != -1)
     {
-        page_table_.erase(old_page_id);
+        PageTableShard &shard = get_shard(*page_id);
+        std::lock_guard lock(shard.latch);
+        shard.table[*page_id] = frame_id;
     }
-    page_table_[*page_id] = frame_id;
-    // replacer_->pin(frame_id);
-    page.pin_count_.store(1);
-    std::lock_guard page_lock(page.latch_);
-    lock.unlock(); // 释放表锁，避免长时间持有
 
-    update_page(&page, *page_id, frame_id);
-
-    page.reset_memory();
-    return &page;
+    load_frame(frame_id, *page_id, false);
+    return &pages_[frame_id];
 }
 
 bool BufferPoolManager_Final::delete_page(const PageId_Final &page_id)
 {
-    std::lock_guard lock(table_latch_);
-    auto it = page_table_.find(page_id);
-    if (it == page_table_.end())
+    PageTableShard &shard = get_shard(page_id);
+    std::lock_guard lock(shard.latch);
+    auto it = shard.table.find(page_id);
+    if (it == shard.table.end())
         return true;
 
+    // 独占帧，失败说明页面被固定或者正在加载
     frame_id_t frame_id = it->second;
-    Page_Final &page = pages_[frame_id];
-    if (page.pin_count_.load() > 0)
+    if (!claim_frame(frame_id))
         return false;
 
-    // 从page table移除并加入free list
-    page_table_.erase(it);
+    // 从page table和replacer中移除并加入free list
+    shard.table.erase(it);
+    if (replacer_)
+        replacer_->pin(frame_id);
+    // 删除的页面不再写回，帧留在空闲链表中时也不会被刷盘线程或析构函数写入已经关闭的文件
     {
-        std::lock_guard free_lock(free_list_mutex_);
-        free_list_.push_back(frame_id);
+        Page_Final &page = pages_[frame_id];
+        std::lock_guard page_lock(page.latch_);
+        if (page.is_dirty_.exchange(false))
+            dirty_page_count_.fetch_sub(1);
+        page.id_.fd = -1;
+        page.flush_lsn_ = INVALID_LSN;
     }
+    release_frame(frame_id);
     return true;
 }
 
@@ -227,71 +290,272 @@ void BufferPoolManager_Final::remove_all_pages(int fd, bool flush)
         return; // 无效的文件描述符
     }
     std::vector<frame_id_t> pages_to_remove;
-    std::lock_guard lock(table_latch_);
-    auto it = page_table_.begin();
-    while (it != page_table_.end())
+    for (auto &shard : page_table_)
     {
-        auto &[pid, frame_id] = *it;
-        if (pid.fd != fd)
+        std::lock_guard lock(shard.latch);
+        auto it = shard.table.begin();
+        while (it != shard.table.end())
         {
-            ++it;
-            continue;
+            auto &[pid, frame_id] = *it;
+            if (pid.fd != fd)
+            {
+                ++it;
+                continue;
+            }
+            if (!claim_frame(frame_id))
+            {
+                // 帧正在加载其他页面，这是还没有写回的被淘汰页面，由加载线程写回
+                assert(pages_[frame_id].loading_.load() && "Cannot remove a pinned page");
+                it = shard.table.erase(it);
+                continue;
+            }
+            if (replacer_)
+                replacer_->pin(frame_id);
+            pages_to_remove.push_back(frame_id);
+
+            // 删除记录
+            it = shard.table.erase(it);
         }
+    }
+
+    for (const auto &frame_id : pages_to_remove)
+    {
         Page_Final &page = pages_[frame_id];
-        if (page.is_dirty_.load())
+        if (flush && page.is_dirty_.load())
+            wal_before_write(page.flush_lsn_.load());
         {
-            if (flush)
-            {
-                pages_to_remove.push_back(frame_id);
-            }
-            else
+            std::lock_guard page_lock(page.latch_);
+            if (page.is_dirty_.exchange(false))
             {
-                page.is_dirty_.store(false);
+                if (flush)
+                {
+                    disk_manager_->write_page(page.id_.fd, page.id_.page_no, page.data_, PAGE_SIZE);
+                    written_flush_.fetch_add(1);
+                }
                 dirty_page_count_.fetch_sub(1);
             }
-        }
-        if (!flush)
             page.id_.fd = -1; // 重置页面ID
+            page.flush_lsn_ = INVALID_LSN;
+        }
+        release_frame(frame_id);
+    }
+}
 
+/**
+ * @description: 提交预读请求，由预读线程异步把页面读入缓冲池，不等待读取完成
+ * 预读的页面以低优先级放入replacer，没有被访问时会先于其他页面被淘汰
+ * @param {int} fd 文件句柄
+ * @param {page_id_t} start_page_no 第一个页面
+ * @param {int} num_pages 页面个数，超出文件已分配页面的部分被忽略
+ */
+void BufferPoolManager_Final::prefetch(int fd, page_id_t start_page_no, int num_pages)
+{
+    if (fd < 0 || fd >= DiskManager_Final::MAX_FD || num_pages <= 0)
+        return;
+    // 第一个页面已经在缓冲池中时认为后面的页面也已经读入，避免热数据上的扫描反复提交预读请求
+    {
+        PageTableShard &shard = get_shard({fd, start_page_no});
+        std::shared_lock lock(shard.latch);
+        if (shard.table.count({fd, start_page_no}))
+            return;
+    }
+    {
+        std::lock_guard lock(prefetch_mutex_);
+        if (terminate_ || prefetch_queue_.size() >= PREFETCH_QUEUE_SIZE)
+            return;
+        prefetch_queue_.push_back({fd, start_page_no, num_pages});
+    }
+    prefetch_cond_.notify_one();
+}
+
+// 同一个文件连续缺页时预读后面的页面
+void BufferPoolManager_Final::note_miss(const PageId_Final &page_id)
+{
+    if (page_id.fd < 0 || page_id.fd >= DiskManager_Final::MAX_FD)
+        return;
+    SeqTracker &tracker = seq_trackers_[page_id.fd];
+    page_id_t last = tracker.last_miss.exchange(page_id.page_no);
+    if (last == INVALID_PAGE_ID || page_id.page_no != last + 1)
+    {
+        tracker.run = 0;
+        return;
+    }
+    if (tracker.run.fetch_add(1) + 1 >= SEQ_MISS_TRIGGER)
+    {
+        tracker.run = 0;
+        prefetch(page_id.fd, page_id.page_no + 1, PREFETCH_PAGES);
+    }
+}
+
+void BufferPoolManager_Final::background_prefetch()
+{
+    while (true)
+    {
+        PrefetchRequest req;
         {
-            std::lock_guard free_lock(free_list_mutex_);
-            free_list_.push_back(frame_id);
+            std::unique_lock lock(prefetch_mutex_);
+            prefetch_cond_.wait(lock, [this]
+                                { return terminate_ || !prefetch_queue_.empty(); });
+            if (terminate_)
+                return;
+            req = prefetch_queue_.front();
+            prefetch_queue_.pop_front();
         }
+        try
+        {
+            prefetch_run(req.fd, req.start_page_no, req.num_pages);
+        }
+        catch (RMDBError &)
+        {
+            // 预读失败不影响正确性，之后访问这些页面时会重新读取
+        }
+    }
+}
 
-        assert(page.pin_count_.load() == 0 && "Cannot remove a pinned page");
-        // page.pin_count_.store(0);
+/**
+ * @description: 把不在缓冲池中的页面分配到帧中，连续的页面合并成一次异步读取
+ */
+void BufferPoolManager_Final::prefetch_run(int fd, page_id_t start_page_no, int num_pages)
+{
+    page_id_t end_page_no = std::min<page_id_t>(start_page_no + num_pages, disk_manager_->get_fd2pageno(fd));
+    std::vector<frame_id_t> frames;
+    std::vector<PageId_Final> old_ids;
+    std::vector<char *> bufs;
+    std::vector<std::unique_lock<std::shared_mutex>> latches;
 
-        // 删除记录
-        it = page_table_.erase(it);
-    }
+    page_id_t run_start = start_page_no;
+    auto read_run = [&]()
+    {
+        if (frames.empty())
+            return;
+        bool ok = true;
+        try
+        {
+            auto start = std::chrono::steady_clock::now();
+            disk_manager_->async_read_pages(fd, run_start, bufs).get();
+            disk_manager_->io_stats().record_latency(LATENCY_READ, std::chrono::steady_clock::now() - start);
+        }
+        catch (RMDBError &)
+        {
+            ok = false;
+        }
+        latches.clear();
+        if (ok)
+            pages_read_.fetch_add(frames.size());
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            PageId_Final page_id{fd, run_start + (page_id_t)i};
+            if (!(old_ids[i] == page_id))
+                erase_mapping(old_ids[i], frames[i]);
+            if (!ok)
+            {
+                erase_mapping(page_id, frames[i]);
+                pages_[frames[i]].id_ = PageId_Final{.fd = -1, .page_no = INVALID_PAGE_ID};
+                release_frame(frames[i]);
+                continue;
+            }
+            finish_loading(frames[i]);
+            unpin_frame(frames[i], true);
+        }
+        frames.clear();
+        old_ids.clear();
+        bufs.clear();
+    };
 
-    for (const auto &frame_id : pages_to_remove)
+    for (page_id_t page_no = start_page_no; page_no < end_page_no && !terminate_; page_no++)
     {
+        PageId_Final page_id{fd, page_no};
+        PageTableShard &shard = get_shard(page_id);
+        frame_id_t frame_id;
+        bool resident = false;
+        bool reserved = false;
+        {
+            std::lock_guard lock(shard.latch);
+            resident = shard.table.count(page_id) > 0;
+            if (!resident && find_victim_page(&frame_id))
+            {
+                shard.table[page_id] = frame_id;
+                reserved = true;
+            }
+        }
+        if (!reserved)
+        {
+            // 已经在缓冲池中的页面把连续段断开；没有可用的帧时放弃剩下的预读
+            read_run();
+            if (!resident)
+                return;
+            continue;
+        }
+
+        // 写回被淘汰的脏页，帧的latch一直持有到读取完成
+        // 需要等待日志持久化时先读取已经分配的页面，不在持有帧latch的情况下等待
         Page_Final &page = pages_[frame_id];
-        std::lock_guard page_lock(page.latch_);
-        if (page.is_dirty_.exchange(false))
+        if (page.is_dirty_.load())
         {
-            disk_manager_->write_page(page.id_.fd, page.id_.page_no, page.data_, PAGE_SIZE);
+            WalFlusher *wal = wal_.load();
+            lsn_t lsn = page.flush_lsn_.load();
+            if (wal != nullptr && lsn != INVALID_LSN && wal->persist_lsn() < lsn)
+            {
+                read_run();
+                wal_before_write(lsn);
+            }
+        }
+        std::unique_lock latch(page.latch_);
+        PageId_Final old_page_id = page.id_;
+        bool dirty = page.is_dirty_.exchange(false);
+        count_eviction(old_page_id, dirty);
+        if (dirty)
+        {
+            try
+            {
+                disk_manager_->write_page(old_page_id.fd, old_page_id.page_no, page.data_, PAGE_SIZE);
+            }
+            catch (RMDBError &)
+            {
+                page.is_dirty_ = true;
+                latch.unlock();
+                erase_mapping(page_id, frame_id);
+                finish_loading(frame_id);
+                release_pin(frame_id);
+                read_run();
+                return;
+            }
             dirty_page_count_.fetch_sub(1);
+            written_eviction_.fetch_add(1);
         }
-        page.id_.fd = -1; // 重置页面ID
+        page.id_ = page_id;
+        page.flush_lsn_ = INVALID_LSN;
+        if (frames.empty())
+            run_start = page_no;
+        frames.push_back(frame_id);
+        old_ids.push_back(old_page_id);
+        bufs.push_back(page.data_);
+        latches.push_back(std::move(latch));
     }
+    read_run();
 }
 
+/**
+ * @description: 后台写线程：每轮根据最近的帧分配速度写回即将被淘汰的脏页，使前台淘汰页面时尽量拿到干净帧
+ */
 void BufferPoolManager_Final::background_flush()
 {
-    std::vector<frame_id_t> batch;
-    batch.reserve(FLUSH_BATCH_SIZE);
+    double lookahead = BGWRITER_LOOKAHEAD_MIN;
+    uint64_t last_alloc = alloc_count_.load();
+    uint64_t last_eviction = written_eviction_.load();
+    auto last_round = std::chrono::steady_clock::now();
+    auto last_periodic = last_round;
+    size_t written = 0;
 
     while (!terminate_.load())
     {
-        // 周期性检查或等待条件触发
+        // 每轮间隔BGWRITER_DELAY，脏页过多时立即开始下一轮；上一轮没有可写的页面（都被固定）时不立即重试
         {
             std::unique_lock lock(flush_mutex_);
-            flush_cond_.wait_for(lock, FLUSH_INTERVAL,
-                                 [this]
+            flush_cond_.wait_for(lock, BGWRITER_DELAY,
+                                 [this, written]
                                  {
-                                     return dirty_page_count_.load() > DIRTY_THRESHOLD ||
+                                     return (written > 0 && dirty_page_count_.load() > DIRTY_THRESHOLD) ||
                                             terminate_;
                                  });
         }
@@ -300,103 +564,692 @@ void BufferPoolManager_Final::background_flush()
         if (terminate_.load())
             break;
 
-        // 收集并处理脏页
-        if (dirty_page_count_.load() > 0)
+        // 继续退役缩小缓冲池时被固定的帧
+        retire_pending_frames();
+
+        auto now = std::chrono::steady_clock::now();
+        bool periodic = now - last_periodic >= FLUSH_INTERVAL;
+        if (periodic)
+            last_periodic = now;
+        written = bgwriter_round(lookahead, last_alloc, last_eviction, periodic);
+
+        // 写回速度取最近几轮的指数平均
+        now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - last_round).count();
+        last_round = now;
+        if (seconds > 0)
+            bgwriter_rate_ = bgwriter_rate_.load() * 0.8 + written / seconds * 0.2;
+    }
+}
+
+/**
+ * @description: 后台写线程的一轮：在时钟指针前方维持一定数量可以直接复用的干净帧，写回其中不足的部分
+ * 干净帧目标 = 平滑后的每轮分配帧数 * lookahead，不超过缓冲池的1/4。前台淘汰时同步写回了脏页说明目标偏小，
+ * lookahead加倍，否则缓慢回落。脏页超过DIRTY_THRESHOLD或者到达FLUSH_INTERVAL时至少写回一批
+ * @return {size_t} 写回的页面数
+ */
+size_t BufferPoolManager_Final::bgwriter_round(double &lookahead, uint64_t &last_alloc, uint64_t &last_eviction,
+                                               bool periodic)
+{
+    uint64_t alloc = alloc_count_.load();
+    double recent = alloc - last_alloc;
+    last_alloc = alloc;
+    // 分配速度上升时立即跟上，下降时缓慢衰减，避免负载短暂停顿后干净帧不够
+    double smoothed = smoothed_alloc_.load();
+    smoothed = recent > smoothed ? recent : smoothed + (recent - smoothed) / 16;
+    smoothed_alloc_ = smoothed;
+
+    uint64_t eviction = written_eviction_.load();
+    if (eviction != last_eviction)
+        lookahead = std::min(lookahead * 2, BGWRITER_LOOKAHEAD_MAX);
+    else
+        lookahead = std::max(lookahead * 0.95, BGWRITER_LOOKAHEAD_MIN);
+    last_eviction = eviction;
+
+    size_t pool_size = pool_size_.load();
+    size_t dirty = std::min(dirty_page_count_.load(), pool_size);
+    size_t target = std::min((size_t)(smoothed * lookahead), pool_size / 4);
+    clean_target_ = target;
+    size_t min_write = dirty > DIRTY_THRESHOLD || (periodic && dirty > 0) ? FLUSH_BATCH_SIZE : 0;
+
+    std::vector<frame_id_t> candidates;
+    collect_dirty_pages(candidates, target, min_write, BGWRITER_MAX_PAGES);
+    size_t written = 0;
+    for (size_t start = 0; start < candidates.size() && !terminate_.load(); start += FLUSH_BATCH_SIZE)
+    {
+        size_t end = std::min(start + FLUSH_BATCH_SIZE, candidates.size());
+        written += flush_batch(std::vector<frame_id_t>(candidates.begin() + start, candidates.begin() + end));
+    }
+    written_bgwriter_.fetch_add(written);
+    return written;
+}
+
+/**
+ * @description: 从时钟指针开始向前扫描即将被淘汰的帧，收集其中需要写回的脏页
+ * 没有被固定、引用位已清除的干净帧淘汰时可以直接复用，计入预留；没有被固定的脏页加入batch，
+ * 其中引用位已清除的写回后同样计入预留。被固定的页面可能正在被修改，留给之后的轮次或者检查点。
+ * 预留达到target并且至少收集了min_write个脏页、收集满limit个或者扫描完整个缓冲池时停止。
+ * 使用replacer_时时钟指针不移动，相当于每轮从第一个帧开始扫描
+ * @param {vector<frame_id_t>&} batch 收集到的帧
+ * @param {size_t} target 需要预留的干净帧数
+ * @param {size_t} min_write 至少收集的脏页数
+ * @param {size_t} limit 最多收集的帧数
+ * @return {size_t} 扫描范围内的预留帧数，包括batch中写回后可以复用的帧
+ */
+size_t BufferPoolManager_Final::collect_dirty_pages(std::vector<frame_id_t> &batch, size_t target, size_t min_write,
+                                                    size_t limit)
+{
+    size_t pool_size = pool_size_.load();
+    size_t pos = clock_hand_.load(std::memory_order_relaxed) % pool_size;
+    size_t reserve = 0;
+    for (size_t n = 0; n < pool_size && batch.size() < limit && (reserve < target || batch.size() < min_write); n++)
+    {
+        Page_Final &page = pages_[pos];
+        uint32_t state = page.pin_state_.load();
+        if ((state & Page_Final::PIN_MASK) == 0)
+        {
+            if (page.is_dirty_.load())
+                batch.push_back(pos);
+            if ((state & Page_Final::REF_BIT) == 0)
+                reserve++;
+        }
+        if (++pos == pool_size)
+            pos = 0;
+    }
+    return reserve;
+}
+
+/**
+ * @description: 写回一批脏页，先持久化这些页面需要的日志
+ * @param {bool} wait_latch 为false时只尝试加页面latch，跳过被其他线程持有latch的页面
+ * @param {size_t*} busy 传出参数：因为latch被占用而跳过的页面数，可以为nullptr
+ * @return {size_t} 实际写回的页面数
+ */
+size_t BufferPoolManager_Final::flush_batch(const std::vector<frame_id_t> &batch, bool wait_latch, size_t *busy)
+{
+    if (batch.empty())
+        return 0;
+
+    // 记录每个帧当前存放的页面，按文件和页号排序，相邻的页面合并成一个写请求
+    std::vector<std::pair<PageId_Final, frame_id_t>> pages;
+    pages.reserve(batch.size());
+    lsn_t wal_lsn = INVALID_LSN;
+    for (frame_id_t fid : batch)
+    {
+        std::shared_lock lock(pages_[fid].latch_, std::defer_lock);
+        if (wait_latch)
+            lock.lock();
+        else if (!lock.try_lock())
+        {
+            if (busy != nullptr)
+                (*busy)++;
+            continue;
+        }
+        pages.emplace_back(pages_[fid].id_, fid);
+        wal_lsn = std::max(wal_lsn, pages_[fid].flush_lsn_.load());
+    }
+    std::sort(pages.begin(), pages.end(), [](const auto &a, const auto &b)
+              { return a.first.fd != b.first.fd ? a.first.fd < b.first.fd : a.first.page_no < b.first.page_no; });
+    // 整批只等待一次日志持久化，之后又被修改、需要更新日志的页面留到下一批
+    wal_before_write(wal_lsn);
+
+    // 每个连续段单独提交给异步IO后端，多个段的IO重叠执行；一个段写入完成之前持有其中页面的读latch，
+    // 防止页面在写入期间被淘汰并由其他线程写回更新的版本，写完后立即释放，不等待整批完成
+    struct PendingRun
+    {
+        IoFuture done;
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        std::chrono::steady_clock::time_point start;
+    };
+    std::vector<PendingRun> runs;
+    std::vector<std::shared_lock<std::shared_mutex>> run_locks;
+    size_t total = 0;
+    auto submit = [&]
+    {
+        // 出错时也要等所有已经提交的段写完，才能释放它们的latch
+        std::exception_ptr err;
+        for (auto &run : runs)
+        {
+            try
+            {
+                run.done.get();
+            }
+            catch (...)
+            {
+                err = err ? err : std::current_exception();
+                continue;
+            }
+            disk_manager_->io_stats().record_latency(LATENCY_WRITE, std::chrono::steady_clock::now() - run.start);
+            dirty_page_count_.fetch_sub(run.locks.size());
+            total += run.locks.size();
+            run.locks.clear();
+        }
+        runs.clear();
+        if (err)
+            std::rethrow_exception(err);
+    };
+    auto writable = [wal_lsn](Page_Final &page, const PageId_Final &page_id)
+    {
+        // 帧已经被换成其他页面，或者已经被其他线程刷盘
+        return page.id_ == page_id && page.flush_lsn_.load() <= wal_lsn && page.is_dirty_.exchange(false);
+    };
+
+    std::vector<const char *> run_data;
+    size_t i = 0;
+    while (i < pages.size())
+    {
+        // 只有在不持有其他页面latch时才阻塞地等待，其余页面只尝试加锁，避免和持有多个页面latch的线程死锁
+        Page_Final &first = pages_[pages[i].second];
+        std::shared_lock first_lock(first.latch_, std::try_to_lock);
+        if (!first_lock.owns_lock())
+        {
+            if (!wait_latch)
+            {
+                if (busy != nullptr)
+                    (*busy)++;
+                i++;
+                continue;
+            }
+            submit();
+            first_lock.lock();
+        }
+        PageId_Final start = pages[i].first;
+        i++;
+        if (!writable(first, start))
+            continue;
+        run_locks.emplace_back(std::move(first_lock));
+        run_data.push_back(first.data_);
+
+        while (i < pages.size() && pages[i].first.fd == start.fd &&
+               pages[i].first.page_no == start.page_no + (page_id_t)run_data.size())
         {
-            collect_dirty_pages(batch);
-            if (batch.size())
+            Page_Final &page = pages_[pages[i].second];
+            std::shared_lock lock(page.latch_, std::try_to_lock);
+            if (!lock.owns_lock())
+                break;
+            if (!writable(page, pages[i].first))
             {
-                flush_batch(batch);
-                batch.clear();
+                i++;
+                break;
             }
+            run_locks.emplace_back(std::move(lock));
+            run_data.push_back(page.data_);
+            i++;
         }
+
+        std::vector<IoRequest> reqs;
+        reqs.push_back(DiskManager_Final::make_page_request(IoOp::WRITE, start.fd, start.page_no, run_data));
+        auto submit_time = std::chrono::steady_clock::now();
+        runs.push_back({disk_manager_->submit_io(std::move(reqs)), std::move(run_locks), submit_time});
+        run_locks.clear();
+        run_data.clear();
     }
+    submit();
+    return total;
 }
 
-void BufferPoolManager_Final::collect_dirty_pages(std::vector<frame_id_t> &batch)
+/**
+ * @description: 取得一个可以使用的帧，帧被固定并标记为正在加载，之后由load_frame()完成加载
+ * @param {frame_id_t*} frame_id 取得的帧编号
+ * @return {bool} 没有空闲帧并且所有页面都被固定时返回false
+ */
+bool BufferPoolManager_Final::find_victim_page(frame_id_t *frame_id)
 {
-    size_t start_pos = last_scan_pos_;
-    size_t current_pos = start_pos;
-    size_t pool_size = pages_.size();
+    while (true)
+    {
+        {
+            std::lock_guard lock(free_list_mutex_);
+            if (free_list_.empty())
+                break;
+            *frame_id = free_list_.front();
+            free_list_.pop_front();
+        }
+        // 缓冲池缩小后超出大小的帧不再使用，等待退役
+        if ((size_t)*frame_id < pool_size_.load() && claim_frame(*frame_id))
+        {
+            alloc_count_.fetch_add(1);
+            return true;
+        }
+    }
+    if (replacer_ == nullptr)
+    {
+        if (!clock_sweep(frame_id))
+            return false;
+        alloc_count_.fetch_add(1);
+        return true;
+    }
+    while (replacer_->victim(frame_id))
+    {
+        // 固定页面和从replacer中移除不是原子的，跳过刚刚被其他线程固定的帧，取消固定时会重新加入replacer
+        if ((size_t)*frame_id < pool_size_.load() && claim_frame(*frame_id))
+        {
+            alloc_count_.fetch_add(1);
+            return true;
+        }
+    }
+    return false;
+}
 
-    // 从上次结束的位置开始扫描,最多扫描一轮
+/**
+ * @description: 独占一个没有被固定的帧：先标记为正在加载，再把固定计数从0改成1
+ * 其他线程在fetch_page()中先增加固定计数再检查加载状态，因此要么这里的CAS失败，要么它们会等待加载完成，
+ * 不会在不持有被淘汰页面所在分区写锁的情况下拿到一个即将被替换的页面
+ * @param {frame_id_t} frame_id 帧编号
+ * @return {bool} 帧已经被固定或者正在加载时返回false
+ */
+bool BufferPoolManager_Final::claim_frame(frame_id_t frame_id)
+{
+    Page_Final &page = pages_[frame_id];
+    if (page.loading_.exchange(true))
+        return false;
+    // 固定计数为0时改成1，同时清除引用位
+    uint32_t state = page.pin_state_.load();
+    while ((state & Page_Final::PIN_MASK) == 0)
+    {
+        if (page.pin_state_.compare_exchange_weak(state, 1))
+            return true;
+    }
+    finish_loading(frame_id);
+    return false;
+}
+
+/**
+ * @description: CLOCK-SWEEP：时钟指针扫过的帧如果设置了引用位就清除，否则尝试独占
+ * 第一圈清除所有引用位，之后一定能遇到没有被访问过的帧，多扫描一圈容忍并发访问重新设置的引用位
+ * @param {frame_id_t*} frame_id 独占的帧编号
+ * @return {bool} 所有帧都被固定时返回false
+ */
+bool BufferPoolManager_Final::clock_sweep(frame_id_t *frame_id)
+{
+    size_t pool_size = pool_size_.load();
+    for (size_t n = 0; n < 3 * pool_size; n++)
+    {
+        frame_id_t fid = clock_hand_.fetch_add(1, std::memory_order_relaxed) % pool_size;
+        std::atomic<uint32_t> &state = pages_[fid].pin_state_;
+        uint32_t cur = state.load();
+        if (cur & Page_Final::PIN_MASK)
+            continue;
+        if (cur & Page_Final::REF_BIT)
+        {
+            state.compare_exchange_strong(cur, cur & ~Page_Final::REF_BIT);
+            continue;
+        }
+        if (claim_frame(fid))
+        {
+            *frame_id = fid;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 固定一个帧，CLOCK-SWEEP策略下只有一次原子加法
+void BufferPoolManager_Final::pin_frame(frame_id_t frame_id)
+{
+    uint32_t prev = pages_[frame_id].pin_state_.fetch_add(1);
+    if ((prev & Page_Final::PIN_MASK) == 0 && replacer_)
+        replacer_->pin(frame_id);
+}
+
+/**
+ * @description: 取消固定一个帧，同一次CAS中设置引用位；只被全表扫描访问的帧不设置引用位，时钟指针第一次经过时就可以淘汰
+ * @return {int} 取消固定之前的固定计数，为0时没有修改
+ */
+int BufferPoolManager_Final::unpin_frame(frame_id_t frame_id, bool low_priority)
+{
+    std::atomic<uint32_t> &state = pages_[frame_id].pin_state_;
+    uint32_t prev = state.load();
+    uint32_t next;
     do
     {
-        if (pages_[current_pos].is_dirty_.load())
+        if ((prev & Page_Final::PIN_MASK) == 0)
+            return 0;
+        next = low_priority ? prev - 1 : (prev - 1) | Page_Final::REF_BIT;
+    } while (!state.compare_exchange_weak(prev, next));
+
+    int pins = prev & Page_Final::PIN_MASK;
+    if (pins == 1 && replacer_)
+    {
+        if (low_priority)
+            replacer_->unpin_low_priority(frame_id);
+        else
+            replacer_->unpin(frame_id);
+    }
+    return pins;
+}
+
+// 释放claim_frame()独占的帧，放回空闲链表
+// 加载失败时等待的线程可能还固定着这个帧，它们取消固定之前find_victim_page()不会再次使用它
+void BufferPoolManager_Final::release_frame(frame_id_t frame_id)
+{
+    pages_[frame_id].pin_state_.fetch_sub(1);
+    finish_loading(frame_id);
+    std::lock_guard free_lock(free_list_mutex_);
+    free_list_.push_back(frame_id);
+}
+
+// 帧中原来的页面被替换时计入它所属文件的淘汰次数
+void BufferPoolManager_Final::count_eviction(const PageId_Final &old_page_id, bool dirty)
+{
+    if (old_page_id.fd < 0)
+        return;
+    IoStats &stats = disk_manager_->io_stats();
+    stats.add(old_page_id.fd, STAT_EVICTIONS);
+    if (dirty)
+        stats.add(old_page_id.fd, STAT_DIRTY_EVICTIONS);
+}
+
+/**
+ * @description: 在分区锁外完成帧的加载：写回被淘汰的脏页，读取新页面（或清空新分配的页面），然后唤醒等待的线程
+ * 被淘汰的页面在写回之前仍然保留在page table中，访问它的线程会等待写回完成后重新从磁盘读取
+ * @param {frame_id_t} frame_id 通过find_victim_page()取得并已经加入page table的帧
+ * @param {PageId_Final&} page_id 新页面
+ * @param {bool} read 是否从磁盘读取，new_page()分配的页面不需要读取
+ */
+void BufferPoolManager_Final::load_frame(frame_id_t frame_id, const PageId_Final &page_id, bool read)
+{
+    Page_Final &page = pages_[frame_id];
+    PageId_Final old_page_id;
+    bool replaced = false; // 帧中的页面是否已经换成新页面
+    try
+    {
+        // 帧已经被独占，被淘汰的页面不会再被修改，在获取latch之前等待它的日志持久化
+        if (page.is_dirty_.load())
+            wal_before_write(page.flush_lsn_.load());
+        // 排他latch同时等待后台刷盘线程对这个帧正在进行的写入完成
+        std::lock_guard page_lock(page.latch_);
+        old_page_id = page.id_;
+        bool dirty = page.is_dirty_.exchange(false);
+        count_eviction(old_page_id, dirty);
+        if (dirty)
         {
-            batch.push_back(current_pos);
-            if (batch.size() >= FLUSH_BATCH_SIZE)
+            try
             {
-                break;
+                disk_manager_->write_page(old_page_id.fd, old_page_id.page_no, page.data_, PAGE_SIZE);
             }
+            catch (...)
+            {
+                // 写回失败，帧中仍然是原来的页面，恢复脏标记，dirty_page_count_没有减少
+                page.is_dirty_ = true;
+                throw;
+            }
+            dirty_page_count_.fetch_sub(1);
+            written_eviction_.fetch_add(1);
         }
-        current_pos++;
-        if (current_pos >= pool_size)
-            current_pos = 0; // 循环扫描
-    } while (current_pos != start_pos && batch.size() < FLUSH_BATCH_SIZE);
+        page.id_ = page_id;
+        page.flush_lsn_ = INVALID_LSN;
+        replaced = true;
+        if (read)
+        {
+            disk_manager_->read_page(page_id.fd, page_id.page_no, page.data_, PAGE_SIZE);
+            pages_read_.fetch_add(1);
+        }
+        else
+            page.reset_memory();
+    }
+    catch (...)
+    {
+        if (!replaced)
+        {
+            // 被淘汰的页面没有写回，保留它的映射，只撤销新页面的映射，下次再淘汰这个帧
+            erase_mapping(page_id, frame_id);
+            finish_loading(frame_id);
+            release_pin(frame_id);
+            throw;
+        }
+        // 读取新页面失败，被淘汰的页面已经写回，把帧放回空闲链表，等待的线程发现页面不匹配后重新查找
+        erase_mapping(old_page_id, frame_id);
+        erase_mapping(page_id, frame_id);
+        page.id_ = PageId_Final{.fd = -1, .page_no = INVALID_PAGE_ID};
+        release_frame(frame_id);
+        throw;
+    }
 
-    // 更新下次扫描的起始位置
-    last_scan_pos_ = current_pos;
+    // 被淘汰的页面已经写回，从page table中移除，之后访问它会从磁盘读取
+    if (old_page_id.fd != -1 && !(old_page_id == page_id))
+    {
+        erase_mapping(old_page_id, frame_id);
+    }
+    finish_loading(frame_id);
 }
 
-void BufferPoolManager_Final::flush_batch(const std::vector<frame_id_t> &batch)
+// 如果page_id仍然映射到frame_id，从page table中移除
+void BufferPoolManager_Final::erase_mapping(const PageId_Final &page_id, frame_id_t frame_id)
 {
-    if (batch.empty())
+    if (page_id.fd == -1)
         return;
+    PageTableShard &shard = get_shard(page_id);
+    std::lock_guard lock(shard.latch);
+    auto it = shard.table.find(page_id);
+    if (it != shard.table.end() && it->second == frame_id)
+        shard.table.erase(it);
+}
 
-    // 直接遍历所有页面进行刷盘
-    for (frame_id_t fid : batch)
+void BufferPoolManager_Final::wait_loaded(frame_id_t frame_id)
+{
+    Page_Final &page = pages_[frame_id];
+    if (!page.loading_.load())
+        return;
+    size_t shard = frame_id % LOAD_WAIT_SHARDS;
+    std::unique_lock lock(load_mutex_[shard]);
+    load_cv_[shard].wait(lock, [&page]
+                         { return !page.loading_.load(); });
+}
+
+void BufferPoolManager_Final::finish_loading(frame_id_t frame_id)
+{
+    size_t shard = frame_id % LOAD_WAIT_SHARDS;
     {
-        Page_Final &page = pages_[fid];
-        std::shared_lock lock(page.latch_);
+        std::lock_guard lock(load_mutex_[shard]);
+        pages_[frame_id].loading_.store(false);
+    }
+    load_cv_[shard].notify_all();
+}
 
-        // 检查是否仍然是脏页
-        if (page.is_dirty_.exchange(false))
+// 释放fetch_page()中为等待加载而增加的固定计数
+void BufferPoolManager_Final::release_pin(frame_id_t frame_id)
+{
+    unpin_frame(frame_id, false);
+}
+
+/**
+ * @description: 强制刷新所有脏页到磁盘
+ * @param {bool} wait_latch 为false时跳过被其他线程持有latch的页面，调用者持有其他线程可能等待的锁时使用
+ * @return {bool} 是否没有因为latch被占用而跳过的脏页
+ */
+bool BufferPoolManager_Final::force_flush_all_pages(bool wait_latch)
+{
+    // 分批收集脏页，每批的写请求一起提交，让多个页面的IO重叠执行
+    std::vector<frame_id_t> batch;
+    batch.reserve(FLUSH_BATCH_SIZE);
+    size_t busy = 0;
+    for (size_t i = 0; i < pages_.size(); i++)
+    {
+        if (!pages_[i].is_dirty_.load())
+            continue;
+        batch.push_back(i);
+        if (batch.size() >= FLUSH_BATCH_SIZE)
         {
-            disk_manager_->write_page(page.id_.fd, page.id_.page_no, page.data_, PAGE_SIZE);
-            dirty_page_count_.fetch_sub(1);
+            written_flush_.fetch_add(flush_batch(batch, wait_latch, &busy));
+            batch.clear();
         }
     }
+    written_flush_.fetch_add(flush_batch(batch, wait_latch, &busy));
+    return busy == 0;
 }
 
-bool BufferPoolManager_Final::find_victim_page(frame_id_t *frame_id)
+BufferPoolStats BufferPoolManager_Final::get_stats() const
+{
+    BufferPoolStats stats;
+    stats.pool_size = pool_size_.load();
+    stats.max_pool_size = pages_.size();
+    stats.dirty_pages = dirty_page_count_.load();
+    stats.pages_read = pages_read_.load();
+    stats.written_bgwriter = written_bgwriter_.load();
+    stats.written_eviction = written_eviction_.load();
+    stats.written_flush = written_flush_.load();
+    stats.wal_flush_waits = wal_flush_waits_.load();
+    // smoothed_alloc_是每轮的分配帧数，按每轮间隔BGWRITER_DELAY换算
+    stats.alloc_rate = smoothed_alloc_.load() * (1000.0 / BGWRITER_DELAY.count());
+    stats.bgwriter_rate = bgwriter_rate_.load();
+    stats.clean_target = clean_target_.load();
+    return stats;
+}
+/**
+ * @description: 在线调整缓冲池的帧数，不能超过创建时指定的最大帧数
+ * 扩大时直接把退役的帧放回free list；缩小时先禁止分配超出大小的帧，再分批退役这些帧，
+ * 每批只短暂持有resize_mutex_，前台查询只会在访问正在退役的页面时等待它写回。
+ * 被固定的帧保留到后台刷盘线程中继续退役，不阻塞调用者
+ * @param {size_t} new_size 新的帧数
+ */
+void BufferPoolManager_Final::resize(size_t new_size)
 {
+    if (new_size == 0 || new_size > pages_.size())
     {
-        std::lock_guard lock(free_list_mutex_);
-        if (free_list_.size())
-        {
+        throw InternalError("BufferPoolManager_Final::resize invalid size " + std::to_string(new_size) +
+                            ", max " + std::to_string(pages_.size()));
+    }
 
-            *frame_id = free_list_.front();
-            free_list_.pop_front();
-            return true;
+    std::unique_lock lock(resize_mutex_);
+    size_t old_size = pool_size_.load();
+    if (new_size >= old_size)
+    {
+        // 还没有退役的帧仍然存放着页面，从等待退役的列表中移除即可
+        retiring_.erase(std::remove_if(retiring_.begin(), retiring_.end(),
+                                       [new_size](frame_id_t fid)
+                                       { return (size_t)fid < new_size; }),
+                        retiring_.end());
+        // 缩小期间free list和replacer在分配时丢弃了超出大小的帧，这里把这些帧重新放回，保证每个帧只出现一次
+        {
+            std::lock_guard free_lock(free_list_mutex_);
+            free_list_.remove_if([old_size, new_size](frame_id_t fid)
+                                 { return (size_t)fid >= old_size && (size_t)fid < new_size; });
+        }
+        // 超出已提交范围的帧从来没有被使用过，先为它们提交内存
+        arena_.commit(new_size);
+        pool_size_.store(new_size);
+        for (size_t i = old_size; i < new_size; i++)
+        {
+            if (retired_[i])
+            {
+                retired_[i] = false;
+                release_frame(i);
+            }
+            else if (claim_frame(i))
+            {
+                // 被固定的帧取消固定时会重新加入replacer，这里只处理没有被固定的帧
+                Page_Final &page = pages_[i];
+                if (page.id_.fd == -1)
+                {
+                    if (replacer_)
+                        replacer_->pin(i);
+                    release_frame(i);
+                }
+                else
+                {
+                    finish_loading(i);
+                    release_pin(i);
+                }
+            }
         }
+        return;
     }
-    return replacer_->victim(frame_id);
+
+    pool_size_.store(new_size);
+    for (size_t i = new_size; i < old_size; i++)
+    {
+        if (!retired_[i])
+            retiring_.push_back(i);
+    }
+    lock.unlock();
+    retire_pending_frames();
 }
 
-void BufferPoolManager_Final::update_page(Page_Final *page, const PageId_Final &new_page_id, frame_id_t new_frame_id)
+/**
+ * @description: 分批退役超出缓冲池大小的帧，被固定的帧留在retiring_中下次再试
+ */
+void BufferPoolManager_Final::retire_pending_frames()
 {
-    if (page->is_dirty_.load())
+    std::unique_lock lock(resize_mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || retiring_.empty())
+        return;
+    std::vector<frame_id_t> pending;
+    pending.swap(retiring_);
+    lock.unlock();
+
+    for (size_t start = 0; start < pending.size(); start += RESIZE_CHUNK)
     {
-        disk_manager_->write_page(page->id_.fd, page->id_.page_no, page->data_, PAGE_SIZE);
-        page->is_dirty_ = false;
-        dirty_page_count_.fetch_sub(1);
+        size_t end = std::min(start + RESIZE_CHUNK, pending.size());
+        std::lock_guard chunk_lock(resize_mutex_);
+        // 处理这一批之前缓冲池可能又被扩大了
+        size_t pool_size = pool_size_.load();
+        size_t run_start = 0, run_len = 0;
+        for (size_t i = start; i < end; i++)
+        {
+            frame_id_t fid = pending[i];
+            if ((size_t)fid < pool_size || retired_[fid])
+                continue;
+            if (!retire_frame(fid))
+            {
+                retiring_.push_back(fid);
+                continue;
+            }
+            retired_[fid] = true;
+            // 合并相邻的帧一起释放内存
+            if (run_len > 0 && (size_t)fid == run_start + run_len)
+            {
+                run_len++;
+                continue;
+            }
+            if (run_len > 0)
+                arena_.release(run_start, run_len);
+            run_start = fid;
+            run_len = 1;
+        }
+        if (run_len > 0)
+            arena_.release(run_start, run_len);
     }
-    page->id_ = new_page_id;
 }
 
-void BufferPoolManager_Final::force_flush_all_pages()
+/**
+ * @description: 退役一个帧：独占后写回脏页、移出page table和replacer，固定计数保持为1
+ * @return {bool} 帧被固定或者正在加载时返回false
+ */
+bool BufferPoolManager_Final::retire_frame(frame_id_t frame_id)
 {
-    // 逐个刷新脏页
-    for (auto &page : pages_)
+    if (!claim_frame(frame_id))
+        return false;
+    if (replacer_)
+        replacer_->pin(frame_id);
+    Page_Final &page = pages_[frame_id];
+    if (page.is_dirty_.load())
+        wal_before_write(page.flush_lsn_.load());
+    PageId_Final old_page_id;
     {
-        std::shared_lock lock(page.latch_);
-        auto &page_id = page.id_;
-        // 检查是否是脏页并刷新
+        std::lock_guard page_lock(page.latch_);
+        old_page_id = page.id_;
         if (page.is_dirty_.exchange(false))
         {
-            disk_manager_->write_page(page_id.fd, page_id.page_no, page.data_, PAGE_SIZE);
+            try
+            {
+                disk_manager_->write_page(old_page_id.fd, old_page_id.page_no, page.data_, PAGE_SIZE);
+            }
+            catch (RMDBError &)
+            {
+                // 写回失败时保留页面，下次再试
+                page.is_dirty_ = true;
+                finish_loading(frame_id);
+                release_pin(frame_id);
+                return false;
+            }
             dirty_page_count_.fetch_sub(1);
+            written_flush_.fetch_add(1);
         }
+        page.id_ = PageId_Final{.fd = -1, .page_no = INVALID_PAGE_ID};
+        page.flush_lsn_ = INVALID_LSN;
     }
-}
\ No newline at end of file
+    // 等待加载的线程发现页面不匹配后重新查找，从磁盘读取
+    erase_mapping(old_page_id, frame_id);
+    finish_loading(frame_id);
+    return true;
+}
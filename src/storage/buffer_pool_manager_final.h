@@ -7,47 +7,173 @@
 #include <thread>
 #include <cassert>
 #include <queue>
+#include <deque>
+#include <memory>
 #include "disk_manager_final.h"
 #include "page_final.h"
+#include "frame_arena.h"
 #include "replacer/lru_replacer_final.h"
 #include "replacer/clock_replacer_final.h"
+#include "replacer/lru_k_replacer_final.h"
+
+/**
+ * @description: 缓冲池写回脏页之前通过这个接口保证日志先于数据持久化（WAL），由LogManager实现
+ */
+class WalFlusher
+{
+public:
+    virtual ~WalFlusher() = default;
+    virtual lsn_t last_lsn() const = 0;      // 最后分配的日志号
+    virtual lsn_t persist_lsn() const = 0;   // 已经持久化的最后一条日志的日志号
+    virtual void flush_until(lsn_t lsn) = 0; // 等待日志号不超过lsn的日志持久化
+};
+
+// 缓冲池的运行统计，写回的页面按触发原因分别计数
+struct BufferPoolStats
+{
+    size_t pool_size;           // 当前帧数
+    size_t max_pool_size;       // 最大帧数
+    size_t dirty_pages;         // 脏页数
+    uint64_t pages_read;        // 从磁盘读取的页面数
+    uint64_t written_bgwriter;  // 后台写线程写回的页面数
+    uint64_t written_eviction;  // 前台淘汰脏页时同步写回的页面数
+    uint64_t written_flush;     // flush_page()和检查点写回的页面数
+    uint64_t wal_flush_waits;   // 写回脏页前等待日志持久化的次数
+    double alloc_rate;          // 平滑后的每秒分配帧数
+    double bgwriter_rate;       // 后台写线程最近的每秒写回页面数
+    size_t clean_target;        // 后台写线程维持的干净帧数目标
+};
 
 class BufferPoolManager_Final
 {
 public:
-    BufferPoolManager_Final(size_t pool_size, DiskManager_Final *disk_manager);
+    // max_pool_size为在线调整时缓冲池的最大帧数，为0时等于pool_size；其余参数见RuntimeConfig
+    BufferPoolManager_Final(size_t pool_size, DiskManager_Final *disk_manager, size_t max_pool_size = 0,
+                            const std::string &replacer_type = DEFAULT_REPLACER, int replacer_k = LRU_K,
+                            bool huge_pages = false, const std::string &numa_policy = "local");
     ~BufferPoolManager_Final();
 
     Page_Final *fetch_page(const PageId_Final &page_id);
-    bool unpin_page(const PageId_Final &page_id, bool is_dirty);
+    bool unpin_page(const PageId_Final &page_id, bool is_dirty, bool low_priority = false);
     bool flush_page(const PageId_Final &page_id);
     Page_Final *new_page(PageId_Final *page_id);
     bool delete_page(const PageId_Final &page_id);
     void remove_all_pages(int fd, bool flush = true);
-    void force_flush_all_pages(); // 强制刷新所有脏页到磁盘
+    bool force_flush_all_pages(bool wait_latch = true); // 强制刷新所有脏页到磁盘
+    void prefetch(int fd, page_id_t start_page_no, int num_pages); // 异步预读页面
+    void resize(size_t new_size);                                  // 在线调整缓冲池的帧数
+
+    size_t get_pool_size() const { return pool_size_.load(); }
+    size_t get_max_pool_size() const { return pages_.size(); }
+    BufferPoolStats get_stats() const;
+
+    // 注册日志管理器，之后写回脏页前先持久化对应的日志；传入nullptr取消注册
+    void set_wal_flusher(WalFlusher *wal) { wal_.store(wal); }
 
 private:
-    std::shared_mutex table_latch_; // 保护 page_table
-    std::unordered_map<PageId_Final, frame_id_t, PageIdHash_Final> page_table_;
-    std::vector<Page_Final> pages_;
+    // page table按页面的哈希值分成多个分区，每个分区有自己的读写锁，访问不同页面的线程不会竞争同一把锁
+    // 分区对齐到缓存行，避免相邻分区的锁在多个CPU之间来回传递
+    struct alignas(64) PageTableShard
+    {
+        std::shared_mutex latch;
+        std::unordered_map<PageId_Final, frame_id_t, PageIdHash_Final> table;
+    };
+    static constexpr size_t PAGE_TABLE_SHARD_BITS = 6;
+    static constexpr size_t PAGE_TABLE_SHARDS = 1 << PAGE_TABLE_SHARD_BITS;
+    PageTableShard page_table_[PAGE_TABLE_SHARDS];
+
+    // 用哈希值的高位选择分区，低位留给分区内的unordered_map
+    PageTableShard &get_shard(const PageId_Final &page_id)
+    {
+        return page_table_[(uint64_t)PageIdHash_Final()(page_id) >> (64 - PAGE_TABLE_SHARD_BITS)];
+    }
+    FrameArena arena_;              // 所有帧的数据区，按最大帧数预留地址空间
+    std::vector<Page_Final> pages_; // 帧的元信息（latch、页面ID、固定计数等），与数据区分开存放
+
+    // 在线调整大小：编号不小于pool_size_的帧不再分配给新页面。缩小时这些帧被逐个退役（写回、移出page table、
+    // 释放内存），退役的帧固定计数保持为1，不在free list和replacer中；被固定的帧由后台刷盘线程稍后继续退役
+    static constexpr size_t RESIZE_CHUNK = 1024; // 每次持有resize_mutex_处理的帧数
+    std::atomic<size_t> pool_size_;
+    std::mutex resize_mutex_;             // 保护retired_和retiring_，串行化resize()
+    std::vector<bool> retired_;           // 帧是否已经退役
+    std::vector<frame_id_t> retiring_;    // 等待退役的帧
     std::mutex free_list_mutex_;      // 保护 free_list_
     std::list<frame_id_t> free_list_; // 空闲帧编号的链表
     DiskManager_Final *disk_manager_;
-    Replacer *replacer_;
+    // 默认的CLOCK-SWEEP策略不使用replacer_（为nullptr）：固定计数和引用位都在帧的pin_state_中，
+    // 固定和取消固定不需要通知replacer，只在淘汰时由clock_sweep()扫描
+    Replacer *replacer_ = nullptr;
+    std::atomic<size_t> clock_hand_{0};
 
     // 异步刷盘相关
     std::atomic<size_t> dirty_page_count_{0}; // 脏页计数
-    size_t last_scan_pos_{0};                 // 上次扫描结束的位置
     std::mutex flush_mutex_;                  // 保护条件变量
     std::condition_variable flush_cond_;
     std::atomic<bool> terminate_{false};
     std::thread flush_thread_;
+    std::atomic<WalFlusher *> wal_{nullptr};
+
+    // 后台写线程根据最近的帧分配速度估计下一轮需要的干净帧，提前写回即将被淘汰的脏页，
+    // 前台淘汰时仍然遇到脏页说明估计偏小，增大预留的倍数
+    std::atomic<uint64_t> alloc_count_{0}; // 累计分配的帧数
+    std::atomic<uint64_t> pages_read_{0};
+    std::atomic<uint64_t> written_bgwriter_{0};
+    std::atomic<uint64_t> written_eviction_{0};
+    std::atomic<uint64_t> written_flush_{0};
+    std::atomic<uint64_t> wal_flush_waits_{0};
+    std::atomic<double> smoothed_alloc_{0};  // 平滑后的每轮分配帧数
+    std::atomic<double> bgwriter_rate_{0};   // 每秒写回页面数
+    std::atomic<size_t> clean_target_{0};
+
+    // 等待帧加载完成的条件变量，按帧编号分片，不需要每个帧一个
+    static constexpr size_t LOAD_WAIT_SHARDS = 64;
+    std::mutex load_mutex_[LOAD_WAIT_SHARDS];
+    std::condition_variable load_cv_[LOAD_WAIT_SHARDS];
+
+    // 预读相关
+    struct PrefetchRequest
+    {
+        int fd;
+        page_id_t start_page_no;
+        int num_pages;
+    };
+    // 记录每个文件最近一次缺页的页号和连续缺页的次数，用于发现没有给出提示的顺序访问
+    struct SeqTracker
+    {
+        std::atomic<page_id_t> last_miss{INVALID_PAGE_ID};
+        std::atomic<int> run{0};
+    };
+    static constexpr size_t PREFETCH_QUEUE_SIZE = 64; // 队列满时丢弃新的预读请求
+    static constexpr int SEQ_MISS_TRIGGER = 2;        // 连续缺页次数达到该值时开始预读
+    std::mutex prefetch_mutex_;
+    std::condition_variable prefetch_cond_;
+    std::deque<PrefetchRequest> prefetch_queue_;
+    std::unique_ptr<SeqTracker[]> seq_trackers_;
+    std::thread prefetch_thread_;
 
     void background_flush();
+    void background_prefetch();
+    void prefetch_run(int fd, page_id_t start_page_no, int num_pages);
+    void note_miss(const PageId_Final &page_id);
     bool find_victim_page(frame_id_t *frame_id);
-    void update_page(Page_Final *page, const PageId_Final &new_page_id, frame_id_t new_frame_id);
+    bool clock_sweep(frame_id_t *frame_id);
+    void pin_frame(frame_id_t frame_id);
+    int unpin_frame(frame_id_t frame_id, bool low_priority);
+    bool claim_frame(frame_id_t frame_id);
+    void release_frame(frame_id_t frame_id);
+    void erase_mapping(const PageId_Final &page_id, frame_id_t frame_id);
+    void load_frame(frame_id_t frame_id, const PageId_Final &page_id, bool read);
+    void count_eviction(const PageId_Final &old_page_id, bool dirty);
+    void wait_loaded(frame_id_t frame_id);
+    void finish_loading(frame_id_t frame_id);
+    void release_pin(frame_id_t frame_id);
+    bool retire_frame(frame_id_t frame_id);
+    void retire_pending_frames();
+    void mark_dirty(Page_Final &page);
+    void wal_before_write(lsn_t lsn);
+    size_t bgwriter_round(double &lookahead, uint64_t &last_alloc, uint64_t &last_eviction, bool periodic);
 
     // 新增的辅助方法
-    void collect_dirty_pages(std::vector<frame_id_t> &batch);
-    void flush_batch(const std::vector<frame_id_t> &batch);
+    size_t collect_dirty_pages(std::vector<frame_id_t> &batch, size_t target, size_t min_write, size_t limit);
+    size_t flush_batch(const std::vector<frame_id_t> &batch, bool wait_latch = true, size_t *busy = nullptr);
 };
\ No newline at end of file
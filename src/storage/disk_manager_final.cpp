@@ -10,14 +10,27 @@ See the Mulan PSL v2 for more details. */
 
 #include "storage/disk_manager_final.h"
 
+#include <algorithm>  // for std::min
+#include <chrono>     // for steady_clock
 #include <assert.h>   // for assert
-#include <string.h>   // for memset
+#include <cerrno>     // for errno
+#include <cstdint>    // for uintptr_t
+#include <string.h>   // for memset, memcpy
+#include <limits.h>   // for IOV_MAX
 #include <sys/stat.h> // for stat
-#include <unistd.h>   // for lseek
+#include <sys/uio.h>  // for preadv, pwritev
+#include <unistd.h>   // for pread, pwrite
 
 #include "defs.h"
 
-DiskManager_Final::DiskManager_Final() : fd2pageno_{0}
+// O_DIRECT要求缓冲区地址、长度和文件偏移都按块对齐，这里统一按PAGE_SIZE对齐
+static inline bool is_page_aligned(const void *buf, int num_bytes)
+{
+    return reinterpret_cast<uintptr_t>(buf) % PAGE_SIZE == 0 && num_bytes % PAGE_SIZE == 0;
+}
+
+DiskManager_Final::DiskManager_Final(bool direct_io, const std::string &io_backend, int io_threads)
+    : fd2pageno_{0}, async_io_(AsyncIO::create(io_backend, io_threads)), direct_io_(direct_io)
 {
     // memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char)));
 }
@@ -31,14 +44,19 @@ DiskManager_Final::DiskManager_Final() : fd2pageno_{0}
  */
 void DiskManager_Final::write_page(int fd, page_id_t page_no, const char *offset, int num_bytes)
 {
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用write()函数
-    // 注意write返回值与num_bytes不等时 throw InternalError("DiskManager_Final::write_page Error");
-    ::lseek(fd, page_no * PAGE_SIZE, SEEK_SET);
-    if (::write(fd, offset, num_bytes) != num_bytes)
+    auto start = std::chrono::steady_clock::now();
+    if (is_direct(fd) && !is_page_aligned(offset, num_bytes))
+    {
+        write_page_unaligned(fd, page_no, offset, num_bytes);
+    }
+    // 使用pwrite()在指定位置写入，不修改文件的共享偏移量，多个线程可以同时读写同一个文件
+    else if (::pwrite(fd, offset, num_bytes, (off_t)page_no * PAGE_SIZE) != num_bytes)
     {
         throw InternalError("DiskManager_Final::write_page Error");
     }
+    io_stats_.record_latency(LATENCY_WRITE, std::chrono::steady_clock::now() - start);
+    io_stats_.add(fd, STAT_PAGES_WRITTEN);
+    io_stats_.add(fd, STAT_BYTES_WRITTEN, num_bytes);
 }
 
 /**
@@ -50,15 +68,195 @@ void DiskManager_Final::write_page(int fd, page_id_t page_no, const char *offset
  */
 void DiskManager_Final::read_page(int fd, page_id_t page_no, char *offset, int num_bytes)
 {
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用read()函数
-    // 注意read返回值与num_bytes不等时，throw InternalError("DiskManager_Final::read_page Error");
-    ::lseek(fd, page_no * PAGE_SIZE, SEEK_SET);
-    // if (::read(fd, offset, num_bytes) != num_bytes) {
-    if (::read(fd, offset, num_bytes) < 0)
+    auto start = std::chrono::steady_clock::now();
+    if (is_direct(fd) && !is_page_aligned(offset, num_bytes))
+    {
+        read_page_unaligned(fd, page_no, offset, num_bytes);
+    }
+    // 使用pread()在指定位置读取，页面可能还没有写入磁盘，读到的数据可以少于num_bytes，剩下的部分清零
+    else
+    {
+        ssize_t n = ::pread(fd, offset, num_bytes, (off_t)page_no * PAGE_SIZE);
+        if (n < 0)
+        {
+            throw InternalError("DiskManager_Final::read_page Error");
+        }
+        if (n < num_bytes)
+        {
+            memset(offset + n, 0, num_bytes - n);
+        }
+    }
+    io_stats_.record_latency(LATENCY_READ, std::chrono::steady_clock::now() - start);
+    io_stats_.add(fd, STAT_PAGES_READ);
+    io_stats_.add(fd, STAT_BYTES_READ, num_bytes);
+}
+
+/**
+ * @description: O_DIRECT文件写入没有对齐的数据（如文件头），先读出整个页面，修改后按页面整体写回
+ */
+void DiskManager_Final::write_page_unaligned(int fd, page_id_t page_no, const char *offset, int num_bytes)
+{
+    alignas(PAGE_SIZE) char buf[PAGE_SIZE];
+    for (int done = 0; done < num_bytes; done += PAGE_SIZE, page_no++)
+    {
+        int len = std::min(num_bytes - done, PAGE_SIZE);
+        if (len < PAGE_SIZE)
+        {
+            ssize_t n = ::pread(fd, buf, PAGE_SIZE, (off_t)page_no * PAGE_SIZE);
+            if (n < 0)
+            {
+                throw InternalError("DiskManager_Final::write_page Error");
+            }
+            memset(buf + n, 0, PAGE_SIZE - n);
+        }
+        memcpy(buf, offset + done, len);
+        if (::pwrite(fd, buf, PAGE_SIZE, (off_t)page_no * PAGE_SIZE) != PAGE_SIZE)
+        {
+            throw InternalError("DiskManager_Final::write_page Error");
+        }
+    }
+}
+
+/**
+ * @description: O_DIRECT文件读取到没有对齐的缓冲区中，先读出整个页面再复制需要的部分
+ */
+void DiskManager_Final::read_page_unaligned(int fd, page_id_t page_no, char *offset, int num_bytes)
+{
+    alignas(PAGE_SIZE) char buf[PAGE_SIZE];
+    for (int done = 0; done < num_bytes; done += PAGE_SIZE, page_no++)
+    {
+        ssize_t n = ::pread(fd, buf, PAGE_SIZE, (off_t)page_no * PAGE_SIZE);
+        if (n < 0)
+        {
+            throw InternalError("DiskManager_Final::read_page Error");
+        }
+        memset(buf + n, 0, PAGE_SIZE - n); // 读到文件末尾
+        memcpy(offset + done, buf, std::min(num_bytes - done, PAGE_SIZE));
+    }
+}
+
+/**
+ * @description: 把多个页面写入文件中从start_page_no开始的连续页面，合并成一次pwritev()
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} start_page_no 第一个页面的编号
+ * @param {vector<const char *>&} pages 每个页面的数据，大小都是PAGE_SIZE
+ */
+void DiskManager_Final::write_pages(int fd, page_id_t start_page_no, const std::vector<const char *> &pages)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<struct iovec> iov(pages.size());
+    for (size_t i = 0; i < pages.size(); i++)
+    {
+        iov[i].iov_base = const_cast<char *>(pages[i]);
+        iov[i].iov_len = PAGE_SIZE;
+    }
+    off_t pos = (off_t)start_page_no * PAGE_SIZE;
+    for (size_t i = 0; i < iov.size(); i += IOV_MAX)
+    {
+        int cnt = std::min(iov.size() - i, (size_t)IOV_MAX);
+        if (::pwritev(fd, iov.data() + i, cnt, pos) != (ssize_t)cnt * PAGE_SIZE)
+        {
+            throw InternalError("DiskManager_Final::write_pages Error");
+        }
+        pos += (off_t)cnt * PAGE_SIZE;
+    }
+    io_stats_.record_latency(LATENCY_WRITE, std::chrono::steady_clock::now() - start);
+    io_stats_.add(fd, STAT_PAGES_WRITTEN, pages.size());
+    io_stats_.add(fd, STAT_BYTES_WRITTEN, pages.size() * PAGE_SIZE);
+}
+
+/**
+ * @description: 读取文件中从start_page_no开始的连续页面，合并成一次preadv()
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} start_page_no 第一个页面的编号
+ * @param {vector<char *>&} pages 每个页面的缓冲区，大小都是PAGE_SIZE
+ */
+void DiskManager_Final::read_pages(int fd, page_id_t start_page_no, const std::vector<char *> &pages)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<struct iovec> iov(pages.size());
+    for (size_t i = 0; i < pages.size(); i++)
+    {
+        iov[i].iov_base = pages[i];
+        iov[i].iov_len = PAGE_SIZE;
+    }
+    off_t pos = (off_t)start_page_no * PAGE_SIZE;
+    for (size_t i = 0; i < iov.size(); i += IOV_MAX)
+    {
+        int cnt = std::min(iov.size() - i, (size_t)IOV_MAX);
+        ssize_t n = ::preadv(fd, iov.data() + i, cnt, pos);
+        if (n < 0)
+        {
+            throw InternalError("DiskManager_Final::read_pages Error");
+        }
+        if (n < (ssize_t)cnt * PAGE_SIZE) // 读到文件末尾，后面的页面都清零
+        {
+            zero_fill_short_read(iov.data() + i, iov.size() - i, n);
+            break;
+        }
+        pos += (off_t)cnt * PAGE_SIZE;
+    }
+    io_stats_.record_latency(LATENCY_READ, std::chrono::steady_clock::now() - start);
+    io_stats_.add(fd, STAT_PAGES_READ, pages.size());
+    io_stats_.add(fd, STAT_BYTES_READ, pages.size() * PAGE_SIZE);
+}
+
+/**
+ * @description: 构造读写从start_page_no开始的连续页面的异步请求
+ * @param {IoOp} op IoOp::READ或IoOp::WRITE
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} start_page_no 第一个页面的编号
+ * @param {vector<const char *>&} pages 每个页面的数据，大小都是PAGE_SIZE
+ */
+IoRequest DiskManager_Final::make_page_request(IoOp op, int fd, page_id_t start_page_no, const std::vector<const char *> &pages)
+{
+    IoRequest req{op, fd, (off_t)start_page_no * PAGE_SIZE, std::vector<struct iovec>(pages.size())};
+    for (size_t i = 0; i < pages.size(); i++)
     {
-        throw InternalError("DiskManager_Final::read_page Error");
+        req.iov[i].iov_base = const_cast<char *>(pages[i]);
+        req.iov[i].iov_len = PAGE_SIZE;
     }
+    return req;
+}
+
+/**
+ * @description: 异步读取文件中从start_page_no开始的连续页面
+ * @return {IoFuture} 读取完成后就绪
+ */
+IoFuture DiskManager_Final::async_read_pages(int fd, page_id_t start_page_no, const std::vector<char *> &pages)
+{
+    std::vector<const char *> bufs(pages.begin(), pages.end());
+    std::vector<IoRequest> reqs;
+    reqs.push_back(make_page_request(IoOp::READ, fd, start_page_no, bufs));
+    count_request(reqs.back());
+    return async_io_->submit(std::move(reqs));
+}
+
+/**
+ * @description: 异步写入文件中从start_page_no开始的连续页面
+ * @return {IoFuture} 写入完成后就绪
+ */
+IoFuture DiskManager_Final::async_write_pages(int fd, page_id_t start_page_no, const std::vector<const char *> &pages)
+{
+    std::vector<IoRequest> reqs;
+    reqs.push_back(make_page_request(IoOp::WRITE, fd, start_page_no, pages));
+    count_request(reqs.back());
+    return async_io_->submit(std::move(reqs));
+}
+
+/**
+ * @description: 异步请求在提交时计入读写的页面数和字节数
+ */
+void DiskManager_Final::count_request(const IoRequest &req)
+{
+    if (req.op == IoOp::FSYNC)
+        return;
+    uint64_t bytes = 0;
+    for (auto &v : req.iov)
+        bytes += v.iov_len;
+    bool read = req.op == IoOp::READ;
+    io_stats_.add(req.fd, read ? STAT_PAGES_READ : STAT_PAGES_WRITTEN, bytes / PAGE_SIZE);
+    io_stats_.add(req.fd, read ? STAT_BYTES_READ : STAT_BYTES_WRITTEN, bytes);
 }
 
 /**
@@ -174,9 +372,23 @@ int DiskManager_Final::open_file(const std::string &path)
     std::lock_guard lock(path2fd_mutex_);
     if (path2fd_.count(path))
         return path2fd_[path];
-    int fd = ::open(path.c_str(), O_RDWR);
+    int fd = -1;
+    bool direct = false;
+    if (direct_io_)
+    {
+        // 文件系统不支持O_DIRECT（如tmpfs）时返回EINVAL，退回到普通的读写
+        fd = ::open(path.c_str(), O_RDWR | O_DIRECT);
+        direct = fd != -1;
+        if (fd == -1 && errno != EINVAL)
+            return fd;
+    }
+    if (fd == -1)
+        fd = ::open(path.c_str(), O_RDWR);
     if (fd != -1)
     {
+        if (fd < MAX_FD)
+            direct_fd_[fd] = direct;
+        io_stats_.reset_file(fd);
         path2fd_.emplace(path, fd);
         fd2path_.emplace(fd, path);
     }
@@ -264,7 +476,7 @@ int DiskManager_Final::read_log(char *log_data, int size, int offset)
         {
             create_file(LOG_FILE_NAME);
         }
-        read_log_fd_ = ::open(LOG_FILE_NAME.c_str(), O_RDWR);
+        read_log_fd_ = ::open(LOG_FILE_NAME.c_str(), O_RDWR | O_APPEND);
         write_log_fd_ = read_log_fd_; // 读写日志文件使用同一个文件句柄
     }
     int file_size = get_file_size(LOG_FILE_NAME);
@@ -276,8 +488,7 @@ int DiskManager_Final::read_log(char *log_data, int size, int offset)
     size = std::min(size, file_size - offset);
     if (size == 0)
         return 0;
-    lseek(read_log_fd_, offset, SEEK_SET);
-    ssize_t bytes_read = read(read_log_fd_, log_data, size);
+    ssize_t bytes_read = pread(read_log_fd_, log_data, size, offset);
     assert(bytes_read == size);
     return bytes_read;
 }
@@ -288,6 +499,50 @@ int DiskManager_Final::read_log(char *log_data, int size, int offset)
  * @param {int} size 要写入的内容大小
  */
 void DiskManager_Final::write_log(char *log_data, int size)
+{
+    open_log_file();
+
+    // 日志文件以O_APPEND方式打开，每次写入都追加到文件末尾，不依赖文件的共享偏移量
+    ssize_t bytes_write = write(write_log_fd_, log_data, size);
+    if (bytes_write != size)
+    {
+        throw UnixError();
+    }
+}
+
+/**
+ * @description: 把已经写入的日志持久化到磁盘中
+ */
+void DiskManager_Final::sync_log()
+{
+    if (write_log_fd_ != -1 && fdatasync(write_log_fd_) != 0)
+    {
+        throw UnixError();
+    }
+}
+
+/**
+ * @description: 异步追加日志，sync为true时写入之后执行fdatasync，两个操作按顺序执行
+ * @param {char} *log_data 要写入的日志，IoFuture就绪之前必须保持有效
+ * @param {int} size 日志的大小
+ * @param {bool} sync 是否持久化到磁盘
+ * @return {IoFuture} 写入（和持久化）完成后就绪
+ */
+IoFuture DiskManager_Final::async_write_log(const char *log_data, int size, bool sync)
+{
+    open_log_file();
+
+    std::vector<IoRequest> reqs;
+    // offset为-1时追加到文件末尾
+    reqs.push_back(IoRequest{IoOp::WRITE, write_log_fd_, -1, {{const_cast<char *>(log_data), (size_t)size}}});
+    if (sync)
+    {
+        reqs.push_back(IoRequest{IoOp::FSYNC, write_log_fd_, 0, {}});
+    }
+    return async_io_->submit(std::move(reqs), true);
+}
+
+void DiskManager_Final::open_log_file()
 {
     if (write_log_fd_ == -1)
     {
@@ -295,17 +550,9 @@ void DiskManager_Final::write_log(char *log_data, int size)
         {
             create_file(LOG_FILE_NAME);
         }
-        write_log_fd_ = ::open(LOG_FILE_NAME.c_str(), O_RDWR);
+        write_log_fd_ = ::open(LOG_FILE_NAME.c_str(), O_RDWR | O_APPEND);
         read_log_fd_ = write_log_fd_; // 读写日志文件使用同一个文件句柄
     }
-
-    // write from the file_end
-    lseek(write_log_fd_, 0, SEEK_END);
-    ssize_t bytes_write = write(write_log_fd_, log_data, size);
-    if (bytes_write != size)
-    {
-        throw UnixError();
-    }
 }
 
 void DiskManager_Final::ensure_file_size(int fd, page_id_t page_no)
@@ -21,9 +21,12 @@ See the Mulan PSL v2 for more details. */
 #include <unordered_map>
 #include <mutex>
 #include <shared_mutex>
+#include <vector>
 
 #include "common/config.h"
 #include "errors.h"
+#include "storage/async_io.h"
+#include "storage/io_stats.h"
 
 /**
  * @description: DiskManager的作用主要是根据上层的需要对磁盘文件进行操作
@@ -31,7 +34,9 @@ See the Mulan PSL v2 for more details. */
 class DiskManager_Final
 {
 public:
-        explicit DiskManager_Final();
+        // direct_io为数据文件是否使用O_DIRECT打开，io_backend、io_threads为异步IO的后端和线程数，见RuntimeConfig
+        explicit DiskManager_Final(bool direct_io = DIRECT_IO, const std::string &io_backend = DEFAULT_IO_BACKEND,
+                                   int io_threads = IO_THREAD_NUM);
 
         ~DiskManager_Final() = default;
 
@@ -39,6 +44,33 @@ public:
 
         void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
 
+        void write_pages(int fd, page_id_t start_page_no, const std::vector<const char *> &pages);
+
+        void read_pages(int fd, page_id_t start_page_no, const std::vector<char *> &pages);
+
+        /*异步操作，返回的IoFuture就绪之前页面的内存必须保持有效*/
+        IoFuture async_read_pages(int fd, page_id_t start_page_no, const std::vector<char *> &pages);
+
+        IoFuture async_write_pages(int fd, page_id_t start_page_no, const std::vector<const char *> &pages);
+
+        // 把多组请求一次提交给异步IO后端，用于后台刷盘时同时写入多段连续的页面
+        IoFuture submit_io(std::vector<IoRequest> reqs, bool ordered = false)
+        {
+                for (auto &req : reqs)
+                        count_request(req);
+                return async_io_->submit(std::move(reqs), ordered);
+        }
+
+        static IoRequest make_page_request(IoOp op, int fd, page_id_t start_page_no, const std::vector<const char *> &pages);
+
+        const char *io_backend() const { return async_io_->name(); }
+
+        // fd是否以O_DIRECT打开，此时读写页面的缓冲区和长度都要按PAGE_SIZE对齐
+        bool is_direct(int fd) const { return fd >= 0 && fd < MAX_FD && direct_fd_[fd]; }
+
+        // 页面文件的IO统计，缓冲池也把命中、淘汰等计数记录在这里；异步IO的延迟由等待它的一方记录
+        IoStats &io_stats() { return io_stats_; }
+
         page_id_t allocate_page(int fd);
 
         void deallocate_page(page_id_t page_id);
@@ -80,6 +112,10 @@ public:
 
         void write_log(char *log_data, int size);
 
+        void sync_log();
+
+        IoFuture async_write_log(const char *log_data, int size, bool sync);
+
         // void SetLogFd(int log_fd) { write_log_fd_ = log_fd; }
 
         // int GetLogFd() { return write_log_fd_; }
@@ -89,7 +125,7 @@ public:
                 {
                         create_file(LOG_BAK_FILE_NAME);
                 }
-                write_log_fd_ = ::open(LOG_BAK_FILE_NAME.c_str(), O_RDWR);
+                write_log_fd_ = ::open(LOG_BAK_FILE_NAME.c_str(), O_RDWR | O_APPEND);
         }
 
         void change_log_file()
@@ -132,4 +168,16 @@ private:
         int read_log_fd_ = -1; // WAL日志文件的文件句柄，默认为-1，代表未打开日志文件
         int write_log_fd_ = -1;
         std::atomic<page_id_t> fd2pageno_[MAX_FD]{}; // 文件中已经分配的页面个数，初始值为0
+        std::unique_ptr<AsyncIO> async_io_;           // 异步IO后端
+        bool direct_io_ = DIRECT_IO;                  // 数据文件是否使用O_DIRECT
+        std::atomic<bool> direct_fd_[MAX_FD]{};       // 以O_DIRECT打开的文件
+        IoStats io_stats_;
+
+        void write_page_unaligned(int fd, page_id_t page_no, const char *offset, int num_bytes);
+
+        void read_page_unaligned(int fd, page_id_t page_no, char *offset, int num_bytes);
+
+        void open_log_file();
+
+        void count_request(const IoRequest &req);
 };
\ No newline at end of file
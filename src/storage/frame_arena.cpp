@@ -0,0 +1,163 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "storage/frame_arena.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "errors.h"
+
+// 直接使用mbind系统调用，不依赖libnuma
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#endif
+#ifndef MPOL_INTERLEAVE
+#define MPOL_INTERLEAVE 3
+#endif
+
+static size_t round_up(size_t n, size_t align) { return (n + align - 1) / align * align; }
+
+FrameArena::FrameArena(size_t num_frames, size_t max_frames, size_t frame_size, bool use_huge,
+                       const std::string &numa_policy)
+    : frame_size_(frame_size), use_huge_(use_huge), numa_policy_(numa_policy)
+{
+    reserved_len_ = round_up(std::max(num_frames, max_frames) * frame_size, HUGE_PAGE_SIZE);
+
+    // 只预留地址空间，多映射2MB以便把起始地址对齐到2MB，透明大页才能覆盖整个数据区
+    mapping_len_ = reserved_len_ + HUGE_PAGE_SIZE;
+    void *addr = mmap(nullptr, mapping_len_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        throw InternalError("FrameArena: cannot allocate buffer pool memory");
+    }
+    mapping_ = addr;
+    base_ = reinterpret_cast<char *>(round_up(reinterpret_cast<uintptr_t>(addr), HUGE_PAGE_SIZE));
+    // 不使用预留的大页时也申请透明大页
+    madvise(base_, reserved_len_, MADV_HUGEPAGE);
+    apply_numa_policy(base_, reserved_len_);
+
+    huge_pages_ = use_huge_;
+    commit(num_frames);
+}
+
+void FrameArena::commit(size_t num_frames)
+{
+    size_t len = std::min(round_up(num_frames * frame_size_, HUGE_PAGE_SIZE), reserved_len_);
+    if (len <= committed_len_)
+        return;
+    char *addr = base_ + committed_len_;
+    size_t grow = len - committed_len_;
+    committed_len_ = len;
+    // 一旦有一段没有拿到大页，后面的帧也使用普通内存，避免同一个缓冲池里混用两种页面
+    if (!huge_pages_)
+        return;
+
+    // 用预留的大页替换这段普通内存。不能带MAP_NORESERVE，否则预留不足时mmap成功但访问时SIGBUS
+    void *huge = mmap(addr, grow, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_FIXED, -1, 0);
+    if (huge != MAP_FAILED)
+    {
+        apply_numa_policy(addr, grow);
+        return;
+    }
+
+    // MAP_FIXED失败后原来的映射可能已经被拆掉，重新映射成普通内存
+    huge_pages_ = false;
+    if (mmap(addr, grow, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) == MAP_FAILED)
+    {
+        throw InternalError("FrameArena: cannot allocate buffer pool memory");
+    }
+    madvise(addr, grow, MADV_HUGEPAGE);
+    apply_numa_policy(addr, grow);
+    // 每个进程只提示一次，测试等场景会创建很多缓冲池
+    static std::atomic<bool> warned{false};
+    if (!warned.exchange(true))
+    {
+        std::cerr << "FrameArena: no reserved huge pages for " << grow / HUGE_PAGE_SIZE
+                  << " x 2MB, falling back to transparent huge pages\n";
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    if (mapping_ != nullptr)
+    {
+        munmap(mapping_, mapping_len_);
+    }
+}
+
+void FrameArena::release(size_t first_frame, size_t num_frames)
+{
+    // 预留的大页只能按整个大页释放，这里忽略失败，内存在扩大缓冲池时会被重新使用
+    madvise(frame(first_frame), num_frames * frame_size_, MADV_DONTNEED);
+}
+
+/**
+ * @description: 按numa_policy_设置数据区的NUMA内存策略，只有一个节点或者设置失败时保持默认的本地分配
+ */
+void FrameArena::apply_numa_policy(void *addr, size_t len)
+{
+    const char *policy = numa_policy_.c_str();
+    if (numa_policy_ == "local")
+        return;
+
+    // 在线节点的列表，格式如"0-3"或"0,2"
+    unsigned long nodemask = 0;
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if (!(online >> nodes))
+        return;
+    size_t pos = 0;
+    while (pos < nodes.size())
+    {
+        size_t end = nodes.find(',', pos);
+        std::string range = nodes.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        size_t dash = range.find('-');
+        int lo = std::atoi(range.c_str());
+        int hi = dash == std::string::npos ? lo : std::atoi(range.c_str() + dash + 1);
+        for (int n = lo; n <= hi && n < (int)(8 * sizeof(nodemask)); n++)
+            nodemask |= 1UL << n;
+        if (end == std::string::npos)
+            break;
+        pos = end + 1;
+    }
+
+    int mode;
+    if (strcmp(policy, "interleave") == 0)
+    {
+        // 只有一个节点时交错分配没有意义
+        if ((nodemask & (nodemask - 1)) == 0)
+            return;
+        mode = MPOL_INTERLEAVE;
+    }
+    else if (strncmp(policy, "node:", 5) == 0)
+    {
+        int node = std::atoi(policy + 5);
+        if (node < 0 || node >= (int)(8 * sizeof(nodemask)) || !(nodemask & (1UL << node)))
+            return;
+        nodemask = 1UL << node;
+        mode = MPOL_BIND;
+    }
+    else
+    {
+        return;
+    }
+    syscall(SYS_mbind, addr, len, mode, &nodemask, 8 * sizeof(nodemask), 0);
+}
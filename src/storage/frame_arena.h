@@ -0,0 +1,66 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @description: 缓冲池所有帧的数据区，一次mmap分配的连续内存，起始地址按2MB对齐，每个帧按PAGE_SIZE对齐
+ *
+ * 按最大帧数预留地址空间（MAP_NORESERVE），只有当前使用的帧才提交内存。整个数据区都通过madvise申请透明大页，
+ * 减少TLB缺失；开启use_huge时提交的范围改为映射预留的大页（MAP_HUGETLB），预留不足时退回透明大页。
+ * 扩大缓冲池时调用commit()提交新增的帧，预留的大页因此只按实际使用的大小占用。
+ * 是否使用大页和NUMA策略来自RuntimeConfig的huge_pages、numa_policy。
+ * 内存在第一次访问时才真正分配，NUMA策略在此之前设置。
+ */
+class FrameArena
+{
+public:
+    /**
+     * @param {size_t} num_frames 当前使用的帧数，构造时提交
+     * @param {size_t} max_frames 最大帧数，只预留地址空间
+     * @param {size_t} frame_size 每个帧的大小
+     * @param {bool} use_huge 是否使用预留的大页，需要事先配置vm.nr_hugepages
+     * @param {string&} numa_policy local、interleave或node:<n>
+     */
+    FrameArena(size_t num_frames, size_t max_frames, size_t frame_size, bool use_huge = false,
+               const std::string &numa_policy = "local");
+    ~FrameArena();
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    inline char *frame(size_t frame_id) const { return base_ + frame_id * frame_size_; }
+
+    bool huge_pages() const { return huge_pages_; }
+
+    // 提交前num_frames个帧的内存，已经提交的部分保持不变
+    void commit(size_t num_frames);
+
+    // 把连续的帧占用的物理内存还给操作系统，地址仍然有效，再次访问时得到全0的页面
+    void release(size_t first_frame, size_t num_frames);
+
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+private:
+    char *base_ = nullptr;     // 第一个帧的地址
+    void *mapping_ = nullptr;  // mmap返回的地址
+    size_t mapping_len_ = 0;   // mmap映射的长度
+    size_t reserved_len_ = 0;  // 从base_开始预留的长度
+    size_t committed_len_ = 0; // 从base_开始已经提交的长度，按2MB对齐
+    size_t frame_size_;
+    bool use_huge_ = false;    // 是否尝试使用预留的大页
+    bool huge_pages_ = false;  // 是否使用了MAP_HUGETLB
+    std::string numa_policy_;
+
+    void apply_numa_policy(void *addr, size_t len);
+};
@@ -0,0 +1,141 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "io_stats.h"
+
+static std::atomic<uint64_t> next_stats_id{1};
+
+// 每个线程缓存最近使用的IoStats实例和它在该实例中的计数器
+struct IoStatsCache
+{
+    uint64_t id = 0;
+    void *slot = nullptr;
+};
+static thread_local IoStatsCache stats_cache;
+
+IoStats::IoStats() : id_(next_stats_id.fetch_add(1)), baseline_(MAX_FILES) {}
+
+IoStats::~IoStats() = default;
+
+IoStats::ThreadSlot::~ThreadSlot()
+{
+    for (auto &chunk : chunks)
+        delete chunk.load();
+}
+
+std::atomic<uint64_t> *IoStats::ThreadSlot::file_counters(int fd)
+{
+    std::atomic<FileChunk *> &chunk = chunks[fd / FILES_PER_CHUNK];
+    FileChunk *c = chunk.load(std::memory_order_acquire);
+    if (c == nullptr)
+    {
+        // 只有所属线程分配，读取统计的线程可能同时读到nullptr，这时这组文件还没有计数
+        c = new FileChunk();
+        chunk.store(c, std::memory_order_release);
+    }
+    return c->counters[fd % FILES_PER_CHUNK];
+}
+
+IoStats::ThreadSlot &IoStats::local()
+{
+    if (stats_cache.id != id_)
+    {
+        stats_cache.slot = register_thread();
+        stats_cache.id = id_;
+    }
+    return *static_cast<ThreadSlot *>(stats_cache.slot);
+}
+
+IoStats::ThreadSlot *IoStats::register_thread()
+{
+    std::lock_guard lock(mutex_);
+    slots_.push_back(std::make_unique<ThreadSlot>());
+    return slots_.back().get();
+}
+
+IoStats::Counters IoStats::raw_file_counters(int fd) const
+{
+    Counters sum{};
+    for (auto &slot : slots_)
+    {
+        FileChunk *chunk = slot->chunks[fd / FILES_PER_CHUNK].load(std::memory_order_acquire);
+        if (chunk == nullptr)
+            continue;
+        for (int i = 0; i < STAT_COUNTER_NUM; i++)
+            sum[i] += chunk->counters[fd % FILES_PER_CHUNK][i].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void IoStats::reset_file(int fd)
+{
+    if (fd < 0 || fd >= MAX_FILES)
+        return;
+    std::lock_guard lock(mutex_);
+    baseline_[fd] = raw_file_counters(fd);
+}
+
+IoStats::Counters IoStats::file_counters(int fd) const
+{
+    if (fd < 0 || fd >= MAX_FILES)
+        return {};
+    std::lock_guard lock(mutex_);
+    Counters counters = raw_file_counters(fd);
+    for (int i = 0; i < STAT_COUNTER_NUM; i++)
+        counters[i] -= baseline_[fd][i];
+    return counters;
+}
+
+IoStats::Counters IoStats::total_counters() const
+{
+    std::lock_guard lock(mutex_);
+    Counters sum{};
+    for (auto &slot : slots_)
+    {
+        for (auto &chunk_ptr : slot->chunks)
+        {
+            FileChunk *chunk = chunk_ptr.load(std::memory_order_acquire);
+            if (chunk == nullptr)
+                continue;
+            for (auto &file : chunk->counters)
+                for (int i = 0; i < STAT_COUNTER_NUM; i++)
+                    sum[i] += file[i].load(std::memory_order_relaxed);
+        }
+    }
+    return sum;
+}
+
+IoStats::Histogram IoStats::latency_histogram(IoLatency op) const
+{
+    std::lock_guard lock(mutex_);
+    Histogram hist{};
+    for (auto &slot : slots_)
+        for (int i = 0; i < LATENCY_BUCKETS; i++)
+            hist[i] += slot->latency[op][i].load(std::memory_order_relaxed);
+    return hist;
+}
+
+uint64_t IoStats::percentile(const Histogram &hist, double p)
+{
+    uint64_t total = 0;
+    for (auto n : hist)
+        total += n;
+    if (total == 0)
+        return 0;
+    uint64_t rank = (uint64_t)(total * p / 100);
+    uint64_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        seen += hist[i];
+        if (seen > rank)
+            return 1ULL << i;
+    }
+    return 1ULL << (LATENCY_BUCKETS - 1);
+}
@@ -0,0 +1,120 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 按文件统计的计数器
+enum IoCounter : int
+{
+    STAT_FETCHES = 0,     // fetch_page()的次数
+    STAT_HITS,            // 页面已经在缓冲池中
+    STAT_MISSES,          // 页面需要从磁盘读取
+    STAT_EVICTIONS,       // 页面被淘汰
+    STAT_DIRTY_EVICTIONS, // 被淘汰时是脏页，由淘汰它的线程写回
+    STAT_PAGES_READ,
+    STAT_PAGES_WRITTEN,
+    STAT_BYTES_READ,
+    STAT_BYTES_WRITTEN,
+    STAT_COUNTER_NUM
+};
+
+enum IoLatency : int
+{
+    LATENCY_READ = 0,
+    LATENCY_WRITE,
+    LATENCY_NUM
+};
+
+/**
+ * @description: 缓冲池和磁盘IO的统计
+ *
+ * 每个线程第一次计数时分配自己的一组计数器，之后只写自己的计数器（不需要原子的读-改-写），
+ * 读取统计时累加所有线程的计数器。按文件的计数器以64个文件为一组按需分配。
+ * 文件打开时记下当前的累计值，按文件的统计从打开时开始计算；全局统计包含已经关闭的文件。
+ * 线程退出后它的计数器保留，工作线程的数量是固定的。
+ */
+class IoStats
+{
+public:
+    static constexpr int MAX_FILES = 8192;        // 与DiskManager_Final::MAX_FD一致，更大的fd不统计
+    static constexpr int LATENCY_BUCKETS = 24;    // 第i个桶统计延迟不超过2^i微秒的IO
+
+    using Counters = std::array<uint64_t, STAT_COUNTER_NUM>;
+    using Histogram = std::array<uint64_t, LATENCY_BUCKETS>;
+
+    IoStats();
+    ~IoStats();
+
+    IoStats(const IoStats &) = delete;
+    IoStats &operator=(const IoStats &) = delete;
+
+    inline void add(int fd, IoCounter counter, uint64_t n = 1)
+    {
+        if (fd < 0 || fd >= MAX_FILES)
+            return;
+        std::atomic<uint64_t> &c = local().file_counters(fd)[counter];
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    inline void record_latency(IoLatency op, std::chrono::steady_clock::duration d)
+    {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+        int bucket = 0;
+        while (bucket < LATENCY_BUCKETS - 1 && (1LL << bucket) < us)
+            bucket++;
+        std::atomic<uint64_t> &c = local().latency[op][bucket];
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // 文件打开后调用，之后file_counters()从0开始计算
+    void reset_file(int fd);
+
+    Counters file_counters(int fd) const;
+    Counters total_counters() const;
+    Histogram latency_histogram(IoLatency op) const;
+
+    // 直方图中的第p百分位（0~100），返回所在桶的上界（微秒），没有记录时返回0
+    static uint64_t percentile(const Histogram &hist, double p);
+
+private:
+    static constexpr int FILES_PER_CHUNK = 64;
+
+    struct FileChunk
+    {
+        std::atomic<uint64_t> counters[FILES_PER_CHUNK][STAT_COUNTER_NUM]{};
+    };
+
+    // 一个线程的计数器，只有这个线程写入
+    struct ThreadSlot
+    {
+        std::atomic<FileChunk *> chunks[MAX_FILES / FILES_PER_CHUNK]{};
+        std::atomic<uint64_t> latency[LATENCY_NUM][LATENCY_BUCKETS]{};
+
+        ~ThreadSlot();
+        std::atomic<uint64_t> *file_counters(int fd);
+    };
+
+    ThreadSlot &local();
+    ThreadSlot *register_thread();
+    Counters raw_file_counters(int fd) const;
+
+    const uint64_t id_;                               // 区分不同实例，线程缓存的计数器属于哪个实例
+    mutable std::mutex mutex_;                        // 保护slots_和baseline_
+    std::vector<std::unique_ptr<ThreadSlot>> slots_;
+    std::vector<Counters> baseline_;                  // 文件打开时的累计值
+};
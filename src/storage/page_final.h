@@ -40,9 +40,19 @@ struct PageId_Final
 };
 
 // PageId的自定义哈希算法, 用于构建unordered_map<PageId_Final, frame_id_t, PageIdHash_Final>
+// 把fd和page_no拼成64位整数后做一次MurmurHash3的finalizer，高位和低位都均匀分布，可以直接用高位选择page table的分区
 struct PageIdHash_Final
 {
-    size_t operator()(const PageId_Final &x) const { return (x.fd << 16) | x.page_no; }
+    size_t operator()(const PageId_Final &x) const
+    {
+        uint64_t h = ((uint64_t)(uint32_t)x.fd << 32) | (uint32_t)x.page_no;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
 };
 
 template <>
@@ -62,7 +72,8 @@ class Page_Final
 public:
     std::shared_mutex latch_;
 
-    Page_Final() { reset_memory(); }
+    // 数据区由BufferPoolManager_Final从FrameArena中分配，初始为0
+    Page_Final() = default;
 
     ~Page_Final() = default;
 
@@ -70,6 +81,15 @@ public:
     {
         // std::cout << id_.page_no<<" is lock\n";
         latch_.lock();
+        version_.fetch_add(1);
+    }
+    // 不阻塞地尝试加排他latch，成功时与lock()一样使版本号变为奇数
+    inline bool try_lock()
+    {
+        if (!latch_.try_lock())
+            return false;
+        version_.fetch_add(1);
+        return true;
     }
     inline void lock_shared()
     {
@@ -79,6 +99,7 @@ public:
     inline void unlock()
     {
         // std::cout << id_.page_no<<" is unlock\n";
+        version_.fetch_add(1);
         latch_.unlock();
     }
     inline void unlock_shared()
@@ -87,12 +108,26 @@ public:
         latch_.unlock_shared();
     }
 
+    /**
+     * @description: 乐观读：读取页面内容之前取得版本号，读取之后用validate()检查期间没有写者
+     * 写者通过lock()/unlock()修改页面，持有排他latch期间版本号为奇数
+     */
+    inline uint64_t read_version() const { return version_.load(std::memory_order_acquire); }
+
+    inline bool validate(uint64_t version) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version_.load(std::memory_order_relaxed) == version;
+    }
+
     PageId_Final get_page_id() const { return id_; }
 
     inline char *get_data() { return data_; }
 
     bool is_dirty() const { return is_dirty_; }
 
+    int get_pin_count() const { return pin_state_.load() & PIN_MASK; }
+
     static constexpr size_t OFFSET_PAGE_START = 0;
     static constexpr size_t OFFSET_LSN = 0;
     static constexpr size_t OFFSET_PAGE_HDR = 4;
@@ -117,13 +152,24 @@ private:
     /** page的唯一标识符 */
     PageId_Final id_ = {.fd = -1, .page_no = INVALID_PAGE_ID};
     /** The actual data that is stored within a page.
-     *  该页面在bufferPool中的偏移地址
+     *  该页面在bufferPool中的偏移地址，指向FrameArena中按PAGE_SIZE对齐的帧
      */
-    char data_[PAGE_SIZE] = {};
+    char *data_ = nullptr;
 
     /** 脏页判断 */
     std::atomic<bool> is_dirty_{false};
 
-    /** The pin count of this page. */
-    std::atomic<int> pin_count_{0};
+    /** 固定计数和CLOCK的引用位放在同一个原子变量中，固定和取消固定只需要一次原子操作 */
+    static constexpr uint32_t PIN_MASK = 0x7fffffff;
+    static constexpr uint32_t REF_BIT = 0x80000000;
+    std::atomic<uint32_t> pin_state_{0};
+
+    /** 乐观读使用的版本号，每次lock()和unlock()各加1 */
+    std::atomic<uint64_t> version_{0};
+
+    /** 帧已经分配给页面，但是还在写回被淘汰的页面或者从磁盘读取数据 */
+    std::atomic<bool> loading_{false};
+
+    /** 写回页面之前必须持久化的日志号，脏页取消固定时更新为当时最后一条日志的日志号 */
+    std::atomic<lsn_t> flush_lsn_{INVALID_LSN};
 };
\ No newline at end of file
@@ -14,11 +14,15 @@ See the Mulan PSL v2 for more details. */
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <array>
+#include <cstdio>
 #include <fstream>
+#include <tuple>
 
 #include "index/ix.h"
 #include "record/rm.h"
 #include "record_printer.h"
+#include "wire_protocol.h"
 
 /**
  * @description: 判断是否为一个文件夹
@@ -115,6 +119,16 @@ void SmManager::open_db(const std::string &db_name)
         throw UnixError();
     }
     ifs >> db_;
+    if (db_.page_size_ != (size_t)PAGE_SIZE)
+    {
+        size_t db_page_size = db_.page_size_;
+        db_ = DbMeta();
+        if (chdir("..") < 0)
+        {
+            throw UnixError();
+        }
+        throw PageSizeMismatchError(db_page_size, PAGE_SIZE);
+    }
 
     // 打开所有表和索引文件
     for (auto &[tab_name, tab_meta] : db_.tabs_)
@@ -213,6 +227,164 @@ void SmManager::show_tables(Context *context)
     }
 }
 
+/**
+ * @description: 显示缓冲池和磁盘IO的运行统计，先输出全局统计，再输出每个有访问的表和索引文件的统计
+ * 计数器由各线程分别累加，这里读取时汇总，不同计数器之间不是同一时刻的快照
+ * @param {Context*} context
+ */
+void SmManager::show_status(Context *context)
+{
+    auto fmt = [](double v)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.2f", v);
+        return std::string(buf);
+    };
+    auto hit_ratio = [&](const IoStats::Counters &c)
+    {
+        return c[STAT_FETCHES] ? fmt((double)c[STAT_HITS] / c[STAT_FETCHES]) : std::string("-");
+    };
+
+    std::vector<std::array<std::string, 3>> rows;
+    auto add_counters = [&](const std::string &scope, const IoStats::Counters &c)
+    {
+        rows.push_back({scope, "fetches", std::to_string(c[STAT_FETCHES])});
+        rows.push_back({scope, "hits", std::to_string(c[STAT_HITS])});
+        rows.push_back({scope, "misses", std::to_string(c[STAT_MISSES])});
+        rows.push_back({scope, "hit_ratio", hit_ratio(c)});
+        rows.push_back({scope, "evictions", std::to_string(c[STAT_EVICTIONS])});
+        rows.push_back({scope, "dirty_evictions", std::to_string(c[STAT_DIRTY_EVICTIONS])});
+        rows.push_back({scope, "pages_read", std::to_string(c[STAT_PAGES_READ])});
+        rows.push_back({scope, "pages_written", std::to_string(c[STAT_PAGES_WRITTEN])});
+        rows.push_back({scope, "bytes_read", std::to_string(c[STAT_BYTES_READ])});
+        rows.push_back({scope, "bytes_written", std::to_string(c[STAT_BYTES_WRITTEN])});
+    };
+
+    IoStats &io_stats = disk_manager_->io_stats();
+    BufferPoolStats bp = buffer_pool_manager_->get_stats();
+    rows.push_back({"global", "pool_size", std::to_string(bp.pool_size)});
+    rows.push_back({"global", "max_pool_size", std::to_string(bp.max_pool_size)});
+    rows.push_back({"global", "dirty_pages", std::to_string(bp.dirty_pages)});
+    rows.push_back({"global", "io_backend", disk_manager_->io_backend()});
+    add_counters("global", io_stats.total_counters());
+    rows.push_back({"global", "bgwriter_writes", std::to_string(bp.written_bgwriter)});
+    rows.push_back({"global", "eviction_writes", std::to_string(bp.written_eviction)});
+    rows.push_back({"global", "flush_writes", std::to_string(bp.written_flush)});
+    rows.push_back({"global", "wal_flush_waits", std::to_string(bp.wal_flush_waits)});
+    rows.push_back({"global", "alloc_rate", fmt(bp.alloc_rate)});
+    rows.push_back({"global", "bgwriter_rate", fmt(bp.bgwriter_rate)});
+    rows.push_back({"global", "clean_target", std::to_string(bp.clean_target)});
+
+    // 延迟直方图：百分位取所在桶的上界，再列出每个非空的桶
+    const std::pair<IoLatency, std::string> ops[] = {{LATENCY_READ, "read"}, {LATENCY_WRITE, "write"}};
+    for (auto &[op, name] : ops)
+    {
+        IoStats::Histogram hist = io_stats.latency_histogram(op);
+        rows.push_back({"global", name + "_p50_us", std::to_string(IoStats::percentile(hist, 50))});
+        rows.push_back({"global", name + "_p99_us", std::to_string(IoStats::percentile(hist, 99))});
+        for (int i = 0; i < IoStats::LATENCY_BUCKETS; i++)
+        {
+            if (hist[i] != 0)
+                rows.push_back({"global", name + "<=" + std::to_string(1ULL << i) + "us", std::to_string(hist[i])});
+        }
+    }
+
+    // 每个文件的统计，只输出打开之后有访问的文件
+    // 表文件同时输出空闲空间映射中还有空闲空间的页面数，索引文件为-1
+    std::vector<std::tuple<std::string, int, int>> files;
+    {
+        std::shared_lock lock(fhs_latch_);
+        for (auto &[name, fh] : fhs_)
+            files.emplace_back(name, fh->GetFd(), fh->get_free_space_map().free_pages());
+    }
+    {
+        std::shared_lock lock(ihs_latch_);
+        for (auto &[name, ih] : ihs_)
+            files.emplace_back(name, ih->get_fd(), -1);
+    }
+    std::sort(files.begin(), files.end());
+    for (auto &[name, fd, free_pages] : files)
+    {
+        IoStats::Counters c = io_stats.file_counters(fd);
+        if (c[STAT_FETCHES] == 0 && c[STAT_PAGES_READ] == 0 && c[STAT_PAGES_WRITTEN] == 0)
+            continue;
+        add_counters(name, c);
+        if (free_pages >= 0)
+            rows.push_back({name, "free_pages", std::to_string(free_pages)});
+    }
+
+    // 行数随表和索引的个数增长，不经过大小有限的data_send_，完整的名称也不截断
+    const std::vector<std::string> captions = {"Scope", "Name", "Value"};
+    std::vector<ColMeta> cols(captions.size());
+    int row_len = 0;
+    for (size_t i = 0; i < cols.size(); i++)
+    {
+        size_t width = captions[i].size();
+        for (auto &row : rows)
+            width = std::max(width, row[i].size());
+        cols[i].name = captions[i];
+        cols[i].type = TYPE_STRING;
+        cols[i].len = width;
+        cols[i].offset = row_len;
+        row_len += width;
+    }
+    if (context->frame_writer_ != nullptr)
+    {
+        // 二进制协议：按普通查询结果的格式逐行发送
+        std::vector<char> data(row_len);
+        context->frame_writer_->send_row_desc(captions, cols);
+        for (auto &row : rows)
+        {
+            std::fill(data.begin(), data.end(), '\0');
+            for (size_t i = 0; i < cols.size(); i++)
+                memcpy(data.data() + cols[i].offset, row[i].data(), row[i].size());
+            context->frame_writer_->send_row(cols, data.data());
+        }
+    }
+    else if (context->text_writer_ != nullptr)
+    {
+        // 文本协议：按每列最长的内容对齐，直接追加到会话的发送缓冲区
+        std::string separator;
+        for (auto &col : cols)
+            separator += "+" + std::string(col.len + 2, '-');
+        separator += "+\n";
+        auto append_row = [&](const std::vector<std::string> &row, std::string &out)
+        {
+            for (size_t i = 0; i < cols.size(); i++)
+                out += "| " + std::string(cols[i].len - row[i].size(), ' ') + row[i] + " ";
+            out += "|\n";
+        };
+        std::string text = separator;
+        append_row(captions, text);
+        text += separator;
+        for (auto &row : rows)
+            append_row({row[0], row[1], row[2]}, text);
+        text += separator;
+        context->text_writer_->put_bytes(text.data(), text.size());
+    }
+    else
+    {
+        RecordPrinter printer(3);
+        printer.print_separator(context);
+        printer.print_record(captions, context);
+        printer.print_separator(context);
+        for (auto &row : rows)
+            printer.print_record({row[0], row[1], row[2]}, context);
+        printer.print_separator(context);
+    }
+
+    if (io_enabled_)
+    {
+        std::fstream outfile("output.txt", std::ios::out | std::ios::app);
+        if (outfile.is_open())
+        {
+            outfile << "| Scope | Name | Value |\n";
+            for (auto &row : rows)
+                outfile << "| " << row[0] << " | " << row[1] << " | " << row[2] << " |\n";
+        }
+    }
+}
+
 /**
  * @description: 显示表的元数据
  * @param {string&} tab_name 表名称
@@ -245,8 +417,10 @@ void SmManager::desc_table(const std::string &tab_name, Context *context)
  * @param {string&} tab_name 表的名称
  * @param {vector<ColDef>&} col_defs 表的字段
  * @param {Context*} context
+ * @param {bool} slotted 是否使用变长格式存储，字符串列只保存实际长度的内容
  */
-void SmManager::create_table(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context)
+void SmManager::create_table(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context,
+                             bool slotted)
 {
     if (db_.is_table(tab_name))
     {
@@ -295,7 +469,16 @@ void SmManager::create_table(const std::string &tab_name, const std::vector<ColD
     }
 
     // Create & open record file
-    rm_manager_->create_file(tab_name, curr_offset);
+    RmFormatHdr format{};
+    if (slotted)
+    {
+        // 长度超过2字节的字符串列变长存储，超过RM_MAX_VAR_COLS的列保持定长
+        format.format = RM_FORMAT_SLOTTED;
+        for (auto &col : tab.cols)
+            if (col.type == TYPE_STRING && col.len > (int)sizeof(uint16_t) && format.num_var_cols < RM_MAX_VAR_COLS)
+                format.var_cols[format.num_var_cols++] = RmVarCol{col.offset, col.len};
+    }
+    rm_manager_->create_file(tab_name, curr_offset, &format);
 
     {
         std::lock_guard lock(fhs_latch_);
@@ -303,6 +486,8 @@ void SmManager::create_table(const std::string &tab_name, const std::vector<ColD
     }
     db_.tabs_.emplace(std::move(tab_name), std::move(tab));
 
+    schema_version_.fetch_add(1, std::memory_order_release);
+
     flush_meta();
 }
 
@@ -343,6 +528,8 @@ void SmManager::drop_table(const std::string &tab_name, Context *context)
         fhs_.erase(record_iter);
     }
 
+    schema_version_.fetch_add(1, std::memory_order_release);
+
     flush_meta();
 }
 
@@ -377,10 +564,11 @@ void SmManager::create_index(const std::string &tab_name, const std::vector<std:
 
     // 向索引中插入表中已有数据
     auto insert_data = std::make_unique<char[]>(tot_col_len);
-    for (RmScan_Final rmScan(fh_, context); !rmScan.is_end(); rmScan.next_batch())
+    RmScan_Final rmScan(fh_, context, true);
+    while (rmScan.load_view())
     {
         auto rids = rmScan.rid_batch();
-        auto records = rmScan.record_batch();
+        auto &records = rmScan.view_records();
         for (size_t id = 0; id < rids.size(); ++id)
         {
             auto &rid = rids[id];
@@ -388,7 +576,7 @@ void SmManager::create_index(const std::string &tab_name, const std::vector<std:
             int offset = 0;
             for (auto &col : cols)
             {
-                std::memcpy(insert_data.get() + offset, record->data + col.offset, col.len);
+                std::memcpy(insert_data.get() + offset, record.data + col.offset, col.len);
                 offset += col.len;
             }
             try
@@ -408,6 +596,8 @@ void SmManager::create_index(const std::string &tab_name, const std::vector<std:
 
     tab.indexes.emplace_back(tab_name, tot_col_len, static_cast<int>(cols.size()), cols);
 
+    schema_version_.fetch_add(1, std::memory_order_release);
+
     flush_meta();
 }
 
@@ -439,6 +629,8 @@ void SmManager::drop_index(const std::string &tab_name, const std::vector<std::s
     auto &tab = db_.get_table(tab_name);
     tab.indexes.erase(tab.get_index_meta(col_names));
 
+    schema_version_.fetch_add(1, std::memory_order_release);
+
     flush_meta();
 }
 
@@ -466,6 +658,8 @@ void SmManager::drop_index(const std::string &tab_name, const std::vector<ColMet
     auto &tab = db_.get_table(tab_name);
     tab.indexes.erase(tab.get_index_meta(cols));
 
+    schema_version_.fetch_add(1, std::memory_order_release);
+
     flush_meta();
 }
 
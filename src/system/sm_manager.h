@@ -9,6 +9,7 @@ MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
 See the Mulan PSL v2 for more details. */
 
 #pragma once
+#include <atomic>
 #include <thread>
 #include <queue>
 #include <mutex>
@@ -117,6 +118,7 @@ private:
     IxManager *ix_manager_;
     std::shared_mutex fhs_latch_; // 保护fhs_的读写锁，保证对文件句柄的并发访问安全
     std::shared_mutex ihs_latch_; // 保护ihs_的读写锁，保证对索引句柄的并发访问安全
+    std::atomic<uint64_t> schema_version_{0}; // 表和索引定义的版本号，每次DDL后递增
     struct DataChunk
     {
         std::unique_ptr<char[]> data;
@@ -228,6 +230,9 @@ public:
 
     IxManager *get_ix_manager() { return ix_manager_; }
 
+    // 缓存的执行计划通过比较版本号判断表或索引是否已经被修改
+    uint64_t schema_version() const { return schema_version_.load(std::memory_order_acquire); }
+
     inline std::shared_ptr<IxIndexHandle> get_index_handle(const std::string &index_name)
     {
         std::shared_lock lock(ihs_latch_);
@@ -264,9 +269,12 @@ public:
 
     void show_tables(Context *context);
 
+    void show_status(Context *context);
+
     void desc_table(const std::string &tab_name, Context *context);
 
-    void create_table(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context);
+    void create_table(const std::string &tab_name, const std::vector<ColDef> &col_defs, Context *context,
+                      bool slotted = false);
 
     void drop_table(const std::string &tab_name, Context *context);
 
@@ -231,6 +231,7 @@ class DbMeta {
     std::string name_;                      // 数据库名称
     std::map<std::string, TabMeta> tabs_;   // 数据库中包含的表
     txn_id_t start_txn_id_ = 0;
+    size_t page_size_ = PAGE_SIZE;          // 创建数据库时的页面大小
 
 public:
     // DbMeta(std::string name) : name_(name) {}
@@ -262,6 +263,7 @@ public:
             os << entry.second << '\n';
         }
         os << db_meta.start_txn_id_ << '\n';
+        os << db_meta.page_size_ << '\n';
         return os;
     }
 
@@ -274,6 +276,12 @@ public:
             db_meta.tabs_.emplace(tab.name, std::move(tab));
         }
         is >> db_meta.start_txn_id_;
+        // 旧版本的db.meta没有记录页面大小，只可能是4KB
+        if (!(is >> db_meta.page_size_))
+        {
+            db_meta.page_size_ = 4096;
+            is.clear();
+        }
         return is;
     }
 };
@@ -50,6 +50,8 @@ public:
   inline txn_id_t get_transaction_id() { return txn_id_; }
 
   inline std::thread::id get_thread_id() { return thread_id_; }
+  // 会话可能被不同的工作线程处理，显式事务的后续语句需要重新绑定当前线程
+  inline void set_thread_id(std::thread::id thread_id) { thread_id_ = thread_id; }
 
   inline void set_txn_mode(bool txn_mode) { txn_mode_ = txn_mode; }
   inline bool get_txn_mode() { return txn_mode_; }
@@ -69,13 +69,15 @@ void TransactionManager::commit(Context *context, LogManager *log_manager)
     // 5. 更新事务状态
     // 如果需要支持MVCC请在上述过程中添加代码
     auto write_set = txn->get_write_set();
+    auto write_index_set = txn->get_write_index_set();
+    // 只读事务不需要等待日志持久化
+    bool has_writes = !write_set->empty() || !write_index_set->empty();
     for (auto write : *write_set)
     {
         delete write;
     }
     write_set->clear(); // 清空写集
 
-    auto write_index_set = txn->get_write_index_set();
     for (auto write : *write_index_set)
     {
         delete write;
@@ -98,8 +100,10 @@ void TransactionManager::commit(Context *context, LogManager *log_manager)
     if (log_manager != nullptr)
     {
         CommitLogRecord log_record(context->txn_->get_transaction_id());
-        log_manager->add_log_to_buffer(&log_record);
-        // log_manager->flush_log_to_disk();
+        lsn_t commit_lsn = log_manager->add_log_to_buffer(&log_record);
+        // 组提交：等待刷盘线程把包含提交日志的这一批日志持久化
+        if (has_writes)
+            log_manager->wait_for_flush(commit_lsn);
     }
 
     // 5. 更新事务状态为已提交
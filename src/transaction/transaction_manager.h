@@ -65,6 +65,8 @@ public:
         {
             delete pair.second; // 删除事务对象
         }
+        // 事务表是静态的，清空后同一进程中之后创建的TransactionManager不会看到已经删除的事务
+        txn_map.clear();
     }
 
     Transaction *begin(Transaction *txn, LogManager *log_manager);
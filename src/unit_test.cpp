@@ -17,24 +17,51 @@ See the Mulan PSL v2 for more details. */
 
 #undef private
 
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <csignal>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
 #include <random>
 #include <set>
+#include <sstream>
 #include <string>
 #include <thread> // NOLINT
 #include <unordered_map>
 #include <vector>
 
+#include "analyze/analyze.h"
 #include "gtest/gtest.h"
+#include "index/ix.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/plan_cache.h"
+#include "optimizer/planner.h"
+#include "portal.h"
+#include "record/bitmap.h"
+#include "record/rm_file_handle_final.h"
+#include "record/rm_free_space_map.h"
+#include "record/rm_manager_final.h"
+#include "recovery/log_recovery.h"
+#include "replacer/lru_k_replacer_final.h"
 #include "replacer/lru_replacer.h"
 #include "storage/disk_manager.h"
+#include "transaction/transaction_manager.h"
+#include "wire_protocol.h"
 
 const std::string TEST_DB_NAME = "BufferPoolManagerTest_db"; // 以数据库名作为根目录
 const std::string TEST_FILE_NAME = "basic";                  // 测试文件的名字
@@ -258,6 +285,56 @@ TEST(LRUReplacerTest, SampleTest)
     EXPECT_EQ(4, value);
 }
 
+TEST(LRUKReplacerTest, SampleTest)
+{
+    LRUKReplacer_Final lru_k_replacer(64, 2);
+
+    // Scenario: frames accessed once. 2 and 17 live in different shards but are evicted in first-access order.
+    lru_k_replacer.unpin(2);
+    lru_k_replacer.unpin(17);
+    lru_k_replacer.unpin(1);
+    // Scenario: frames 3 and 4 are accessed twice, their 2nd most recent accesses are at t4 and t6.
+    lru_k_replacer.unpin(3);
+    lru_k_replacer.pin(3);
+    lru_k_replacer.unpin(3);
+    lru_k_replacer.unpin(4);
+    lru_k_replacer.pin(4);
+    lru_k_replacer.unpin(4);
+    // Scenario: access 3 twice more, its 2nd most recent access moves after that of 4.
+    lru_k_replacer.pin(3);
+    lru_k_replacer.unpin(3);
+    lru_k_replacer.pin(3);
+    lru_k_replacer.unpin(3);
+    EXPECT_EQ(5, lru_k_replacer.Size());
+
+    // Scenario: frames with fewer than K accesses go first, then the K-distance order across all shards.
+    int value;
+    std::vector<int> victims;
+    while (lru_k_replacer.victim(&value))
+        victims.push_back(value);
+    EXPECT_EQ((std::vector<int>{2, 17, 1, 4, 3}), victims);
+    EXPECT_EQ(0, lru_k_replacer.Size());
+
+    // Scenario: with K = 3 a second access does not move a frame in the history queue.
+    LRUKReplacer_Final lru_3_replacer(64, 3);
+    lru_3_replacer.unpin(5);
+    lru_3_replacer.unpin(6);
+    lru_3_replacer.pin(5);
+    lru_3_replacer.unpin(5);
+    // Scenario: a frame released at low priority is evicted before everything else, pinned frames never.
+    lru_3_replacer.unpin_low_priority(7);
+    lru_3_replacer.unpin(8);
+    lru_3_replacer.pin(8);
+    EXPECT_EQ(3, lru_3_replacer.Size());
+    lru_3_replacer.victim(&value);
+    EXPECT_EQ(7, value);
+    lru_3_replacer.victim(&value);
+    EXPECT_EQ(5, value);
+    lru_3_replacer.victim(&value);
+    EXPECT_EQ(6, value);
+    EXPECT_FALSE(lru_3_replacer.victim(&value));
+}
+
 /** 注意：每个测试点只测试了单个文件！
  * 对于每个测试点，先创建和进入目录TEST_DB_NAME
  * 然后在此目录下创建和打开文件TEST_FILE_NAME，记录其文件描述符fd */
@@ -751,3 +828,2035 @@ TEST(RecordManagerTest, SimpleTest)
     rm_manager->close_file(file_handle.get());
     rm_manager->destroy_file(filename);
 }
+
+/**
+ * @brief 在随机bitmap上比较按64位一次扫描的next_bit、set_bits、count与逐位扫描的结果，
+ * 长度包括不是64的倍数的情况，bitmap只分配(max_n+7)/8个字节
+ */
+TEST(BitmapTest, WordScanTest)
+{
+    std::mt19937 rng(12345);
+    std::vector<int> lengths = {1, 7, 8, 9, 63, 64, 65, 127, 128, 129, 191, 200, 1000, 4095};
+    for (int i = 0; i < 50; i++)
+    {
+        lengths.push_back(1 + rng() % 2048);
+    }
+    for (int max_n : lengths)
+    {
+        // 密度从全0到全1
+        for (int density : {0, 1, 50, 99, 100})
+        {
+            std::vector<char> bm((max_n + BITMAP_WIDTH - 1) / BITMAP_WIDTH);
+            Bitmap::init(bm.data(), bm.size());
+            for (int pos = 0; pos < max_n; pos++)
+            {
+                if ((int)(rng() % 100) < density)
+                    Bitmap::set(bm.data(), pos);
+            }
+            // 最后一个字节中max_n之后的位也置1，扫描结果不能受它们影响
+            for (int pos = max_n; pos < (int)bm.size() * BITMAP_WIDTH; pos++)
+            {
+                Bitmap::set(bm.data(), pos);
+            }
+
+            std::vector<int> expect;
+            for (int pos = 0; pos < max_n; pos++)
+            {
+                if (Bitmap::is_set(bm.data(), pos))
+                    expect.push_back(pos);
+            }
+            std::vector<int> out(max_n);
+            int n = Bitmap::set_bits(bm.data(), max_n, out.data());
+            out.resize(n);
+            EXPECT_EQ(out, expect) << "max_n " << max_n;
+            EXPECT_EQ(Bitmap::count(bm.data(), max_n), (int)expect.size()) << "max_n " << max_n;
+
+            for (bool bit : {false, true})
+            {
+                for (int curr = -1; curr < max_n; curr++)
+                {
+                    int ref = curr + 1;
+                    while (ref < max_n && Bitmap::is_set(bm.data(), ref) != bit)
+                        ref++;
+                    ASSERT_EQ(Bitmap::next_bit(bit, bm.data(), max_n, curr), ref)
+                        << "max_n " << max_n << " bit " << bit << " curr " << curr;
+                }
+                EXPECT_EQ(Bitmap::first_bit(bit, bm.data(), max_n), Bitmap::next_bit(bit, bm.data(), max_n, -1));
+            }
+        }
+    }
+}
+
+// 分级0表示已满；分级高于bucket_of(n)的页面一定有n的空闲空间
+TEST(FreeSpaceMapTest, BucketTest)
+{
+    for (int capacity : {1, 7, 31, 32, 33, 100, 4000})
+    {
+        RmFreeSpaceMap fsm(capacity);
+        EXPECT_EQ(fsm.bucket_of(-1), 0);
+        EXPECT_EQ(fsm.bucket_of(0), 0);
+        EXPECT_EQ(fsm.bucket_of(1), 1);
+        // 容量小于分级数时空页面达不到最高的分级
+        if (capacity >= RmFreeSpaceMap::NUM_BUCKETS)
+        {
+            EXPECT_EQ(fsm.bucket_of(capacity), RmFreeSpaceMap::NUM_BUCKETS - 1);
+        }
+        for (int free_space = 1; free_space <= capacity; free_space++)
+        {
+            EXPECT_GE(fsm.bucket_of(free_space), fsm.bucket_of(free_space - 1));
+            EXPECT_LT(fsm.bucket_of(free_space), RmFreeSpaceMap::NUM_BUCKETS);
+        }
+        for (int need = 1; need <= capacity; need++)
+        {
+            for (int free_space = 0; free_space <= capacity; free_space++)
+            {
+                if (fsm.bucket_of(free_space) > fsm.bucket_of(need))
+                {
+                    ASSERT_GE(free_space, need) << "capacity " << capacity;
+                }
+            }
+        }
+    }
+}
+
+// update()维护每64个页面一个的has_space位图，claim()按位图跳过已满的页面和其他槽位的目标页面
+TEST(FreeSpaceMapTest, HasSpaceTest)
+{
+    const int capacity = 100;
+    RmFreeSpaceMap fsm(capacity);
+    EXPECT_EQ(fsm.claim(0), RM_NO_PAGE);
+
+    // 跨过64个页面的字边界和CHUNK_PAGES的块边界
+    std::vector<int> pages = {1, 63, 64, 65, 127, 128, RmFreeSpaceMap::CHUNK_PAGES - 1, RmFreeSpaceMap::CHUNK_PAGES,
+                              RmFreeSpaceMap::CHUNK_PAGES + 1};
+    for (int page_no : pages)
+    {
+        fsm.update(page_no, capacity);
+        EXPECT_TRUE(fsm.has_space(page_no));
+        EXPECT_EQ(fsm.bucket(page_no), RmFreeSpaceMap::NUM_BUCKETS - 1);
+    }
+    EXPECT_EQ(fsm.free_pages(), (int)pages.size());
+    EXPECT_FALSE(fsm.has_space(2));
+    EXPECT_FALSE(fsm.has_space(-1));
+
+    // 分级变化但仍有空闲空间时位图不变，变为已满时清除对应的位
+    fsm.update(64, 1);
+    EXPECT_TRUE(fsm.has_space(64));
+    EXPECT_EQ(fsm.free_pages(), (int)pages.size());
+    for (int page_no : pages)
+    {
+        fsm.update(page_no, 0);
+        EXPECT_FALSE(fsm.has_space(page_no));
+    }
+    EXPECT_EQ(fsm.free_pages(), 0);
+    for (int slot = 0; slot < RmFreeSpaceMap::TARGET_SLOTS; slot++)
+        EXPECT_EQ(fsm.claim(slot), RM_NO_PAGE);
+
+    // 超出管理范围的页面视为已满
+    fsm.update(-1, capacity);
+    fsm.update(RmFreeSpaceMap::CHUNK_PAGES * RmFreeSpaceMap::MAX_CHUNKS, capacity);
+    EXPECT_EQ(fsm.free_pages(), 0);
+
+    // 每个槽位选到不同的页面
+    fsm.update(5, capacity);
+    fsm.update(70, 10);
+    fsm.update(RmFreeSpaceMap::CHUNK_PAGES + 3, capacity);
+    EXPECT_EQ(fsm.claim(0), 5);
+    EXPECT_EQ(fsm.claim(1), 70);
+    EXPECT_EQ(fsm.claim(2), RmFreeSpaceMap::CHUNK_PAGES + 3);
+    EXPECT_EQ(fsm.claim(3), RM_NO_PAGE);
+    EXPECT_EQ(fsm.target(1), 70);
+
+    // 分级不够的页面被跳过
+    fsm.set_target(0, RM_NO_PAGE);
+    fsm.set_target(2, RM_NO_PAGE);
+    EXPECT_EQ(fsm.claim(3, fsm.bucket_of(50) + 1), 5);
+    EXPECT_EQ(fsm.claim(4, fsm.bucket_of(50) + 1), RmFreeSpaceMap::CHUNK_PAGES + 3);
+    EXPECT_EQ(fsm.claim(5, fsm.bucket_of(50) + 1), RM_NO_PAGE);
+
+    // 目标页面满了之后从它开始向后查找，到末尾后回到开头
+    fsm.update(70, 0);
+    fsm.set_target(3, RM_NO_PAGE);
+    fsm.set_target(4, RM_NO_PAGE);
+    EXPECT_EQ(fsm.claim(1), RmFreeSpaceMap::CHUNK_PAGES + 3);
+    fsm.update(RmFreeSpaceMap::CHUNK_PAGES + 3, 0);
+    EXPECT_EQ(fsm.claim(1), 5);
+}
+
+// save()保存每个页面的分级，load()只接受页面数和容量都一致的完整文件
+TEST(FreeSpaceMapTest, SaveLoadTest)
+{
+    const int capacity = 37;
+    const int num_pages = 3 * RmFreeSpaceMap::CHUNK_PAGES / 2;
+    const std::string path = "fsm_save_test.fsm";
+    std::mt19937 rng(2024);
+    RmFreeSpaceMap fsm(capacity);
+    for (int page_no = RM_FIRST_RECORD_PAGE; page_no < num_pages; page_no++)
+        fsm.update(page_no, rng() % (capacity + 1));
+    fsm.save(path, num_pages);
+
+    RmFreeSpaceMap loaded(capacity);
+    ASSERT_TRUE(loaded.load(path, num_pages));
+    for (int page_no = 0; page_no < num_pages; page_no++)
+        ASSERT_EQ(loaded.bucket(page_no), fsm.bucket(page_no)) << "page " << page_no;
+    EXPECT_EQ(loaded.free_pages(), fsm.free_pages());
+
+    RmFreeSpaceMap other(capacity);
+    EXPECT_FALSE(other.load(path, num_pages + 1));
+    RmFreeSpaceMap other_capacity(capacity + 1);
+    EXPECT_FALSE(other_capacity.load(path, num_pages));
+    EXPECT_FALSE(other.load(path + ".missing", num_pages));
+
+    // 截断的文件
+    std::ifstream ifs(path, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(content.data(), content.size() - 1);
+    RmFreeSpaceMap truncated(capacity);
+    EXPECT_FALSE(truncated.load(path, num_pages));
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief 表文件正常关闭时保存<表名>.fsm，再次打开时读入并删除它；
+ * 文件不存在（系统崩溃后）时从页头重建，两种方式得到的分级都与页头中的记录数一致
+ */
+TEST(FreeSpaceMapTest, FileHandleTest)
+{
+    const std::string filename = "fsm_test.tbl";
+    const std::string fsm_path = filename + ".fsm";
+    auto disk_manager = std::make_unique<DiskManager_Final>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(64, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager_Final>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(filename))
+        disk_manager->destroy_file(filename);
+    std::remove(fsm_path.c_str());
+
+    const int record_size = 100;
+    rm_manager->create_file(filename, record_size);
+    auto file_handle = rm_manager->open_file(filename);
+    int per_page = file_handle->get_file_hdr().num_records_per_page;
+
+    // 插入10页多的记录，再删掉一部分，让页面的空闲程度各不相同
+    std::mt19937 rng(7);
+    char buf[record_size];
+    std::vector<Rid> rids;
+    for (int i = 0; i < per_page * 10 + per_page / 2; i++)
+    {
+        rand_buf(record_size, buf);
+        rids.push_back(file_handle->insert_record(buf, nullptr));
+    }
+    for (auto &rid : rids)
+    {
+        if ((int)(rng() % per_page) < rid.page_no * per_page / 12)
+            file_handle->recovery_delete_record(rid);
+    }
+
+    // 分级与页头中的记录数一致
+    auto check_headers = [&](const std::shared_ptr<RmFileHandle_Final> &handle)
+    {
+        const RmFreeSpaceMap &fsm = handle->get_free_space_map();
+        int free_pages = 0;
+        for (int page_no = RM_FIRST_RECORD_PAGE; page_no < handle->get_page_num(); page_no++)
+        {
+            RmPageHandle_FInal page_handle = handle->fetch_page_handle(page_no);
+            int free_space = per_page - page_handle.page_hdr->num_records;
+            buffer_pool_manager->unpin_page(page_handle.page->get_page_id(), false);
+            EXPECT_EQ(fsm.bucket(page_no), fsm.bucket_of(free_space)) << "page " << page_no;
+            free_pages += free_space > 0;
+        }
+        EXPECT_EQ(fsm.free_pages(), free_pages);
+    };
+    check_headers(file_handle);
+    int num_pages = file_handle->get_page_num();
+    std::vector<int> buckets(num_pages);
+    for (int page_no = 0; page_no < num_pages; page_no++)
+        buckets[page_no] = file_handle->get_free_space_map().bucket(page_no);
+
+    // 正常关闭后读入保存的映射
+    file_handle.reset();
+    ASSERT_TRUE(disk_manager->is_file(fsm_path));
+    file_handle = rm_manager->open_file(filename);
+    EXPECT_FALSE(disk_manager->is_file(fsm_path));
+    ASSERT_EQ(file_handle->get_page_num(), num_pages);
+    for (int page_no = 0; page_no < num_pages; page_no++)
+        EXPECT_EQ(file_handle->get_free_space_map().bucket(page_no), buckets[page_no]) << "page " << page_no;
+
+    // 没有保存的映射时从页头重建
+    file_handle.reset();
+    ASSERT_TRUE(disk_manager->is_file(fsm_path));
+    disk_manager->destroy_file(fsm_path);
+    file_handle = rm_manager->open_file(filename);
+    for (int page_no = 0; page_no < num_pages; page_no++)
+        EXPECT_EQ(file_handle->get_free_space_map().bucket(page_no), buckets[page_no]) << "page " << page_no;
+    check_headers(file_handle);
+
+    // 保存的映射与文件的页面数不一致时也从页头重建
+    rand_buf(record_size, buf);
+    file_handle->insert_record(buf, nullptr);
+    file_handle.reset();
+    RmFreeSpaceMap stale(per_page);
+    stale.save(fsm_path, num_pages + 100);
+    file_handle = rm_manager->open_file(filename);
+    EXPECT_FALSE(disk_manager->is_file(fsm_path));
+    check_headers(file_handle);
+
+    file_handle.reset();
+    disk_manager->destroy_file(fsm_path);
+    rm_manager->destroy_file(filename);
+}
+
+TEST(BufferPoolManagerFinalTest, DeletePageTest)
+{
+    const std::string filename = "delete_page_test.tbl";
+    auto disk_manager = std::make_unique<DiskManager_Final>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(16, disk_manager.get());
+    if (disk_manager->is_file(filename))
+        disk_manager->destroy_file(filename);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+
+    // 新建4个脏页，删除其中2个
+    std::vector<PageId_Final> page_ids(4);
+    for (auto &page_id : page_ids)
+    {
+        page_id.fd = fd;
+        Page_Final *page = buffer_pool_manager->new_page(&page_id);
+        ASSERT_NE(page, nullptr);
+        memset(page->get_data(), 'a' + page_id.page_no, PAGE_SIZE);
+        buffer_pool_manager->unpin_page(page_id, true);
+    }
+    EXPECT_EQ(buffer_pool_manager->get_stats().dirty_pages, 4u);
+    EXPECT_TRUE(buffer_pool_manager->delete_page(page_ids[0]));
+    EXPECT_TRUE(buffer_pool_manager->delete_page(page_ids[2]));
+    EXPECT_EQ(buffer_pool_manager->get_stats().dirty_pages, 2u);
+
+    // 被固定的页面不能删除
+    ASSERT_NE(buffer_pool_manager->fetch_page(page_ids[1]), nullptr);
+    EXPECT_FALSE(buffer_pool_manager->delete_page(page_ids[1]));
+    buffer_pool_manager->unpin_page(page_ids[1], false);
+
+    // 关闭文件时只写回没有删除的页面，文件关闭后析构缓冲池也不会再写这个文件
+    buffer_pool_manager->remove_all_pages(fd, true);
+    EXPECT_EQ(buffer_pool_manager->get_stats().written_flush, 2u);
+    EXPECT_EQ(buffer_pool_manager->get_stats().dirty_pages, 0u);
+    disk_manager->close_file(fd);
+    EXPECT_NO_THROW(buffer_pool_manager.reset());
+
+    disk_manager->destroy_file(filename);
+}
+
+TEST(BufferPoolManagerFinalTest, ResizeTest)
+{
+    const std::string filename = "resize_test.tbl";
+    const size_t pool_size = 8, max_pool_size = 32;
+    auto disk_manager = std::make_unique<DiskManager_Final>();
+    auto buffer_pool_manager =
+        std::make_unique<BufferPoolManager_Final>(pool_size, disk_manager.get(), max_pool_size);
+    if (disk_manager->is_file(filename))
+        disk_manager->destroy_file(filename);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+    auto frame_of = [&](Page_Final *page)
+    { return (frame_id_t)(page - buffer_pool_manager->pages_.data()); };
+
+    // 填满缓冲池，超出新大小的帧上的页面保持固定并且是脏页
+    std::vector<PageId_Final> page_ids(pool_size);
+    std::vector<Page_Final *> pinned;
+    for (auto &page_id : page_ids)
+    {
+        page_id.fd = fd;
+        Page_Final *page = buffer_pool_manager->new_page(&page_id);
+        ASSERT_NE(page, nullptr);
+        memset(page->get_data(), 'a' + page_id.page_no, PAGE_SIZE);
+        if ((size_t)frame_of(page) < pool_size / 2)
+        {
+            buffer_pool_manager->unpin_page(page_id, true);
+            continue;
+        }
+        ASSERT_EQ(buffer_pool_manager->fetch_page(page_id), page);
+        buffer_pool_manager->unpin_page(page_id, true);
+        pinned.push_back(page);
+    }
+    ASSERT_EQ(pinned.size(), pool_size / 2);
+
+    // 被固定的帧不能退役，留在等待退役的列表中，页面内容不受影响
+    buffer_pool_manager->resize(pool_size / 2);
+    EXPECT_EQ(buffer_pool_manager->get_pool_size(), pool_size / 2);
+    buffer_pool_manager->retire_pending_frames();
+    {
+        std::lock_guard lock(buffer_pool_manager->resize_mutex_);
+        EXPECT_EQ(buffer_pool_manager->retiring_.size(), pinned.size());
+        for (auto *page : pinned)
+            EXPECT_FALSE(buffer_pool_manager->retired_[frame_of(page)]);
+    }
+    for (auto *page : pinned)
+        EXPECT_EQ(page->get_data()[0], 'a' + page->get_page_id().page_no);
+
+    // 取消固定后帧被写回并退役
+    for (auto *page : pinned)
+        buffer_pool_manager->unpin_page(page->get_page_id(), false);
+    buffer_pool_manager->retire_pending_frames();
+    {
+        std::lock_guard lock(buffer_pool_manager->resize_mutex_);
+        EXPECT_TRUE(buffer_pool_manager->retiring_.empty());
+        for (auto *page : pinned)
+        {
+            EXPECT_TRUE(buffer_pool_manager->retired_[frame_of(page)]);
+            EXPECT_EQ(page->get_page_id().fd, -1);
+            EXPECT_FALSE(page->is_dirty());
+        }
+    }
+
+    // 缩小后的缓冲池轮流装入所有页面，退役时写回的页面没有丢失
+    for (auto &page_id : page_ids)
+    {
+        Page_Final *page = buffer_pool_manager->fetch_page(page_id);
+        ASSERT_NE(page, nullptr);
+        EXPECT_LT((size_t)frame_of(page), pool_size / 2);
+        EXPECT_EQ(page->get_data()[0], 'a' + page_id.page_no);
+        EXPECT_EQ(page->get_data()[PAGE_SIZE - 1], 'a' + page_id.page_no);
+        buffer_pool_manager->unpin_page(page_id, false);
+    }
+
+    // 扩大到超过创建时的大小，最多可以同时固定max_pool_size个页面
+    EXPECT_THROW(buffer_pool_manager->resize(max_pool_size + 1), InternalError);
+    buffer_pool_manager->resize(max_pool_size);
+    EXPECT_EQ(buffer_pool_manager->get_pool_size(), max_pool_size);
+    std::vector<PageId_Final> grown_ids;
+    for (size_t i = 0; i < max_pool_size; i++)
+    {
+        PageId_Final page_id{.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page_Final *page = i < page_ids.size() ? buffer_pool_manager->fetch_page(page_id = page_ids[i])
+                                               : buffer_pool_manager->new_page(&page_id);
+        ASSERT_NE(page, nullptr);
+        if (i < page_ids.size())
+        {
+            EXPECT_EQ(page->get_data()[0], 'a' + page_id.page_no);
+        }
+        grown_ids.push_back(page_id);
+    }
+    PageId_Final extra_id{.fd = fd, .page_no = INVALID_PAGE_ID};
+    EXPECT_EQ(buffer_pool_manager->new_page(&extra_id), nullptr);
+    for (auto &page_id : grown_ids)
+        buffer_pool_manager->unpin_page(page_id, false);
+
+    buffer_pool_manager->remove_all_pages(fd, true);
+    disk_manager->close_file(fd);
+    buffer_pool_manager.reset();
+    disk_manager->destroy_file(filename);
+}
+
+TEST(BufferPoolManagerFinalTest, BgwriterTest)
+{
+    const std::string filename = "bgwriter_test.tbl";
+    const size_t pool_size = 16;
+    auto disk_manager = std::make_unique<DiskManager_Final>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(pool_size, disk_manager.get());
+    if (disk_manager->is_file(filename))
+        disk_manager->destroy_file(filename);
+    disk_manager->create_file(filename);
+    int fd = disk_manager->open_file(filename);
+
+    // 停止后台写线程，由测试直接执行每一轮
+    buffer_pool_manager->terminate_ = true;
+    buffer_pool_manager->flush_cond_.notify_all();
+    buffer_pool_manager->flush_thread_.join();
+    buffer_pool_manager->terminate_ = false;
+
+    // 所有帧都是没有被固定的脏页，前一半的引用位已清除
+    std::vector<PageId_Final> frame_pages(pool_size);
+    for (size_t i = 0; i < pool_size; i++)
+    {
+        PageId_Final page_id{.fd = fd, .page_no = INVALID_PAGE_ID};
+        Page_Final *page = buffer_pool_manager->new_page(&page_id);
+        ASSERT_NE(page, nullptr);
+        size_t fid = page - buffer_pool_manager->pages_.data();
+        frame_pages[fid] = page_id;
+        buffer_pool_manager->unpin_page(page_id, true, fid < pool_size / 2);
+    }
+
+    // 从时钟指针开始收集，引用位已清除的脏页写回后可以复用，预留够了就停止
+    buffer_pool_manager->clock_hand_ = 4;
+    std::vector<frame_id_t> batch;
+    EXPECT_EQ(buffer_pool_manager->collect_dirty_pages(batch, 3, 0, pool_size), 3u);
+    EXPECT_EQ(batch, (std::vector<frame_id_t>{4, 5, 6}));
+
+    // 被固定的帧既不写回也不计入预留
+    ASSERT_NE(buffer_pool_manager->fetch_page(frame_pages[5]), nullptr);
+    batch.clear();
+    EXPECT_EQ(buffer_pool_manager->collect_dirty_pages(batch, 3, 0, pool_size), 3u);
+    EXPECT_EQ(batch, (std::vector<frame_id_t>{4, 6, 7}));
+    batch.clear();
+    EXPECT_EQ(buffer_pool_manager->collect_dirty_pages(batch, 0, 0, pool_size), 0u);
+    EXPECT_TRUE(batch.empty());
+
+    // 分配了16个帧，干净帧目标为缓冲池的1/4。引用位被设置的帧不计入预留，要扫过它们到帧0才凑够4个
+    double lookahead = 2.0;
+    uint64_t last_alloc = 0, last_eviction = 0;
+    EXPECT_EQ(buffer_pool_manager->bgwriter_round(lookahead, last_alloc, last_eviction, false), 12u);
+    EXPECT_EQ(buffer_pool_manager->get_stats().clean_target, pool_size / 4);
+    for (size_t fid = 0; fid < pool_size; fid++)
+        EXPECT_EQ(buffer_pool_manager->pages_[fid].is_dirty(), (fid >= 1 && fid <= 3) || fid == 5) << "frame " << fid;
+    buffer_pool_manager->unpin_page(frame_pages[5], false);
+
+    buffer_pool_manager->remove_all_pages(fd, true);
+    disk_manager->close_file(fd);
+    buffer_pool_manager.reset();
+    disk_manager->destroy_file(filename);
+}
+
+TEST(IndexTest, GetValueTest)
+{
+    const std::string filename = "ix_lookup_test";
+    std::vector<ColMeta> cols = {ColMeta{.tab_name = filename, .name = "k", .type = TYPE_INT, .len = sizeof(int), .offset = 0}};
+    auto disk_manager = std::make_unique<DiskManager_Final>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(64, disk_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(ix_manager->get_index_name(filename, cols)))
+        ix_manager->destroy_index(filename, cols);
+    ix_manager->create_index(filename, cols);
+    auto ih = ix_manager->open_index(filename, cols);
+    Transaction txn(0, nullptr);
+
+    // 只插入偶数键，多到需要分裂出若干层
+    const int num_keys = 4000;
+    for (int key = 0; key < num_keys; key += 2)
+        ih->insert_entry(reinterpret_cast<const char *>(&key), Rid{key / 100 + 1, key % 100}, &txn, true);
+
+    // 存在的键返回插入时的rid，不存在的键（包括比所有键都大的键）返回false
+    auto check = [&](int key, bool expect)
+    {
+        Rid rid{-1, -1};
+        bool exist = ih->get_value(reinterpret_cast<const char *>(&key), &rid, &txn);
+        EXPECT_EQ(exist, expect) << "key " << key;
+        if (exist && expect)
+        {
+            EXPECT_EQ(rid.page_no, key / 100 + 1) << "key " << key;
+            EXPECT_EQ(rid.slot_no, key % 100) << "key " << key;
+        }
+    };
+    for (int key = -1; key <= num_keys + 1; key++)
+        check(key, key >= 0 && key < num_keys && key % 2 == 0);
+
+    // 删除后不再能查到
+    for (int key = 0; key < num_keys; key += 4)
+        ih->delete_entry(reinterpret_cast<const char *>(&key), Rid{key / 100 + 1, key % 100}, &txn, true);
+    for (int key = 0; key < num_keys; key++)
+        check(key, key % 4 == 2);
+
+    ih.reset();
+    ix_manager->destroy_index(filename, cols);
+}
+
+TEST(IndexTest, ConcurrentLookupTest)
+{
+    const std::string filename = "ix_concurrent_test";
+    const int key_len = 64; // 较长的键让结点的容量较小，少量的键就能让树长高几层
+    std::vector<ColMeta> cols = {ColMeta{.tab_name = filename, .name = "k", .type = TYPE_STRING, .len = key_len, .offset = 0}};
+    auto disk_manager = std::make_unique<DiskManager_Final>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(256, disk_manager.get());
+    auto ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(ix_manager->get_index_name(filename, cols)))
+        ix_manager->destroy_index(filename, cols);
+    ix_manager->create_index(filename, cols);
+    auto ih = ix_manager->open_index(filename, cols);
+
+    auto make_key = [&](int num)
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "k%06d", num);
+        std::string key(key_len, '\0');
+        memcpy(key.data(), buf, strlen(buf));
+        return key;
+    };
+
+    // 稳定的键在整个测试期间都存在，只够放进一个叶子结点，树的高度完全由其他线程插入和删除的键决定
+    const int stable_step = 100;
+    const int num_stable = 40;
+    const int key_range = stable_step * num_stable;
+    Transaction loader(0, nullptr);
+    for (int i = 0; i < num_stable; i++)
+        ih->insert_entry(make_key(i * stable_step).c_str(), Rid{i * stable_step, 0}, &loader, true);
+
+    // 修改线程在稳定的键之间反复插入再删除各自的一组键：插入时叶子结点和内部结点分裂，根结点从叶子结点变成内部结点，
+    // 树长到三层；删除时结点合并或者重分配，最后根结点又变回叶子结点
+    const int num_writers = 2;
+    const int num_readers = 4;
+    const int rounds = 3;
+    std::atomic<int> writers_running{num_writers};
+    std::atomic<int> failures{0};
+    std::atomic<uint64_t> lookups{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_writers; t++)
+    {
+        threads.emplace_back([&, t]
+                             {
+            Transaction txn(t + 1, nullptr);
+            for (int round = 0; round < rounds; round++)
+            {
+                for (int num = t; num < 2 * key_range; num += num_writers)
+                {
+                    if (num % stable_step != 0 || num >= key_range)
+                        ih->insert_entry(make_key(num).c_str(), Rid{num, 1}, &txn, true);
+                }
+                for (int num = t; num < 2 * key_range; num += num_writers)
+                {
+                    if ((num % stable_step != 0 || num >= key_range) &&
+                        !ih->delete_entry(make_key(num).c_str(), Rid{num, 1}, &txn, true))
+                        failures++;
+                }
+            }
+            writers_running--; });
+    }
+    // 查找线程：稳定的键始终能找到并且rid正确，从来没有插入过的键始终找不到
+    for (int t = 0; t < num_readers; t++)
+    {
+        threads.emplace_back([&, t]
+                             {
+            int i = t;
+            while (writers_running.load() > 0)
+            {
+                int num = (i++ % num_stable) * stable_step;
+                Rid rid{-1, -1};
+                if (!ih->get_value(make_key(num).c_str(), &rid, nullptr) || rid.page_no != num || rid.slot_no != 0)
+                    failures++;
+                if (ih->get_value(make_key(2 * key_range + num).c_str(), &rid, nullptr))
+                    failures++;
+                lookups++;
+            } });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_GT(lookups.load(), 0u);
+    // 插入使叶子结点满了的时候，乐观查找一定会因为叶子结点不安全而退回到从根结点开始加排他latch
+    EXPECT_GT(ih->optimistic_unsafe(), 0u);
+
+    // 持有叶子结点的排他latch，乐观查找每次都会看到奇数的版本号，重试次数用完后退回到逐层加共享latch，
+    // 在叶子结点上等待latch释放后仍然返回正确的结果
+    std::string key = make_key(stable_step);
+    auto leaf = ih->find_leaf_page(key.c_str(), Operation::FIND, nullptr);
+    PageId_Final leaf_id = leaf.get_page_id();
+    ih->unlock_shared(leaf);
+    Page_Final *leaf_page = buffer_pool_manager->fetch_page(leaf_id);
+    leaf_page->lock();
+    uint64_t conflicts = ih->optimistic_conflicts();
+    std::atomic<bool> found{false};
+    std::thread reader([&]
+                       {
+        Rid rid{-1, -1};
+        found = ih->get_value(key.c_str(), &rid, nullptr) && rid.page_no == stable_step; });
+    while (ih->optimistic_conflicts() == conflicts)
+        std::this_thread::yield();
+    EXPECT_FALSE(found.load());
+    leaf_page->unlock();
+    buffer_pool_manager->unpin_page(leaf_id, false);
+    reader.join();
+    EXPECT_TRUE(found.load());
+
+    ih.reset();
+    ix_manager->destroy_index(filename, cols);
+}
+
+TEST(TransactionManagerTest, ReopenTest)
+{
+    auto disk_manager = std::make_unique<DiskManager_Final>();
+    auto log_manager = std::make_unique<LogManager>(disk_manager.get(), nullptr);
+
+    // 两个先后创建的事务管理器分配相同的事务ID，后一个不能看到前一个已经释放的事务
+    for (int round = 0; round < 2; round++)
+    {
+        TransactionManager txn_manager(nullptr, nullptr, ConcurrencyMode::MVCC);
+        std::vector<Transaction *> txns;
+        for (int i = 0; i < 3; i++)
+            txns.push_back(txn_manager.begin(nullptr, log_manager.get()));
+        for (auto *txn : txns)
+        {
+            EXPECT_EQ(txn_manager.get_transaction(txn->get_transaction_id()), txn) << "round " << round;
+        }
+        EXPECT_EQ(TransactionManager::txn_map.size(), txns.size());
+    }
+    EXPECT_TRUE(TransactionManager::txn_map.empty());
+
+    log_manager.reset();
+    disk_manager->destroy_file(LOG_FILE_NAME);
+}
+
+/**
+ * @brief 变长格式页面的测试环境：在缓冲池中创建一个页面，按RmSlottedPage的布局直接检查页头和slot目录
+ */
+class SlottedPageTest : public ::testing::Test
+{
+public:
+    const std::string filename = "slotted_page_test.tbl";
+    std::unique_ptr<DiskManager_Final> disk_manager_;
+    std::unique_ptr<BufferPoolManager_Final> buffer_pool_manager_;
+    int fd_ = -1;
+    PageId_Final page_id_{};
+    Page_Final *page_ = nullptr;
+
+    void SetUp() override
+    {
+        disk_manager_ = std::make_unique<DiskManager_Final>();
+        buffer_pool_manager_ = std::make_unique<BufferPoolManager_Final>(16, disk_manager_.get());
+        if (disk_manager_->is_file(filename))
+            disk_manager_->destroy_file(filename);
+        disk_manager_->create_file(filename);
+        fd_ = disk_manager_->open_file(filename);
+        page_id_ = {fd_, INVALID_PAGE_ID};
+        page_ = buffer_pool_manager_->new_page(&page_id_);
+        ASSERT_NE(page_, nullptr);
+        RmSlottedPage(page_).init();
+    }
+
+    void TearDown() override
+    {
+        buffer_pool_manager_->unpin_page(page_id_, false);
+        buffer_pool_manager_->remove_all_pages(fd_, false);
+        disk_manager_->close_file(fd_);
+        disk_manager_->destroy_file(filename);
+    }
+
+    char *base() { return page_->get_data() + Page_Final::OFFSET_PAGE_HDR; }
+    RmPageHdr *page_hdr() { return reinterpret_cast<RmPageHdr *>(base()); }
+    RmSlottedPageHdr *hdr() { return reinterpret_cast<RmSlottedPageHdr *>(base() + sizeof(RmPageHdr)); }
+    RmSlot *slots() { return reinterpret_cast<RmSlot *>(base() + RmSlottedPage::HDR_SIZE); }
+    int contiguous_space() { return hdr()->data_begin - RmSlottedPage::HDR_SIZE - hdr()->num_slots * (int)sizeof(RmSlot); }
+
+    /**
+     * @brief 检查slot目录的不变式，并与model中的记录比较：
+     * 空闲的slot三项都为0，记录满足0 < len <= cap，[offset, offset + cap)位于记录区中且互不重叠，
+     * 记录区的大小等于所有cap之和加上garbage_bytes，目录末尾的slot总是有记录
+     */
+    void check_page(const std::map<int, std::string> &model)
+    {
+        RmSlottedPage sp(page_);
+        const int num_slots = hdr()->num_slots;
+        const int data_begin = hdr()->data_begin;
+        ASSERT_GE(num_slots, 0);
+        ASSERT_GE(hdr()->garbage_bytes, 0);
+        ASSERT_LE(RmSlottedPage::HDR_SIZE + num_slots * (int)sizeof(RmSlot), data_begin);
+        ASSERT_LE(data_begin, RmSlottedPage::PAGE_BYTES);
+        if (num_slots > 0)
+        {
+            EXPECT_GT(slots()[num_slots - 1].len, 0) << "trailing free slot";
+        }
+
+        std::vector<std::pair<int, int>> regions;
+        int total_cap = 0;
+        for (int i = 0; i < num_slots; i++)
+        {
+            const RmSlot &slot = slots()[i];
+            if (slot.len == 0)
+            {
+                EXPECT_EQ(slot.cap, 0) << "slot " << i;
+                EXPECT_EQ(model.count(i), 0u) << "slot " << i;
+                continue;
+            }
+            EXPECT_LE(slot.len, slot.cap) << "slot " << i;
+            EXPECT_GE(slot.offset, data_begin) << "slot " << i;
+            EXPECT_LE(slot.offset + slot.cap, RmSlottedPage::PAGE_BYTES) << "slot " << i;
+            regions.emplace_back(slot.offset, slot.offset + slot.cap);
+            total_cap += slot.cap;
+        }
+        std::sort(regions.begin(), regions.end());
+        for (size_t i = 1; i < regions.size(); i++)
+            EXPECT_LE(regions[i - 1].second, regions[i].first) << "overlapping records";
+        EXPECT_EQ(RmSlottedPage::PAGE_BYTES - data_begin, total_cap + hdr()->garbage_bytes);
+        EXPECT_EQ(sp.free_space(),
+                  RmSlottedPage::capacity() - num_slots * (int)sizeof(RmSlot) - total_cap);
+
+        // 内容与model一致
+        ASSERT_EQ(page_hdr()->num_records, (int)model.size());
+        std::vector<int> live(num_slots + 1);
+        ASSERT_EQ(sp.live_slots(live.data()), (int)model.size());
+        int n = 0;
+        for (auto &[slot_no, data] : model)
+        {
+            EXPECT_EQ(live[n++], slot_no);
+            ASSERT_TRUE(sp.is_live(slot_no)) << "slot " << slot_no;
+            ASSERT_EQ(sp.tuple_len(slot_no), (int)data.size()) << "slot " << slot_no;
+            EXPECT_EQ(memcmp(sp.tuple(slot_no), data.data(), data.size()), 0) << "slot " << slot_no;
+        }
+    }
+};
+
+/**
+ * @brief 整理页面只移动记录，slot_no和内容不变，garbage_bytes清零，空闲空间变为连续
+ */
+TEST_F(SlottedPageTest, CompactTest)
+{
+    RmSlottedPage sp(page_);
+    std::map<int, std::string> model;
+    const int len = 100;
+    std::string data(len, '\0');
+    for (int i = 0;; i++)
+    {
+        for (int j = 0; j < len; j++)
+            data[j] = (char)('a' + (i + j) % 26);
+        int slot_no = sp.insert(data.data(), len);
+        if (slot_no < 0)
+            break;
+        EXPECT_EQ(slot_no, i);
+        model[slot_no] = data;
+    }
+    ASSERT_GT(model.size(), 4u);
+    EXPECT_LT(sp.free_space(), len + (int)sizeof(RmSlot));
+    check_page(model);
+
+    // 删掉一半记录，空间计入garbage_bytes，连续的空闲空间不变
+    int contiguous = contiguous_space();
+    int num_records = (int)model.size();
+    for (int i = 0; i < num_records - 1; i += 2)
+    {
+        sp.remove(i);
+        model.erase(i);
+    }
+    EXPECT_EQ(contiguous_space(), contiguous);
+    EXPECT_GT(hdr()->garbage_bytes, 0);
+    check_page(model);
+
+    // 需要整理才能放下的记录
+    int big = sp.free_space();
+    ASSERT_GT(big, contiguous_space());
+    std::string big_data(big, 'Z');
+    EXPECT_EQ(sp.insert(big_data.data(), big), 0);
+    model[0] = big_data;
+    EXPECT_EQ(hdr()->garbage_bytes, 0);
+    EXPECT_EQ(contiguous_space(), 0);
+    EXPECT_EQ(sp.free_space(), 0);
+    check_page(model);
+
+    // 页面已满，插入和变长的更新都失败且页面不变
+    std::vector<char> before(page_->get_data(), page_->get_data() + PAGE_SIZE);
+    EXPECT_EQ(sp.insert("x", 1), -1);
+    EXPECT_FALSE(sp.can_update(1, len + 1));
+    EXPECT_FALSE(sp.update(1, big_data.data(), len + 1));
+    EXPECT_EQ(memcmp(before.data(), page_->get_data(), PAGE_SIZE), 0);
+
+    // 显式整理后空闲空间都在记录区之前
+    sp.remove(0);
+    model.erase(0);
+    sp.compact();
+    EXPECT_EQ(hdr()->garbage_bytes, 0);
+    EXPECT_EQ(contiguous_space(), sp.free_space());
+    check_page(model);
+}
+
+/**
+ * @brief 记录变短时保留原来分配的空间，页面被其他记录填满之后仍然能原地恢复原来的长度（回滚依赖这一点）；
+ * shrink之后多出的空间计入garbage_bytes，可以被其他记录使用
+ */
+TEST_F(SlottedPageTest, CapacityTest)
+{
+    RmSlottedPage sp(page_);
+    std::map<int, std::string> model;
+    std::string old_data(300, 'o');
+    ASSERT_EQ(sp.insert(old_data.data(), (int)old_data.size()), 0);
+    model[0] = old_data;
+
+    // 原地变短，offset和cap不变
+    RmSlot before = slots()[0];
+    ASSERT_TRUE(sp.update(0, "short", 5));
+    model[0] = "short";
+    EXPECT_EQ(slots()[0].offset, before.offset);
+    EXPECT_EQ(slots()[0].cap, before.cap);
+    EXPECT_EQ(slots()[0].len, 5);
+    check_page(model);
+
+    // 用其他记录填满页面
+    std::string filler(50, 'f');
+    int slot_no;
+    while ((slot_no = sp.insert(filler.data(), (int)filler.size())) >= 0)
+        model[slot_no] = filler;
+    while ((slot_no = sp.insert("f", 1)) >= 0)
+        model[slot_no] = "f";
+    check_page(model);
+
+    // 仍然可以恢复原来的长度
+    EXPECT_TRUE(sp.can_update(0, (int)old_data.size()));
+    ASSERT_TRUE(sp.update(0, old_data.data(), (int)old_data.size()));
+    model[0] = old_data;
+    EXPECT_EQ(slots()[0].offset, before.offset);
+    check_page(model);
+    EXPECT_FALSE(sp.can_update(0, (int)old_data.size() + (int)sizeof(RmSlot) + 1));
+
+    // shrink之后空间可以给其他记录使用，原来的记录不能再原地变长
+    ASSERT_TRUE(sp.update(0, "short", 5));
+    model[0] = "short";
+    sp.shrink(0);
+    EXPECT_EQ(slots()[0].cap, 5);
+    EXPECT_EQ(hdr()->garbage_bytes, (int)old_data.size() - 5);
+    check_page(model);
+    std::string other((int)old_data.size() - 5 - (int)sizeof(RmSlot), 'n');
+    slot_no = sp.insert(other.data(), (int)other.size());
+    ASSERT_GE(slot_no, 0);
+    model[slot_no] = other;
+    EXPECT_FALSE(sp.can_update(0, (int)old_data.size()));
+    check_page(model);
+}
+
+/**
+ * @brief 随机插入、在指定slot插入、更新、删除、shrink和整理，每一步之后检查slot目录的不变式；
+ * 操作失败时页面的每个字节都不变
+ */
+TEST_F(SlottedPageTest, RandomOpsTest)
+{
+    RmSlottedPage sp(page_);
+    std::map<int, std::string> model;
+    std::mt19937 rng(2023);
+    auto random_data = [&rng](int max_len)
+    {
+        std::string data(1 + rng() % max_len, '\0');
+        for (auto &c : data)
+            c = (char)(rng() % 256);
+        return data;
+    };
+    auto random_live = [&]()
+    {
+        auto it = model.begin();
+        std::advance(it, rng() % model.size());
+        return it->first;
+    };
+
+    for (int round = 0; round < 20000; round++)
+    {
+        std::vector<char> before(page_->get_data(), page_->get_data() + PAGE_SIZE);
+        int free_space = sp.free_space();
+        bool failed = false;
+        int op = rng() % 16;
+        if (model.empty() && op >= 6)
+            op = 0;
+        if (op < 4)
+        {
+            // 优先使用空闲的slot
+            std::string data = random_data(op == 0 ? RM_MAX_ENCODED_SIZE : 64);
+            int expect_slot = 0;
+            while (model.count(expect_slot))
+                expect_slot++;
+            int need = (int)data.size() + (expect_slot == hdr()->num_slots ? (int)sizeof(RmSlot) : 0);
+            int slot_no = sp.insert(data.data(), (int)data.size());
+            failed = need > free_space;
+            ASSERT_EQ(slot_no, failed ? -1 : expect_slot);
+            if (!failed)
+                model[slot_no] = data;
+        }
+        else if (op < 6)
+        {
+            // 恢复时在指定的slot上写入，可能需要扩展目录
+            int slot_no = rng() % (hdr()->num_slots + 4);
+            if (model.count(slot_no))
+                continue;
+            std::string data = random_data(128);
+            int need = (int)data.size() + std::max(0, slot_no + 1 - hdr()->num_slots) * (int)sizeof(RmSlot);
+            failed = need > free_space;
+            ASSERT_EQ(sp.insert_at(slot_no, data.data(), (int)data.size()), !failed);
+            if (!failed)
+                model[slot_no] = data;
+        }
+        else if (op < 10)
+        {
+            // 更新为更短或者更长的记录
+            int slot_no = random_live();
+            std::string data = random_data(op < 8 ? 32 : 256);
+            RmSlot slot = slots()[slot_no];
+            failed = (int)data.size() > slot.cap && (int)data.size() > free_space + slot.cap;
+            ASSERT_EQ(sp.can_update(slot_no, (int)data.size()), !failed);
+            ASSERT_EQ(sp.update(slot_no, data.data(), (int)data.size()), !failed);
+            if (!failed)
+            {
+                // 不超过原来的空间时原地写入
+                if ((int)data.size() <= slot.cap)
+                {
+                    EXPECT_EQ(slots()[slot_no].offset, slot.offset);
+                    EXPECT_EQ(slots()[slot_no].cap, slot.cap);
+                }
+                model[slot_no] = data;
+            }
+        }
+        else if (op < 14)
+        {
+            int slot_no = random_live();
+            sp.remove(slot_no);
+            model.erase(slot_no);
+        }
+        else if (op == 14)
+        {
+            if (rng() % 4 == 0)
+                sp.shrink_all();
+            else
+                sp.shrink(random_live());
+            EXPECT_GE(sp.free_space(), free_space);
+        }
+        else
+        {
+            sp.compact();
+            EXPECT_EQ(hdr()->garbage_bytes, 0);
+            EXPECT_EQ(sp.free_space(), free_space);
+        }
+        if (failed)
+        {
+            EXPECT_EQ(memcmp(before.data(), page_->get_data(), PAGE_SIZE), 0) << "failed operation changed the page";
+        }
+        check_page(model);
+        if (HasFailure())
+        {
+            FAIL() << "round " << round << " op " << op;
+        }
+    }
+}
+
+/**
+ * @brief 字符串列编码为2字节的长度加去掉末尾'\0'之后的内容，解码后与原记录相同；
+ * 所有字符串列都写满时编码后的长度达到RM_MAX_ENCODED_SIZE，仍然能放进一个空页面
+ */
+TEST(RmTupleCodecTest, EncodeDecodeTest)
+{
+    // slot目录中2字节的offset、len和cap能表示页面中的任何位置
+    static_assert(RmSlottedPage::PAGE_BYTES <= UINT16_MAX, "slot offsets must fit in 2 bytes");
+    static_assert(RM_MAX_ENCODED_SIZE + (int)sizeof(RmSlot) <= RmSlottedPage::capacity(),
+                  "the longest encoded record must fit in an empty page");
+
+    // int(4) | char(20) | float(8) | char(300)
+    RmFormatHdr format{};
+    format.format = RM_FORMAT_SLOTTED;
+    format.num_var_cols = 2;
+    format.var_cols[0] = RmVarCol{4, 20};
+    format.var_cols[1] = RmVarCol{32, 300};
+    const int record_size = 332;
+    RmTupleCodec codec(format, record_size);
+    EXPECT_EQ(codec.max_size(), record_size + 2 * (int)sizeof(uint16_t));
+
+    auto check = [&](const std::string &s1, const std::string &s2)
+    {
+        char record[record_size] = {};
+        memset(record, 0x11, 4);
+        memset(record + 24, 0x22, 8);
+        memcpy(record + 4, s1.data(), s1.size());
+        memcpy(record + 32, s2.data(), s2.size());
+        // 长度不包括末尾的'\0'，中间的'\0'保留
+        uint16_t n1 = s1.find_last_not_of('\0') == std::string::npos ? 0 : s1.find_last_not_of('\0') + 1;
+        uint16_t n2 = s2.find_last_not_of('\0') == std::string::npos ? 0 : s2.find_last_not_of('\0') + 1;
+
+        char encoded[RM_MAX_ENCODED_SIZE];
+        int len = codec.encode(record, encoded);
+        ASSERT_EQ(len, 4 + 2 + n1 + 8 + 2 + n2);
+        ASSERT_LE(len, codec.max_size());
+        uint16_t len1, len2;
+        memcpy(&len1, encoded + 4, sizeof(len1));
+        memcpy(&len2, encoded + 4 + 2 + n1 + 8, sizeof(len2));
+        EXPECT_EQ(len1, n1);
+        EXPECT_EQ(len2, n2);
+
+        char decoded[record_size];
+        memset(decoded, 0x7f, record_size);
+        codec.decode(encoded, decoded);
+        EXPECT_EQ(memcmp(decoded, record, record_size), 0);
+    };
+    check("", "");
+    check(std::string(20, 'a'), std::string(300, 'b'));
+    check("ab", std::string(299, 'c'));
+    check(std::string("a\0b", 3), std::string("\0\0x\0\0", 5));
+    check(std::string(19, 'z') + '\0', "");
+
+    // 字符串列数和记录长度都达到上限
+    RmFormatHdr max_format{};
+    max_format.format = RM_FORMAT_SLOTTED;
+    max_format.num_var_cols = RM_MAX_VAR_COLS;
+    const int col_len = RM_MAX_RECORD_SIZE / RM_MAX_VAR_COLS;
+    for (int i = 0; i < RM_MAX_VAR_COLS; i++)
+        max_format.var_cols[i] = RmVarCol{i * col_len, col_len};
+    RmTupleCodec max_codec(max_format, RM_MAX_RECORD_SIZE);
+    EXPECT_EQ(max_codec.max_size(), RM_MAX_ENCODED_SIZE);
+    char record[RM_MAX_RECORD_SIZE];
+    memset(record, 'm', sizeof(record));
+    char encoded[RM_MAX_ENCODED_SIZE];
+    EXPECT_EQ(max_codec.encode(record, encoded), RM_MAX_ENCODED_SIZE);
+    char decoded[RM_MAX_RECORD_SIZE];
+    max_codec.decode(encoded, decoded);
+    EXPECT_EQ(memcmp(decoded, record, sizeof(record)), 0);
+
+    // 一个字符串列占满整条记录，长度仍然能用2字节表示
+    RmFormatHdr wide_format{};
+    wide_format.format = RM_FORMAT_SLOTTED;
+    wide_format.num_var_cols = 1;
+    wide_format.var_cols[0] = RmVarCol{0, RM_MAX_RECORD_SIZE};
+    RmTupleCodec wide_codec(wide_format, RM_MAX_RECORD_SIZE);
+    EXPECT_EQ(wide_codec.encode(record, encoded), RM_MAX_RECORD_SIZE + (int)sizeof(uint16_t));
+    uint16_t wide_len;
+    memcpy(&wide_len, encoded, sizeof(wide_len));
+    EXPECT_EQ(wide_len, RM_MAX_RECORD_SIZE);
+    wide_codec.decode(encoded, decoded);
+    EXPECT_EQ(memcmp(decoded, record, sizeof(record)), 0);
+}
+
+/**
+ * @brief 恢复的分析阶段删除日志中出现的变长格式记录：重复的、乱序的、页面还没有写入文件的记录号都可以出现，
+ * 其他记录不受影响，空闲空间映射随之更新；之后按日志在原来的slot上重做，得到与原来相同的记录
+ */
+TEST(SlottedFileTest, RecoveryRemoveTest)
+{
+    const std::string filename = "slotted_file_test.tbl";
+    auto disk_manager = std::make_unique<DiskManager_Final>();
+    auto buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(64, disk_manager.get());
+    auto rm_manager = std::make_unique<RmManager_Final>(disk_manager.get(), buffer_pool_manager.get());
+    if (disk_manager->is_file(filename))
+        disk_manager->destroy_file(filename);
+    std::remove((filename + ".fsm").c_str());
+
+    // int | char(200)
+    const int record_size = 204;
+    RmFormatHdr format{};
+    format.format = RM_FORMAT_SLOTTED;
+    format.num_var_cols = 1;
+    format.var_cols[0] = RmVarCol{4, 200};
+    rm_manager->create_file(filename, record_size, &format);
+    auto file_handle = rm_manager->open_file(filename);
+    ASSERT_TRUE(file_handle->is_slotted());
+
+    std::mt19937 rng(11);
+    std::unordered_map<Rid, std::string, rid_hash_t, rid_equal_t> records;
+    std::vector<Rid> rids;
+    while (file_handle->get_page_num() < RM_FIRST_RECORD_PAGE + 4)
+    {
+        std::string buf(record_size, '\0');
+        int i = (int)rids.size();
+        memcpy(&buf[0], &i, sizeof(i));
+        int len = 1 + rng() % 200;
+        for (int j = 0; j < len; j++)
+            buf[4 + j] = (char)('a' + rng() % 26);
+        Rid rid = file_handle->insert_record(&buf[0], nullptr);
+        ASSERT_EQ(records.count(rid), 0u);
+        records[rid] = buf;
+        rids.push_back(rid);
+    }
+
+    auto check_records = [&]()
+    {
+        for (auto &[rid, buf] : records)
+        {
+            auto rec = file_handle->get_record(rid, nullptr);
+            EXPECT_EQ(memcmp(rec->data, buf.data(), record_size), 0) << rid;
+        }
+        const RmFreeSpaceMap &fsm = file_handle->get_free_space_map();
+        for (int page_no = RM_FIRST_RECORD_PAGE; page_no < file_handle->get_page_num(); page_no++)
+        {
+            RmPageHandle_FInal page_handle = file_handle->fetch_page_handle(page_no);
+            RmSlottedPage sp(page_handle.page);
+            int num_live = 0;
+            for (auto &entry : records)
+                num_live += entry.first.page_no == page_no;
+            EXPECT_EQ(page_handle.page_hdr->num_records, num_live) << "page " << page_no;
+            EXPECT_EQ(fsm.bucket(page_no), fsm.bucket_of(sp.free_space())) << "page " << page_no;
+            buffer_pool_manager->unpin_page(page_handle.page->get_page_id(), false);
+        }
+    };
+    check_records();
+
+    // 日志中的记录号：第一个页面的全部记录和其他页面的一部分，有重复，乱序，还有超出文件的页面
+    std::vector<Rid> logged;
+    for (auto &rid : rids)
+    {
+        if (rid.page_no == RM_FIRST_RECORD_PAGE || rng() % 3 == 0)
+        {
+            logged.push_back(rid);
+            if (rng() % 4 == 0)
+                logged.push_back(rid);
+        }
+    }
+    logged.push_back(Rid{file_handle->get_page_num() + 2, 0});
+    std::shuffle(logged.begin(), logged.end(), rng);
+
+    std::unordered_map<Rid, std::string, rid_hash_t, rid_equal_t> removed;
+    for (auto &rid : logged)
+    {
+        auto it = records.find(rid);
+        if (it != records.end())
+        {
+            removed.insert(*it);
+            records.erase(it);
+        }
+    }
+    std::vector<Rid> to_remove = logged;
+    file_handle->recovery_remove_records(to_remove);
+    for (auto &entry : removed)
+        EXPECT_THROW(file_handle->get_record(entry.first, nullptr), RecordNotFoundError) << entry.first;
+    check_records();
+
+    // 第一个页面已经空了
+    {
+        RmPageHandle_FInal page_handle = file_handle->fetch_page_handle(RM_FIRST_RECORD_PAGE);
+        RmSlottedPage sp(page_handle.page);
+        EXPECT_EQ(sp.num_slots(), 0);
+        EXPECT_EQ(sp.free_space(), RmSlottedPage::capacity());
+        buffer_pool_manager->unpin_page(page_handle.page->get_page_id(), false);
+    }
+
+    // 按原来的顺序在原来的slot上重做
+    for (auto &rid : rids)
+    {
+        auto it = removed.find(rid);
+        if (it != removed.end())
+        {
+            file_handle->recovery_insert_record(rid, &it->second[0]);
+            records.insert(*it);
+        }
+    }
+    check_records();
+
+    file_handle.reset();
+    std::remove((filename + ".fsm").c_str());
+    rm_manager->destroy_file(filename);
+}
+
+/**
+ * @brief 在进程内按rmdb的方式创建各个模块、打开数据库并执行恢复，SQL的结果写入缓冲区而不是客户端
+ * 每条语句与服务端一样在单独的事务中执行，显式事务由begin/commit语句控制
+ */
+class SqlTestDb
+{
+public:
+    std::unique_ptr<DiskManager_Final> disk_manager;
+    std::unique_ptr<BufferPoolManager_Final> buffer_pool_manager;
+    std::unique_ptr<RmManager_Final> rm_manager;
+    std::unique_ptr<IxManager> ix_manager;
+    std::unique_ptr<SmManager> sm_manager;
+    std::unique_ptr<LockManager> lock_manager;
+    std::unique_ptr<TransactionManager> txn_manager;
+    std::unique_ptr<Planner> planner;
+    std::unique_ptr<Optimizer> optimizer;
+    std::unique_ptr<QlManager> ql_manager;
+    std::unique_ptr<LogManager> log_manager;
+    std::unique_ptr<RecoveryManager> recovery;
+    std::unique_ptr<Portal> portal;
+    std::unique_ptr<Analyze> analyze;
+    std::unique_ptr<Context> context;
+    SqlParser parser;
+    char data_send[BUFFER_LENGTH];
+    int offset = 0;
+    txn_id_t txn_id = INVALID_TXN_ID;
+
+    // fresh为true时先删除已有的同名数据库
+    SqlTestDb(const std::string &db_name, bool fresh, size_t pool_size = 256)
+    {
+        disk_manager = std::make_unique<DiskManager_Final>();
+        buffer_pool_manager = std::make_unique<BufferPoolManager_Final>(pool_size, disk_manager.get());
+        rm_manager = std::make_unique<RmManager_Final>(disk_manager.get(), buffer_pool_manager.get());
+        ix_manager = std::make_unique<IxManager>(disk_manager.get(), buffer_pool_manager.get());
+        sm_manager = std::make_unique<SmManager>(disk_manager.get(), buffer_pool_manager.get(), rm_manager.get(), ix_manager.get());
+        lock_manager = std::make_unique<LockManager>();
+        txn_manager = std::make_unique<TransactionManager>(lock_manager.get(), sm_manager.get());
+        planner = std::make_unique<Planner>(sm_manager.get());
+        optimizer = std::make_unique<Optimizer>(sm_manager.get(), planner.get());
+        ql_manager = std::make_unique<QlManager>(sm_manager.get(), txn_manager.get(), planner.get());
+        log_manager = std::make_unique<LogManager>(disk_manager.get(), buffer_pool_manager.get());
+        recovery = std::make_unique<RecoveryManager>(disk_manager.get(), buffer_pool_manager.get(), sm_manager.get(), txn_manager.get());
+        portal = std::make_unique<Portal>(sm_manager.get());
+        analyze = std::make_unique<Analyze>(sm_manager.get());
+        sm_manager->io_enabled_ = false;
+
+        if (fresh && sm_manager->is_dir(db_name))
+            sm_manager->drop_db(db_name);
+        if (!sm_manager->is_dir(db_name))
+            sm_manager->create_db(db_name);
+        sm_manager->open_db(db_name);
+        txn_manager->set_concurrency_mode(ConcurrencyMode::MVCC);
+        recovery->analyze();
+        recovery->redo();
+        recovery->undo();
+        context = std::make_unique<Context>(lock_manager.get(), log_manager.get(), nullptr, data_send, &offset);
+    }
+
+    ~SqlTestDb()
+    {
+        if (context->txn_ != nullptr)
+        {
+            txn_manager->abort(context.get(), log_manager.get());
+            context->txn_->release();
+            context->txn_ = nullptr;
+        }
+        sm_manager->close_db();
+    }
+
+    // 没有正在运行的事务时，与后台清理线程一样清理所有的表：删除已经提交的删除，释放不会再回滚的空间
+    void purge()
+    {
+        for (auto &fh : sm_manager->get_all_table_handle())
+            for (int page_no = RM_FIRST_RECORD_PAGE; page_no < fh->get_page_num(); page_no++)
+                fh->clean_page(page_no, txn_manager.get(), std::numeric_limits<timestamp_t>::max());
+    }
+
+    // 删除已经关闭的数据库
+    static void drop(const std::string &db_name)
+    {
+        std::string cmd = "rm -r " + db_name;
+        ASSERT_EQ(system(cmd.c_str()), 0);
+    }
+
+    // 执行一条语句，返回写给客户端的内容
+    std::string exec(const std::string &sql)
+    {
+        std::shared_ptr<ast::TreeNode> parse_tree;
+        if (parser.parse(sql.c_str(), parse_tree) != 0 || parse_tree == nullptr)
+            return "parse error\n";
+        return exec_plan([&]
+                         { return optimizer->plan_query(analyze->do_analyze(parse_tree, context.get()), context.get()); });
+    }
+
+    // 在语句所属的事务中生成计划并执行，返回写给客户端的内容
+    std::string exec_plan(const std::function<std::shared_ptr<Plan>()> &make_plan)
+    {
+        offset = 0;
+        context->ellipsis_ = false;
+        if (context->txn_ == nullptr)
+        {
+            context->txn_ = txn_manager->begin(nullptr, log_manager.get());
+            txn_id = context->txn_->get_transaction_id();
+            context->txn_->set_txn_mode(false);
+        }
+        std::string result;
+        try
+        {
+            std::shared_ptr<Plan> plan = make_plan();
+            PortalGuard guard(portal.get(), context.get());
+            guard.stmt = portal->start(plan, context.get());
+            portal->run(guard.stmt, ql_manager.get(), &txn_id, context.get());
+            result.assign(data_send, offset);
+        }
+        catch (TransactionAbortException &e)
+        {
+            txn_manager->abort(context.get(), log_manager.get());
+            result = "abort\n";
+        }
+        catch (RMDBError &e)
+        {
+            txn_manager->abort(context.get(), log_manager.get());
+            result = std::string(e.what()) + "\n";
+        }
+        if (context->txn_->get_state() == TransactionState::ABORTED ||
+            context->txn_->get_state() == TransactionState::COMMITTED)
+        {
+            context->txn_->release();
+            context->txn_ = nullptr;
+        }
+        else if (!context->txn_->get_txn_mode())
+        {
+            txn_manager->commit(context.get(), log_manager.get());
+            context->txn_->release();
+            context->txn_ = nullptr;
+        }
+        return result;
+    }
+
+    // 执行select count(*)，返回计数
+    int count(const std::string &tab_name, const std::string &where = "")
+    {
+        std::string result = exec("select count(*) as n from " + tab_name + (where.empty() ? "" : " where " + where) + ";");
+        // 结果的第二行是数据：| n |
+        std::istringstream lines(result);
+        std::string line;
+        int line_no = 0;
+        while (std::getline(lines, line))
+        {
+            if (line.empty() || line[0] != '|')
+                continue;
+            if (line_no++ == 1)
+                return std::stoi(line.substr(1));
+        }
+        ADD_FAILURE() << "unexpected result: " << result;
+        return -1;
+    }
+
+    // 通过索引查找键对应的记录号
+    bool lookup(const std::string &tab_name, const std::vector<std::string> &cols, const std::string &key, Rid *rid)
+    {
+        auto ih = sm_manager->get_index_handle(sm_manager->get_ix_manager()->get_index_name(tab_name, cols));
+        return ih->get_value(key.data(), rid, nullptr);
+    }
+};
+
+// 定长的char(n)索引键
+static std::string char_key(const std::string &s, int len)
+{
+    std::string key(len, '\0');
+    memcpy(&key[0], s.data(), std::min((int)s.size(), len));
+    return key;
+}
+
+static std::string int_key(int v) { return std::string(reinterpret_cast<const char *>(&v), sizeof(v)); }
+
+// 第i行的长字符串
+static std::string long_value(int i, int len)
+{
+    std::string s(len, ' ');
+    for (int j = 0; j < len; j++)
+        s[j] = (char)('a' + (i + j) % 26);
+    return s;
+}
+
+/**
+ * @brief ROW_FORMAT = SLOTTED的表中把字符串更新成更长的值：页面中放得下时原地更新，记录号不变；
+ * 放不下时删除后重新插入，所有索引（包括修改了键的索引和复合索引）都指向新的记录号，不再有指向旧记录号的索引项
+ */
+TEST(SlottedTableTest, UpdateRelocateTest)
+{
+    const std::string db_name = "slotted_update_db";
+    {
+        SqlTestDb db(db_name, true);
+        ASSERT_EQ(db.exec("create table t (id int, s char(200), c char(8)) row_format = slotted;"), "");
+        ASSERT_EQ(db.exec("create index t(id);"), "");
+        ASSERT_EQ(db.exec("create index t(c);"), "");
+        ASSERT_EQ(db.exec("create index t(id, c);"), "");
+        auto fh = db.sm_manager->get_table_handle("t");
+        ASSERT_TRUE(fh->is_slotted());
+
+        // 插入短记录直到占满几个页面
+        std::vector<std::string> s_values, c_values;
+        while (fh->get_page_num() < RM_FIRST_RECORD_PAGE + 3)
+        {
+            int i = (int)s_values.size();
+            s_values.push_back("x");
+            c_values.push_back("c" + std::to_string(i));
+            ASSERT_EQ(db.exec("insert into t values (" + std::to_string(i) + ", 'x', '" + c_values[i] + "');"), "");
+        }
+        const int num_rows = (int)s_values.size();
+
+        // 三个索引都指向同一个记录号
+        auto rid_of = [&](int i)
+        {
+            Rid rid{}, by_c{}, by_both{};
+            EXPECT_TRUE(db.lookup("t", {"id"}, int_key(i), &rid)) << "id " << i;
+            EXPECT_TRUE(db.lookup("t", {"c"}, char_key(c_values[i], 8), &by_c)) << "id " << i;
+            EXPECT_TRUE(db.lookup("t", {"id", "c"}, int_key(i) + char_key(c_values[i], 8), &by_both)) << "id " << i;
+            EXPECT_EQ(rid, by_c) << "id " << i;
+            EXPECT_EQ(rid, by_both) << "id " << i;
+            return rid;
+        };
+        auto check_row = [&](int i)
+        {
+            EXPECT_EQ(db.count("t", "id = " + std::to_string(i)), 1) << "id " << i;
+            EXPECT_EQ(db.count("t", "c = '" + c_values[i] + "'"), 1) << "id " << i;
+            EXPECT_EQ(db.count("t", "id = " + std::to_string(i) + " and s = '" + s_values[i] + "'"), 1) << "id " << i;
+        };
+
+        // 第一个页面已满，变长之后放不下，记录移到其他页面
+        Rid old_rid = rid_of(10);
+        ASSERT_EQ(old_rid.page_no, RM_FIRST_RECORD_PAGE);
+        s_values[10] = long_value(10, 200);
+        ASSERT_EQ(db.exec("update t set s = '" + s_values[10] + "' where id = 10;"), "");
+        Rid new_rid = rid_of(10);
+        EXPECT_NE(new_rid, old_rid);
+        check_row(10);
+
+        // 不超过原来的空间时原地更新
+        Rid rid = rid_of(20);
+        s_values[20] = "";
+        ASSERT_EQ(db.exec("update t set s = '' where id = 20;"), "");
+        EXPECT_EQ(rid_of(20), rid);
+        check_row(20);
+        s_values[10] = long_value(10, 50);
+        ASSERT_EQ(db.exec("update t set s = '" + s_values[10] + "' where id = 10;"), "");
+        EXPECT_EQ(rid_of(10), new_rid);
+        check_row(10);
+        // 移到的页面还有空闲空间，再次变长也在页面中完成
+        s_values[10] = long_value(10, 200);
+        ASSERT_EQ(db.exec("update t set s = '" + s_values[10] + "' where id = 10;"), "");
+        EXPECT_EQ(rid_of(10), new_rid);
+        check_row(10);
+
+        // 同时修改索引列，旧的键不再存在，新的键指向新的记录号
+        old_rid = rid_of(11);
+        std::string old_c = c_values[11];
+        s_values[11] = long_value(11, 180);
+        c_values[11] = "z11";
+        ASSERT_EQ(db.exec("update t set s = '" + s_values[11] + "', c = 'z11' where id = 11;"), "");
+        new_rid = rid_of(11);
+        EXPECT_NE(new_rid, old_rid);
+        Rid stale{};
+        EXPECT_FALSE(db.lookup("t", {"c"}, char_key(old_c, 8), &stale));
+        EXPECT_FALSE(db.lookup("t", {"id", "c"}, int_key(11) + char_key(old_c, 8), &stale));
+        check_row(11);
+
+        // 一条语句更新多行，部分原地完成，部分移动
+        std::vector<Rid> before(num_rows);
+        for (int i = 0; i < num_rows; i++)
+            before[i] = rid_of(i);
+        for (int i = 30; i < 90; i++)
+            s_values[i] = long_value(i, 150);
+        ASSERT_EQ(db.exec("update t set s = '" + long_value(0, 150) + "' where id >= 30 and id < 90;"), "");
+        for (int i = 30; i < 90; i++)
+            s_values[i] = long_value(0, 150);
+        std::set<std::pair<int, int>> seen;
+        for (int i = 0; i < num_rows; i++)
+        {
+            Rid r = rid_of(i);
+            EXPECT_TRUE(seen.emplace(r.page_no, r.slot_no).second) << "duplicate rid for id " << i;
+            if (i < 30 || i >= 90)
+            {
+                EXPECT_EQ(r, before[i]) << "id " << i;
+            }
+        }
+        for (int i = 0; i < num_rows; i += 7)
+            check_row(i);
+        for (int i = 30; i < 90; i++)
+            check_row(i);
+        EXPECT_EQ(db.count("t"), num_rows);
+        EXPECT_EQ(db.count("t", "s = '" + long_value(0, 150) + "'"), 60);
+    }
+
+    // 正常关闭后重新打开，内容和索引不变
+    {
+        SqlTestDb db(db_name, false);
+        EXPECT_EQ(db.count("t", "s = '" + long_value(0, 150) + "'"), 60);
+        EXPECT_EQ(db.count("t", "id = 11 and c = 'z11' and s = '" + long_value(11, 180) + "'"), 1);
+        EXPECT_EQ(db.count("t", "c = 'c11'"), 0);
+        EXPECT_EQ(db.count("t", "id = 10 and s = '" + long_value(10, 200) + "'"), 1);
+    }
+    SqlTestDb::drop(db_name);
+}
+
+/**
+ * @brief 变长格式的表在崩溃后恢复：磁盘上的页面已经包含日志中较早的修改之后的内容，
+ * 分析阶段先删除日志中出现的记录，重做在原来的slot上重建，撤销回滚没有提交的事务（包括移动了位置的更新），
+ * 恢复后的内容和所有索引与已经提交的修改一致，之后的更新可以继续在这些页面中移动记录
+ */
+TEST(SlottedTableTest, RecoveryTest)
+{
+    const std::string db_name = "slotted_recovery_db";
+    const int num_rows = 300;
+
+    // 子进程执行修改后模拟崩溃：日志已经落盘，缓冲池中的页面停留在中途写回时的状态
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        try
+        {
+            SqlTestDb db(db_name, true);
+            auto run = [&db](const std::string &sql)
+            {
+                std::string result = db.exec(sql);
+                if (!result.empty())
+                {
+                    std::cerr << sql << ": " << result;
+                    _exit(2);
+                }
+            };
+            run("create table r (id int, s char(300), c char(16)) row_format = slotted;");
+            run("create index r(id);");
+            run("create index r(c);");
+            auto insert = [&run](int id, const std::string &s)
+            { run("insert into r values (" + std::to_string(id) + ", '" + s + "', 'k" + std::to_string(id) + "');"); };
+            for (int i = 0; i < num_rows; i++)
+                insert(i, i < 20 ? long_value(i, 280) : "v" + std::to_string(i));
+            // 原地变短，清理之后多余的空间被新插入的记录占用
+            for (int i = 0; i < 20; i++)
+                run("update r set s = 's" + std::to_string(i) + "' where id = " + std::to_string(i) + ";");
+            for (int i = 20; i < 60; i++)
+                run("update r set s = '" + long_value(i, 250) + "' where id = " + std::to_string(i) + ";");
+            run("delete from r where id >= 280;");
+            db.purge();
+            for (int i = 300; i < 400; i++)
+                insert(i, "v" + std::to_string(i));
+            db.buffer_pool_manager->force_flush_all_pages();
+
+            // 磁盘上的页面不包含下面的修改
+            run("update r set s = 'w' where id >= 100 and id < 140;");
+            for (int i = 140; i < 160; i++)
+                run("update r set s = '" + long_value(i, 200) + "' where id = " + std::to_string(i) + ";");
+            for (int i = 0; i < 10; i++)
+                insert(1000 + i, "n" + std::to_string(i));
+            run("delete from r where id >= 260 and id < 270;");
+
+            // 没有提交的事务
+            run("begin;");
+            run("update r set s = '" + long_value(1, 290) + "' where id >= 160 and id < 180;");
+            run("delete from r where id < 10;");
+            run("insert into r values (2000, 'u', 'k2000');");
+            db.log_manager->flush_log_to_disk();
+        }
+        catch (std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            _exit(3);
+        }
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << "child status " << status;
+
+    // 已经提交的修改
+    std::map<int, std::string> expected;
+    for (int i = 0; i < 400; i++)
+    {
+        if ((i >= 260 && i < 270) || (i >= 280 && i < 300))
+            continue;
+        if (i < 20)
+            expected[i] = "s" + std::to_string(i);
+        else if (i < 60)
+            expected[i] = long_value(i, 250);
+        else if (i >= 100 && i < 140)
+            expected[i] = "w";
+        else if (i >= 140 && i < 160)
+            expected[i] = long_value(i, 200);
+        else
+            expected[i] = "v" + std::to_string(i);
+    }
+    for (int i = 0; i < 10; i++)
+        expected[1000 + i] = "n" + std::to_string(i);
+
+    auto check = [&](SqlTestDb &db)
+    {
+        EXPECT_EQ(db.count("r"), (int)expected.size());
+        EXPECT_EQ(db.count("r", "s = 'w'"), 40);
+        std::set<std::pair<int, int>> seen;
+        for (int id : {0, 9, 10, 19, 20, 59, 60, 99, 100, 139, 140, 159, 160, 179, 180, 259, 260, 269, 270, 279,
+                       280, 299, 300, 399, 1000, 1009, 2000})
+        {
+            std::string c = "k" + std::to_string(id);
+            Rid rid{}, by_c{};
+            bool found = db.lookup("r", {"id"}, int_key(id), &rid);
+            EXPECT_EQ(db.lookup("r", {"c"}, char_key(c, 16), &by_c), found) << "id " << id;
+            if (!found)
+            {
+                EXPECT_EQ(expected.count(id), 0u) << "id " << id;
+                EXPECT_EQ(db.count("r", "id = " + std::to_string(id)), 0) << "id " << id;
+                continue;
+            }
+            ASSERT_EQ(expected.count(id), 1u) << "id " << id;
+            EXPECT_EQ(rid, by_c) << "id " << id;
+            EXPECT_TRUE(seen.emplace(rid.page_no, rid.slot_no).second) << "id " << id;
+            EXPECT_EQ(db.count("r", "id = " + std::to_string(id) + " and s = '" + expected[id] + "' and c = '" + c + "'"), 1)
+                << "id " << id;
+        }
+        for (auto &[id, s] : expected)
+        {
+            Rid rid{};
+            EXPECT_TRUE(db.lookup("r", {"id"}, int_key(id), &rid)) << "id " << id;
+            EXPECT_EQ(db.count("r", "c = 'k" + std::to_string(id) + "' and s = '" + s + "'"), 1) << "id " << id;
+        }
+    };
+
+    {
+        SqlTestDb db(db_name, false);
+        check(db);
+
+        // 恢复后的页面上继续变长和变短
+        EXPECT_EQ(db.exec("update r set s = '" + long_value(3, 300) + "' where id < 200;"), "");
+        for (auto &[id, s] : expected)
+            if (id < 200)
+                s = long_value(3, 300);
+        EXPECT_EQ(db.exec("update r set s = 'w' where id >= 200 and id < 230;"), "");
+        for (auto &[id, s] : expected)
+            if (id >= 200 && id < 230)
+                s = "w";
+        EXPECT_EQ(db.count("r", "s = '" + long_value(3, 300) + "'"), 200);
+    }
+    {
+        SqlTestDb db(db_name, false);
+        EXPECT_EQ(db.count("r"), (int)expected.size());
+        EXPECT_EQ(db.count("r", "s = 'w'"), 30);
+        EXPECT_EQ(db.count("r", "s = '" + long_value(3, 300) + "'"), 200);
+        for (auto &[id, s] : expected)
+            EXPECT_EQ(db.count("r", "id = " + std::to_string(id) + " and s = '" + s + "'"), 1) << "id " << id;
+    }
+    SqlTestDb::drop(db_name);
+}
+
+TEST(LogManagerTest, CheckpointEvictionTest)
+{
+    const std::string db_name = "checkpoint_eviction_db";
+    const int num_threads = 4;
+    const int keys_per_thread = 4000;
+
+    // 索引插入在持有祖先节点latch时淘汰脏页，需要等待日志持久化；同时执行的检查点要获取页面latch写回脏页。
+    // 两者发生死锁时子进程不会退出，由父进程超时判定失败
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        try
+        {
+            SqlTestDb db(db_name, true, 64);
+            std::vector<ColMeta> cols = {ColMeta{.tab_name = "ckpt", .name = "k", .type = TYPE_STRING, .len = 64, .offset = 0}};
+            db.ix_manager->create_index("ckpt", cols);
+            auto ih = db.ix_manager->open_index("ckpt", cols);
+
+            std::atomic<int> running{num_threads};
+            std::vector<std::thread> threads;
+            for (int t = 0; t < num_threads; t++)
+            {
+                threads.emplace_back([&, t]
+                                     {
+                    Transaction txn(t + 1, nullptr);
+                    for (int i = 0; i < keys_per_thread; i++)
+                    {
+                        // 先写日志再修改页面，页面写回前需要等待这条日志持久化
+                        BeginLogRecord log_record(t + 1);
+                        db.log_manager->add_log_to_buffer(&log_record);
+                        int key = i * num_threads + t;
+                        ih->insert_entry(char_key("k" + std::to_string(key), 64).c_str(), Rid{key, 0}, &txn, true);
+                    }
+                    running--; });
+            }
+            // 页面一直被占用时检查点可以失败，但不能阻塞；插入结束后至少要成功一次
+            int checkpoints = 0;
+            while (running.load() > 0 || checkpoints == 0)
+            {
+                try
+                {
+                    db.log_manager->create_static_check_point(db.txn_manager.get());
+                    checkpoints++;
+                }
+                catch (InternalError &)
+                {
+                }
+            }
+            for (auto &thread : threads)
+                thread.join();
+
+            Transaction txn(0, nullptr);
+            for (int key = 0; key < num_threads * keys_per_thread; key++)
+            {
+                Rid rid{-1, -1};
+                if (!ih->get_value(char_key("k" + std::to_string(key), 64).c_str(), &rid, &txn) || rid.page_no != key)
+                {
+                    std::cerr << "key " << key << " lost after " << checkpoints << " checkpoints" << std::endl;
+                    _exit(2);
+                }
+            }
+            ih.reset();
+        }
+        catch (std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+            _exit(3);
+        }
+        _exit(0);
+    }
+
+    int status = 0;
+    pid_t done = 0;
+    for (int i = 0; i < 600 && done == 0; i++)
+    {
+        done = waitpid(pid, &status, WNOHANG);
+        if (done == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (done == 0)
+    {
+        kill(pid, SIGKILL);
+        waitpid(pid, &status, 0);
+        FAIL() << "checkpoint deadlocked with concurrent index inserts";
+    }
+    ASSERT_EQ(done, pid);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << "child status " << status;
+    SqlTestDb::drop(db_name);
+}
+
+TEST(FrameWriterTest, SlowReaderTest)
+{
+    const std::string db_name = "slow_reader_db";
+    const int num_rows = 4000;
+    const size_t str_len = 500;
+    {
+        SqlTestDb db(db_name, true);
+        Context *context = db.context.get();
+        db.exec("create table t (id int, s char(500));");
+        for (int i = 0; i < num_rows; i++)
+            db.exec("insert into t values (" + std::to_string(i) + ", '" + std::string(str_len, 'a' + i % 26) + "');");
+
+        // 对端暂时不读取，socket的发送缓冲区写满之后结果只能留在FrameWriter中
+        int fds[2];
+        ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        ASSERT_EQ(fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK), 0);
+        ASSERT_EQ(fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK), 0);
+        FrameWriter writer(fds[0]);
+        db.exec("begin;");
+        context->frame_writer_ = &writer;
+
+        // 查询不等待socket可写，积压的结果超过FRAME_HIGH_WATER时暂停，游标留在PortalStmt中
+        std::shared_ptr<ast::TreeNode> tree;
+        ASSERT_EQ(db.parser.parse("select * from t;", tree), 0);
+        auto plan = db.optimizer->plan_query(db.analyze->do_analyze(tree, context), context);
+        auto start = std::chrono::steady_clock::now();
+        {
+            PortalGuard guard(db.portal.get(), context);
+            guard.stmt = db.portal->start(plan, context);
+            db.portal->run(guard.stmt, db.ql_manager.get(), &db.txn_id, context);
+            ASSERT_NE(guard.stmt->cursor, nullptr);
+            EXPECT_FALSE(writer.broken());
+            EXPECT_GE(writer.pending(), FRAME_HIGH_WATER);
+            EXPECT_LT(writer.pending(), FRAME_HIGH_WATER + 2 * str_len);
+            EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+            // 对端开始读取后，每次socket可写、积压降到FRAME_FLUSH_SIZE以下时继续执行查询
+            std::string received;
+            char buf[65536];
+            ssize_t n;
+            int resumes = 0;
+            while (guard.stmt->cursor != nullptr || writer.pending() > 0)
+            {
+                while ((n = read(fds[1], buf, sizeof(buf))) > 0)
+                    received.append(buf, n);
+                ASSERT_TRUE(writer.try_flush());
+                if (writer.pending() < FRAME_FLUSH_SIZE && guard.stmt->cursor != nullptr)
+                {
+                    resumes++;
+                    db.portal->resume(guard.stmt, db.ql_manager.get(), context);
+                }
+            }
+            while ((n = read(fds[1], buf, sizeof(buf))) > 0)
+                received.append(buf, n);
+            EXPECT_GT(resumes, 0);
+
+            // 所有行都完整到达
+            size_t pos = 0;
+            ASSERT_GE(received.size(), FRAME_HEADER_LENGTH);
+            EXPECT_EQ(received[4], FRAME_ROW_DESC);
+            pos += read_frame_u32(received.data()) + 4;
+            std::vector<bool> seen(num_rows, false);
+            int rows = 0;
+            while (pos + FRAME_HEADER_LENGTH <= received.size())
+            {
+                uint32_t len = read_frame_u32(received.data() + pos);
+                ASSERT_LE(pos + len + 4, received.size());
+                ASSERT_EQ(received[pos + 4], FRAME_DATA_ROW);
+                const char *row = received.data() + pos + FRAME_HEADER_LENGTH;
+                int id = (int)read_frame_u32(row + 1);
+                ASSERT_TRUE(id >= 0 && id < num_rows && !seen[id]) << "id " << id;
+                seen[id] = true;
+                uint16_t str_size = ntohs(*(const uint16_t *)(row + 6));
+                EXPECT_EQ(std::string(row + 8, str_size), std::string(str_len, 'a' + id % 26));
+                rows++;
+                pos += len + 4;
+            }
+            EXPECT_EQ(pos, received.size());
+            EXPECT_EQ(rows, num_rows);
+        }
+        context->frame_writer_ = nullptr;
+        db.exec("commit;");
+        close(fds[0]);
+        close(fds[1]);
+    }
+    SqlTestDb::drop(db_name);
+}
+
+// 规范化一条语句并解析，得到自动缓存使用的键和常量
+static std::shared_ptr<ast::TreeNode> parse_for_cache(SqlTestDb &db, const std::string &sql, std::string &key,
+                                                      std::vector<std::shared_ptr<ast::Value>> &literals)
+{
+    literals.clear();
+    EXPECT_TRUE(db.parser.normalize(sql.c_str(), key, literals)) << sql;
+    std::shared_ptr<ast::TreeNode> tree;
+    EXPECT_EQ(db.parser.parse(sql.c_str(), tree), 0) << sql;
+    return tree;
+}
+
+// 查询结果中的数据行数，不包括表头
+static int result_rows(const std::string &result)
+{
+    std::istringstream lines(result);
+    std::string line;
+    int rows = 0;
+    while (std::getline(lines, line))
+    {
+        if (!line.empty() && line[0] == '|')
+            rows++;
+    }
+    return rows - 1;
+}
+
+TEST(PlanCacheTest, BindTest)
+{
+    const std::string db_name = "plan_cache_bind_db";
+    {
+        SqlTestDb db(db_name, true);
+        ASSERT_EQ(db.exec("create table t(a int, b char(8), c float);"), "");
+        for (int i = 0; i < 10; i++)
+            db.exec("insert into t values(" + std::to_string(i) + ", 'v" + std::to_string(i % 2) + "', " +
+                    std::to_string(i) + ".5);");
+        PlanCache cache(db.sm_manager.get(), db.analyze.get(), db.optimizer.get(), db.planner.get());
+        Context *context = db.context.get();
+
+        // 常量按出现顺序替换成参数占位符，再次遍历时只给占位符编号
+        std::string key;
+        std::vector<std::shared_ptr<ast::Value>> literals;
+        auto tree = parse_for_cache(db, "select * from t where a < 4 and b = 'v1';", key, literals);
+        std::vector<std::shared_ptr<ast::Value>> replaced;
+        ASSERT_EQ(PlanCache::parameterize(tree, &replaced), 2);
+        ASSERT_EQ(replaced.size(), 2u);
+        EXPECT_EQ(std::static_pointer_cast<ast::IntLit>(replaced[0])->val, 4);
+        EXPECT_EQ(std::static_pointer_cast<ast::StringLit>(replaced[1])->val, "v1");
+        auto conds = std::static_pointer_cast<ast::SelectStmt>(tree)->conds;
+        for (int i = 0; i < 2; i++)
+        {
+            ASSERT_EQ(conds[i]->rhs->Nodetype(), ast::TreeNodeType::Param);
+            EXPECT_EQ(std::static_pointer_cast<ast::Param>(conds[i]->rhs)->idx, i);
+        }
+        EXPECT_EQ(PlanCache::parameterize(tree, nullptr), 2);
+
+        ASSERT_EQ(db.exec("begin;"), "");
+        tree = parse_for_cache(db, "select * from t where a < 4 and b = 'v1';", key, literals);
+        auto entry = cache.insert(key, tree, literals, context);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->param_count, 2);
+        EXPECT_EQ(result_rows(db.exec_plan([&]
+                                           { return PlanCache::bind(*entry, literals); })),
+                  2);
+
+        // 同一个规范化SQL命中同一个计划，绑定时原地修改计划中的参数，新旧参数交替绑定结果都正确
+        std::string key2;
+        std::vector<std::shared_ptr<ast::Value>> literals2;
+        parse_for_cache(db, "select * from t where a < 9 and b = 'v0';", key2, literals2);
+        EXPECT_EQ(key2, key);
+        EXPECT_EQ(cache.lookup(key2, context), entry);
+        EXPECT_EQ(result_rows(db.exec_plan([&]
+                                           { return PlanCache::bind(*entry, literals2); })),
+                  5);
+        EXPECT_EQ(result_rows(db.exec_plan([&]
+                                           { return PlanCache::bind(*entry, literals); })),
+                  2);
+
+        // 参数个数不一致
+        EXPECT_THROW(PlanCache::bind(*entry, {}), InvalidParamCountError);
+        EXPECT_THROW(PlanCache::bind(*entry, {literals[0]}), InvalidParamCountError);
+
+        // insert的values同样绑定，按列的类型转换：INT常量插入FLOAT列
+        tree = parse_for_cache(db, "insert into t values(100, 'x', 1.5);", key, literals);
+        entry = cache.insert(key, tree, literals, context);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(db.exec_plan([&]
+                               { return PlanCache::bind(*entry, literals); }),
+                  "");
+        parse_for_cache(db, "insert into t values(101, 'y', 2.5);", key2, literals2);
+        ASSERT_EQ(cache.lookup(key2, context), entry);
+        EXPECT_EQ(db.exec_plan([&]
+                               { return PlanCache::bind(*entry, literals2); }),
+                  "");
+        ASSERT_EQ(db.exec("commit;"), "");
+        EXPECT_EQ(db.count("t", "a >= 100"), 2);
+        EXPECT_EQ(db.count("t", "b = 'y'"), 1);
+    }
+    SqlTestDb::drop(db_name);
+}
+
+TEST(PlanCacheTest, InvalidationTest)
+{
+    const std::string db_name = "plan_cache_invalidation_db";
+    {
+        SqlTestDb db(db_name, true);
+        ASSERT_EQ(db.exec("create table t(a int, b int);"), "");
+        for (int i = 0; i < 10; i++)
+            db.exec("insert into t values(" + std::to_string(i) + ", " + std::to_string(i * 10) + ");");
+        PlanCache cache(db.sm_manager.get(), db.analyze.get(), db.optimizer.get(), db.planner.get());
+        Context *context = db.context.get();
+
+        std::string key;
+        std::vector<std::shared_ptr<ast::Value>> literals;
+        const std::string sql = "select * from t where a = 3;";
+        ASSERT_EQ(db.exec("begin;"), "");
+        auto entry = cache.insert(key, parse_for_cache(db, sql, key, literals), literals, context);
+        ASSERT_NE(entry, nullptr);
+        auto plan = entry->plan;
+        // 没有DDL和参数修改时直接复用
+        EXPECT_EQ(cache.lookup(key, context), entry);
+        EXPECT_EQ(entry->plan, plan);
+        ASSERT_EQ(db.exec("commit;"), "");
+
+        // DDL使模式版本号变化，下一次查找时重新生成计划
+        ASSERT_EQ(db.exec("create index t(a);"), "");
+        ASSERT_EQ(db.exec("begin;"), "");
+        EXPECT_EQ(cache.lookup(key, context), entry);
+        EXPECT_NE(entry->plan, plan);
+        EXPECT_EQ(entry->schema_version, db.sm_manager->schema_version());
+        EXPECT_EQ(result_rows(db.exec_plan([&]
+                                           { return PlanCache::bind(*entry, literals); })),
+                  1);
+
+        // 修改规划参数同样使计划失效
+        plan = entry->plan;
+        db.planner->set_enable_nestedloop_join(false);
+        EXPECT_EQ(cache.lookup(key, context), entry);
+        EXPECT_NE(entry->plan, plan);
+        EXPECT_EQ(entry->knob_version, db.planner->knob_version());
+        db.planner->set_enable_nestedloop_join(true);
+        ASSERT_EQ(db.exec("commit;"), "");
+
+        // 表被删除后重新生成计划失败，表以不同的定义重建后按新的列类型检查参数
+        ASSERT_EQ(db.exec("drop table t;"), "");
+        ASSERT_EQ(db.exec("begin;"), "");
+        EXPECT_THROW(cache.lookup(key, context), TableNotFoundError);
+        ASSERT_EQ(db.exec("commit;"), "");
+        ASSERT_EQ(db.exec("create table t(a char(4));"), "");
+        ASSERT_EQ(db.exec("begin;"), "");
+        EXPECT_EQ(cache.lookup(key, context), entry);
+        EXPECT_THROW(PlanCache::bind(*entry, literals), IncompatibleTypeError);
+        ASSERT_EQ(db.exec("commit;"), "");
+    }
+    SqlTestDb::drop(db_name);
+}
+
+TEST(PlanCacheTest, PreparedTest)
+{
+    const std::string db_name = "plan_cache_prepared_db";
+    {
+        SqlTestDb db(db_name, true);
+        ASSERT_EQ(db.exec("create table t(a int, b char(8));"), "");
+        for (int i = 0; i < 10; i++)
+            db.exec("insert into t values(" + std::to_string(i) + ", 'v" + std::to_string(i % 2) + "');");
+        PlanCache cache(db.sm_manager.get(), db.analyze.get(), db.optimizer.get(), db.planner.get());
+        Context *context = db.context.get();
+
+        auto parse = [&](const std::string &sql)
+        {
+            std::shared_ptr<ast::TreeNode> tree;
+            EXPECT_EQ(db.parser.parse(sql.c_str(), tree), 0) << sql;
+            return tree;
+        };
+        auto prepare = [&](const std::string &sql)
+        {
+            auto x = std::static_pointer_cast<ast::PrepareStmt>(parse(sql));
+            cache.prepare(x->name, x->stmt, context);
+        };
+        auto execute = [&](const std::string &sql)
+        {
+            auto x = std::static_pointer_cast<ast::ExecuteStmt>(parse(sql));
+            return db.exec_plan([&]
+                                { return PlanCache::bind(*cache.get_prepared(x->name, context), x->vals); });
+        };
+
+        ASSERT_EQ(db.exec("begin;"), "");
+        prepare("prepare q as select * from t where a > ? and b = ?;");
+        EXPECT_EQ(cache.get_prepared("q", context)->param_count, 2);
+        EXPECT_EQ(result_rows(execute("execute q (4, 'v1');")), 3);
+        EXPECT_EQ(result_rows(execute("execute q (0, 'v0');")), 4);
+
+        // 重复的名字、不存在的名字、参数个数和类型不正确
+        EXPECT_THROW(prepare("prepare q as select * from t;"), PreparedStmtExistsError);
+        EXPECT_THROW(cache.get_prepared("r", context), PreparedStmtNotFoundError);
+        EXPECT_EQ(execute("execute q (1);"), std::string(InvalidParamCountError(2, 1).what()) + "\n");
+        ASSERT_EQ(db.exec("begin;"), "");
+        EXPECT_EQ(execute("execute q ('x', 'v1');"), std::string(IncompatibleTypeError("INT", "STRING").what()) + "\n");
+        ASSERT_EQ(db.exec("begin;"), "");
+
+        // EXPLAIN中的参数同样能绑定
+        prepare("prepare e as explain select * from t where a = ?;");
+        EXPECT_NE(execute("execute e (3);").find("t.a=3"), std::string::npos);
+        EXPECT_NE(execute("execute e (7);").find("t.a=7"), std::string::npos);
+        ASSERT_EQ(db.exec("commit;"), "");
+
+        // DDL之后预编译语句重新生成计划
+        ASSERT_EQ(db.exec("create index t(a);"), "");
+        ASSERT_EQ(db.exec("begin;"), "");
+        EXPECT_EQ(result_rows(execute("execute q (4, 'v1');")), 3);
+
+        cache.deallocate("q");
+        EXPECT_THROW(cache.deallocate("q"), PreparedStmtNotFoundError);
+        EXPECT_THROW(cache.get_prepared("q", context), PreparedStmtNotFoundError);
+        ASSERT_EQ(db.exec("commit;"), "");
+    }
+    SqlTestDb::drop(db_name);
+}
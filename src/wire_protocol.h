@@ -0,0 +1,285 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "defs.h"
+#include "system/sm_meta.h"
+
+/*
+ * 二进制帧协议
+ *
+ * 客户端连接后先发送5字节的握手：PROTOCOL_MAGIC + 版本号，服务端回复一个FRAME_READY帧；
+ * 第一个字节不是0xFF的连接按原来的文本协议处理（每条请求以'\0'结尾，返回以'\0'结尾的文本）。
+ *
+ * 之后双方都以帧为单位通信，整数一律使用网络字节序：
+ *   | uint32 长度（类型+内容的字节数） | uint8 类型 | 内容 |
+ *
+ * 客户端 -> 服务端
+ *   FRAME_QUERY     SQL文本，不需要'\0'结尾，长度不受BUFFER_LENGTH限制
+ *   FRAME_TERMINATE 关闭连接
+ * 服务端 -> 客户端
+ *   FRAME_READY     uint8 协议版本
+ *   FRAME_ROW_DESC  uint16 列数，每列：uint8 ColType，uint16 列名长度，列名
+ *   FRAME_DATA_ROW  一行数据，每列：uint8 是否为空，非空时INT/FLOAT为4字节，STRING/DATETIME为uint16长度+内容
+ *   FRAME_COMPLETE  uint64 返回的行数，其余为文本结果（show tables、explain等），每条语句以该帧或FRAME_ERROR结束
+ *   FRAME_ERROR     错误信息
+ *   FRAME_READY_FOR_QUERY 一个FRAME_QUERY中的所有语句都已经执行完
+ *
+ * 一个FRAME_QUERY中可以包含多条以';'分隔的语句，每条语句依次返回各自的结果，最后是FRAME_READY_FOR_QUERY。
+ * 客户端不需要等待结果就可以继续发送下一个FRAME_QUERY，服务端按顺序执行并按顺序返回。
+ *
+ * 查询结果按行流式发送，缓存的帧超过FRAME_FLUSH_SIZE时不阻塞地写入socket，写不下的部分留在缓存中。
+ * 执行器不会等待socket可写：工作线程数有限，等待读取较慢的客户端会让其他会话也无法执行。
+ * 客户端读取较慢、缓存超过FRAME_HIGH_WATER时查询暂停产生结果，游标保存在会话中，工作线程转而处理其他会话；
+ * 会话等待socket可写（EPOLLOUT），缓存降到FRAME_FLUSH_SIZE以下后由之后的工作线程继续执行这条查询。
+ *
+ * 语句执行完之后剩下的结果同样不阻塞写入，留在会话的发送缓冲区中，等socket可写时由之后的工作线程继续写出；
+ * 发送缓冲区中的数据超过FRAME_FLUSH_SIZE时暂停处理这个会话的后续请求。
+ * 客户端退出或者关闭连接的写端之后，已经产生的结果仍然按同样的方式写完再关闭连接。
+ * 文本协议的结果也经过同一个发送缓冲区。
+ */
+static constexpr char PROTOCOL_MAGIC[4] = {'\xff', 'R', 'M', 'B'};
+static constexpr uint8_t PROTOCOL_VERSION = 1;
+static constexpr size_t PROTOCOL_HANDSHAKE_LENGTH = sizeof(PROTOCOL_MAGIC) + 1;
+static constexpr size_t FRAME_HEADER_LENGTH = 5;
+static constexpr uint32_t MAX_FRAME_LENGTH = 64 * 1024 * 1024;
+static constexpr size_t FRAME_FLUSH_SIZE = 64 * 1024;
+static constexpr size_t FRAME_HIGH_WATER = 1024 * 1024;
+
+enum FrameType : char
+{
+    FRAME_QUERY = 'Q',
+    FRAME_TERMINATE = 'X',
+    FRAME_READY = 'R',
+    FRAME_ROW_DESC = 'T',
+    FRAME_DATA_ROW = 'D',
+    FRAME_COMPLETE = 'C',
+    FRAME_ERROR = 'E',
+    FRAME_READY_FOR_QUERY = 'Z'
+};
+
+// 不阻塞地写入尽可能多的数据，返回写入的字节数，连接出错时返回-1；对端已经关闭时不产生SIGPIPE
+inline ssize_t write_some(int fd, const char *data, size_t len)
+{
+    size_t written = 0;
+    while (written < len)
+    {
+        ssize_t n = ::send(fd, data + written, len - written, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            written += n;
+            continue;
+        }
+        if (n == -1 && errno == EINTR)
+            continue;
+        if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        return -1;
+    }
+    return written;
+}
+
+// 从缓冲区中读取网络字节序的uint32
+inline uint32_t read_frame_u32(const char *data)
+{
+    uint32_t val;
+    memcpy(&val, data, sizeof(val));
+    return ntohl(val);
+}
+
+// 会话的发送缓冲区：二进制协议把帧编码到缓冲区中，文本协议直接追加结果，按需写入socket
+class FrameWriter
+{
+private:
+    int fd_;
+    std::string buf_;
+    size_t frame_start_ = 0;
+    uint64_t rows_ = 0;   // 当前请求已经发送的行数
+    bool broken_ = false; // 写socket失败，之后的数据全部丢弃
+
+public:
+    explicit FrameWriter(int fd) : fd_(fd) {}
+
+    void begin_frame(FrameType type)
+    {
+        frame_start_ = buf_.size();
+        buf_.append(4, '\0');
+        buf_.push_back(type);
+    }
+
+    void end_frame()
+    {
+        uint32_t len = htonl(buf_.size() - frame_start_ - 4);
+        memcpy(&buf_[frame_start_], &len, sizeof(len));
+    }
+
+    void put_u8(uint8_t val) { buf_.push_back((char)val); }
+
+    void put_u16(uint16_t val)
+    {
+        val = htons(val);
+        buf_.append((const char *)&val, sizeof(val));
+    }
+
+    void put_u32(uint32_t val)
+    {
+        val = htonl(val);
+        buf_.append((const char *)&val, sizeof(val));
+    }
+
+    void put_u64(uint64_t val)
+    {
+        put_u32(val >> 32);
+        put_u32(val & 0xffffffff);
+    }
+
+    void put_bytes(const char *data, size_t len) { buf_.append(data, len); }
+
+    /**
+     * @description: 发送列信息，开始一个新的查询结果
+     * @param {vector<std::string>&} captions 列名
+     * @param {vector<ColMeta>&} cols 列的元信息
+     */
+    void send_row_desc(const std::vector<std::string> &captions, const std::vector<ColMeta> &cols)
+    {
+        begin_frame(FRAME_ROW_DESC);
+        put_u16(cols.size());
+        for (size_t i = 0; i < cols.size(); i++)
+        {
+            put_u8(cols[i].type);
+            put_u16(captions[i].size());
+            put_bytes(captions[i].data(), captions[i].size());
+        }
+        end_frame();
+    }
+
+    /**
+     * @description: 发送一行数据，缓存的数据足够多时不阻塞地写入socket，写不下的部分留在缓存中，
+     * 调用者在缓存超过FRAME_HIGH_WATER时暂停产生结果
+     * @param {vector<ColMeta>&} cols 列的元信息
+     * @param {char} *data 记录的内容
+     */
+    void send_row(const std::vector<ColMeta> &cols, const char *data)
+    {
+        if (broken_)
+            return;
+        begin_frame(FRAME_DATA_ROW);
+        for (auto &col : cols)
+        {
+            const char *rec_buf = data + col.offset;
+            switch (col.type)
+            {
+            case TYPE_INT:
+            {
+                int val = *(int *)rec_buf;
+                // 与文本协议一致，INT的最大值和最小值表示空值
+                bool is_null = std::numeric_limits<int>::max() == val || std::numeric_limits<int>::min() == val;
+                put_u8(is_null);
+                if (!is_null)
+                    put_u32(val);
+                break;
+            }
+            case TYPE_FLOAT:
+            {
+                float val = *(float *)rec_buf;
+                bool is_null = std::numeric_limits<float>::max() == val || std::numeric_limits<float>::lowest() == val;
+                put_u8(is_null);
+                if (!is_null)
+                {
+                    uint32_t bits;
+                    memcpy(&bits, &val, sizeof(bits));
+                    put_u32(bits);
+                }
+                break;
+            }
+            case TYPE_STRING:
+            {
+                put_u8(0);
+                size_t len = strnlen(rec_buf, col.len);
+                put_u16(len);
+                put_bytes(rec_buf, len);
+                break;
+            }
+            default:
+                put_u8(0);
+                put_u16(col.len);
+                put_bytes(rec_buf, col.len);
+                break;
+            }
+        }
+        end_frame();
+        rows_++;
+        if (buf_.size() >= FRAME_FLUSH_SIZE)
+            try_flush();
+    }
+
+    // 发送请求的执行结果，text为文本协议下返回的内容
+    void send_complete(const char *text, size_t len)
+    {
+        begin_frame(FRAME_COMPLETE);
+        put_u64(rows_);
+        put_bytes(text, len);
+        end_frame();
+        rows_ = 0;
+    }
+
+    void send_error(const char *msg, size_t len)
+    {
+        begin_frame(FRAME_ERROR);
+        put_bytes(msg, len);
+        end_frame();
+        rows_ = 0;
+    }
+
+    void send_ready_for_query()
+    {
+        begin_frame(FRAME_READY_FOR_QUERY);
+        end_frame();
+    }
+
+    void send_ready()
+    {
+        begin_frame(FRAME_READY);
+        put_u8(PROTOCOL_VERSION);
+        end_frame();
+    }
+
+    bool broken() const { return broken_; }
+
+    // 还没有写入socket的字节数
+    size_t pending() const { return buf_.size(); }
+
+    // 不阻塞地写出尽可能多的数据，剩下的留在缓冲区中，等socket可写时再次调用
+    bool try_flush()
+    {
+        if (!broken_ && !buf_.empty())
+        {
+            ssize_t n = write_some(fd_, buf_.data(), buf_.size());
+            if (n < 0)
+                broken_ = true;
+            else
+                buf_.erase(0, n);
+        }
+        if (broken_)
+            buf_.clear();
+        return !broken_;
+    }
+};